@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "AdaptiveCompression.h"
+
+
+namespace evio {
+
+
+    /**
+     * Constructor.
+     * Types not compiled into this library (gzip without USE_GZIP,
+     * zstd without USE_ZSTD) are dropped from the candidates.
+     *
+     * @param targetMBps rate in MB/s (of uncompressed data) at which each compressing
+     *                   thread must compress records.
+     * @param types      compression types to choose from, besides no compression.
+     *                   If empty, LZ4, LZ4 best and, if available, zstd.
+     * @throws EvioException if targetMBps <= 0.
+     */
+    AdaptiveCompression::AdaptiveCompression(double targetMBps,
+                                             std::vector<Compressor::CompressionType> types) :
+            targetRate(targetMBps) {
+
+        if (targetMBps <= 0.) {
+            throw EvioException("target rate must be > 0");
+        }
+
+        if (types.empty()) {
+            types = {Compressor::LZ4, Compressor::LZ4_BEST, Compressor::ZSTD};
+        }
+
+        for (auto type : types) {
+            if (type == Compressor::UNCOMPRESSED || !Compressor::isSupported(type)) continue;
+            bool have = false;
+            for (auto cand : candidates) {
+                if (cand == type) have = true;
+            }
+            if (!have) candidates.push_back(type);
+        }
+    }
+
+
+    /**
+     * Choose the type of compression for the next record.
+     * @return type of compression for the next record.
+     */
+    Compressor::CompressionType AdaptiveCompression::select() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        uint64_t count = recordCount++;
+
+        // Try each candidate once to start with
+        for (auto type : candidates) {
+            if (stats[type].records == 0) {
+                return type;
+            }
+        }
+
+        if (candidates.empty()) {
+            return Compressor::UNCOMPRESSED;
+        }
+
+        // Now & then try each candidate again, in turn, as the data may have changed
+        if (count % sampleInterval == 0) {
+            return candidates[(count / sampleInterval) % candidates.size()];
+        }
+
+        // Smallest result of those fast enough, if it's worth it
+        auto best = Compressor::UNCOMPRESSED;
+        double bestRatio = 1. - minSavings;
+        for (auto type : candidates) {
+            Stats & st = stats[type];
+            if (st.rate >= targetRate && st.ratio < bestRatio) {
+                best = type;
+                bestRatio = st.ratio;
+            }
+        }
+
+        return best;
+    }
+
+
+    /**
+     * Add the result of compressing a record to the running averages.
+     * @param type              type of compression used.
+     * @param uncompressedBytes size of data before compression.
+     * @param compressedBytes   size of data after compression.
+     * @param seconds           time it took to compress.
+     */
+    void AdaptiveCompression::update(Compressor::CompressionType type, uint32_t uncompressedBytes,
+                                     uint32_t compressedBytes, double seconds) {
+        if (type > Compressor::ZSTD) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        Stats & st = stats[type];
+        st.records++;
+        if (type == Compressor::UNCOMPRESSED || uncompressedBytes == 0) {
+            return;
+        }
+
+        double ratio = (double)compressedBytes / uncompressedBytes;
+        // Too fast to measure counts as very fast
+        double rate = seconds > 0. ? uncompressedBytes / 1.e6 / seconds : 1.e6;
+
+        if (st.records == 1) {
+            st.ratio = ratio;
+            st.rate  = rate;
+        }
+        else {
+            st.ratio += WEIGHT * (ratio - st.ratio);
+            st.rate  += WEIGHT * (rate  - st.rate);
+        }
+    }
+
+
+    /**
+     * Get the rate in MB/s at which each compressing thread must compress records.
+     * @return rate in MB/s at which each compressing thread must compress records.
+     */
+    double AdaptiveCompression::getTargetRate() const {return targetRate;}
+
+
+    /**
+     * Set the fraction of the data a compression type must save to be used.
+     * Data saving less is not worth the time to compress and uncompress it.
+     * @param fraction fraction of the data a compression type must save, 0 to 1.
+     *                 Default is {@link #DEFAULT_MIN_SAVINGS}.
+     */
+    void AdaptiveCompression::setMinSavings(double fraction) {
+        std::lock_guard<std::mutex> lock(mutex);
+        minSavings = fraction < 0. ? 0. : (fraction > 1. ? 1. : fraction);
+    }
+
+
+    /**
+     * Set the number of records after which another candidate is tried again.
+     * @param records number of records after which another candidate is tried again.
+     *                Default is {@link #DEFAULT_SAMPLE_INTERVAL}.
+     */
+    void AdaptiveCompression::setSampleInterval(uint32_t records) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sampleInterval = records < 1 ? 1 : records;
+    }
+
+
+    /**
+     * Get the compression types chosen from, besides no compression.
+     * @return compression types chosen from, besides no compression.
+     */
+    std::vector<Compressor::CompressionType> AdaptiveCompression::getCandidates() const {
+        return candidates;
+    }
+
+
+    /**
+     * Get the number of records compressed with the given type.
+     * @param type type of compression.
+     * @return number of records compressed with the given type.
+     */
+    uint64_t AdaptiveCompression::getRecords(Compressor::CompressionType type) const {
+        if (type > Compressor::ZSTD) return 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats[type].records;
+    }
+
+
+    /**
+     * Get the average ratio of compressed to uncompressed size for the given type.
+     * @param type type of compression.
+     * @return average ratio of compressed to uncompressed size, 1 if none measured.
+     */
+    double AdaptiveCompression::getRatio(Compressor::CompressionType type) const {
+        if (type > Compressor::ZSTD) return 1.;
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats[type].ratio;
+    }
+
+
+    /**
+     * Get the average rate of compression in MB/s for the given type.
+     * @param type type of compression.
+     * @return average rate of compression in MB/s of uncompressed data, 0 if none measured.
+     */
+    double AdaptiveCompression::getRate(Compressor::CompressionType type) const {
+        if (type > Compressor::ZSTD) return 0.;
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats[type].rate;
+    }
+
+
+    /**
+     * Obtain a string representation of the statistics.
+     * @return string representation of the statistics.
+     */
+    std::string AdaptiveCompression::toString() const {
+        static const char *names[] = {"none", "lz4", "lz4 best", "gzip", "zstd"};
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::stringstream ss;
+
+        ss << "target rate " << targetRate << " MB/s" << std::endl;
+        for (int i = 0; i < 5; i++) {
+            if (stats[i].records == 0) continue;
+            ss << "  " << names[i] << ": " << stats[i].records << " records";
+            if (i != Compressor::UNCOMPRESSED) {
+                ss << ", ratio " << stats[i].ratio << ", " << stats[i].rate << " MB/s";
+            }
+            ss << std::endl;
+        }
+        return ss.str();
+    }
+
+}
@@ -0,0 +1,120 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_ADAPTIVECOMPRESSION_H
+#define EVIO_6_0_ADAPTIVECOMPRESSION_H
+
+
+#include <vector>
+#include <mutex>
+#include <string>
+#include <sstream>
+#include <cstdint>
+
+
+#include "Compressor.h"
+#include "EvioException.h"
+
+
+namespace evio {
+
+
+    /**
+     * Class which chooses the type of compression for each record written so that
+     * records are as small as possible while compression keeps up with a target rate.<p>
+     *
+     * For each candidate type it keeps a running average of the compression ratio
+     * achieved and of the rate at which data was compressed. Of the candidates fast
+     * enough, the one producing the smallest records is chosen. If none is fast enough,
+     * or none saves a worthwhile amount of space (as for random data such as ADC noise),
+     * records are left uncompressed. Every so often another candidate is tried again
+     * so that the averages follow changes in the data. Since each record header contains
+     * its own compression type, a file may hold any mix of them.<p>
+     *
+     * One object is shared by all threads compressing records for a writer.
+     *
+     * @date 10/16/2026
+     * @author timmer
+     */
+    class AdaptiveCompression {
+
+    public:
+
+        /** Default fraction of the data a compression type must save to be worth using. */
+        static constexpr double DEFAULT_MIN_SAVINGS = 0.05;
+        /** Default number of records after which another candidate is tried again. */
+        static const uint32_t DEFAULT_SAMPLE_INTERVAL = 16;
+
+    private:
+
+        /** Running averages for one compression type. */
+        struct Stats {
+            /** Number of records compressed. */
+            uint64_t records = 0;
+            /** Average of compressed size / uncompressed size. */
+            double ratio = 1.;
+            /** Average rate of compression in MB/s of uncompressed data. */
+            double rate = 0.;
+        };
+
+        /** Weight of the latest record in the running averages. */
+        static constexpr double WEIGHT = 0.5;
+
+        /** Protects everything below. */
+        mutable std::mutex mutex;
+
+        /** Compression types to choose from, besides no compression. */
+        std::vector<Compressor::CompressionType> candidates;
+
+        /** Statistics, indexed by compression type. */
+        Stats stats[5];
+
+        /** Rate in MB/s at which each compressing thread must compress data. */
+        double targetRate;
+
+        /** Fraction of the data a compression type must save to be worth using. */
+        double minSavings = DEFAULT_MIN_SAVINGS;
+
+        /** Number of records after which another candidate is tried again. */
+        uint32_t sampleInterval = DEFAULT_SAMPLE_INTERVAL;
+
+        /** Number of records a type has been chosen for. */
+        uint64_t recordCount = 0;
+
+    public:
+
+        explicit AdaptiveCompression(double targetMBps,
+                                     std::vector<Compressor::CompressionType> types = {});
+
+        AdaptiveCompression(const AdaptiveCompression & other) = delete;
+        AdaptiveCompression & operator=(const AdaptiveCompression & other) = delete;
+
+        ~AdaptiveCompression() = default;
+
+        Compressor::CompressionType select();
+        void update(Compressor::CompressionType type, uint32_t uncompressedBytes,
+                    uint32_t compressedBytes, double seconds);
+
+        double getTargetRate() const;
+        void setMinSavings(double fraction);
+        void setSampleInterval(uint32_t records);
+
+        std::vector<Compressor::CompressionType> getCandidates() const;
+        uint64_t getRecords(Compressor::CompressionType type) const;
+        double getRatio(Compressor::CompressionType type) const;
+        double getRate(Compressor::CompressionType type) const;
+
+        std::string toString() const;
+    };
+
+}
+
+
+#endif //EVIO_6_0_ADAPTIVECOMPRESSION_H
@@ -0,0 +1,443 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "AsyncRecordIO.h"
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <sys/syscall.h>
+    #include <linux/io_uring.h>
+    #define EVIO_HAVE_IO_URING 1
+#endif
+
+
+namespace evio {
+
+
+    /**
+     * Constructor. Opens the file and, for the IO_URING engine,
+     * sets up the io_uring and its buffers. Nothing is read until asked for.
+     *
+     * @param fileName   name of file to read.
+     * @param positions  position of each record in the file.
+     * @param lengths    length of each record in bytes.
+     * @param engine     PREAD or IO_URING. IFSTREAM is treated as PREAD.
+     *                   If io_uring cannot be set up, PREAD is used.
+     * @param queueDepth max number of records read at once by io_uring.
+     *                   Values &lt; 1 are set to 1.
+     * @throws EvioException if file cannot be opened or positions and lengths differ in size.
+     */
+    AsyncRecordIO::AsyncRecordIO(std::string const & fileName,
+                                 std::vector<size_t> const & positions,
+                                 std::vector<uint32_t> const & lengths,
+                                 IoEngine engine, uint32_t queueDepth) :
+            fileName(fileName), recordPositions(positions), recordLengths(lengths) {
+
+        if (positions.size() != lengths.size()) {
+            throw EvioException("need one length per record position");
+        }
+
+        fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw EvioException("cannot open " + fileName + ", " + std::strerror(errno));
+        }
+
+        uint32_t maxLength = 0;
+        for (uint32_t len : recordLengths) {
+            maxLength = std::max(maxLength, len);
+        }
+
+        if (queueDepth < 1) queueDepth = 1;
+        if (engine != IO_URING || recordPositions.empty()) queueDepth = 1;
+
+        slots.resize(queueDepth);
+        for (auto & slot : slots) {
+            slot.buffer = ByteBuffer(maxLength > 0 ? maxLength : 1);
+        }
+
+        this->engine = PREAD;
+        if (engine == IO_URING && setupIoUring(queueDepth)) {
+            this->engine = IO_URING;
+        }
+        else if (slots.size() > 1) {
+            // pread does not read ahead, so 1 buffer is enough
+            slots.resize(1);
+        }
+    }
+
+
+    /** Destructor. Waits for outstanding reads, then releases the io_uring and file. */
+    AsyncRecordIO::~AsyncRecordIO() {
+        closeIoUring();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+
+    /**
+     * Get the engine actually used to read, PREAD or IO_URING.
+     * @return engine actually used to read.
+     */
+    AsyncRecordIO::IoEngine AsyncRecordIO::getEngine() const {return engine;}
+
+
+    /**
+     * Get the record of the given index. With io_uring, if it's the next record expected,
+     * it's taken from those already being read (waiting if necessary), and the read of
+     * another record is submitted in its place. If it's not, reading starts over from this
+     * record. With pread, the record is simply read.
+     *
+     * @param recordIndex index of the record (starting at 0).
+     * @param record      object to fill with the record.
+     * @throws EvioException if index too large or error reading or parsing record.
+     */
+    void AsyncRecordIO::readRecord(uint32_t recordIndex, RecordInput & record) {
+
+        if (recordIndex >= recordPositions.size()) {
+            throw EvioException("record index too large");
+        }
+
+        if (engine != IO_URING) {
+            Slot & slot = slots[0];
+            preadRecord(slot, recordIndex);
+            record.readRecord(slot.buffer, 0);
+            return;
+        }
+
+        Slot & slot = slots[recordIndex % slots.size()];
+        if (slot.state == EMPTY || slot.recordIndex != recordIndex) {
+            startOver(recordIndex);
+        }
+
+        submitAhead(recordIndex);
+        while (slot.state == PENDING) {
+            reapCompletions(true);
+        }
+
+        slot.state = EMPTY;
+        if (slot.error != 0) {
+            throw EvioException("error reading record " + std::to_string(recordIndex) +
+                                " of " + fileName + ", " + std::strerror(slot.error));
+        }
+
+        slot.buffer.clear();
+        slot.buffer.limit(recordLengths[recordIndex]);
+        record.readRecord(slot.buffer, 0);
+
+        // Slot's buffer is free again, so read further ahead
+        submitAhead(recordIndex + 1);
+    }
+
+
+    /**
+     * Read the given record into the given slot's buffer with pread.
+     * @param slot        slot to read into.
+     * @param recordIndex index of the record.
+     * @throws EvioException if error reading.
+     */
+    void AsyncRecordIO::preadRecord(Slot & slot, uint32_t recordIndex) {
+        uint32_t length = recordLengths[recordIndex];
+        off_t position = recordPositions[recordIndex];
+        uint8_t *dest = slot.buffer.array();
+        uint32_t done = 0;
+
+        while (done < length) {
+            ssize_t n = ::pread(fd, dest + done, length - done, position + done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw EvioException("error reading record " + std::to_string(recordIndex) +
+                                    " of " + fileName + ", " + std::strerror(errno));
+            }
+            if (n == 0) {
+                throw EvioException("unexpected end of file " + fileName + " reading record " +
+                                    std::to_string(recordIndex));
+            }
+            done += n;
+        }
+
+        slot.buffer.clear();
+        slot.buffer.limit(length);
+    }
+
+
+    /**
+     * Start reading from the given record. After waiting for all outstanding reads,
+     * records already read which are within queueDepth of the given one are kept.
+     * @param recordIndex index of record to start from.
+     */
+    void AsyncRecordIO::startOver(uint32_t recordIndex) {
+        // Buffers may not be reused while the kernel may still write into them
+        while (pendingCount > 0) {
+            reapCompletions(true);
+        }
+
+        for (auto & slot : slots) {
+            if (slot.state == READY &&
+                (slot.recordIndex < recordIndex || slot.recordIndex >= recordIndex + slots.size())) {
+                slot.state = EMPTY;
+            }
+        }
+        nextToSubmit = recordIndex;
+    }
+
+
+    /**
+     * Submit reads of records, starting with the next one not yet submitted, into each free slot
+     * until queueDepth records starting at the given one are read or being read.
+     * @param fromIndex index of record being, or about to be, taken by the reader.
+     */
+    void AsyncRecordIO::submitAhead(uint32_t fromIndex) {
+        while (nextToSubmit < recordPositions.size() && nextToSubmit < fromIndex + slots.size()) {
+            Slot & slot = slots[nextToSubmit % slots.size()];
+
+            if (slot.state == EMPTY) {
+                slot.recordIndex = nextToSubmit;
+                slot.bytesRead = 0;
+                slot.error = 0;
+                slot.state = PENDING;
+                prepareRead(nextToSubmit % slots.size());
+            }
+            else if (slot.recordIndex != nextToSubmit) {
+                // Slot still holds a record the reader has not taken
+                break;
+            }
+            nextToSubmit++;
+        }
+        submitReads();
+    }
+
+
+#ifdef EVIO_HAVE_IO_URING
+
+
+    /**
+     * Set up an io_uring of the given depth, map its rings, and register slot buffers.
+     * @param queueDepth number of submission queue entries.
+     * @return true if successful, false if io_uring cannot be used.
+     */
+    bool AsyncRecordIO::setupIoUring(uint32_t queueDepth) {
+
+        struct io_uring_params params {};
+        ringFd = (int) ::syscall(__NR_io_uring_setup, queueDepth, &params);
+        if (ringFd < 0) {
+            ringFd = -1;
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            closeIoUring();
+            return false;
+        }
+
+        if (singleMap) {
+            cqRing = sqRing;
+        }
+        else {
+            cqRing = ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ringFd, IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED) {
+                cqRing = nullptr;
+                closeIoUring();
+                return false;
+            }
+        }
+
+        sqEntriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        sqEntries = ::mmap(nullptr, sqEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFd, IORING_OFF_SQES);
+        if (sqEntries == MAP_FAILED) {
+            sqEntries = nullptr;
+            closeIoUring();
+            return false;
+        }
+
+        auto sq = static_cast<uint8_t *>(sqRing);
+        auto cq = static_cast<uint8_t *>(cqRing);
+        sqTail    = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+        sqMask    = reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+        sqArray   = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+        cqHead    = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+        cqTail    = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+        cqMask    = reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+        cqEntries = cq + params.cq_off.cqes;
+
+        // Registering buffers saves the kernel mapping them for each read.
+        // It can fail (e.g. locked memory limit), in which case plain vectored reads are used.
+        std::vector<struct iovec> iovs(slots.size());
+        for (size_t i=0; i < slots.size(); i++) {
+            iovs[i].iov_base = slots[i].buffer.array();
+            iovs[i].iov_len  = slots[i].buffer.capacity();
+        }
+        fixedBuffers = ::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS,
+                                 iovs.data(), (unsigned) iovs.size()) == 0;
+        return true;
+    }
+
+
+    /** Wait for all outstanding reads, then unmap and close the io_uring. */
+    void AsyncRecordIO::closeIoUring() {
+        if (ringFd < 0) return;
+
+        try {
+            while (pendingCount > 0) {
+                reapCompletions(true);
+            }
+        }
+        catch (EvioException &) {}
+
+        if (sqEntries != nullptr) ::munmap(sqEntries, sqEntriesSize);
+        if (cqRing != nullptr && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+        if (sqRing != nullptr) ::munmap(sqRing, sqRingSize);
+        sqEntries = cqRing = sqRing = nullptr;
+
+        ::close(ringFd);
+        ringFd = -1;
+    }
+
+
+    /**
+     * Place a read of the rest of the record of the given slot into the submission queue.
+     * It's not submitted to the kernel until {@link #submitReads()} is called.
+     * @param slotIndex index of slot.
+     */
+    void AsyncRecordIO::prepareRead(uint32_t slotIndex) {
+        Slot & slot = slots[slotIndex];
+        uint32_t index = slot.recordIndex;
+        uint8_t *dest = slot.buffer.array() + slot.bytesRead;
+        uint32_t length = recordLengths[index] - slot.bytesRead;
+
+        uint32_t tail = *sqTail;
+        uint32_t entry = tail & *sqMask;
+        auto sqe = static_cast<struct io_uring_sqe *>(sqEntries) + entry;
+        std::memset(sqe, 0, sizeof(*sqe));
+
+        sqe->fd = fd;
+        sqe->off = recordPositions[index] + slot.bytesRead;
+        sqe->user_data = slotIndex;
+
+        if (fixedBuffers) {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = reinterpret_cast<uint64_t>(dest);
+            sqe->len = length;
+            sqe->buf_index = slotIndex;
+        }
+        else {
+            slot.iov.iov_base = dest;
+            slot.iov.iov_len = length;
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = reinterpret_cast<uint64_t>(&slot.iov);
+            sqe->len = 1;
+        }
+
+        sqArray[entry] = entry;
+        // Kernel must see the entry before the new tail
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        toSubmit++;
+    }
+
+
+    /** Submit all prepared reads to the kernel. */
+    void AsyncRecordIO::submitReads() {
+        while (toSubmit > 0) {
+            int n = (int) ::syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, nullptr, 0);
+            if (n < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                throw EvioException("io_uring submit failed, " + std::string(std::strerror(errno)));
+            }
+            toSubmit -= n;
+            pendingCount += n;
+        }
+    }
+
+
+    /**
+     * Handle completed reads. A short read is resubmitted for the rest of the record.
+     * @param wait if true, wait for at least one read to complete if none has.
+     */
+    void AsyncRecordIO::reapCompletions(bool wait) {
+        // Ring indexes are shared with the kernel, so access them as liburing does
+        uint32_t head = *cqHead;
+
+        if (wait && head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            int n = (int) ::syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (n < 0 && errno != EINTR && errno != EAGAIN) {
+                throw EvioException("io_uring wait failed, " + std::string(std::strerror(errno)));
+            }
+        }
+
+        uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        bool resubmit = false;
+
+        while (head != tail) {
+            auto cqe = static_cast<struct io_uring_cqe *>(cqEntries) + (head & *cqMask);
+            Slot & slot = slots[cqe->user_data];
+            int res = cqe->res;
+            head++;
+            pendingCount--;
+
+            if (res < 0) {
+                slot.error = -res;
+                slot.state = READY;
+            }
+            else if (res == 0) {
+                slot.error = EIO;
+                slot.state = READY;
+            }
+            else {
+                slot.bytesRead += res;
+                if (slot.bytesRead < recordLengths[slot.recordIndex]) {
+                    prepareRead(cqe->user_data);
+                    resubmit = true;
+                }
+                else {
+                    slot.state = READY;
+                }
+            }
+        }
+
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        if (resubmit) {
+            submitReads();
+        }
+    }
+
+
+#else
+
+
+    bool AsyncRecordIO::setupIoUring(uint32_t) {return false;}
+    void AsyncRecordIO::closeIoUring() {}
+    void AsyncRecordIO::prepareRead(uint32_t) {}
+    void AsyncRecordIO::submitReads() {}
+    void AsyncRecordIO::reapCompletions(bool) {}
+
+
+#endif
+
+}
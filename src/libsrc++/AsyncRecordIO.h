@@ -0,0 +1,161 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_ASYNCRECORDIO_H
+#define EVIO_6_0_ASYNCRECORDIO_H
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/uio.h>
+
+
+#include "ByteBuffer.h"
+#include "RecordInput.h"
+#include "EvioException.h"
+
+
+namespace evio {
+
+
+    /**
+     * Class used by {@link Reader} to read whole records of a file with as few
+     * system calls as possible. Since the position and length of each record are known
+     * from scanning the file, a record (header, index, user header and data)
+     * is read in one go instead of with separate reads for header and payload.<p>
+     *
+     * With the IO_URING engine (Linux only), reads of the next records are submitted
+     * together to the kernel through an io_uring, each into its own buffer registered with
+     * the kernel. This keeps up to queueDepth reads outstanding, which is what fast
+     * (NVMe) storage needs to reach full throughput. Records are handed out in order.
+     * If a record other than the next one is asked for, reads start over from that record.
+     * If io_uring is not available (older kernel, not allowed, not Linux),
+     * the PREAD engine is used instead, which reads each record with pread when asked for.
+     * <b>This is for internal use only.</b>
+     *
+     * @date 10/15/2026
+     * @author timmer
+     */
+    class AsyncRecordIO {
+
+    public:
+
+        /** Ways to read records of a file. */
+        enum IoEngine {
+            /** Read header, then payload, through std::ifstream (Reader's default). */
+            IFSTREAM = 0,
+            /** Read each whole record with one pread. */
+            PREAD,
+            /** Read ahead through Linux io_uring, with pread as fallback. */
+            IO_URING
+        };
+
+    private:
+
+        /** State of a buffer slot. */
+        enum SlotState {
+            /** No record or stale record. */
+            EMPTY = 0,
+            /** Read has been submitted. */
+            PENDING,
+            /** Read is complete. */
+            READY
+        };
+
+        /** Each slot holds one record being read or already read. */
+        struct Slot {
+            /** Buffer record is read into, big enough for the largest record. */
+            ByteBuffer buffer;
+            /** Index of record held in this slot. */
+            uint32_t recordIndex = 0;
+            /** State of this slot. */
+            SlotState state = EMPTY;
+            /** Number of bytes read so far. */
+            uint32_t bytesRead = 0;
+            /** Errno of failed read, 0 if none. */
+            int error = 0;
+            /** Describes rest of buffer to be read into if buffers are not registered. */
+            struct iovec iov {nullptr, 0};
+        };
+
+
+        /** Name of file being read. */
+        std::string fileName;
+        /** File descriptor of file being read. */
+        int fd = -1;
+        /** Position of each record in the file. */
+        std::vector<size_t> recordPositions;
+        /** Length of each record in bytes. */
+        std::vector<uint32_t> recordLengths;
+        /** Ring of slots. Record #n always goes into slot #(n % slots.size()). */
+        std::vector<Slot> slots;
+        /** Engine actually used. */
+        IoEngine engine = PREAD;
+
+        /** Index of the next record to be submitted. */
+        uint32_t nextToSubmit = 0;
+        /** Number of reads submitted but not completed. */
+        uint32_t pendingCount = 0;
+        /** Number of reads prepared but not yet submitted. */
+        uint32_t toSubmit = 0;
+
+        /** File descriptor of io_uring. */
+        int ringFd = -1;
+        /** Were slot buffers registered with the kernel? */
+        bool fixedBuffers = false;
+        /** Memory mapped submission queue ring. */
+        void *sqRing = nullptr;
+        /** Memory mapped completion queue ring. */
+        void *cqRing = nullptr;
+        /** Memory mapped submission queue entries. */
+        void *sqEntries = nullptr;
+        /** Size of mapped submission queue ring. */
+        size_t sqRingSize = 0;
+        /** Size of mapped completion queue ring. */
+        size_t cqRingSize = 0;
+        /** Size of mapped submission queue entries. */
+        size_t sqEntriesSize = 0;
+        /** Fields of the mapped rings. */
+        uint32_t *sqTail = nullptr, *sqMask = nullptr, *sqArray = nullptr;
+        uint32_t *cqHead = nullptr, *cqTail = nullptr, *cqMask = nullptr;
+        /** Completion queue entries. */
+        void *cqEntries = nullptr;
+
+
+        bool setupIoUring(uint32_t queueDepth);
+        void closeIoUring();
+        void prepareRead(uint32_t slotIndex);
+        void submitReads();
+        void submitAhead(uint32_t fromIndex);
+        void reapCompletions(bool wait);
+        void startOver(uint32_t recordIndex);
+        void preadRecord(Slot & slot, uint32_t recordIndex);
+
+    public:
+
+        AsyncRecordIO(std::string const & fileName,
+                      std::vector<size_t> const & positions,
+                      std::vector<uint32_t> const & lengths,
+                      IoEngine engine, uint32_t queueDepth);
+
+        AsyncRecordIO(const AsyncRecordIO & other) = delete;
+        AsyncRecordIO & operator=(const AsyncRecordIO & other) = delete;
+
+        ~AsyncRecordIO();
+
+        IoEngine getEngine() const;
+        void readRecord(uint32_t recordIndex, RecordInput & record);
+    };
+
+}
+
+
+#endif //EVIO_6_0_ASYNCRECORDIO_H
@@ -14,7 +14,7 @@
 namespace evio {
 
     /** Define a deleter that does not delete memory for a shared pointer that's used with shared memory. */
-    void null_deleter(uint8_t *) {};
+    void null_deleter(uint8_t *) {}
 
 
     /** Default constructor, size of 4096 bytes.  */
@@ -85,12 +85,14 @@ namespace evio {
      * @param byteArray pointer to array which this object will wrap.
      * @param len length of array in bytes.
      * @param isMappedMem is the byteArray arg a pointer obtained through mmap (file memory mapping)?.
+     *                    If so, it's unmapped once this buffer and all buffers duplicated
+     *                    or sliced from it are destroyed.
      */
     ByteBuffer::ByteBuffer(uint8_t* byteArray, size_t len, bool isMappedMem) {
 
         if (isMappedMem) {
-            // Must remove the deleter since we're using shared memory and it must be unmapped, not deleted
-            buf = std::shared_ptr<uint8_t>(byteArray,  &null_deleter);
+            // Memory must be unmapped, not deleted, once this buffer and all its duplicates are gone
+            buf = std::shared_ptr<uint8_t>(byteArray,  [len](uint8_t* p) { ::munmap(p, len); });
         }
         else {
             buf = std::shared_ptr<uint8_t>(byteArray,  [](uint8_t* p) { delete[] p; });
@@ -104,15 +106,28 @@ namespace evio {
     }
 
 
-    /** Destructor. Be sure to unmap any memory mapped file. */
-    ByteBuffer::~ByteBuffer() {
-        if (isMappedMemory) {
-            // unmap any memory map
-            ::munmap(buf.get(), cap);
-        }
+    /**
+     * Constructor wrapping an array whose memory is managed by the given shared pointer.
+     * To wrap memory owned by someone else, give the shared pointer a deleter that does
+     * nothing, such as {@link null_deleter}. It is then up to the caller to keep the
+     * memory around while this buffer, or any buffer duplicated or sliced from it, is in use.
+     *
+     * @param byteArray shared pointer to array which this object will wrap.
+     * @param len length of array in bytes.
+     */
+    ByteBuffer::ByteBuffer(std::shared_ptr<uint8_t> byteArray, size_t len) : buf(std::move(byteArray)) {
+        totalSize = cap = len;
+        clear();
+
+        isLittleEndian = byteOrder.isLittleEndian();
+        isHostEndian = true;
     }
 
 
+    /** Destructor. Any memory mapped file is unmapped when the last buffer sharing it is destroyed. */
+    ByteBuffer::~ByteBuffer() {}
+
+
     /**
      * Move assignment operator.
      * @param other right side object.
@@ -734,7 +749,9 @@ namespace evio {
      * @return  the same byte buffer as passed in as the argument.
      */
     std::shared_ptr<ByteBuffer> ByteBuffer::duplicate() {
-        auto destBuf = std::make_shared<ByteBuffer>(cap);
+        // Share this buffer's memory from the start. Allocating a new buffer of the
+        // same capacity would fail for large memory mapped files.
+        auto destBuf = std::make_shared<ByteBuffer>(buf, cap);
         destBuf->lim = lim;
         destBuf->pos = pos;
         destBuf->mrk = mrk;
@@ -744,9 +761,6 @@ namespace evio {
         destBuf->byteOrder = byteOrder;
         destBuf->isHostEndian = isHostEndian;
         destBuf->isLittleEndian = isLittleEndian;
-
-        // shared pointers
-        destBuf->buf = buf;
         return destBuf;
     }
 
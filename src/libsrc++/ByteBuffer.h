@@ -33,6 +33,10 @@
 namespace evio {
 
 
+    /** Deleter that does not delete memory, for shared pointers to memory owned by someone else. */
+    void null_deleter(uint8_t *);
+
+
     /**
      * This class is copied from one of the same name in the Java programming language.
      * It wraps an array or buffer of data and is extremely useful in reading and writing
@@ -86,7 +90,7 @@ namespace evio {
         bool isLittleEndian = false;
 
         /** Is the pointer pased to the constructor pointed to file mapped memory?
-         * I.e. does it need to be unmapped by destructor?
+         * I.e. does it need to be unmapped, which the deleter of buf does?
          */
         bool isMappedMemory = false;
 
@@ -98,6 +102,7 @@ namespace evio {
         ByteBuffer(ByteBuffer && srcBuf) noexcept;
         ByteBuffer(char* byteArray, size_t len, bool isMappedMem = false);
         ByteBuffer(uint8_t* byteArray, size_t len, bool isMappedMem = false);
+        ByteBuffer(std::shared_ptr<uint8_t> byteArray, size_t len);
 
         ~ByteBuffer();
 
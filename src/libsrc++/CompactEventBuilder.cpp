@@ -44,7 +44,7 @@ namespace evio {
         createdBuffer = true;
 
         totalLengths.assign(MAX_LEVELS, 0);
-        stackArray.reserve(MAX_LEVELS);
+        stackArray.resize(MAX_LEVELS);
 
         // Fill stackArray vector with pre-allocated objects so each openBank/Seg/TagSeg
         // doesn't have to create a new StructureContent object each time they're called.
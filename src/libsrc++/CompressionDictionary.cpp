@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "CompressionDictionary.h"
+
+#ifdef USE_ZSTD
+    #include "zstd.h"
+    #include "zdict.h"
+#endif
+
+
+namespace evio {
+
+
+    /**
+     * Constructor from the bytes of a dictionary, either user-supplied
+     * or as read from a file.
+     *
+     * @param bytes  dictionary bytes, which are copied.
+     * @param length number of bytes.
+     * @throws EvioException if bytes is null or length is 0.
+     */
+    CompressionDictionary::CompressionDictionary(const uint8_t *bytes, size_t length) {
+        if (bytes == nullptr || length < 1) {
+            throw EvioException("empty compression dictionary");
+        }
+        data.assign(bytes, bytes + length);
+    }
+
+
+    /**
+     * Constructor from the bytes of a dictionary, either user-supplied
+     * or as read from a file.
+     *
+     * @param bytes dictionary bytes.
+     * @throws EvioException if bytes is empty.
+     */
+    CompressionDictionary::CompressionDictionary(std::vector<uint8_t> bytes) : data(std::move(bytes)) {
+        if (data.empty()) {
+            throw EvioException("empty compression dictionary");
+        }
+    }
+
+
+    /**
+     * Create a dictionary from sample events.
+     * With zstd available, a dictionary is trained from the samples, which needs
+     * a sample count in the hundreds or more to work well.
+     * If training is not possible (no zstd, too few samples), the dictionary is
+     * simply the last maxBytes of the samples, which also helps since
+     * the following events are similar.
+     *
+     * @param samples  sample events.
+     * @param maxBytes max size of dictionary in bytes.
+     * @return dictionary, or null if there is no sample data.
+     */
+    std::shared_ptr<CompressionDictionary> CompressionDictionary::train(std::vector<std::vector<uint8_t>> const & samples,
+                                                                        uint32_t maxBytes) {
+        size_t totalBytes = 0;
+        for (auto const & sample : samples) {
+            totalBytes += sample.size();
+        }
+        if (totalBytes == 0 || maxBytes == 0) {
+            return nullptr;
+        }
+
+#ifdef USE_ZSTD
+        std::vector<uint8_t> sampleBuffer;
+        std::vector<size_t> sampleSizes;
+        sampleBuffer.reserve(totalBytes);
+        sampleSizes.reserve(samples.size());
+        for (auto const & sample : samples) {
+            if (sample.empty()) continue;
+            sampleBuffer.insert(sampleBuffer.end(), sample.begin(), sample.end());
+            sampleSizes.push_back(sample.size());
+        }
+
+        std::vector<uint8_t> trained(maxBytes);
+        size_t size = ZDICT_trainFromBuffer(trained.data(), trained.size(), sampleBuffer.data(),
+                                            sampleSizes.data(), sampleSizes.size());
+        if (!ZDICT_isError(size) && size > 0) {
+            trained.resize(size);
+            return std::make_shared<CompressionDictionary>(std::move(trained));
+        }
+#endif
+
+        // Use most recent sample bytes as is
+        size_t first = samples.size(), bytes = 0;
+        while (first > 0 && bytes < maxBytes) {
+            bytes += samples[--first].size();
+        }
+
+        std::vector<uint8_t> dict;
+        dict.reserve(bytes);
+        for (size_t i = first; i < samples.size(); i++) {
+            dict.insert(dict.end(), samples[i].begin(), samples[i].end());
+        }
+        if (dict.size() > maxBytes) {
+            dict.erase(dict.begin(), dict.end() - maxBytes);
+        }
+        return std::make_shared<CompressionDictionary>(std::move(dict));
+    }
+
+
+    /**
+     * Get the dictionary bytes.
+     * @return dictionary bytes.
+     */
+    const uint8_t * CompressionDictionary::getData() const {return data.data();}
+
+
+    /**
+     * Get the size of the dictionary in bytes.
+     * @return size of the dictionary in bytes.
+     */
+    uint32_t CompressionDictionary::getSize() const {return data.size();}
+
+
+    /**
+     * Get the part of the dictionary used by LZ4, its last 64kB.
+     * @return part of the dictionary used by LZ4.
+     */
+    const uint8_t * CompressionDictionary::getLZ4Data() const {
+        return data.data() + data.size() - getLZ4Size();
+    }
+
+
+    /**
+     * Get the size of the part of the dictionary used by LZ4.
+     * @return size in bytes of the part of the dictionary used by LZ4.
+     */
+    uint32_t CompressionDictionary::getLZ4Size() const {
+        return data.size() < LZ4_MAX_BYTES ? data.size() : LZ4_MAX_BYTES;
+    }
+
+
+#ifdef USE_ZSTD
+
+    /**
+     * Get the dictionary digested for zstd compression at the given level,
+     * creating it if necessary.
+     * @param level zstd compression level.
+     * @return dictionary digested for zstd compression.
+     * @throws EvioException if it cannot be created.
+     */
+    const ZSTD_CDict * CompressionDictionary::getZstdCDict(int level) const {
+        std::lock_guard<std::mutex> lock(zstdMutex);
+
+        auto it = zstdCDicts.find(level);
+        if (it != zstdCDicts.end()) {
+            return it->second.get();
+        }
+
+        std::shared_ptr<ZSTD_CDict> cdict(ZSTD_createCDict(data.data(), data.size(), level), ZSTD_freeCDict);
+        if (cdict == nullptr) {
+            throw EvioException("cannot create zstd compression dictionary");
+        }
+        zstdCDicts[level] = cdict;
+        return cdict.get();
+    }
+
+
+    /**
+     * Get the dictionary digested for zstd decompression, creating it if necessary.
+     * @return dictionary digested for zstd decompression.
+     * @throws EvioException if it cannot be created.
+     */
+    const ZSTD_DDict * CompressionDictionary::getZstdDDict() const {
+        std::lock_guard<std::mutex> lock(zstdMutex);
+
+        if (zstdDDict == nullptr) {
+            zstdDDict = std::shared_ptr<ZSTD_DDict>(ZSTD_createDDict(data.data(), data.size()), ZSTD_freeDDict);
+            if (zstdDDict == nullptr) {
+                throw EvioException("cannot create zstd decompression dictionary");
+            }
+        }
+        return zstdDDict.get();
+    }
+
+#endif
+
+}
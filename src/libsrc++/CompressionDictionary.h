@@ -0,0 +1,100 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_COMPRESSIONDICTIONARY_H
+#define EVIO_6_0_COMPRESSIONDICTIONARY_H
+
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+
+#include "EvioException.h"
+
+
+// Opaque zstd types, so this class looks the same whether or not zstd is used
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+
+namespace evio {
+
+
+    /**
+     * Class holding a dictionary used to compress and decompress records with
+     * LZ4 or zstd. Records holding many small, similar events compress much
+     * better when the compressor starts out from a dictionary of the byte
+     * sequences these events have in common.<p>
+     *
+     * A dictionary is either given by the user or trained from sample events
+     * with {@link #train}. A writer stores it once in the file header's user header,
+     * next to the xml dictionary and first event, and marks each record compressed
+     * with it. A {@link Reader} loads it automatically. LZ4 uses the last 64kB
+     * of the dictionary, zstd all of it.<p>
+     *
+     * Once created, a dictionary is never changed and may be shared by any
+     * number of threads.
+     *
+     * @date 10/15/2026
+     * @author timmer
+     */
+    class CompressionDictionary {
+
+    public:
+
+        /** Default size of a trained dictionary in bytes. */
+        static const uint32_t DEFAULT_BYTES = 65536;
+        /** Max number of bytes of a dictionary LZ4 can use. */
+        static const uint32_t LZ4_MAX_BYTES = 65536;
+
+    private:
+
+        /** Dictionary contents. */
+        std::vector<uint8_t> data;
+
+        /** Protects creation of zstd dictionaries. */
+        mutable std::mutex zstdMutex;
+        /** Digested dictionary for zstd compression, one per compression level. Unused without zstd. */
+        mutable std::map<int, std::shared_ptr<ZSTD_CDict_s>> zstdCDicts;
+        /** Digested dictionary for zstd decompression. Unused without zstd. */
+        mutable std::shared_ptr<ZSTD_DDict_s> zstdDDict;
+
+    public:
+
+        CompressionDictionary(const uint8_t *bytes, size_t length);
+        explicit CompressionDictionary(std::vector<uint8_t> bytes);
+
+        CompressionDictionary(const CompressionDictionary & other) = delete;
+        CompressionDictionary & operator=(const CompressionDictionary & other) = delete;
+
+        ~CompressionDictionary() = default;
+
+        static std::shared_ptr<CompressionDictionary> train(std::vector<std::vector<uint8_t>> const & samples,
+                                                            uint32_t maxBytes = DEFAULT_BYTES);
+
+        const uint8_t * getData() const;
+        uint32_t getSize() const;
+
+        const uint8_t * getLZ4Data() const;
+        uint32_t getLZ4Size() const;
+
+        // Only defined when built with zstd
+        const ZSTD_CDict_s * getZstdCDict(int level) const;
+        const ZSTD_DDict_s * getZstdDDict() const;
+    };
+
+}
+
+
+#endif //EVIO_6_0_COMPRESSIONDICTIONARY_H
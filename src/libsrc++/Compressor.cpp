@@ -18,15 +18,118 @@ namespace evio {
 
 
 #ifdef USE_GZIP
-    z_stream Compressor::strmDeflate;
-    z_stream Compressor::strmInflate;
+#ifdef USE_LIBDEFLATE
+    /**
+     * Libdeflate compressor and decompressor of a single thread.
+     * Created the first time a thread uses gzip and released when the thread exits.
+     */
+    struct Compressor::DeflateState {
+
+        libdeflate_compressor   *compressor;
+        libdeflate_decompressor *decompressor;
+
+        DeflateState() {
+            // Same level as zlib's default, 1 gives top speed, 12 top compression
+            compressor   = libdeflate_alloc_compressor(6);
+            decompressor = libdeflate_alloc_decompressor();
+            if (compressor == nullptr || decompressor == nullptr) {
+                if (compressor   != nullptr) libdeflate_free_compressor(compressor);
+                if (decompressor != nullptr) libdeflate_free_decompressor(decompressor);
+                throw EvioException("error allocating libdeflate compressor/decompressor");
+            }
+        }
+
+        ~DeflateState() {
+            libdeflate_free_compressor(compressor);
+            libdeflate_free_decompressor(decompressor);
+        }
+
+        DeflateState(const DeflateState &) = delete;
+        DeflateState & operator=(const DeflateState &) = delete;
+    };
+
+
+    /**
+     * Get the libdeflate state of the calling thread, creating it if necessary.
+     * @return libdeflate state of the calling thread.
+     * @throws EvioException if it cannot be allocated.
+     */
+    Compressor::DeflateState & Compressor::getDeflateState() {
+        thread_local DeflateState state;
+        return state;
+    }
+#else
+    /**
+     * Gzip deflate and inflate streams of a single thread.
+     * Created the first time a thread uses gzip and released when the thread exits.
+     */
+    struct Compressor::ZlibStreams {
+
+        z_stream strmDeflate;
+        z_stream strmInflate;
+
+        ZlibStreams() {
+            // init deflate state
+            strmDeflate.next_in = Z_NULL;
+            strmDeflate.zalloc  = Z_NULL;
+            strmDeflate.zfree   = Z_NULL;
+            strmDeflate.opaque  = Z_NULL;
+
+            int level = Z_DEFAULT_COMPRESSION; // =6, 1 gives top speed, 9 top compression
+            int windowBits = 15 + 16; // 15 is default and adding 16 makes it gzip and not zlib format
+            int memLevel = 9;         // Highest mem usage for best speed
+
+            int ret = deflateInit2(&strmDeflate, level, Z_DEFLATED, windowBits,
+                                   memLevel, Z_DEFAULT_STRATEGY);
+            if (ret != Z_OK)
+                throw EvioException("error initializing gzip deflate stream");
+
+            //-----------------------------------------------------------------
+
+            /* init inflate state */
+            strmInflate.next_in  = Z_NULL;
+            strmInflate.avail_in = 0;
+            strmInflate.zalloc   = Z_NULL;
+            strmInflate.zfree    = Z_NULL;
+            strmInflate.opaque   = Z_NULL;
+
+            ret = inflateInit2(&strmInflate, windowBits);
+            if (ret != Z_OK) {
+                deflateEnd(&strmDeflate);
+                throw EvioException("error initializing gzip inflate stream");
+            }
+        }
+
+        ~ZlibStreams() {
+            deflateEnd(&strmDeflate);
+            inflateEnd(&strmInflate);
+        }
+
+        ZlibStreams(const ZlibStreams &) = delete;
+        ZlibStreams & operator=(const ZlibStreams &) = delete;
+    };
+
+
+    /**
+     * Get the gzip streams of the calling thread, creating them if necessary.
+     * @return gzip streams of the calling thread.
+     * @throws EvioException if streams cannot be initialized.
+     */
+    Compressor::ZlibStreams & Compressor::getZlibStreams() {
+        thread_local ZlibStreams streams;
+        return streams;
+    }
+#endif
+#endif
+
+#ifdef USE_ZSTD
+    std::atomic<int> Compressor::zstdLevel {ZSTD_CLEVEL_DEFAULT};
 #endif
 
 
     /** Constructor. */
     Compressor::Compressor() {
         setUpCompressionHardware();
-        setUpZlib();
     }
 
 
@@ -78,6 +181,8 @@ namespace evio {
      */
     Compressor::CompressionType Compressor::toCompressionType(uint32_t type) {
         switch (type) {
+            case ZSTD:
+                return ZSTD;
             case GZIP:
                 return GZIP;
             case LZ4_BEST:
@@ -92,43 +197,31 @@ namespace evio {
 
 
     /**
-     * Method to setup use of z library for gzip compression.
+     * Is the given type of compression compiled into this library?
+     * Gzip needs USE_GZIP and zstd needs USE_ZSTD.
+     * @param type type of compression.
+     * @return true if records can be compressed and uncompressed with this type.
      */
-    void Compressor::setUpZlib() {
-
+    bool Compressor::isSupported(CompressionType type) {
+        switch (type) {
+            case GZIP:
 #ifdef USE_GZIP
-
-        // init deflate state
-        strmDeflate.next_in = Z_NULL;
-        strmDeflate.zalloc  = Z_NULL;
-        strmDeflate.zfree   = Z_NULL;
-        strmDeflate.opaque  = Z_NULL;
-
-        int level = Z_DEFAULT_COMPRESSION; // =6, 1 gives top speed, 9 top compression
-        int windowBits = 15 + 16; // 15 is default and adding 16 makes it gzip and not zlib format
-        int memLevel = 9;         // Highest mem usage for best speed
-
-        int ret = deflateInit2(&strmDeflate, level, Z_DEFLATED, windowBits,
-                               memLevel, Z_DEFAULT_STRATEGY);
-        if (ret != Z_OK)
-            throw EvioException("error initializing gzip deflate stream");
-
-        //-----------------------------------------------------------------
-
-        /* init deflate state */
-        strmInflate.next_in  = Z_NULL;
-        strmInflate.avail_in = Z_NULL;
-        strmInflate.zalloc   = Z_NULL;
-        strmInflate.zfree    = Z_NULL;
-        strmInflate.opaque   = Z_NULL;
-
-        ret = inflateInit2(&strmInflate, windowBits);
-        if (ret != Z_OK)
-            throw EvioException("error initializing gzip inflate stream");
+                return true;
+#else
+                return false;
 #endif
-
+            case ZSTD:
+#ifdef USE_ZSTD
+                return true;
+#else
+                return false;
+#endif
+            default:
+                return true;
+        }
     }
 
+
     /**
      * Check for existence of AHA3641/2 board for gzip hardware compression.
      * This will most likely not be used so comment it out.
@@ -223,7 +316,7 @@ namespace evio {
      * of uncompressed data. Depends on compression type. Unknown for gzip.
      *
      * @param compressionType type of data compression to do
-     *                        (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip).
+     *                        (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip, 4=zstd).
      *                        Default to none.
      * @param uncompressedLength uncompressed data length in bytes.
      * @return maximum compressed length in bytes or -1 if unknown.
@@ -231,14 +324,22 @@ namespace evio {
     int Compressor::getMaxCompressedLength(CompressionType compressionType, uint32_t uncompressedLength) {
         switch(compressionType) {
             case GZIP:
-#ifdef USE_GZIP
-                return deflateBound(&strmDeflate, uncompressedLength);
+#if defined(USE_GZIP) && defined(USE_LIBDEFLATE)
+                return libdeflate_gzip_compress_bound(getDeflateState().compressor, uncompressedLength);
+#elif defined(USE_GZIP)
+                return deflateBound(&getZlibStreams().strmDeflate, uncompressedLength);
 #else
                 return -1;
 #endif
             case LZ4_BEST:
             case LZ4:
                 return LZ4_compressBound(uncompressedLength);
+            case ZSTD:
+#ifdef USE_ZSTD
+                return ZSTD_compressBound(uncompressedLength);
+#else
+                return -1;
+#endif
             case UNCOMPRESSED:
             default:
                 return uncompressedLength;
@@ -270,7 +371,7 @@ uint8_t* Compressor::compressGZIP(uint8_t* ungzipped, uint32_t offset,
         throw EvioException("ungzipped and/or compLen arg is null");
     }
 
-    uint32_t dstLen = deflateBound(&strmDeflate, length);
+    uint32_t dstLen = getMaxCompressedLength(GZIP, length);
     auto *dst = new uint8_t[dstLen];
 
     // This should not generate an error
@@ -333,7 +434,8 @@ uint8_t* Compressor::uncompressGZIP(uint8_t* gzipped, uint32_t off,
  *
  * @param dest buffer for holding compressed data.
  * @param destLen upon entry, *destLen is the total size of the destination buffer,
- *                which must be at least 0.1% larger than sourceLen plus 12 bytes.
+ *                which, to be safe, must be at least
+ *                {@link #getMaxCompressedLength}(GZIP, sourceLen).
  *                Upon exit, *destLen is the actual size of the compressed buffer.
  * @param source buffer holding uncompressed data.
  * @param sourceLen byte length of the source buffer.
@@ -341,8 +443,7 @@ uint8_t* Compressor::uncompressGZIP(uint8_t* gzipped, uint32_t off,
  *          Z_MEM_ERROR if there was not enough memory,
  *          Z_BUF_ERROR if there was not enough room in the output buffer,
  *          Z_STREAM_ERROR if the level parameter is invalid.
- * @throws EvioException if the value at destLen is too small, destLen is null,
- *                       dest is null, or source in null.
+ * @throws EvioException if destLen is null, dest is null, or source in null.
  */
 int Compressor::compressGZIP(uint8_t* dest, uint32_t *destLen,
                              const uint8_t* source, uint32_t sourceLen) {
@@ -355,9 +456,17 @@ int Compressor::compressGZIP(uint8_t* dest, uint32_t *destLen,
         throw EvioException("null pointer for one or both buffer args");
     }
 
-    if ((deflateBound(&strmDeflate, sourceLen)) < *destLen) {
-        throw EvioException("destination buffer is too small");
+#ifdef USE_LIBDEFLATE
+    // Whole buffer at once
+    size_t size = libdeflate_gzip_compress(getDeflateState().compressor, source, sourceLen,
+                                           dest, *destLen);
+    if (size == 0) {
+        return Z_BUF_ERROR;
     }
+    *destLen = size;
+    return Z_OK;
+#else
+    z_stream & strmDeflate = getZlibStreams().strmDeflate;
 
     strmDeflate.next_out  = dest;
     strmDeflate.avail_out = *destLen;
@@ -371,6 +480,7 @@ int Compressor::compressGZIP(uint8_t* dest, uint32_t *destLen,
     deflateReset(&strmDeflate);
 
     return err == Z_STREAM_END ? Z_OK : err;
+#endif
 }
 
 
@@ -418,9 +528,24 @@ int Compressor::uncompressGZIP(uint8_t* dest, uint32_t *destLen,
         throw EvioException("destination buffer is too small");
     }
 
+#ifdef USE_LIBDEFLATE
+    // Whole buffer at once
+    size_t inBytes = 0, outBytes = 0;
+    libdeflate_result result = libdeflate_gzip_decompress_ex(getDeflateState().decompressor,
+                                                             source, *sourceLen, dest, *destLen,
+                                                             &inBytes, &outBytes);
+    if (result != LIBDEFLATE_SUCCESS) {
+        return result == LIBDEFLATE_INSUFFICIENT_SPACE ? Z_BUF_ERROR : Z_DATA_ERROR;
+    }
+    *sourceLen = inBytes;
+    *destLen   = outBytes;
+    return Z_OK;
+#else
     uint32_t len  = *sourceLen;
     uint32_t left = *destLen;
 
+    z_stream & strmInflate = getZlibStreams().strmInflate;
+
     strmInflate.next_in   = (z_const Bytef *)source;
     strmInflate.avail_in  = len;
 
@@ -439,6 +564,7 @@ int Compressor::uncompressGZIP(uint8_t* dest, uint32_t *destLen,
     return err == Z_STREAM_END ? Z_OK :
            err == Z_NEED_DICT ? Z_DATA_ERROR  :
            err == Z_BUF_ERROR && left + avail_out ? Z_DATA_ERROR : err;
+#endif
 }
 
 /**
@@ -476,6 +602,302 @@ uint8_t* Compressor::uncompressGZIP(ByteBuffer & gzipped, uint32_t * uncompLen)
 
     return ungzipped;
 }
+
+
+/**
+ * GZIP compression directly into the given array.
+ * Returns length of compressed data in bytes.
+ *
+ * @param src      source of uncompressed data.
+ * @param srcOff   start offset in src.
+ * @param srcSize  number of bytes to compress.
+ * @param dst      destination array.
+ * @param dstOff   start offset in dst.
+ * @param maxSize  maximum number of bytes to write in dst.
+ * @return length of compressed data in bytes.
+ * @throws EvioException if maxSize too small or compression failed.
+ */
+int Compressor::compressGZIP(uint8_t *src, int srcOff, int srcSize,
+                             uint8_t *dst, int dstOff, int maxSize) {
+
+    uint32_t dstLen = maxSize;
+
+    int err = compressGZIP(dst + dstOff, &dstLen, src + srcOff, srcSize);
+    if (err != Z_OK) {
+        throw EvioException("maxSize too small or gzip compression failed");
+    }
+
+    return (int) dstLen;
+}
+
+
+/**
+ * GZIP decompression directly into the given array.
+ * Returns original length of decompressed data in bytes.
+ *
+ * @param src      source of compressed data.
+ * @param srcOff   start offset in src.
+ * @param srcSize  number of compressed bytes.
+ * @param dst      destination array.
+ * @param dstOff   start offset in dst.
+ * @param dstCapacity size of destination buffer in bytes, which must be already allocated.
+ * @return original (uncompressed) input size.
+ * @throws EvioException if uncompressed data bytes &gt; dstCapacity or
+ *                       source data is malformed.
+ */
+int Compressor::uncompressGZIP(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                               int dstOff, int dstCapacity) {
+
+    uint32_t srcLen = srcSize;
+    uint32_t dstLen = dstCapacity;
+
+    int err = uncompressGZIP(dst + dstOff, &dstLen, src + srcOff, &srcLen, 0);
+    if (err != Z_OK) {
+        throw EvioException("destination buffer too small or data malformed");
+    }
+
+    return (int) dstLen;
+}
+#endif
+
+
+    //---------------------------
+    // ZSTD Compression
+    //---------------------------
+
+
+#ifdef USE_ZSTD
+
+
+    /**
+     * Get the zstd compression context of the calling thread, creating it if necessary.
+     * @return zstd compression context of the calling thread.
+     * @throws EvioException if context cannot be created.
+     */
+    static ZSTD_CCtx * zstdCompressionContext() {
+        thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx *)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+        if (cctx == nullptr) {
+            throw EvioException("cannot create zstd compression context");
+        }
+        return cctx.get();
+    }
+
+
+    /**
+     * Get the zstd decompression context of the calling thread, creating it if necessary.
+     * @return zstd decompression context of the calling thread.
+     * @throws EvioException if context cannot be created.
+     */
+    static ZSTD_DCtx * zstdDecompressionContext() {
+        thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx *)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+        if (dctx == nullptr) {
+            throw EvioException("cannot create zstd decompression context");
+        }
+        return dctx.get();
+    }
+
+
+    /**
+     * Set the zstd compression level used when none is given to {@link #compressZSTD}.
+     * Lower levels are faster, higher levels compress more. Levels 1-3 have about the
+     * speed of LZ4 with a significantly better compression ratio. Negative levels are
+     * even faster. Applies to all subsequent zstd compression by all writers.
+     *
+     * @param level zstd compression level, from ZSTD_minCLevel() to ZSTD_maxCLevel().
+     *              0 sets zstd's default level (3).
+     * @throws EvioException if level is out of range.
+     */
+    void Compressor::setZstdLevel(int level) {
+        if (level == 0) {
+            level = ZSTD_CLEVEL_DEFAULT;
+        }
+        if (level < ZSTD_minCLevel() || level > ZSTD_maxCLevel()) {
+            throw EvioException("zstd level must be from " + std::to_string(ZSTD_minCLevel()) +
+                                " to " + std::to_string(ZSTD_maxCLevel()));
+        }
+        zstdLevel = level;
+    }
+
+
+    /**
+     * Get the zstd compression level used when none is given to {@link #compressZSTD}.
+     * @return zstd compression level.
+     */
+    int Compressor::getZstdLevel() {return zstdLevel;}
+
+
+    /**
+     * Zstandard compression. Returns length of compressed data in bytes.
+     * Each thread uses its own compression context, reused from call to call.
+     *
+     * @param src      source of uncompressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of bytes to compress.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param maxSize  maximum number of bytes to write in dst.
+     * @param level    compression level. If 0, use {@link #getZstdLevel()}.
+     * @return length of compressed data in bytes.
+     * @throws EvioException if maxSize too small or compression failed.
+     */
+    int Compressor::compressZSTD(uint8_t *src, int srcOff, int srcSize,
+                                 uint8_t *dst, int dstOff, int maxSize, int level) {
+
+        if (level == 0) {
+            level = zstdLevel;
+        }
+
+        size_t size = ZSTD_compressCCtx(zstdCompressionContext(), dst + dstOff, maxSize,
+                                        src + srcOff, srcSize, level);
+        if (ZSTD_isError(size)) {
+            throw EvioException(std::string("zstd compression failed, ") + ZSTD_getErrorName(size));
+        }
+
+        return (int) size;
+    }
+
+
+    /**
+     * Zstandard decompression. Returns original length of decompressed data in bytes.
+     * The data is placed in dst starting at its position.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination buffer.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if destination buffer is too small to hold uncompressed data or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressZSTD(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst) {
+
+        int dstOff = dst.position();
+
+        int size = uncompressZSTD(src.array(), srcOff, srcSize,
+                                  dst.array(), dstOff, dst.remaining());
+
+        // Prepare buffer for reading
+        dst.limit(dstOff + size).position(dstOff);
+        return size;
+    }
+
+
+    /**
+     * Zstandard decompression. Returns original length of decompressed data in bytes.
+     * Each thread uses its own decompression context, reused from call to call.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param dstCapacity size of destination buffer in bytes, which must be already allocated.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if uncompressed data bytes &gt; dstCapacity or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressZSTD(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                   int dstOff, int dstCapacity) {
+
+        size_t size = ZSTD_decompressDCtx(zstdDecompressionContext(), dst + dstOff, dstCapacity,
+                                          src + srcOff, srcSize);
+        if (ZSTD_isError(size)) {
+            throw EvioException("destination buffer too small or data malformed");
+        }
+
+        return (int) size;
+    }
+
+
+    /**
+     * Zstandard compression starting from a dictionary.
+     * Returns length of compressed data in bytes.
+     *
+     * @param src      source of uncompressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of bytes to compress.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param maxSize  maximum number of bytes to write in dst.
+     * @param level    compression level. If 0, use {@link #getZstdLevel()}.
+     * @param dict     compression dictionary.
+     * @return length of compressed data in bytes.
+     * @throws EvioException if maxSize too small or compression failed.
+     */
+    int Compressor::compressZSTD(uint8_t *src, int srcOff, int srcSize,
+                                 uint8_t *dst, int dstOff, int maxSize, int level,
+                                 CompressionDictionary const & dict) {
+
+        if (level == 0) {
+            level = zstdLevel;
+        }
+
+        size_t size = ZSTD_compress_usingCDict(zstdCompressionContext(), dst + dstOff, maxSize,
+                                               src + srcOff, srcSize, dict.getZstdCDict(level));
+        if (ZSTD_isError(size)) {
+            throw EvioException(std::string("zstd compression failed, ") + ZSTD_getErrorName(size));
+        }
+
+        return (int) size;
+    }
+
+
+    /**
+     * Zstandard decompression of data compressed with a dictionary.
+     * Returns original length of decompressed data in bytes.
+     * The data is placed in dst starting at its position.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination buffer.
+     * @param dict     dictionary used to compress the data.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if destination buffer is too small to hold uncompressed data or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressZSTD(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst,
+                                   CompressionDictionary const & dict) {
+
+        int dstOff = dst.position();
+
+        int size = uncompressZSTD(src.array(), srcOff, srcSize,
+                                  dst.array(), dstOff, dst.remaining(), dict);
+
+        // Prepare buffer for reading
+        dst.limit(dstOff + size).position(dstOff);
+        return size;
+    }
+
+
+    /**
+     * Zstandard decompression of data compressed with a dictionary.
+     * Returns original length of decompressed data in bytes.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param dstCapacity size of destination buffer in bytes, which must be already allocated.
+     * @param dict     dictionary used to compress the data.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if uncompressed data bytes &gt; dstCapacity or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressZSTD(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                   int dstOff, int dstCapacity, CompressionDictionary const & dict) {
+
+        size_t size = ZSTD_decompress_usingDDict(zstdDecompressionContext(), dst + dstOff, dstCapacity,
+                                                 src + srcOff, srcSize, dict.getZstdDDict());
+        if (ZSTD_isError(size)) {
+            throw EvioException("destination buffer too small, data malformed, or wrong dictionary");
+        }
+
+        return (int) size;
+    }
+
+
 #endif
 
 
@@ -774,4 +1196,147 @@ uint8_t* Compressor::uncompressGZIP(ByteBuffer & gzipped, uint32_t * uncompLen)
         return size;
     }
 
+
+    //---------------------------
+    // LZ4 with dictionary
+    //---------------------------
+
+
+    /**
+     * Fastest LZ4 compression starting from a dictionary.
+     * Returns length of compressed data in bytes.
+     *
+     * @param src      source of uncompressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of bytes to compress.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param maxSize  maximum number of bytes to write in dst.
+     * @param dict     compression dictionary.
+     * @return length of compressed data in bytes.
+     * @throws EvioException if maxSize &lt; max # of compressed bytes or compression failed.
+     */
+    int Compressor::compressLZ4(uint8_t *src, int srcOff, int srcSize,
+                                uint8_t *dst, int dstOff, int maxSize,
+                                CompressionDictionary const & dict) {
+        if (LZ4_compressBound(srcSize) > maxSize) {
+            throw EvioException("maxSize (" + std::to_string(maxSize) +
+                                ") is < max # of compressed bytes (" +
+                                std::to_string(LZ4_compressBound(srcSize)) + ")");
+        }
+
+        thread_local std::unique_ptr<LZ4_stream_t, int (*)(LZ4_stream_t *)> stream(LZ4_createStream(), LZ4_freeStream);
+        if (stream == nullptr) {
+            throw EvioException("cannot create lz4 stream");
+        }
+
+        // Loading the dictionary also resets the stream
+        LZ4_loadDict(stream.get(), (const char*)dict.getLZ4Data(), dict.getLZ4Size());
+        int size = LZ4_compress_fast_continue(stream.get(), (const char*)(src + srcOff), (char*)(dst + dstOff),
+                                              srcSize, maxSize, lz4Acceleration);
+        if (size < 1) {
+            throw EvioException("compression failed");
+        }
+
+        return size;
+    }
+
+
+    /**
+     * Highest LZ4 compression starting from a dictionary.
+     * Returns length of compressed data in bytes.
+     *
+     * @param src      source of uncompressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of bytes to compress.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param maxSize  maximum number of bytes to write in dst.
+     * @param dict     compression dictionary.
+     * @return length of compressed data in bytes.
+     * @throws EvioException if maxSize &lt; max # of compressed bytes or compression failed.
+     */
+    int Compressor::compressLZ4Best(uint8_t *src, int srcOff, int srcSize,
+                                    uint8_t *dst, int dstOff, int maxSize,
+                                    CompressionDictionary const & dict) {
+        if (LZ4_compressBound(srcSize) > maxSize) {
+            throw EvioException("maxSize (" + std::to_string(maxSize) +
+                                ") is < max # of compressed bytes (" +
+                                std::to_string(LZ4_compressBound(srcSize)) + ")");
+        }
+
+        thread_local std::unique_ptr<LZ4_streamHC_t, int (*)(LZ4_streamHC_t *)> stream(LZ4_createStreamHC(), LZ4_freeStreamHC);
+        if (stream == nullptr) {
+            throw EvioException("cannot create lz4 stream");
+        }
+
+        LZ4_resetStreamHC_fast(stream.get(), 1);
+        LZ4_loadDictHC(stream.get(), (const char*)dict.getLZ4Data(), dict.getLZ4Size());
+        int size = LZ4_compress_HC_continue(stream.get(), (const char*)(src + srcOff), (char*)(dst + dstOff),
+                                            srcSize, maxSize);
+        if (size < 1) {
+            throw EvioException("compression failed");
+        }
+
+        return size;
+    }
+
+
+    /**
+     * LZ4 decompression of data compressed with a dictionary.
+     * Returns original length of decompressed data in bytes.
+     * The data is placed in dst starting at its position.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination buffer.
+     * @param dict     dictionary used to compress the data.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if destination buffer is too small to hold uncompressed data or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressLZ4(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst,
+                                  CompressionDictionary const & dict) {
+
+        int dstOff = dst.position();
+
+        int size = uncompressLZ4(src.array(), srcOff, srcSize,
+                                 dst.array(), dstOff, dst.remaining(), dict);
+
+        // Prepare buffer for reading
+        dst.limit(dstOff + size).position(dstOff);
+        return size;
+    }
+
+
+    /**
+     * LZ4 decompression of data compressed with a dictionary.
+     * Returns original length of decompressed data in bytes.
+     *
+     * @param src      source of compressed data.
+     * @param srcOff   start offset in src.
+     * @param srcSize  number of compressed bytes.
+     * @param dst      destination array.
+     * @param dstOff   start offset in dst.
+     * @param dstCapacity size of destination buffer in bytes, which must be already allocated.
+     * @param dict     dictionary used to compress the data.
+     * @return original (uncompressed) input size.
+     * @throws EvioException if uncompressed data bytes &gt; dstCapacity or
+     *                       source data is malformed.
+     */
+    int Compressor::uncompressLZ4(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                  int dstOff, int dstCapacity, CompressionDictionary const & dict) {
+
+        int size = LZ4_decompress_safe_usingDict((const char*)(src + srcOff), (char*)(dst + dstOff),
+                                                 srcSize, dstCapacity,
+                                                 (const char*)dict.getLZ4Data(), dict.getLZ4Size());
+        if (size < 0) {
+            throw EvioException("destination buffer too small or data malformed");
+        }
+
+        return size;
+    }
+
+
 }
@@ -21,11 +21,20 @@
 
 #include "EvioException.h"
 #include "ByteBuffer.h"
+#include "CompressionDictionary.h"
 #include "lz4.h"
 #include "lz4hc.h"
 
 #ifdef USE_GZIP
     #include "zlib.h"
+    #ifdef USE_LIBDEFLATE
+        #include "libdeflate.h"
+    #endif
+#endif
+
+#ifdef USE_ZSTD
+    #include <atomic>
+    #include "zstd.h"
 #endif
 
 
@@ -34,7 +43,10 @@ namespace evio {
 
     /**
      * Singleton class used to provide data compression and decompression in a variety of formats.
-     * This class in NOT thread safe when using the gzip deflating and inflating routines.
+     * This class is thread safe. The gzip and zstd routines keep their (de)compression
+     * state per thread, so any number of threads may compress and decompress at once.
+     * If built with USE_LIBDEFLATE, gzip uses libdeflate, which (de)compresses whole
+     * buffers much faster than zlib, instead of zlib. Its output is the same gzip format.
      * @date 04/29/2019
      * @author timmer
      */
@@ -66,16 +78,25 @@ namespace evio {
             UNCOMPRESSED = 0,
             LZ4,
             LZ4_BEST,
-            GZIP
+            GZIP,
+            ZSTD
         };
 
         static CompressionType toCompressionType(uint32_t type);
+        static bool isSupported(CompressionType type);
 
     private:
 
 #ifdef USE_GZIP
-        static z_stream strmDeflate;
-        static z_stream strmInflate;
+    #ifdef USE_LIBDEFLATE
+        /** Libdeflate compressor and decompressor, one set per thread. */
+        struct DeflateState;
+        static DeflateState & getDeflateState();
+    #else
+        /** Gzip deflate and inflate streams, one set per thread. */
+        struct ZlibStreams;
+        static ZlibStreams & getZlibStreams();
+    #endif
 #endif
 
         /** Number of bytes to read in a single call while doing gzip decompression. */
@@ -84,13 +105,17 @@ namespace evio {
         /* Makes regular lz4 compression to be lz4Acceleration * 3% speed up. */
         static const int lz4Acceleration = 1;
 
+#ifdef USE_ZSTD
+        /** Zstandard compression level used when none is specified. */
+        static std::atomic<int> zstdLevel;
+#endif
+
 //        static uint32_t getYear(       ByteBuffer & buf);
 //        static uint32_t getRevisionId( ByteBuffer & buf, uint32_t board_id);
 //        static uint32_t getSubsystemId(ByteBuffer & buf, uint32_t board_id);
 //        static uint32_t getDeviceId(   ByteBuffer & buf, uint32_t board_id);
 
         static void setUpCompressionHardware();
-        static void setUpZlib();
 
     public:
 
@@ -114,6 +139,36 @@ namespace evio {
                                   uint32_t uncompLen);
 
         static uint8_t* uncompressGZIP(ByteBuffer & gzipped, uint32_t *uncompLen);
+
+        static int compressGZIP(uint8_t *src, int srcOff, int srcSize,
+                                uint8_t *dst, int dstOff, int maxSize);
+
+        static int uncompressGZIP(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                  int dstOff, int dstCapacity);
+#endif
+
+        //---------------
+        // ZSTD
+        //---------------
+#ifdef USE_ZSTD
+        static void setZstdLevel(int level);
+        static int  getZstdLevel();
+
+        static int compressZSTD(uint8_t *src, int srcOff, int srcSize,
+                                uint8_t *dst, int dstOff, int maxSize, int level = 0);
+
+        static int uncompressZSTD(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst);
+        static int uncompressZSTD(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                  int dstOff, int dstCapacity);
+
+        static int compressZSTD(uint8_t *src, int srcOff, int srcSize,
+                                uint8_t *dst, int dstOff, int maxSize, int level,
+                                CompressionDictionary const & dict);
+
+        static int uncompressZSTD(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst,
+                                  CompressionDictionary const & dict);
+        static int uncompressZSTD(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                  int dstOff, int dstCapacity, CompressionDictionary const & dict);
 #endif
 
         //---------------
@@ -136,6 +191,16 @@ namespace evio {
         static int uncompressLZ4(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
                                  int dstOff, int dstCapacity);
 
+        static int compressLZ4(uint8_t *src, int srcOff, int srcSize,
+                               uint8_t *dst, int dstOff, int maxSize,
+                               CompressionDictionary const & dict);
+        static int compressLZ4Best(uint8_t *src, int srcOff, int srcSize,
+                                   uint8_t *dst, int dstOff, int maxSize,
+                                   CompressionDictionary const & dict);
+        static int uncompressLZ4(ByteBuffer & src, int srcOff, int srcSize, ByteBuffer & dst,
+                                 CompressionDictionary const & dict);
+        static int uncompressLZ4(uint8_t *src, int srcOff, int srcSize, uint8_t *dst,
+                                 int dstOff, int dstCapacity, CompressionDictionary const & dict);
 
     };
 
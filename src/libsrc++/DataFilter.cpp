@@ -0,0 +1,466 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "DataFilter.h"
+#include "EvioException.h"
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+
+namespace evio {
+
+
+    /**
+     * Turn an integer into its filter type. Unknown values give NONE.
+     * @param type integer value of filter type.
+     * @return filter type.
+     */
+    DataFilter::FilterType DataFilter::toFilterType(uint32_t type) {
+        switch (type) {
+            case 1:  return SHUFFLE;
+            case 2:  return DELTA;
+            case 3:  return DELTA_SHUFFLE;
+            default: return NONE;
+        }
+    }
+
+
+    /** Throw if word size is not 4 or 8. */
+    static void checkWordSize(uint32_t wordSize) {
+        if (wordSize != 4 && wordSize != 8) {
+            throw EvioException("filter word size must be 4 or 8");
+        }
+    }
+
+
+    /**
+     * Apply a filter to data.
+     *
+     * @param type     type of filter.
+     * @param wordSize size of words in bytes, 4 or 8.
+     * @param swap     true if the words are not in the local byte order (matters for delta only).
+     * @param src      data to filter.
+     * @param dst      where filtered data is written. Must not overlap src.
+     * @param bytes    number of bytes of data.
+     * @param scratch  temporary storage, enlarged as needed.
+     * @throws EvioException if wordSize is not 4 or 8.
+     */
+    void DataFilter::encode(FilterType type, uint32_t wordSize, bool swap,
+                            const uint8_t *src, uint8_t *dst, size_t bytes,
+                            std::vector<uint8_t> & scratch) {
+        checkWordSize(wordSize);
+
+        switch (type) {
+            case SHUFFLE:
+                shuffle(src, dst, bytes, wordSize);
+                break;
+
+            case DELTA:
+                deltaEncode(src, dst, bytes, wordSize, swap);
+                break;
+
+            case DELTA_SHUFFLE:
+                if (scratch.size() < bytes) scratch.resize(bytes);
+                deltaEncode(src, scratch.data(), bytes, wordSize, swap);
+                shuffle(scratch.data(), dst, bytes, wordSize);
+                break;
+
+            case NONE:
+            default:
+                std::memcpy(dst, src, bytes);
+        }
+    }
+
+
+    /**
+     * Undo a filter, in place.
+     *
+     * @param type     type of filter.
+     * @param wordSize size of words in bytes, 4 or 8.
+     * @param swap     true if the words are not in the local byte order (matters for delta only).
+     * @param data     filtered data, replaced by the original data.
+     * @param bytes    number of bytes of data.
+     * @param scratch  temporary storage, enlarged as needed.
+     * @throws EvioException if wordSize is not 4 or 8.
+     */
+    void DataFilter::decode(FilterType type, uint32_t wordSize, bool swap,
+                            uint8_t *data, size_t bytes,
+                            std::vector<uint8_t> & scratch) {
+        checkWordSize(wordSize);
+
+        switch (type) {
+            case SHUFFLE:
+            case DELTA_SHUFFLE:
+                if (scratch.size() < bytes) scratch.resize(bytes);
+                std::memcpy(scratch.data(), data, bytes);
+                unshuffle(scratch.data(), data, bytes, wordSize);
+                if (type == SHUFFLE) break;
+                deltaDecode(data, bytes, wordSize, swap);
+                break;
+
+            case DELTA:
+                deltaDecode(data, bytes, wordSize, swap);
+                break;
+
+            case NONE:
+            default:
+                break;
+        }
+    }
+
+
+    /**
+     * Undo a filter, writing the original data somewhere else.
+     * Unlike in place decoding, no temporary storage or copy is needed to unshuffle.
+     *
+     * @param type     type of filter.
+     * @param wordSize size of words in bytes, 4 or 8.
+     * @param swap     true if the words are not in the local byte order (matters for delta only).
+     * @param src      filtered data.
+     * @param dst      where original data is written. Must not overlap src.
+     * @param bytes    number of bytes of data.
+     * @throws EvioException if wordSize is not 4 or 8.
+     */
+    void DataFilter::decode(FilterType type, uint32_t wordSize, bool swap,
+                            const uint8_t *src, uint8_t *dst, size_t bytes) {
+        checkWordSize(wordSize);
+
+        switch (type) {
+            case SHUFFLE:
+            case DELTA_SHUFFLE:
+                unshuffle(src, dst, bytes, wordSize);
+                if (type == SHUFFLE) break;
+                deltaDecode(dst, bytes, wordSize, swap);
+                break;
+
+            case DELTA:
+                std::memcpy(dst, src, bytes);
+                deltaDecode(dst, bytes, wordSize, swap);
+                break;
+
+            case NONE:
+            default:
+                std::memcpy(dst, src, bytes);
+        }
+    }
+
+
+    /**
+     * Byte shuffle. Byte j of word i goes to dst[j*words + i].
+     * Bytes past the last whole word are copied as is.
+     *
+     * @param src      data to shuffle.
+     * @param dst      where shuffled data is written. Must not overlap src.
+     * @param bytes    number of bytes of data.
+     * @param wordSize size of words in bytes, 4 or 8.
+     */
+    void DataFilter::shuffle(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize) {
+        size_t words = bytes / wordSize;
+        size_t i = 0;
+
+#ifdef __SSE2__
+        // 16 words at a time, transposing bytes with unpacks
+        if (wordSize == 4) {
+            for (; i + 16 <= words; i += 16) {
+                const __m128i *in = reinterpret_cast<const __m128i *>(src + 4*i);
+                __m128i a0 = _mm_loadu_si128(in),     a1 = _mm_loadu_si128(in + 1);
+                __m128i a2 = _mm_loadu_si128(in + 2), a3 = _mm_loadu_si128(in + 3);
+
+                __m128i t0 = _mm_unpacklo_epi8(a0, a1), t1 = _mm_unpackhi_epi8(a0, a1);
+                __m128i t2 = _mm_unpacklo_epi8(a2, a3), t3 = _mm_unpackhi_epi8(a2, a3);
+
+                __m128i u0 = _mm_unpacklo_epi8(t0, t1), u1 = _mm_unpackhi_epi8(t0, t1);
+                __m128i u2 = _mm_unpacklo_epi8(t2, t3), u3 = _mm_unpackhi_epi8(t2, t3);
+
+                __m128i v0 = _mm_unpacklo_epi8(u0, u1), v1 = _mm_unpackhi_epi8(u0, u1);
+                __m128i v2 = _mm_unpacklo_epi8(u2, u3), v3 = _mm_unpackhi_epi8(u2, u3);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),           _mm_unpacklo_epi64(v0, v2));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + words + i),   _mm_unpackhi_epi64(v0, v2));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2*words + i), _mm_unpacklo_epi64(v1, v3));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 3*words + i), _mm_unpackhi_epi64(v1, v3));
+            }
+        }
+        else {
+            for (; i + 16 <= words; i += 16) {
+                const __m128i *in = reinterpret_cast<const __m128i *>(src + 8*i);
+                __m128i a[8], t[8], u[8], v[8];
+                for (int k = 0; k < 8; k++) a[k] = _mm_loadu_si128(in + k);
+
+                for (int k = 0; k < 8; k += 2) {
+                    t[k]   = _mm_unpacklo_epi8(a[k], a[k+1]);
+                    t[k+1] = _mm_unpackhi_epi8(a[k], a[k+1]);
+                }
+                for (int k = 0; k < 8; k += 2) {
+                    u[k]   = _mm_unpacklo_epi8(t[k], t[k+1]);
+                    u[k+1] = _mm_unpackhi_epi8(t[k], t[k+1]);
+                }
+                for (int k = 0; k < 8; k += 4) {
+                    v[k]   = _mm_unpacklo_epi32(u[k],   u[k+2]);
+                    v[k+1] = _mm_unpackhi_epi32(u[k],   u[k+2]);
+                    v[k+2] = _mm_unpacklo_epi32(u[k+1], u[k+3]);
+                    v[k+3] = _mm_unpackhi_epi32(u[k+1], u[k+3]);
+                }
+                for (int k = 0; k < 4; k++) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2*k*words + i),
+                                     _mm_unpacklo_epi64(v[k], v[k+4]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + (2*k + 1)*words + i),
+                                     _mm_unpackhi_epi64(v[k], v[k+4]));
+                }
+            }
+        }
+#endif
+
+        for (; i < words; i++) {
+            for (uint32_t j = 0; j < wordSize; j++) {
+                dst[j*words + i] = src[i*wordSize + j];
+            }
+        }
+
+        std::memcpy(dst + words*wordSize, src + words*wordSize, bytes - words*wordSize);
+    }
+
+
+    /**
+     * Undo byte shuffle. Byte dst[j*words + i] goes back to byte j of word i.
+     * Bytes past the last whole word are copied as is.
+     *
+     * @param src      shuffled data.
+     * @param dst      where unshuffled data is written. Must not overlap src.
+     * @param bytes    number of bytes of data.
+     * @param wordSize size of words in bytes, 4 or 8.
+     */
+    void DataFilter::unshuffle(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize) {
+        size_t words = bytes / wordSize;
+        size_t i = 0;
+
+#ifdef __SSE2__
+        // 16 words at a time, interleaving bytes with unpacks
+        if (wordSize == 4) {
+            for (; i + 16 <= words; i += 16) {
+                __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + words + i));
+                __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2*words + i));
+                __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3*words + i));
+
+                __m128i x0 = _mm_unpacklo_epi8(p0, p1), x1 = _mm_unpackhi_epi8(p0, p1);
+                __m128i x2 = _mm_unpacklo_epi8(p2, p3), x3 = _mm_unpackhi_epi8(p2, p3);
+
+                __m128i *out = reinterpret_cast<__m128i *>(dst + 4*i);
+                _mm_storeu_si128(out,     _mm_unpacklo_epi16(x0, x2));
+                _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(x0, x2));
+                _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(x1, x3));
+                _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(x1, x3));
+            }
+        }
+        else {
+            for (; i + 16 <= words; i += 16) {
+                __m128i p[8], x[8], y[8];
+                for (int k = 0; k < 8; k++) {
+                    p[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + k*words + i));
+                }
+
+                // x[k] even: words 0-7, odd: words 8-15, of byte pairs (2k/2, 2k/2 + 1)
+                for (int k = 0; k < 8; k += 2) {
+                    x[k]   = _mm_unpacklo_epi8(p[k], p[k+1]);
+                    x[k+1] = _mm_unpackhi_epi8(p[k], p[k+1]);
+                }
+
+                // 4 byte pieces: y0,y1 = bytes 0-3 of words 0-7, y2,y3 = bytes 4-7 of words 0-7,
+                // y4 - y7 the same for words 8-15
+                y[0] = _mm_unpacklo_epi16(x[0], x[2]);  y[1] = _mm_unpackhi_epi16(x[0], x[2]);
+                y[2] = _mm_unpacklo_epi16(x[4], x[6]);  y[3] = _mm_unpackhi_epi16(x[4], x[6]);
+                y[4] = _mm_unpacklo_epi16(x[1], x[3]);  y[5] = _mm_unpackhi_epi16(x[1], x[3]);
+                y[6] = _mm_unpacklo_epi16(x[5], x[7]);  y[7] = _mm_unpackhi_epi16(x[5], x[7]);
+
+                __m128i *out = reinterpret_cast<__m128i *>(dst + 8*i);
+                for (int k = 0; k < 2; k++) {
+                    _mm_storeu_si128(out + 4*k,     _mm_unpacklo_epi32(y[4*k],     y[4*k + 2]));
+                    _mm_storeu_si128(out + 4*k + 1, _mm_unpackhi_epi32(y[4*k],     y[4*k + 2]));
+                    _mm_storeu_si128(out + 4*k + 2, _mm_unpacklo_epi32(y[4*k + 1], y[4*k + 3]));
+                    _mm_storeu_si128(out + 4*k + 3, _mm_unpackhi_epi32(y[4*k + 1], y[4*k + 3]));
+                }
+            }
+        }
+#endif
+
+        for (; i < words; i++) {
+            for (uint32_t j = 0; j < wordSize; j++) {
+                dst[i*wordSize + j] = src[j*words + i];
+            }
+        }
+
+        std::memcpy(dst + words*wordSize, src + words*wordSize, bytes - words*wordSize);
+    }
+
+
+    /** Delta encode words of type T. */
+    template <typename T>
+    static void deltaEncodeWords(const uint8_t *src, uint8_t *dst, size_t words, bool swap) {
+        T prev = 0;
+        for (size_t i = 0; i < words; i++) {
+            T val;
+            std::memcpy(&val, src + i*sizeof(T), sizeof(T));
+            if (swap) val = (sizeof(T) == 4) ? SWAP_32(val) : SWAP_64(val);
+            T diff = val - prev;
+            prev = val;
+            if (swap) diff = (sizeof(T) == 4) ? SWAP_32(diff) : SWAP_64(diff);
+            std::memcpy(dst + i*sizeof(T), &diff, sizeof(T));
+        }
+    }
+
+
+    /** Delta decode words of type T, in place. */
+    template <typename T>
+    static void deltaDecodeWords(uint8_t *data, size_t words, bool swap) {
+        T sum = 0;
+        for (size_t i = 0; i < words; i++) {
+            T val;
+            std::memcpy(&val, data + i*sizeof(T), sizeof(T));
+            if (swap) val = (sizeof(T) == 4) ? SWAP_32(val) : SWAP_64(val);
+            sum += val;
+            val = sum;
+            if (swap) val = (sizeof(T) == 4) ? SWAP_32(val) : SWAP_64(val);
+            std::memcpy(data + i*sizeof(T), &val, sizeof(T));
+        }
+    }
+
+
+    /**
+     * Delta encoding. Each word is replaced by its difference from the previous word.
+     * The first word is kept as is. Bytes past the last whole word are copied as is.
+     *
+     * @param src      data to encode.
+     * @param dst      where encoded data is written. Must not overlap src.
+     * @param bytes    number of bytes of data.
+     * @param wordSize size of words in bytes, 4 or 8.
+     * @param swap     true if the words are not in the local byte order.
+     */
+    void DataFilter::deltaEncode(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize, bool swap) {
+        size_t words = bytes / wordSize;
+
+        if (swap || words == 0) {
+            if (wordSize == 4) deltaEncodeWords<uint32_t>(src, dst, words, swap);
+            else               deltaEncodeWords<uint64_t>(src, dst, words, swap);
+        }
+        else {
+            // First word, then each word minus the one before it
+            std::memcpy(dst, src, wordSize);
+            size_t i = 1;
+#ifdef __SSE2__
+            if (wordSize == 4) {
+                for (; i + 4 <= words; i += 4) {
+                    __m128i cur  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4*i));
+                    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4*(i - 1)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4*i), _mm_sub_epi32(cur, prev));
+                }
+            }
+            else {
+                for (; i + 2 <= words; i += 2) {
+                    __m128i cur  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8*i));
+                    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8*(i - 1)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8*i), _mm_sub_epi64(cur, prev));
+                }
+            }
+#endif
+            for (; i < words; i++) {
+                if (wordSize == 4) {
+                    uint32_t cur, prev;
+                    std::memcpy(&cur,  src + 4*i, 4);
+                    std::memcpy(&prev, src + 4*(i - 1), 4);
+                    cur -= prev;
+                    std::memcpy(dst + 4*i, &cur, 4);
+                }
+                else {
+                    uint64_t cur, prev;
+                    std::memcpy(&cur,  src + 8*i, 8);
+                    std::memcpy(&prev, src + 8*(i - 1), 8);
+                    cur -= prev;
+                    std::memcpy(dst + 8*i, &cur, 8);
+                }
+            }
+        }
+
+        std::memcpy(dst + words*wordSize, src + words*wordSize, bytes - words*wordSize);
+    }
+
+
+    /**
+     * Undo delta encoding, in place. Each word is replaced by the sum of it and all
+     * words before it. Bytes past the last whole word are left as they are.
+     *
+     * @param data     encoded data, replaced by the original data.
+     * @param bytes    number of bytes of data.
+     * @param wordSize size of words in bytes, 4 or 8.
+     * @param swap     true if the words are not in the local byte order.
+     */
+    void DataFilter::deltaDecode(uint8_t *data, size_t bytes, uint32_t wordSize, bool swap) {
+        size_t words = bytes / wordSize;
+
+        if (swap) {
+            if (wordSize == 4) deltaDecodeWords<uint32_t>(data, words, swap);
+            else               deltaDecodeWords<uint64_t>(data, words, swap);
+            return;
+        }
+
+        size_t i = 0;
+#ifdef __SSE2__
+        // Prefix sum within each register, plus the running total
+        if (wordSize == 4) {
+            __m128i total = _mm_setzero_si128();
+            for (; i + 4 <= words; i += 4) {
+                __m128i *p = reinterpret_cast<__m128i *>(data + 4*i);
+                __m128i x = _mm_loadu_si128(p);
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, total);
+                _mm_storeu_si128(p, x);
+                total = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+        }
+        else {
+            __m128i total = _mm_setzero_si128();
+            for (; i + 2 <= words; i += 2) {
+                __m128i *p = reinterpret_cast<__m128i *>(data + 8*i);
+                __m128i x = _mm_loadu_si128(p);
+                x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi64(x, total);
+                _mm_storeu_si128(p, x);
+                total = _mm_unpackhi_epi64(x, x);
+            }
+        }
+#endif
+
+        if (wordSize == 4) {
+            uint32_t sum = 0;
+            if (i > 0) std::memcpy(&sum, data + 4*(i - 1), 4);
+            for (; i < words; i++) {
+                uint32_t val;
+                std::memcpy(&val, data + 4*i, 4);
+                sum += val;
+                std::memcpy(data + 4*i, &sum, 4);
+            }
+        }
+        else {
+            uint64_t sum = 0;
+            if (i > 0) std::memcpy(&sum, data + 8*(i - 1), 8);
+            for (; i < words; i++) {
+                uint64_t val;
+                std::memcpy(&val, data + 8*i, 8);
+                sum += val;
+                std::memcpy(data + 8*i, &sum, 8);
+            }
+        }
+    }
+
+}
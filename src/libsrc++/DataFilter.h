@@ -0,0 +1,87 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_DATAFILTER_H
+#define EVIO_6_0_DATAFILTER_H
+
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+
+#include "ByteOrder.h"
+
+
+namespace evio {
+
+
+    /**
+     * Class of reversible filters applied to a record's data just before it is compressed
+     * and undone just after it is uncompressed. Arrays of 32 and 64 bit integers, which
+     * make up much of evio data, compress poorly since the compressor sees little repetition
+     * in them, even when neighboring values differ by little.<p>
+     *
+     * <ul>
+     * <li>Byte shuffle (as in Blosc) groups the first byte of each word, then the second
+     *     byte of each word, etc. The high bytes of small or similar integers then form
+     *     long runs.</li>
+     * <li>Delta encoding replaces each word with its difference from the previous one,
+     *     which turns slowly changing values, such as time stamps, into small numbers.</li>
+     * </ul>
+     *
+     * Both work on 4 or 8 byte words, and may be combined (delta, then shuffle).
+     * Any bytes past the last whole word are left as they are.
+     * SSE2 is used where available.
+     *
+     * @date 10/16/2026
+     * @author timmer
+     */
+    class DataFilter {
+
+    public:
+
+        /** Filter types. Values are stored in record headers. */
+        enum FilterType {
+            /** No filter. */
+            NONE = 0,
+            /** Byte shuffle. */
+            SHUFFLE = 1,
+            /** Delta encoding. */
+            DELTA = 2,
+            /** Delta encoding, then byte shuffle. */
+            DELTA_SHUFFLE = 3
+        };
+
+        static FilterType toFilterType(uint32_t type);
+
+        static void encode(FilterType type, uint32_t wordSize, bool swap,
+                           const uint8_t *src, uint8_t *dst, size_t bytes,
+                           std::vector<uint8_t> & scratch);
+
+        static void decode(FilterType type, uint32_t wordSize, bool swap,
+                           uint8_t *data, size_t bytes,
+                           std::vector<uint8_t> & scratch);
+
+        static void decode(FilterType type, uint32_t wordSize, bool swap,
+                           const uint8_t *src, uint8_t *dst, size_t bytes);
+
+        static void shuffle(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize);
+        static void unshuffle(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize);
+
+        static void deltaEncode(const uint8_t *src, uint8_t *dst, size_t bytes, uint32_t wordSize, bool swap);
+        static void deltaDecode(uint8_t *data, size_t bytes, uint32_t wordSize, bool swap);
+    };
+
+}
+
+
+#endif //EVIO_6_0_DATAFILTER_H
@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "DirectFile.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+namespace evio {
+
+
+    /** Round a number of bytes down to a multiple of ALIGNMENT. */
+    static inline uint64_t alignDown(uint64_t bytes) {
+        return bytes & ~((uint64_t)DirectFile::ALIGNMENT - 1);
+    }
+
+    /** Round a number of bytes up to a multiple of ALIGNMENT. */
+    static inline uint64_t alignUp(uint64_t bytes) {
+        return alignDown(bytes + DirectFile::ALIGNMENT - 1);
+    }
+
+
+    /**
+     * Constructor.
+     * @param stagingBytes size in bytes of the buffer data is gathered in before being written.
+     *                     Rounded up to a multiple of {@link #ALIGNMENT}.
+     *                     Larger sizes mean fewer, bigger writes.
+     */
+    DirectFile::DirectFile(size_t stagingBytes) :
+            staging(nullptr, std::free),
+            stagingBytes(alignUp(std::max(stagingBytes, ALIGNMENT))) {
+
+        staging.reset(allocateAligned(this->stagingBytes));
+    }
+
+
+    /** Destructor. Closes the file if still open. */
+    DirectFile::~DirectFile() {
+        try {
+            close();
+        }
+        catch (EvioException & e) {}
+    }
+
+
+    /**
+     * Allocate memory aligned for direct I/O, to be freed with std::free.
+     * @param bytes number of bytes to allocate.
+     * @return allocated memory.
+     * @throws EvioException if out of memory.
+     */
+    uint8_t * DirectFile::allocateAligned(size_t bytes) {
+        void *mem = nullptr;
+        if (posix_memalign(&mem, ALIGNMENT, bytes) != 0) {
+            throw EvioException("cannot allocate " + std::to_string(bytes) + " aligned bytes");
+        }
+        return static_cast<uint8_t *>(mem);
+    }
+
+
+    /**
+     * Create, or truncate if it exists, the file and open it for writing,
+     * with direct I/O if the file system supports it.
+     * @param name name of file.
+     * @throws EvioException if already open; if file cannot be opened.
+     */
+    void DirectFile::open(const std::string & name) {
+        if (fd >= 0) {
+            throw EvioException("file " + fileName + " already open");
+        }
+
+        fileName = name;
+        stagingFilePos = 0;
+        stagedBytes = 0;
+        fileSize = 0;
+        direct = false;
+
+        // Read access is needed to update parts of blocks already written
+        int flags = O_RDWR | O_CREAT | O_TRUNC;
+
+#ifdef O_DIRECT
+        fd = ::open(name.c_str(), flags | O_DIRECT, 0666);
+        if (fd >= 0) {
+            direct = true;
+        }
+        else if (errno != EINVAL) {
+            throw EvioException("error opening file " + name + ": " + std::strerror(errno));
+        }
+#endif
+
+        // File system does not do direct I/O, so use the page cache
+        if (fd < 0) {
+            fd = ::open(name.c_str(), flags, 0666);
+            if (fd < 0) {
+                throw EvioException("error opening file " + name + ": " + std::strerror(errno));
+            }
+#ifdef F_NOCACHE
+            // Closest thing to O_DIRECT on MacOS
+            direct = (fcntl(fd, F_NOCACHE, 1) == 0);
+#endif
+        }
+    }
+
+
+    /**
+     * Write all the given bytes at the given file position.
+     * @param data  aligned memory to write.
+     * @param bytes number of bytes to write, multiple of ALIGNMENT.
+     * @param pos   position in file, multiple of ALIGNMENT.
+     * @throws EvioException if error writing.
+     */
+    void DirectFile::writeFully(const uint8_t *data, size_t bytes, uint64_t pos) {
+        while (bytes > 0) {
+            ssize_t n = ::pwrite(fd, data, bytes, pos);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw EvioException("error writing file " + fileName + ": " + std::strerror(errno));
+            }
+            data  += n;
+            bytes -= n;
+            pos   += n;
+        }
+    }
+
+
+    /**
+     * Read the given number of bytes from the given file position.
+     * @param data  aligned memory to read into.
+     * @param bytes number of bytes to read, multiple of ALIGNMENT.
+     * @param pos   position in file, multiple of ALIGNMENT.
+     * @throws EvioException if error reading or file too short.
+     */
+    void DirectFile::readFully(uint8_t *data, size_t bytes, uint64_t pos) {
+        while (bytes > 0) {
+            ssize_t n = ::pread(fd, data, bytes, pos);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw EvioException("error reading file " + fileName + ": " + std::strerror(errno));
+            }
+            if (n == 0) {
+                throw EvioException("file " + fileName + " shorter than data written");
+            }
+            data  += n;
+            bytes -= n;
+            pos   += n;
+        }
+    }
+
+
+    /**
+     * Write the whole blocks in the staging buffer to the file.
+     * The last partial block stays at the front of the staging buffer.
+     * @param all if true, also write the last partial block, padded with zeros.
+     *            It's written again once more data is added to it.
+     * @throws EvioException if error writing.
+     */
+    void DirectFile::writeStaged(bool all) {
+        size_t fullBytes = alignDown(stagedBytes);
+        size_t writeBytes = fullBytes;
+
+        if (all && stagedBytes > fullBytes) {
+            writeBytes = alignUp(stagedBytes);
+            std::memset(staging.get() + stagedBytes, 0, writeBytes - stagedBytes);
+        }
+
+        if (writeBytes == 0) return;
+        writeFully(staging.get(), writeBytes, stagingFilePos);
+
+        size_t tailBytes = stagedBytes - fullBytes;
+        if (fullBytes > 0 && tailBytes > 0) {
+            std::memmove(staging.get(), staging.get() + fullBytes, tailBytes);
+        }
+        stagingFilePos += fullBytes;
+        stagedBytes = tailBytes;
+    }
+
+
+    /**
+     * Append data to the file. Data is written once a staging buffer's worth is gathered.
+     * @param data  data to write, need not be aligned.
+     * @param bytes number of bytes to write.
+     * @throws EvioException if not open; if error writing.
+     */
+    void DirectFile::write(const void *data, size_t bytes) {
+        if (fd < 0) {
+            throw EvioException("file not open");
+        }
+
+        auto src = static_cast<const uint8_t *>(data);
+
+        while (bytes > 0) {
+            size_t chunk = std::min(bytes, stagingBytes - stagedBytes);
+            std::memcpy(staging.get() + stagedBytes, src, chunk);
+            stagedBytes += chunk;
+            fileSize    += chunk;
+            src         += chunk;
+            bytes       -= chunk;
+
+            if (stagedBytes == stagingBytes) {
+                writeStaged(false);
+            }
+        }
+    }
+
+
+    /**
+     * Overwrite data already appended to the file, such as a word of the file header.
+     * Data still in the staging buffer is changed there. Data already written
+     * is changed by reading, modifying and rewriting the blocks it's in.
+     * @param pos   position in file of first byte to overwrite.
+     * @param data  data to write, need not be aligned.
+     * @param bytes number of bytes to write.
+     * @throws EvioException if not open; if past the end of data written; if error writing.
+     */
+    void DirectFile::writeAt(uint64_t pos, const void *data, size_t bytes) {
+        if (fd < 0) {
+            throw EvioException("file not open");
+        }
+        if (pos + bytes > fileSize) {
+            throw EvioException("cannot overwrite past end of data in file " + fileName);
+        }
+
+        auto src = static_cast<const uint8_t *>(data);
+        uint64_t end = pos + bytes;
+
+        // Part still in staging buffer
+        if (end > stagingFilePos) {
+            uint64_t start = std::max(pos, stagingFilePos);
+            std::memcpy(staging.get() + (start - stagingFilePos), src + (start - pos), end - start);
+            end = start;
+        }
+
+        // Part already written to file
+        if (end > pos) {
+            uint64_t blockStart = alignDown(pos);
+            size_t blockBytes = alignUp(end) - blockStart;
+
+            std::unique_ptr<uint8_t, void(*)(void*)> blocks(allocateAligned(blockBytes), std::free);
+            readFully(blocks.get(), blockBytes, blockStart);
+            std::memcpy(blocks.get() + (pos - blockStart), src, end - pos);
+            writeFully(blocks.get(), blockBytes, blockStart);
+        }
+    }
+
+
+    /**
+     * Write all data appended so far and force it to the physical disk.
+     * The last partial block is written padded with zeros, so until the file
+     * is closed, it may appear to be longer than the data written.
+     * @throws EvioException if not open; if error writing.
+     */
+    void DirectFile::sync() {
+        if (fd < 0) {
+            throw EvioException("file not open");
+        }
+
+        writeStaged(true);
+        if (::fsync(fd) != 0) {
+            throw EvioException("error syncing file " + fileName + ": " + std::strerror(errno));
+        }
+    }
+
+
+    /**
+     * Write all data appended so far, cut off any padding of the last block, and close the file.
+     * Does nothing if not open.
+     * @throws EvioException if error writing.
+     */
+    void DirectFile::close() {
+        if (fd < 0) return;
+
+        std::string err;
+        try {
+            writeStaged(true);
+        }
+        catch (EvioException & e) {
+            err = e.what();
+        }
+
+        if (err.empty() && ::ftruncate(fd, fileSize) != 0) {
+            err = "error truncating file " + fileName + ": " + std::strerror(errno);
+        }
+
+        ::close(fd);
+        fd = -1;
+        stagingFilePos = 0;
+        stagedBytes = 0;
+
+        if (!err.empty()) {
+            throw EvioException(err);
+        }
+    }
+
+
+    /** @return true if the file is open. */
+    bool DirectFile::isOpen() const {return fd >= 0;}
+
+
+    /** @return true if the file is written with direct I/O, bypassing the page cache. */
+    bool DirectFile::isDirect() const {return direct;}
+
+
+    /** @return number of bytes appended to the file. */
+    uint64_t DirectFile::getSize() const {return fileSize;}
+
+}
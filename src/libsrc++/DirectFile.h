@@ -0,0 +1,116 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_DIRECTFILE_H
+#define EVIO_6_0_DIRECTFILE_H
+
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+
+#include "EvioException.h"
+
+
+namespace evio {
+
+
+    /**
+     * Class used by {@link EventWriter} and {@link WriterMT} to write a file with
+     * direct I/O (O_DIRECT), bypassing the kernel's page cache. At sustained high
+     * rates, writeback of cached pages causes latency stalls and evicts the
+     * page cache's other contents, which direct I/O avoids.<p>
+     *
+     * Direct I/O requires the memory, file position and size of each write to be
+     * multiples of the device block size. Since records have any length and follow
+     * one another in the file without gaps, data is appended to an aligned staging
+     * buffer and written out in whole blocks. When the file is synced or closed,
+     * the last partial block is written padded with zeros, and at close the file
+     * is truncated back to the length of the data. After a sync, the padding is seen
+     * by anyone reading the file until the next write overwrites it, which is why
+     * a {@link Reader} following the file takes a header of zeros as not yet written.
+     * Previously written bytes, such as words of the file header, may be overwritten
+     * with {@link #writeAt}.<p>
+     *
+     * If the file system does not support direct I/O (tmpfs for example),
+     * or not on Linux, the file is written through the page cache with the same
+     * calls. {@link #isDirect()} tells which.
+     * <b>This is for internal use only.</b>
+     *
+     * @date 10/16/2026
+     * @author timmer
+     */
+    class DirectFile {
+
+    public:
+
+        /** Alignment in bytes of memory, file positions and sizes of direct writes. */
+        static const size_t ALIGNMENT = 4096;
+
+        /** Default size in bytes of the staging buffer. */
+        static const size_t DEFAULT_STAGING_BYTES = 8*1024*1024;
+
+    private:
+
+        /** File descriptor, -1 if not open. */
+        int fd = -1;
+
+        /** Was the file opened with direct I/O? */
+        bool direct = false;
+
+        /** Name of file. */
+        std::string fileName;
+
+        /** Aligned buffer holding data not yet written. */
+        std::unique_ptr<uint8_t, void(*)(void*)> staging;
+
+        /** Size of staging buffer in bytes, multiple of ALIGNMENT. */
+        size_t stagingBytes;
+
+        /** Position in file of the first byte of the staging buffer, multiple of ALIGNMENT. */
+        uint64_t stagingFilePos = 0;
+
+        /** Bytes of data in the staging buffer. */
+        size_t stagedBytes = 0;
+
+        /** Bytes of data appended to the file so far. */
+        uint64_t fileSize = 0;
+
+
+        static uint8_t * allocateAligned(size_t bytes);
+
+        void writeFully(const uint8_t *data, size_t bytes, uint64_t pos);
+        void readFully(uint8_t *data, size_t bytes, uint64_t pos);
+        void writeStaged(bool all);
+
+    public:
+
+        explicit DirectFile(size_t stagingBytes = DEFAULT_STAGING_BYTES);
+        ~DirectFile();
+
+        DirectFile(const DirectFile &) = delete;
+        DirectFile & operator=(const DirectFile &) = delete;
+
+        void open(const std::string & name);
+        void write(const void *data, size_t bytes);
+        void writeAt(uint64_t pos, const void *data, size_t bytes);
+        void sync();
+        void close();
+
+        bool isOpen() const;
+        bool isDirect() const;
+        uint64_t getSize() const;
+    };
+
+}
+
+#endif //EVIO_6_0_DIRECTFILE_H
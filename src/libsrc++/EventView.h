@@ -0,0 +1,152 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_EVENTVIEW_H
+#define EVIO_6_0_EVENTVIEW_H
+
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+
+#include "ByteOrder.h"
+#include "EvioException.h"
+
+
+namespace evio {
+
+
+    /**
+     * Class giving borrowed, read-only access to an event in a record
+     * without copying it. It contains a pointer into the record's internal
+     * (decompressed) buffer, the event's length and byte order, and the
+     * generation of the record data it points into.
+     * A view is only valid until the {@link RecordInput} it came from reads
+     * another record. Comparing {@link #getGeneration()} with
+     * {@link RecordInput#getGeneration()} tells whether that has happened.<p>
+     *
+     * If the library and program are compiled with EVIO_CHECK_EVENT_VIEWS
+     * defined, each view also tracks its record's generation and
+     * {@link #data()} throws an exception if the view has become stale.
+     * This catches use of views after the next record load, but it makes
+     * views more expensive, so it's meant for debugging only.
+     * The class layout is the same either way, so the library and program
+     * may be compiled differently; the check is then simply not done.
+     *
+     * @date 10/15/2026
+     * @author timmer
+     */
+    class EventView {
+
+    private:
+
+        /** Pointer to start of event. */
+        const uint8_t *ptr = nullptr;
+
+        /** Length of event in bytes. */
+        uint32_t len = 0;
+
+        /** Byte order of event data. */
+        ByteOrder order {ByteOrder::ENDIAN_LOCAL};
+
+        /** Generation of record data when this view was created. */
+        uint64_t generation = 0;
+
+        /** Current generation of the record data this view points into.
+         *  Only set if compiled with EVIO_CHECK_EVENT_VIEWS. */
+        std::shared_ptr<const std::atomic<uint64_t>> source;
+
+    public:
+
+        /** Constructor of an empty view. */
+        EventView() = default;
+
+
+        /**
+         * Constructor.
+         * @param data       pointer to start of event.
+         * @param length     length of event in bytes.
+         * @param byteOrder  byte order of event data.
+         * @param generation current generation of record data.
+         * @param source     record's generation counter.
+         */
+        EventView(const uint8_t *data, uint32_t length, ByteOrder const & byteOrder,
+                  uint64_t generation,
+                  [[maybe_unused]] std::shared_ptr<const std::atomic<uint64_t>> const & source) :
+                ptr(data), len(length), order(byteOrder), generation(generation)
+#ifdef EVIO_CHECK_EVENT_VIEWS
+                , source(source)
+#endif
+                {}
+
+
+        /**
+         * Get a pointer to the start of the event.
+         * @return pointer to the start of the event, or null if empty view.
+         * @throws EvioException if compiled with EVIO_CHECK_EVENT_VIEWS and view is stale.
+         */
+        const uint8_t * data() const {
+#ifdef EVIO_CHECK_EVENT_VIEWS
+            if (isStale()) {
+                throw EvioException("stale event view, record has since been reloaded");
+            }
+#endif
+            return ptr;
+        }
+
+
+        /**
+         * Get the length of the event in bytes.
+         * @return length of the event in bytes.
+         */
+        uint32_t length() const {return len;}
+
+
+        /**
+         * Get the byte order of the event data.
+         * @return byte order of the event data.
+         */
+        ByteOrder const & getByteOrder() const {return order;}
+
+
+        /**
+         * Get the generation of the record data this view points into.
+         * @return generation of the record data this view points into.
+         */
+        uint64_t getGeneration() const {return generation;}
+
+
+        /**
+         * Is this view empty?
+         * @return true if this view points to no event.
+         */
+        bool empty() const {return ptr == nullptr;}
+
+
+        /**
+         * Has the record this view points into read other data since this view was created?
+         * This can only be determined if compiled with EVIO_CHECK_EVENT_VIEWS defined.
+         * Otherwise compare {@link #getGeneration()} with that of the record.
+         * @return true if compiled with EVIO_CHECK_EVENT_VIEWS and view is stale, else false.
+         */
+        bool isStale() const {
+#ifdef EVIO_CHECK_EVENT_VIEWS
+            return source != nullptr && source->load(std::memory_order_acquire) != generation;
+#else
+            return false;
+#endif
+        }
+    };
+
+}
+
+
+#endif //EVIO_6_0_EVENTVIEW_H
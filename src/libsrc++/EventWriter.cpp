@@ -149,13 +149,16 @@ namespace evio {
      * @param bufferSize    number of bytes to make each internal buffer which will
      *                      be storing events before writing them to a file.
      *                      9MB = default if bufferSize = 0.
+     * @param waitStrategy  how compression and writing threads wait for records: blocking uses
+     *                      the least CPU, busy-spin the least latency. Ignored with 1 compression thread.
      *
      * @throws EvioException if maxRecordSize or maxEventCount exceed limits;
      *                       if defined dictionary or first event while appending;
      *                       if splitting file while appending;
      *                       if file name arg is empty;
      *                       if file could not be opened, positioned, or written to;
-     *                       if file exists but user requested no over-writing or appending.
+     *                       if file exists but user requested no over-writing or appending;
+     *                       if compressionType is not compiled in.
      */
     EventWriter::EventWriter(std::string & baseName, const std::string & directory, const std::string & runType,
                              uint32_t runNumber, uint64_t split,
@@ -165,7 +168,8 @@ namespace evio {
                              std::shared_ptr<EvioBank> firstEvent, uint32_t streamId,
                              uint32_t splitNumber, uint32_t splitIncrement, uint32_t streamCount,
                              Compressor::CompressionType compressionType, uint32_t compressionThreads,
-                             uint32_t ringSize, size_t bufferSize) {
+                             uint32_t ringSize, size_t bufferSize,
+                             RecordSupply::WaitStrategy waitStrategy) {
 
         if (baseName.empty()) {
             throw EvioException("baseName arg is empty");
@@ -214,6 +218,9 @@ namespace evio {
             createCommonRecord(xmlDictionary, firstEvent, nullptr, nullptr);
         }
 
+        if (!Compressor::isSupported(compressionType)) {
+            throw EvioException("compression type " + std::to_string(compressionType) + " not compiled in");
+        }
         this->compressionType = compressionType;
 
         // How much compression will data experience? Percentage of original size.
@@ -227,6 +234,9 @@ namespace evio {
             case Compressor::GZIP:
                 compressionFactor = 42;
                 break;
+            case Compressor::ZSTD:
+                compressionFactor = 40;
+                break;
 
             case Compressor::UNCOMPRESSED:
             default:
@@ -368,7 +378,11 @@ namespace evio {
             supply = std::make_shared<RecordSupply>(ringSize, this->byteOrder,
                                                     compressionThreads,
                                                     maxEventCount, maxRecordSize,
-                                                    compressionType);
+                                                    compressionType, waitStrategy);
+
+            // Ring records are not reused until written, so uncompressed
+            // events can be written from where they were added
+            supply->setVectoredWrite(true);
 
             // Do a quick calculation as to how much data a ring full
             // of records can hold since we may have to write that to
@@ -486,6 +500,7 @@ namespace evio {
       *                        If &lt; 0 or &gt; 15, this arg is ignored.
       *
       * @throws EvioException if maxRecordSize or maxEventCount exceed limits;
+      *                       if compressionType is not compiled in.
       */
     EventWriter::EventWriter(std::shared_ptr<ByteBuffer> & buf,
                              uint32_t maxRecordSize, uint32_t maxEventCount,
@@ -499,6 +514,9 @@ namespace evio {
         this->recordNumber    = recordNumber;
 
         this->xmlDictionary   = xmlDictionary;
+        if (!Compressor::isSupported(compressionType)) {
+            throw EvioException("compression type " + std::to_string(compressionType) + " not compiled in");
+        }
         this->compressionType = compressionType;
 
         // How much compression will data experience? Percentage of original size.
@@ -512,6 +530,9 @@ namespace evio {
             case Compressor::GZIP:
                 compressionFactor = 42;
                 break;
+            case Compressor::ZSTD:
+                compressionFactor = 40;
+                break;
 
             case Compressor::UNCOMPRESSED:
             default:
@@ -594,12 +615,56 @@ namespace evio {
      * Necesssary because std::async cannot run member functions (i.e. asyncFileChannel->write)
      * directly.
      *
-     * @param pWriter pointer to this object.
+     * @param file    file to write to.
+     * @param dFile   direct I/O file to write to, or null to write to file.
      * @param data    pointer to data.
      * @param len     number of bytes to write.
+     * @param flush   if true, flush the data out of the stream's or direct I/O file's buffer.
+     */
+    void EventWriter::staticWriteFunction(std::shared_ptr<std::fstream> file,
+                                          std::shared_ptr<DirectFile> dFile,
+                                          const char* data, size_t len, bool flush) {
+        if (dFile != nullptr) {
+            dFile->write(data, len);
+            if (flush) dFile->sync();
+            return;
+        }
+        file->write(data, len);
+        if (flush) file->flush();
+    }
+
+
+    /**
+     * Static wrapper function used to asynchronously run threads to write
+     * the pieces of a record, one after the other, to file.
+     *
+     * @param file     file to write to.
+     * @param dFile    direct I/O file to write to, or null to write to file.
+     * @param segments memory to write, in order.
+     * @param flush    if true, flush the data out of the stream's or direct I/O file's buffer.
+     * @see RecordOutput#getWriteSegments()
      */
-    void EventWriter::staticWriteFunction(EventWriter *pWriter, const char* data, size_t len) {
-        pWriter->asyncFileChannel->write(data, len);
+    void EventWriter::staticWriteSegmentsFunction(std::shared_ptr<std::fstream> file,
+                                                  std::shared_ptr<DirectFile> dFile,
+                                                  std::vector<RecordOutput::Segment> segments,
+                                                  bool flush) {
+        for (auto const & seg : segments) {
+            if (dFile != nullptr) {
+                dFile->write(seg.data, seg.bytes);
+            }
+            else {
+                file->write(reinterpret_cast<const char *>(seg.data), seg.bytes);
+            }
+        }
+
+        if (flush) {
+            if (dFile != nullptr) {
+                dFile->sync();
+            }
+            else {
+                file->flush();
+            }
+        }
     }
 
 
@@ -781,6 +846,8 @@ namespace evio {
      * @param sId  value of the source Id.
      */
     void EventWriter::setSourceId(int sId) {
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         sourceId = sId;
         auto header = currentRecord->getHeader();
         header->setUserRegisterFirst(sId);
@@ -798,6 +865,8 @@ namespace evio {
      *             else = nothing set).
      */
     void EventWriter::setEventType(int type) {
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         auto header = currentRecord->getHeader();
         header->setBitInfoEventType(type);
     }
@@ -876,7 +945,10 @@ namespace evio {
      * Warning, this value may be changing.
      * @return the current record number.
      */
-    uint32_t EventWriter::getRecordNumber() const {return recordNumber;}
+    uint32_t EventWriter::getRecordNumber() const {
+        RecordFlushTimer::Guard guard(flushTimer.get());
+        return recordNumber;
+    }
 
 
     /**
@@ -909,6 +981,8 @@ namespace evio {
      * @param startingRecordNumber  the number with which to start record numbers.
      */
     void EventWriter::setStartingRecordNumber(uint32_t startingRecordNumber) {
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         // If events have been written already, forget about it
         if (eventsWrittenTotal > 0) return;
         recordNumber = startingRecordNumber;
@@ -955,6 +1029,8 @@ namespace evio {
      */
     void EventWriter::setFirstEvent(std::shared_ptr<EvioNode> node) {
 
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         if (closed) {return;}
 
         if (!toFile) {
@@ -1013,6 +1089,8 @@ namespace evio {
      */
     void EventWriter::setFirstEvent(std::shared_ptr<ByteBuffer> buf) {
 
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         if (closed) {return;}
 
         if ((buf->remaining() < 8) && (xmlDictionary.empty())) {
@@ -1070,6 +1148,8 @@ namespace evio {
      */
     void EventWriter::setFirstEvent(std::shared_ptr<EvioBank> bank) {
 
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         if (closed) {return;}
 
         if (!toFile) {
@@ -1085,1091 +1165,2043 @@ namespace evio {
 
 
     /**
-     * Create and fill the common record which contains the dictionary and first event.
-     * Use the firstBank as the first event if specified, else try using the
-     * firstNode if specified, else try the firstBuf.
+     * Set the dictionary with which to compress records. Records holding many small,
+     * similar events compress much better with one. It's only used for LZ4 and zstd
+     * compression and is ignored otherwise. The dictionary is stored in the common
+     * record, after any xml dictionary and first event, which is the user header of
+     * the file header of each split file. A {@link Reader} loads it automatically.<p>
      *
-     * @param xmlDict        xml dictionary
-     * @param firstBank      first event as EvioBank
-     * @param firstNode      first event as EvioNode
-     * @param firstBuf       first event as ByteBuffer
-     * @throws EvioException if dictionary is in improper format
+     * Must be called before any event is written.
+     * Do not call this while simultaneously calling
+     * close, flush, writeEvent, or getByteBuffer.
+     *
+     * @param dict dictionary with which to compress records.
+     * @throws EvioException if writing to buffer or appending to file;
+     *                       if events were already written;
+     *                       if a compression dictionary was already set or is being trained.
      */
-    void EventWriter::createCommonRecord(const std::string & xmlDict,
-                                         std::shared_ptr<EvioBank> firstBank,
-                                         std::shared_ptr<EvioNode> firstNode,
-                                         std::shared_ptr<ByteBuffer> firstBuf) {
+    void EventWriter::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
 
-        // Create record if necessary, else clear it
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {return;}
+
+        checkCompressionDictionaryAllowed();
+
+        // Only lz4 and zstd use a dictionary
+        if (dict == nullptr ||
+            compressionType == Compressor::UNCOMPRESSED ||
+            compressionType == Compressor::GZIP) {
+            return;
+        }
+
+        compressionDictionary = dict;
+        if (singleThreadedCompression) {
+            currentRecord->setCompressionDictionary(dict);
+        }
+        else {
+            supply->setCompressionDictionary(dict);
+        }
+
+        // Add to end of common record which becomes the file header's "user header".
+        // No compression please ...
         if (commonRecord == nullptr) {
-            // No compression please ...
             commonRecord = std::make_shared<RecordOutput>(byteOrder, 0, 0,
                                                           Compressor::CompressionType::UNCOMPRESSED);
         }
-        else {
-            commonRecord->reset();
+        if (!commonRecord->addEvent(dict->getData(), dict->getSize())) {
+            throw EvioException("compression dictionary too large");
         }
+        commonRecord->build();
+        commonRecordBytesToBuffer = 4*commonRecord->getHeader()->getLengthWords();
+    }
 
-        // Place dictionary & first event into a single record
-        if (!xmlDict.empty()) {
-//std::cout << "createCommonRecord: got dictionary, # chars = " << xmlDict.size() << std::endl;
-            // 56 is the minimum number of characters for a valid xml dictionary
-            if (xmlDict.length() < 56) {
-                throw EvioException("Dictionary improper format, too few characters");
-            }
 
-            // Turn dictionary data into ascii (not evio bank)
-            Util::stringToASCII(xmlDict, dictionaryByteArray);
+    /**
+     * Train a dictionary with which to compress records from the first events written,
+     * then compress all records with it, including those holding the training events.
+     * Those events are held back until the given number of them is reached, or until
+     * {@link #flush()} or {@link #close()} is called. They are then written in order,
+     * but without any force or ownRecord flag they were written with.
+     * See {@link #setCompressionDictionary} for more details.<p>
+     *
+     * Must be called before any event is written.
+     * Only useful for LZ4 and zstd compression and is ignored otherwise.
+     *
+     * @param eventCount number of events to train with. Hundreds or more work best.
+     *                   0 means do not train.
+     * @param dictBytes  max size of dictionary in bytes.
+     * @throws EvioException if writing to buffer or appending to file;
+     *                       if events were already written;
+     *                       if a compression dictionary was already set or is being trained.
+     */
+    void EventWriter::trainCompressionDictionary(uint32_t eventCount, uint32_t dictBytes) {
 
-            // Add to record which will be our file header's "user header"
-            commonRecord->addEvent(dictionaryByteArray);
-//std::cout << "createCommonRecord: turned dictionary into ascii & added to commonRecord, byte size = " <<
-//             dictionaryByteArray.size() << std::endl;
-        }
-        else {
-            dictionaryByteArray.clear();
+        if (closed) {return;}
+
+        checkCompressionDictionaryAllowed();
+
+        if (compressionType == Compressor::UNCOMPRESSED ||
+            compressionType == Compressor::GZIP) {
+            return;
         }
 
-        // Convert first event into bytes
-        haveFirstEvent = true;
-        if (firstBank != nullptr) {
-            firstEventByteArray.resize(firstBank->getTotalBytes());
-            firstBank->write(firstEventByteArray.data(), byteOrder);
+        trainingEventCount = eventCount;
+        trainingDictionaryBytes = dictBytes;
+    }
 
-            // Add to record which will be our file header's "user header"
-            commonRecord->addEvent(firstEventByteArray);
+
+    /**
+     * Get the dictionary records are compressed with.
+     * @return dictionary records are compressed with, null if none (yet).
+     */
+    std::shared_ptr<CompressionDictionary> EventWriter::getCompressionDictionary() const {
+        return compressionDictionary;
+    }
+
+
+    /**
+     * Choose the type of compression for each record, instead of always using the
+     * type given in the constructor, so that records are as small as possible while
+     * compression keeps up with the given rate. Data which does not compress well,
+     * such as random ADC noise, is left uncompressed. Since each record header holds
+     * its own compression type, any reader handles the resulting mix of types.
+     * See {@link AdaptiveCompression}.<p>
+     *
+     * Must be called before any event is written.
+     * Do not call this while simultaneously calling
+     * close, flush, writeEvent, or getByteBuffer.
+     *
+     * @param targetMBps rate in MB/s of uncompressed data which all compression threads
+     *                   together must keep up with. 0 to stop adaptive compression.
+     * @param types      compression types to choose from, besides no compression.
+     *                   If empty, LZ4, LZ4 best and, if available, zstd.
+     * @throws EvioException if events were already written; if targetMBps < 0.
+     */
+    void EventWriter::setAdaptiveCompression(double targetMBps,
+                                             std::vector<Compressor::CompressionType> types) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {return;}
+
+        if (recordsWritten > 0 || splitEventCount > 0 || currentRecord->getEventCount() > 0) {
+            throw EvioException("adaptive compression must be set before writing events");
         }
-        else if (firstNode != nullptr) {
-            ByteBuffer firstEventBuf(firstNode->getTotalBytes());
-            firstNode->getStructureBuffer(firstEventBuf, true);
-            commonRecord->addEvent(firstEventBuf);
+
+        if (targetMBps < 0.) {
+            throw EvioException("target rate must be >= 0");
         }
-        else if (firstBuf != nullptr) {
-            commonRecord->addEvent(firstBuf);
+
+        adaptiveCompression = nullptr;
+        if (targetMBps > 0.) {
+            // Each compression thread must keep up with its share
+            size_t threads = supply == nullptr ? 1 : recordCompressorThreads.size();
+            adaptiveCompression = std::make_shared<AdaptiveCompression>(targetMBps / threads, types);
+        }
+
+        // Writing to a buffer or single threaded
+        if (supply == nullptr) {
+            currentRecord->setAdaptiveCompression(adaptiveCompression);
         }
         else {
-            haveFirstEvent = false;
+            supply->setAdaptiveCompression(adaptiveCompression);
         }
+    }
 
-        commonRecord->build();
-        commonRecordBytesToBuffer = 4*commonRecord->getHeader()->getLengthWords();
-//std::cout << "createCommonRecord: padded commonRecord size is " << commonRecordBytesToBuffer << " bytes" << std::endl;
+
+    /**
+     * Get the object choosing the type of compression for each record,
+     * which also holds the ratio and rate achieved by each type.
+     * @return object choosing the type of compression for each record, null if none.
+     */
+    std::shared_ptr<AdaptiveCompression> EventWriter::getAdaptiveCompression() const {
+        return adaptiveCompression;
     }
 
 
     /**
-     * Create and write a general file header into the file.
-     * The general header's user header is the common record which
-     * contains any existing dictionary and first event.<p>
+     * Filter the data of each compressed record before compressing it, which helps
+     * compress arrays of 32 or 64 bit integers. Byte shuffle groups the bytes of equal
+     * significance of all words together; delta encoding stores the differences between
+     * successive words. The filter is recorded in each record header and undone when
+     * reading. Uncompressed records are not filtered. See {@link DataFilter}.
+     * Since older versions of evio cannot undo the filter, only use it if all readers
+     * of the data are this version or later.<p>
      *
-     * Call this method AFTER file split or, in constructor, after the file
-     * name is created in order to ensure a consistent value for file split number.
+     * Must be called before any event is written.
+     * Do not call this while simultaneously calling
+     * close, flush, writeEvent, or getByteBuffer.
+     *
+     * @param type     type of filter.
+     * @param wordSize size in bytes of the words filtered, 4 or 8.
+     * @throws EvioException if events were already written;
+     *                       if wordSize is not 4 or 8.
      */
-    void EventWriter::writeFileHeader() {
-        // For the file header, our "user header" will be the common record,
-        // which is a record containing the dictionary and first event.
+    void EventWriter::setDataFilter(DataFilter::FilterType type, uint32_t wordSize) {
 
-        fileHeader.reset();
-        // File split # in header. Go back to last one as currently is set for the next split.
-        fileHeader.setFileNumber(splitNumber - splitIncrement);
+        RecordFlushTimer::Guard guard(flushTimer.get());
 
-        // Check to see if we have dictionary and/or first event
-        int commonRecordBytes = 0;
-        int commonRecordCount = 0;
+        if (closed) {return;}
 
-        if (commonRecord != nullptr) {
-            commonRecordCount = commonRecord->getEventCount();
-            if (commonRecordCount > 0) {
-                commonRecordBytes = commonRecord->getHeader()->getLength();
-                bool haveDict = !dictionaryByteArray.empty();
-                fileHeader.setBitInfo(haveFirstEvent, haveDict, false);
-            }
-            // Sets file header length too
-            fileHeader.setUserHeaderLength(commonRecordBytes);
+        if (recordsWritten > 0 || splitEventCount > 0 || currentRecord->getEventCount() > 0) {
+            throw EvioException("data filter must be set before writing events");
         }
 
-        // Index array is unused
+        // Writing to a buffer or single threaded
+        if (supply == nullptr) {
+            currentRecord->setDataFilter(type, wordSize);
+        }
+        else {
+            supply->setDataFilter(type, wordSize);
+        }
+    }
 
-        // Total header size in bytes
-        int bytes = fileHeader.getLength();
-        ByteBuffer buf(bytes);
-        uint8_t* array = buf.array();
-        buf.order(byteOrder);
 
-        // Write file header into array
-        try {
-            fileHeader.writeHeader(buf, 0);
+    /**
+     * Pin the compression threads and the writing thread to the given CPUs, and place
+     * the memory of records on the NUMA nodes of the compression threads' CPUs
+     * (of the writing thread's CPUs if compCpus is empty). On machines with
+     * several sockets, this keeps the threads from migrating between sockets and
+     * working on memory attached to another one. Pick CPUs on the socket local to the
+     * disk or network card written to. All compression threads share the CPU set.
+     * Get CPUs with {@link ThreadPlacement#getNodeCpus(int)} or
+     * {@link ThreadPlacement#parseCpuList(std::string const &)}.<p>
+     *
+     * Must be called before any event is written, since records cannot be moved
+     * while compression threads are using them. Threads already running are pinned.
+     * When compressing in the calling thread (1 compression thread, or writing to a buffer)
+     * there are no threads to pin, but the record is still placed.
+     * Threads cannot be pinned to CPUs that do not exist.
+     * Only works on Linux, elsewhere this does nothing.
+     *
+     * @param compCpus  CPUs the compression threads may run on, empty for any.
+     * @param writeCpus CPUs the writing thread may run on, empty for any.
+     * @throws EvioException if events were already written.
+     */
+    void EventWriter::setThreadPlacement(std::vector<int> const & compCpus, std::vector<int> const & writeCpus) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {return;}
+
+        if (recordsWritten > 0 || splitEventCount > 0 || currentRecord->getEventCount() > 0) {
+            throw EvioException("thread placement must be set before writing events");
         }
-        catch (EvioException & e) {/* never happen */}
 
-        // Write user header into array if necessary
-        if (commonRecordBytes > 0) {
-            auto commonBuf = commonRecord->getBinaryBuffer();
-            uint8_t* commonArray = commonBuf->array();
-            if (commonArray != nullptr) {
-                std::memcpy((void *)(array + FileHeader::HEADER_SIZE_BYTES),
-                            (const void *)(commonArray + commonBuf->arrayOffset()), commonRecordBytes);
-            }
-            else {
-                commonBuf->getBytes(array + FileHeader::HEADER_SIZE_BYTES, commonRecordBytes);
-            }
+        compressorCpus = compCpus;
+        writerCpus = writeCpus;
+
+        for (auto & thd : recordCompressorThreads) {
+            thd.setCpus(compressorCpus);
+        }
+        for (auto & thd : recordWriterThread) {
+            thd.setCpus(writerCpus);
         }
 
-        // Write array into file
-        asyncFileChannel->write(reinterpret_cast<char *>(array), bytes);
+        // Records are filled and compressed by compression threads, then written
+        auto nodes = ThreadPlacement::getNumaNodes(compressorCpus.empty() ? writerCpus : compressorCpus);
 
-        eventsWrittenTotal = eventsWrittenToFile = commonRecordCount;
-        bytesWritten = bytes;
-        fileWritingPosition += bytes;
+        // Writing to a buffer or single threaded
+        if (supply == nullptr) {
+            currentRecord->setNumaNodes(nodes);
+        }
+        else {
+            supply->setNumaNodes(nodes);
+        }
     }
 
 
     /**
-     * This method flushes any remaining internally buffered data to file.
-     * Calling {@link #close()} automatically does this so it isn't necessary
-     * to call before closing. This method should only be used when writing
-     * events at such a low rate that it takes an inordinate amount of time
-     * for internally buffered data to be written to the file.<p>
+     * Write files with direct I/O (O_DIRECT), bypassing the kernel's page cache.
+     * At sustained rates of GB/s, writeback of the page cache causes stalls and evicts
+     * data other programs on the machine are working with. With direct I/O,
+     * records are gathered in an aligned buffer and written in whole blocks,
+     * and the file header is updated in place at close. See {@link DirectFile}.
+     * If the file system cannot do direct I/O, files are written normally.
+     * Best used with multiple compression threads so writing overlaps compression.<p>
      *
-     * Calling this may easily kill performance. May not call this when simultaneously
-     * calling writeEvent, close, setFirstEvent, or getByteBuffer.
+     * Forcing data to disk (flush or writeEvent with force) writes out the last partial
+     * block padded with zeros, so until the next write the file ends in up to 4kB of zeros.
+     * A {@link Reader} in follow mode skips these, but other programs reading the file
+     * while it's being written must expect them.<p>
+     *
+     * Must be called before any event is written.
+     *
+     * @param direct true to write with direct I/O.
+     * @throws EvioException if events were already written;
+     *                       if writing to a buffer or appending to a file.
      */
-    void EventWriter::flush() {
+    void EventWriter::setDirectIO(bool direct) {
 
-        if (closed) {
-            return;
-        }
+        RecordFlushTimer::Guard guard(flushTimer.get());
 
-        if (toFile) {
-            if (singleThreadedCompression) {
-                try {
-                    compressAndWriteToFile(true);
-                }
-                catch (EvioException & e) {
-                    std::cout << e.what() << std::endl;
-                }
-            }
-            else {
-                // Write any existing data.
-                currentRingItem->forceToDisk(true);
-                if (currentRecord->getEventCount() > 0) {
-                    // Send current record back to ring
-                    supply->publish(currentRingItem);
-                }
+        if (closed) {return;}
 
-                // Get another empty record from ring
-                std::cout << "EventWriter: flush, get ring item, seq = " << currentRingItem->getSequence() << std::endl;
-                currentRingItem = supply->get();
-                currentRecord = currentRingItem->getRecord();
-            }
+        if (recordsWritten > 0 || splitEventCount > 0 || currentRecord->getEventCount() > 0) {
+            throw EvioException("direct I/O must be set before writing events");
         }
-        else {
-            flushCurrentRecordToBuffer();
+
+        if (direct && (!toFile || append)) {
+            throw EvioException("direct I/O only used when writing a new file");
         }
+
+        directIO = direct;
     }
 
 
     /**
-     * This method flushes any remaining data to file and disables this object.
-     * This needs to be called before getting buffer through
-     * {@link #getByteBuffer()} so that the buffer is ready to read.
-     * May not call this when simultaneously calling
-     * writeEvent, flush, setFirstEvent, or getByteBuffer.
+     * Are files written with direct I/O?
+     * @return true if files are written with direct I/O.
+     * @see #setDirectIO(bool)
      */
-    void EventWriter::close() {
-        if (closed) {
-            return;
+    bool EventWriter::isDirectIO() const {return directIO;}
+
+
+    /**
+     * Set the longest time a partially filled record may wait before it's written.
+     * When events arrive slowly, a record can otherwise sit unwritten for a long time
+     * and be lost if the process dies. With a limit, a separate thread checks the
+     * record being filled about 8 times per period and, once it has held events
+     * for that long, sends it off to be written as if it were full.
+     * Events then reach the file (or the kernel when using the page cache)
+     * no later than about 1/8 of a period after the limit.<p>
+     *
+     * The thread writing events pays nothing for this beyond a few plain memory
+     * accesses per call; the checking thread keeps it out while shipping a record.
+     * Only used when writing to a file. Calling it again changes the limit.
+     * Do not call it while simultaneously writing events.
+     *
+     * @param millis max age of a record in milliseconds, 0 for no limit.
+     * @throws EvioException if writing to a buffer.
+     */
+    void EventWriter::setMaxRecordAge(uint32_t millis) {
+
+        if (closed) {return;}
+
+        if (millis > 0 && !toFile) {
+            throw EvioException("max record age only used when writing to a file");
         }
-        // If buffer ...
-        if (!toFile) {
-            flushCurrentRecordToBuffer();
-            // Write empty last header
-            try {
-                writeTrailerToBuffer(addTrailerIndex);
-            }
-            catch (std::exception & e) {
-                // We're here if buffer is too small
-                std::cout << e.what() << std::endl;
-            }
+
+        if (flushTimer != nullptr) {
+            flushTimer->stop();
+            flushTimer.reset();
         }
-        // If file ...
-        else {
-            // Write record to file
-            if (singleThreadedCompression) {
-               if (currentRecord->getEventCount() > 0) {
-                    try {compressAndWriteToFile(false);}
-                    catch (std::exception & e) {
-                        std::cout << e.what() << std::endl;
-                    }
-                }
-            }
-            else {
-                // If we're building a record, send it off
-                // to compressing thread since we're done.
-                // This should never happen as END event forces things through.
-                if (currentRecord->getEventCount() > 0) {
-                    // Put it back in supply for compressing and force to disk
-                    supply->publish(currentRingItem);
-                }
 
-                // Since the writer thread is the last to process each record,
-                // wait until it's done with the last item, then exit the thread.
-                recordWriterThread[0].waitForLastItem();
+        maxRecordAge = millis;
+        agedRecord = nullptr;
 
-                // Stop all compressing threads which by now are stuck on get
-                for (RecordCompressor &thd : recordCompressorThreads) {
-                    thd.stopThread();
-                }
-            }
+        if (millis > 0) {
+            flushTimer = std::make_unique<RecordFlushTimer>(std::max(millis/8, 1U),
+                                                            [this]() {this->shipOldRecord();});
+        }
+    }
 
-            // Finish writing record to current file
-            try {
-                if (future1 != nullptr && future1->valid()) {
-                    // Wait for last write to end before we continue
-                    future1->get();
-                }
-            }
-            catch (std::exception & e) {}
 
-            // Write trailer
-            if (addingTrailer) {
-                // Write the trailer
-                try {
-                    writeTrailerToFile(addTrailerIndex);
-                }
-                catch (std::exception & e) {
-                    std::cout << e.what() << std::endl;
-                }
-            }
+    /**
+     * Get the longest time a partially filled record may wait before it's written.
+     * @return max age of a record in milliseconds, 0 for no limit.
+     * @see #setMaxRecordAge(uint32_t)
+     */
+    uint32_t EventWriter::getMaxRecordAge() const {return maxRecordAge;}
 
-            try {
-                // Find & update file header's record count word
-                ByteBuffer bb(4);
-                bb.order(byteOrder);
-                bb.putInt(0, recordNumber - 1);
-                asyncFileChannel->seekg(FileHeader::RECORD_COUNT_OFFSET);
-                asyncFileChannel->write(reinterpret_cast<char*>(bb.array()), 4);
-            }
-            catch (std::exception & e) {
-                std::cout << e.what() << std::endl;
-            }
 
-            try {
-                if (asyncFileChannel->is_open()) asyncFileChannel->close();
+    /**
+     * Called periodically by the flush timer's thread, while the thread writing events
+     * is kept out, to send off the record being filled if it has held events for
+     * longer than maxRecordAge. A record's age is counted from the first time it's
+     * seen holding events, so it's written between maxRecordAge and one timer period
+     * later than that.
+     */
+    void EventWriter::shipOldRecord() {
 
-                // Shut down all file closing threads
-                if (fileCloser != nullptr) fileCloser->close();
-            }
-            catch (std::exception & e) {}
+        // A reserved event points into the current record, so leave it alone
+        if (closed || !toFile || eventReserved || trainingEventCount > 0 || currentRecord == nullptr) {
+            return;
+        }
 
-            // release resources
-            supply.reset();
-            currentRecord.reset();
-            recordWriterThread.clear();
-            recordCompressorThreads.clear();
-            ringItem1.reset();
-            currentRingItem.reset();
+        if (currentRecord->getEventCount() < 1) {
+            agedRecord = nullptr;
+            return;
         }
 
-        recordLengths->clear();
-        closed = true;
+        // Start the clock for a record not seen before
+        if (agedRecord != currentRecord.get() || agedRecordNumber != recordNumber) {
+            agedRecord = currentRecord.get();
+            agedRecordNumber = recordNumber;
+            agedRecordStart = std::chrono::steady_clock::now();
+            return;
+        }
+
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - agedRecordStart).count();
+        if (age < maxRecordAge) {
+            return;
+        }
+
+        agedRecord = nullptr;
+
+        try {
+            // Flush it out of the file's write buffer too, or it may sit there
+            if (singleThreadedCompression) {
+                compressAndWriteToFile(false, true);
+            }
+            else {
+                // Send current record back to ring
+                currentRingItem->flushAfterWrite(true);
+                supply->publish(currentRingItem);
+
+                // Get another empty record from ring
+                currentRingItem = supply->get();
+                currentRecord = currentRingItem->getRecord();
+                currentRecord->getHeader()->setRecordNumber(recordNumber++);
+            }
+        }
+        catch (std::exception & e) {
+            // No caller to throw to in this thread, so keep it for the next call
+            agedRecordError = e.what();
+        }
+        catch (...) {
+            // Anything escaping this thread would terminate the program
+            agedRecordError = "unknown error";
+        }
     }
 
 
     /**
-     * Reads part of the file header in order to determine
-     * the evio version # and endianness of the file in question.
-     *
-     * @throws EvioException not in append mode, contains too little data, is not in proper format,
-     *                       version earlier than 6, premature EOF or file reading error,
-     *                       and all other exceptions.
+     * Throw, once, any error from writing an old record in the flush timer's thread.
+     * @throws EvioException if writing an old record failed since the last call.
      */
-    void EventWriter::examineFileHeader() {
-
-        // Only for append mode - only used for files
-        if (!append) {
-            // Internal logic error, should never have gotten here
-            throw EvioException("need to be in append mode");
+    void EventWriter::throwAgedRecordError() {
+        if (!agedRecordError.empty()) {
+            std::string err = "error writing old record, " + agedRecordError;
+            agedRecordError.clear();
+            throw EvioException(err);
         }
+    }
 
-        int nBytes;
-
-        auto headerBytes = new char[FileHeader::HEADER_SIZE_BYTES];
-        ByteBuffer buf(headerBytes, FileHeader::HEADER_SIZE_BYTES);
 
-        asyncFileChannel->read(headerBytes, FileHeader::HEADER_SIZE_BYTES);
-        nBytes = asyncFileChannel->gcount();
-        if (asyncFileChannel->fail()) {
-            throw EvioException("error reading first record header from " + currentFileName);
+    /**
+     * Check that a compression dictionary may still be set or trained.
+     * @throws EvioException if writing to buffer or appending to file;
+     *                       if events were already written;
+     *                       if a compression dictionary was already set or is being trained.
+     */
+    void EventWriter::checkCompressionDictionaryAllowed() {
+        if (!toFile) {
+            throw EvioException("compression dictionary can only be stored in a file");
         }
 
-        // Check to see if we read the whole header
-        if (nBytes != FileHeader::HEADER_SIZE_BYTES) {
-            throw EvioException("bad file format");
+        if (append) {
+            throw EvioException("cannot add compression dictionary when appending");
         }
 
-        // Parse header info
-        appendFileHeader = FileHeader();
-        buf.position(0);
-        // Buffer's position/limit does not change
-        appendFileHeader.readHeader(buf);
-
-        // Set the byte order to match the buffer/file's ordering.
-        byteOrder = appendFileHeader.getByteOrder();
+        if (compressionDictionary != nullptr || trainingEventCount > 0) {
+            throw EvioException("compression dictionary already set");
+        }
 
-        hasAppendDictionary = appendFileHeader.hasDictionary();
-        hasTrailerWithIndex = appendFileHeader.hasTrailerWithIndex();
-        indexLength         = appendFileHeader.getIndexLength();
-        userHeaderLength    = appendFileHeader.getUserHeaderLength();
-        userHeaderPadding   = appendFileHeader.getUserHeaderLengthPadding();
-        //
-        //        int fileID      = appendFileHeader.getFileId();
-        //        int headerLen   = appendFileHeader.getHeaderLength();
-        //        int recordCount = appendFileHeader.getEntries();
-        //        int fileNum     = appendFileHeader.getFileNumber();
-        //
-        //        std::cout << "file ID          = " << fileID << std::endl;
-        //        std::cout << "fileNumber       = " << fileNum << std::endl;
-        //        std::cout << "headerLength     = " << headerLen << std::endl;
-        //        std::cout << "recordCount      = " << recordCount << std::endl;
-        //        std::cout << "trailer index    = " << hasTrailerWithIndex << std::endl;
-        //        std::cout << "bit info         = " << Integer.toHexString(bitInfo) << std::endl;
-        //        std::cout << std::endl;
+        if (recordsWritten > 0 || splitEventCount > 0 || currentRecord->getEventCount() > 0) {
+            throw EvioException("compression dictionary must be set before writing events");
+        }
     }
 
 
     /**
-     * This method positions a file for the first {@link #writeEvent(std::shared_ptr<EvioBank>)}
-     * in append mode. It places the writing position after the last event (not record header).
+     * Hold back an event, written while training a compression dictionary, as a training sample.
+     * Once enough are held, train the dictionary and write them all.
      *
-     * @throws EvioException     if file reading/writing problems,
-     *                           if bad file/buffer format; if not in append mode
+     * @param bank       the bank (as an EvioBank object) to hold.
+     * @param bankBuffer the bank (as a ByteBuffer object) to hold. Takes precedence over bank.
+     * @return true if event was held or written.
+     * @throws EvioException if error writing the held events.
      */
-    void EventWriter::toAppendPosition() {
-
-        // Only for append mode
-        if (!append) {
-            throw EvioException("need to be in append mode");
-        }
-
-        // Jump over the file header, index array, and user header & padding
-        uint64_t pos = FileHeader::HEADER_SIZE_BYTES + indexLength +
-                       userHeaderLength + userHeaderPadding;
-        // This puts us at the beginning of the first record header
-        fileWritingPosition = pos;
+    bool EventWriter::addTrainingEvent(std::shared_ptr<EvioBank> & bank, std::shared_ptr<ByteBuffer> & bankBuffer) {
+        std::vector<uint8_t> event;
 
-#ifdef USE_FILESYSTEMLIB
-        uint64_t fileSize = fs::file_size(currentFileName);
-#else
-        uint64_t fileSize;
-        struct stat stt{};
-        if (stat(currentFileName.c_str(), &stt) == 0) {
-            fileSize = stt.st_size;
+        if (bankBuffer != nullptr) {
+            const uint8_t *data = bankBuffer->array() + bankBuffer->arrayOffset() + bankBuffer->position();
+            event.assign(data, data + bankBuffer->remaining());
         }
         else {
-            throw EvioException("error getting file size of " + currentFileName);
+            event.resize(bank->getTotalBytes());
+            bank->write(event.data(), byteOrder);
         }
-#endif
-//std::cout << "toAppendPos:  fileSize = " << fileSize << ", jump to pos = " << fileWritingPosition << std::endl;
 
-        bool lastRecord, isTrailer, readEOF = false;
-        uint32_t recordLen, eventCount, nBytes, bitInfo, headerPosition;
+        trainingEvents.push_back(std::move(event));
 
-        uint64_t bytesLeftInFile = fileSize;
+        if (trainingEvents.size() >= trainingEventCount) {
+            finishTraining();
+        }
+        return true;
+    }
 
-        //        uint32_t indexArrayLen, userHeaderLen, compDataLen, unCompDataLen;
-        //        uint32_t userPadding, dataPadding, compPadding;
-        //        uint32_t headerLen, currentPosition, compType, compWord;
 
-        // The file's record #s may be fine or they may be messed up.
-        // Assume they start with one and increment from there. That
-        // way any additional records now added to the file will have a
-        // reasonable # instead of incrementing from the last existing
-        // record.
-        recordNumber = 1;
-//std::cout << "toAppendPos:     record # = 1" << std::endl;
+    /**
+     * If training a compression dictionary, train it with the events held back,
+     * start compressing with it, and write those events. If training fails
+     * (no data), records are compressed without dictionary.
+     * @throws EvioException if error writing the held events.
+     */
+    void EventWriter::finishTraining() {
+        if (trainingEventCount == 0) {
+            return;
+        }
 
-        // To read in all of the normal record header set this to 40 bytes.
-        // To read the bare minimum to do the append set this to 24 bytes,
-        // but be sure to comment out lines reading beyond this point in the header.
-        uint32_t headerBytesToRead = 40;
+        trainingEventCount = 0;
+        std::vector<std::vector<uint8_t>> events = std::move(trainingEvents);
+        trainingEvents.clear();
 
-        while (true) {
-            nBytes = 0;
+        auto dict = CompressionDictionary::train(events, trainingDictionaryBytes);
+        if (dict != nullptr) {
+            setCompressionDictionary(dict);
+        }
 
-            buffer->clear();
-            buffer->limit(headerBytesToRead);
+        // Write held events in their original order
+        size_t maxBytes = 0;
+        for (auto const & event : events) {
+            maxBytes = std::max(maxBytes, event.size());
+        }
 
-            while (nBytes < headerBytesToRead) {
- //std::cout << "Read Header bytes" << std::endl;
+        auto buf = std::make_shared<ByteBuffer>(maxBytes);
+        buf->order(byteOrder);
+        for (auto const & event : events) {
+            buf->clear();
+            buf->put(event.data(), event.size());
+            buf->flip();
+            writeEvent(nullptr, buf, false, false);
+        }
+    }
 
-                // There is no internal asyncFileChannel position
-                asyncFileChannel->seekg(fileWritingPosition);
-                asyncFileChannel->read(reinterpret_cast<char *>(buffer->array()) + nBytes, headerBytesToRead-nBytes);
-                int partial = asyncFileChannel->gcount();
-                if (asyncFileChannel->fail()) {
-                    throw EvioException("error reading record header from " + currentFileName);
-                }
 
-                // TODO: handling EOF seems wrong.............
-                // TODO: If eof hit with nBytes = 0, then header should NOT be parsed ....
+    /**
+     * Create and fill the common record which contains the dictionary and first event.
+     * Use the firstBank as the first event if specified, else try using the
+     * firstNode if specified, else try the firstBuf.
+     *
+     * @param xmlDict        xml dictionary
+     * @param firstBank      first event as EvioBank
+     * @param firstNode      first event as EvioNode
+     * @param firstBuf       first event as ByteBuffer
+     * @throws EvioException if dictionary is in improper format
+     */
+    void EventWriter::createCommonRecord(const std::string & xmlDict,
+                                         std::shared_ptr<EvioBank> firstBank,
+                                         std::shared_ptr<EvioNode> firstNode,
+                                         std::shared_ptr<ByteBuffer> firstBuf) {
 
-                // If EOF ...
-                if (asyncFileChannel->eof()) {
-                    if (nBytes != 0) {
-                        throw EvioException("bad buffer format");
-                    }
-                    // Missing last empty record header
-                    readEOF = true;
-                    break;
-                }
-                nBytes += partial;
-                bytesLeftInFile -= partial;
-            }
+        // Create record if necessary, else clear it
+        if (commonRecord == nullptr) {
+            // No compression please ...
+            commonRecord = std::make_shared<RecordOutput>(byteOrder, 0, 0,
+                                                          Compressor::CompressionType::UNCOMPRESSED);
+        }
+        else {
+            commonRecord->reset();
+        }
 
-            // If we did not read correct # of bytes or didn't run into EOF right away
-            if (nBytes != 0 && nBytes != headerBytesToRead) {
-                throw EvioException("internal file reading error");
+        // Place dictionary & first event into a single record
+        if (!xmlDict.empty()) {
+//std::cout << "createCommonRecord: got dictionary, # chars = " << xmlDict.size() << std::endl;
+            // 56 is the minimum number of characters for a valid xml dictionary
+            if (xmlDict.length() < 56) {
+                throw EvioException("Dictionary improper format, too few characters");
             }
 
-            headerPosition = 0;
-            fileWritingPosition += headerBytesToRead;
+            // Turn dictionary data into ascii (not evio bank)
+            Util::stringToASCII(xmlDict, dictionaryByteArray);
 
-            bitInfo    = buffer->getInt(headerPosition + RecordHeader::BIT_INFO_OFFSET);
-            recordLen  = buffer->getInt(headerPosition + RecordHeader::RECORD_LENGTH_OFFSET);
-            eventCount = buffer->getInt(headerPosition + RecordHeader::EVENT_COUNT_OFFSET);
-            lastRecord = RecordHeader::isLastRecord(bitInfo);
-            isTrailer  = RecordHeader::isEvioTrailer(bitInfo);
+            // Add to record which will be our file header's "user header"
+            commonRecord->addEvent(dictionaryByteArray);
+//std::cout << "createCommonRecord: turned dictionary into ascii & added to commonRecord, byte size = " <<
+//             dictionaryByteArray.size() << std::endl;
+        }
+        else {
+            dictionaryByteArray.clear();
+        }
 
-            ////          If reading entire header, change headerBytesToRead from 24 to 40
-            //            int headerLen     = buffer->getInt(headerPosition + RecordHeader::HEADER_LENGTH_OFFSET);
-            //            int userHeaderLen = buffer->getInt(headerPosition + RecordHeader::USER_LENGTH_OFFSET);
-            //            int indexArrayLen = buffer->getInt(headerPosition + RecordHeader::INDEX_ARRAY_OFFSET);
-            //            int unCompDataLen = buffer->getInt(headerPosition + RecordHeader::UNCOMPRESSED_LENGTH_OFFSET);
-            //
-            //            int compWord      = buffer->getInt(headerPosition + RecordHeader::COMPRESSION_TYPE_OFFSET);
-            //            int compType = compWord >> 28 & 0xff;
-            //            // If there is compression ...
-            //            if (compType != 0) {
-            //                compDataLen = compWord & 0xfffffff;
-            //            }
+        // Convert first event into bytes
+        haveFirstEvent = true;
+        if (firstBank != nullptr) {
+            firstEventByteArray.resize(firstBank->getTotalBytes());
+            firstBank->write(firstEventByteArray.data(), byteOrder);
 
-//            std::cout << "bitInfo      = 0x" << std::hex << bitInfo << std::dec << std::endl;
-//            std::cout << "recordLength = " << recordLen << std::endl;
-//            std::cout << "eventCount   = " << eventCount << std::endl;
-//            std::cout << "lastRecord   = " << lastRecord << std::endl;
-//            std::cout << std::endl;
+            // Add to record which will be our file header's "user header"
+            commonRecord->addEvent(firstEventByteArray);
+        }
+        else if (firstNode != nullptr) {
+            ByteBuffer firstEventBuf(firstNode->getTotalBytes());
+            firstNode->getStructureBuffer(firstEventBuf, true);
+            commonRecord->addEvent(firstEventBuf);
+        }
+        else if (firstBuf != nullptr) {
+            commonRecord->addEvent(firstBuf);
+        }
+        else {
+            haveFirstEvent = false;
+        }
 
-            // Update vector with record size & event count unless this is the trailer
-            if (!isTrailer) {
-//std::cout << "                 adding to recordLengths append: " << (4 * recordLen) << ", " <<
-//             eventCount << "   ------" << std::endl;
-                recordLengths->push_back(4 * recordLen);
-                recordLengths->push_back(eventCount);
-            }
+        // Compression dictionary comes last
+        if (compressionDictionary != nullptr) {
+            commonRecord->addEvent(compressionDictionary->getData(), compressionDictionary->getSize());
+        }
 
-            // Track total number of events in file/buffer (minus dictionary)
-            eventsWrittenTotal += eventCount;
+        commonRecord->build();
+        commonRecordBytesToBuffer = 4*commonRecord->getHeader()->getLengthWords();
+//std::cout << "createCommonRecord: padded commonRecord size is " << commonRecordBytesToBuffer << " bytes" << std::endl;
+    }
 
-            recordNumber++;
-//std::cout << "                 next record # = " << recordNumber << std::endl;
 
-            // Stop at the last record. The file may not have a last record if
-            // improperly terminated. Running into an End-Of-File will flag
-            // this condition.
-            if (isTrailer || lastRecord || readEOF) {
-                break;
-            }
+    /**
+     * Create and write a general file header into the file.
+     * The general header's user header is the common record which
+     * contains any existing dictionary and first event.<p>
+     *
+     * Call this method AFTER file split or, in constructor, after the file
+     * name is created in order to ensure a consistent value for file split number.
+     */
+    void EventWriter::writeFileHeader() {
+        // For the file header, our "user header" will be the common record,
+        // which is a record containing the dictionary and first event.
 
-            // Hop to next record header
-            if (4*recordLen < headerBytesToRead) {
-                throw EvioException("bad file format");
-            }
+        fileHeader.reset();
+        // File split # in header. Go back to last one as currently is set for the next split.
+        fileHeader.setFileNumber(splitNumber - splitIncrement);
 
-            uint32_t bytesToNextBlockHeader = 4*recordLen - headerBytesToRead;
-            if (bytesLeftInFile < bytesToNextBlockHeader) {
-                throw EvioException("bad file format");
+        // Check to see if we have dictionary and/or first event
+        int commonRecordBytes = 0;
+        int commonRecordCount = 0;
+
+        if (commonRecord != nullptr) {
+            commonRecordCount = commonRecord->getEventCount();
+            if (commonRecordCount > 0) {
+                commonRecordBytes = commonRecord->getHeader()->getLength();
+                bool haveDict = !dictionaryByteArray.empty();
+                fileHeader.setBitInfo(haveFirstEvent, haveDict, false);
+                fileHeader.hasCompressionDictionary(compressionDictionary != nullptr);
             }
-            fileWritingPosition += bytesToNextBlockHeader;
-            bytesLeftInFile     -= bytesToNextBlockHeader;
-            asyncFileChannel->seekg(fileWritingPosition);
+            // Sets file header length too
+            fileHeader.setUserHeaderLength(commonRecordBytes);
         }
 
-        if (hasAppendDictionary) {
-            eventsWrittenToFile = eventsWrittenToBuffer = eventsWrittenTotal + 1;
-        }
-        else {
-            eventsWrittenToFile = eventsWrittenToBuffer = eventsWrittenTotal;
-        }
+        // Index array is unused
 
-        //-------------------------------------------------------------------------------
-        // If we're here, we've just read the last record header (at least some of it).
-        // File position is just past header, but buffer position is just before it.
-        // Either that or we ran into end of file (last record header missing).
-        //
-        // If EOF, last record header missing, we're good.
-        //
-        // Else check to see if the last record contains data. If it does,
-        // change a single bit so it's not labeled as the last record,
-        // then jump past all data.
-        //
-        // Else if there is no data, position file before it as preparation for writing
-        // the next record.
-        //-------------------------------------------------------------------------------
+        // Total header size in bytes
+        int bytes = fileHeader.getLength();
+        ByteBuffer buf(bytes);
+        uint8_t* array = buf.array();
+        buf.order(byteOrder);
 
-        // If no last, empty record header in file ...
-        if (readEOF) {
-            // It turns out we need to do nothing. The constructor that
-            // calls this method will write out the next record header.
-            recordNumber--;
-//std::cout << "                 read EOF, record # = " << recordNumber << std::endl;
+        // Write file header into array
+        try {
+            fileHeader.writeHeader(buf, 0);
         }
-            // else if last record or has NO data in it ...
-        else if (isTrailer || eventCount < 1) {
-            // We already partially read in the record header, now back up so we can overwrite it.
-            // If using buffer, we never incremented the position, so we're OK.
+        catch (EvioException & e) {/* never happen */}
 
-            // Since creating next record does ++recordNumber, we decrement it first
-            recordNumber--;
+        // Write user header into array if necessary
+        if (commonRecordBytes > 0) {
+            auto commonBuf = commonRecord->getBinaryBuffer();
+            uint8_t* commonArray = commonBuf->array();
+            if (commonArray != nullptr) {
+                std::memcpy((void *)(array + FileHeader::HEADER_SIZE_BYTES),
+                            (const void *)(commonArray + commonBuf->arrayOffset()), commonRecordBytes);
+            }
+            else {
+                commonBuf->getBytes(array + FileHeader::HEADER_SIZE_BYTES, commonRecordBytes);
+            }
+        }
 
-//std::cout << "                 last rec has no data, is Trailer = " << isTrailer << ", record # = " << recordNumber << std::endl;
-            fileWritingPosition -= headerBytesToRead;
-//std::cout << "toAppendPos: position (bkup) = " << fileWritingPosition << std::endl;
-            asyncFileChannel->seekg(fileWritingPosition);
+        // Write array into file
+        if (directIO) {
+            directFile->write(array, bytes);
         }
         else {
-            // Clear last record bit in 6th header word
-            bitInfo = RecordHeader::clearLastRecordBit(bitInfo);
-
-            // Rewrite header word with new bit info & hop over record
+            asyncFileChannel->write(reinterpret_cast<char *>(array), bytes);
+        }
 
-            // File now positioned right after the last header to be read
-            // Back up to before 6th block header word
-            fileWritingPosition -= headerBytesToRead - RecordHeader::BIT_INFO_OFFSET;
-            asyncFileChannel->seekg(fileWritingPosition);
+        // The compression dictionary is not an event
+        if (compressionDictionary != nullptr) {
+            commonRecordCount--;
+        }
+        eventsWrittenTotal = eventsWrittenToFile = commonRecordCount;
+        bytesWritten = bytes;
+        fileWritingPosition += bytes;
+    }
 
-//std::cout << "toAppendPosition: writing over last block's 6th word, back up " <<
-//             (headerBytesToRead - RecordHeader::BIT_INFO_OFFSET)/4 << " words" << std::endl;
 
-            // Write over 6th block header word
-            buffer->clear();
-            buffer->putInt(bitInfo);
+    /**
+     * This method flushes any remaining internally buffered data to file.
+     * Calling {@link #close()} automatically does this so it isn't necessary
+     * to call before closing. This method should only be used when writing
+     * events at such a low rate that it takes an inordinate amount of time
+     * for internally buffered data to be written to the file.<p>
+     *
+     * Calling this may easily kill performance. May not call this when simultaneously
+     * calling writeEvent, close, setFirstEvent, or getByteBuffer.
+     */
+    void EventWriter::flush() {
 
-            asyncFileChannel->read(reinterpret_cast<char *>(buffer->array()), 4);
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error updating last record header in " + currentFileName);
-            }
+        RecordFlushTimer::Guard guard(flushTimer.get());
 
-            // Hop over the entire block
-//std::cout << "toAppendPosition: wrote over last block's 6th word, hop over whole record, " <<
-//             ((4 * recordLen) - (RecordHeader::BIT_INFO_OFFSET + 4))/4 << " words" << std::endl;
-            fileWritingPosition += (4 * recordLen) - (RecordHeader::BIT_INFO_OFFSET + 4);
-            asyncFileChannel->seekg(fileWritingPosition);
+        if (closed) {
+            return;
         }
 
-        bytesWritten = fileWritingPosition;
-        recordsWritten = recordNumber - 1;
-
-        //        // The when writing the NEXT record, code does an ++recordNumber,
-        //        // so account for that
-        //        recordNumber--;
-//std::cout << "toAppendPos: file pos = " << fileWritingPosition <<
-//             ", recordNumber = " << recordNumber << std::endl;
-
-        // We should now be in a state identical to that if we had
-        // just now written everything currently in the file/buffer.
-        buffer->clear();
-    }
+        // Write any events held back for training
+        finishTraining();
 
-
-    /**
-     * Is there room to write this many bytes to an output buffer as a single event?
-     * Will always return true when writing to a file.
-     * @param bytes number of bytes to write
-     * @return {@code true} if there still room in the output buffer, else {@code false}.
+        if (toFile) {
+            if (singleThreadedCompression) {
+                try {
+                    compressAndWriteToFile(true);
+                }
+                catch (EvioException & e) {
+                    std::cout << e.what() << std::endl;
+                }
+            }
+            else {
+                // Write any existing data.
+                currentRingItem->forceToDisk(true);
+                if (currentRecord->getEventCount() > 0) {
+                    // Send current record back to ring
+                    supply->publish(currentRingItem);
+                }
+
+                // Get another empty record from ring
+                std::cout << "EventWriter: flush, get ring item, seq = " << currentRingItem->getSequence() << std::endl;
+                currentRingItem = supply->get();
+                currentRecord = currentRingItem->getRecord();
+            }
+        }
+        else {
+            flushCurrentRecordToBuffer();
+        }
+    }
+
+
+    /**
+     * This method flushes any remaining data to file and disables this object.
+     * This needs to be called before getting buffer through
+     * {@link #getByteBuffer()} so that the buffer is ready to read.
+     * May not call this when simultaneously calling
+     * writeEvent, flush, setFirstEvent, or getByteBuffer.
+     */
+    void EventWriter::close() {
+        if (closed) {
+            return;
+        }
+
+        // No more records shipped for being old
+        if (flushTimer != nullptr) {
+            flushTimer->stop();
+            flushTimer.reset();
+        }
+
+        // Write any events held back for training
+        finishTraining();
+        // If buffer ...
+        if (!toFile) {
+            flushCurrentRecordToBuffer();
+            // Write empty last header
+            try {
+                writeTrailerToBuffer(addTrailerIndex);
+            }
+            catch (std::exception & e) {
+                // We're here if buffer is too small
+                std::cout << e.what() << std::endl;
+            }
+        }
+        // If file ...
+        else {
+            // Write record to file
+            if (singleThreadedCompression) {
+               if (currentRecord->getEventCount() > 0) {
+                    try {compressAndWriteToFile(false);}
+                    catch (std::exception & e) {
+                        std::cout << e.what() << std::endl;
+                    }
+                }
+            }
+            else {
+                // If we're building a record, send it off
+                // to compressing thread since we're done.
+                // This should never happen as END event forces things through.
+                if (currentRecord->getEventCount() > 0) {
+                    // Put it back in supply for compressing and force to disk
+                    supply->publish(currentRingItem);
+                }
+
+                // Since the writer thread is the last to process each record,
+                // wait until it's done with the last item, then exit the thread.
+                recordWriterThread[0].waitForLastItem();
+
+                // Stop all compressing threads which by now are stuck on get
+                for (RecordCompressor &thd : recordCompressorThreads) {
+                    thd.stopThread();
+                }
+            }
+
+            // Finish writing record to current file
+            try {
+                if (future1 != nullptr && future1->valid()) {
+                    // Wait for last write to end before we continue
+                    future1->get();
+                }
+            }
+            catch (std::exception & e) {}
+
+            // Write trailer
+            if (addingTrailer) {
+                // Write the trailer
+                try {
+                    writeTrailerToFile(addTrailerIndex);
+                }
+                catch (std::exception & e) {
+                    std::cout << e.what() << std::endl;
+                }
+            }
+
+            try {
+                // Find & update file header's record count word
+                ByteBuffer bb(4);
+                bb.order(byteOrder);
+                bb.putInt(0, recordNumber - 1);
+                if (directIO) {
+                    if (directFile != nullptr) {
+                        directFile->writeAt(FileHeader::RECORD_COUNT_OFFSET, bb.array(), 4);
+                    }
+                }
+                else {
+                    asyncFileChannel->seekg(FileHeader::RECORD_COUNT_OFFSET);
+                    asyncFileChannel->write(reinterpret_cast<char*>(bb.array()), 4);
+                }
+            }
+            catch (std::exception & e) {
+                std::cout << e.what() << std::endl;
+            }
+
+            try {
+                if (directFile != nullptr) directFile->close();
+                if (asyncFileChannel->is_open()) asyncFileChannel->close();
+
+                // Shut down all file closing threads
+                if (fileCloser != nullptr) fileCloser->close();
+            }
+            catch (std::exception & e) {}
+
+            // release resources
+            supply.reset();
+            currentRecord.reset();
+            recordWriterThread.clear();
+            recordCompressorThreads.clear();
+            ringItem1.reset();
+            currentRingItem.reset();
+        }
+
+        recordLengths->clear();
+        closed = true;
+    }
+
+
+    /**
+     * Reads part of the file header in order to determine
+     * the evio version # and endianness of the file in question.
+     *
+     * @throws EvioException not in append mode, contains too little data, is not in proper format,
+     *                       version earlier than 6, premature EOF or file reading error,
+     *                       and all other exceptions.
+     */
+    void EventWriter::examineFileHeader() {
+
+        // Only for append mode - only used for files
+        if (!append) {
+            // Internal logic error, should never have gotten here
+            throw EvioException("need to be in append mode");
+        }
+
+        int nBytes;
+
+        auto headerBytes = new char[FileHeader::HEADER_SIZE_BYTES];
+        ByteBuffer buf(headerBytes, FileHeader::HEADER_SIZE_BYTES);
+
+        asyncFileChannel->read(headerBytes, FileHeader::HEADER_SIZE_BYTES);
+        nBytes = asyncFileChannel->gcount();
+        if (asyncFileChannel->fail()) {
+            throw EvioException("error reading first record header from " + currentFileName);
+        }
+
+        // Check to see if we read the whole header
+        if (nBytes != FileHeader::HEADER_SIZE_BYTES) {
+            throw EvioException("bad file format");
+        }
+
+        // Parse header info
+        appendFileHeader = FileHeader();
+        buf.position(0);
+        // Buffer's position/limit does not change
+        appendFileHeader.readHeader(buf);
+
+        // Set the byte order to match the buffer/file's ordering.
+        byteOrder = appendFileHeader.getByteOrder();
+
+        hasAppendDictionary = appendFileHeader.hasDictionary();
+        hasTrailerWithIndex = appendFileHeader.hasTrailerWithIndex();
+        indexLength         = appendFileHeader.getIndexLength();
+        userHeaderLength    = appendFileHeader.getUserHeaderLength();
+        userHeaderPadding   = appendFileHeader.getUserHeaderLengthPadding();
+        //
+        //        int fileID      = appendFileHeader.getFileId();
+        //        int headerLen   = appendFileHeader.getHeaderLength();
+        //        int recordCount = appendFileHeader.getEntries();
+        //        int fileNum     = appendFileHeader.getFileNumber();
+        //
+        //        std::cout << "file ID          = " << fileID << std::endl;
+        //        std::cout << "fileNumber       = " << fileNum << std::endl;
+        //        std::cout << "headerLength     = " << headerLen << std::endl;
+        //        std::cout << "recordCount      = " << recordCount << std::endl;
+        //        std::cout << "trailer index    = " << hasTrailerWithIndex << std::endl;
+        //        std::cout << "bit info         = " << Integer.toHexString(bitInfo) << std::endl;
+        //        std::cout << std::endl;
+    }
+
+
+    /**
+     * This method positions a file for the first {@link #writeEvent(std::shared_ptr<EvioBank>)}
+     * in append mode. It places the writing position after the last event (not record header).
+     *
+     * @throws EvioException     if file reading/writing problems,
+     *                           if bad file/buffer format; if not in append mode
+     */
+    void EventWriter::toAppendPosition() {
+
+        // Only for append mode
+        if (!append) {
+            throw EvioException("need to be in append mode");
+        }
+
+        // Jump over the file header, index array, and user header & padding
+        uint64_t pos = FileHeader::HEADER_SIZE_BYTES + indexLength +
+                       userHeaderLength + userHeaderPadding;
+        // This puts us at the beginning of the first record header
+        fileWritingPosition = pos;
+
+#ifdef USE_FILESYSTEMLIB
+        uint64_t fileSize = fs::file_size(currentFileName);
+#else
+        uint64_t fileSize;
+        struct stat stt{};
+        if (stat(currentFileName.c_str(), &stt) == 0) {
+            fileSize = stt.st_size;
+        }
+        else {
+            throw EvioException("error getting file size of " + currentFileName);
+        }
+#endif
+//std::cout << "toAppendPos:  fileSize = " << fileSize << ", jump to pos = " << fileWritingPosition << std::endl;
+
+        bool lastRecord, isTrailer, readEOF = false;
+        uint32_t recordLen, eventCount, nBytes, bitInfo, headerPosition;
+
+        uint64_t bytesLeftInFile = fileSize;
+
+        //        uint32_t indexArrayLen, userHeaderLen, compDataLen, unCompDataLen;
+        //        uint32_t userPadding, dataPadding, compPadding;
+        //        uint32_t headerLen, currentPosition, compType, compWord;
+
+        // The file's record #s may be fine or they may be messed up.
+        // Assume they start with one and increment from there. That
+        // way any additional records now added to the file will have a
+        // reasonable # instead of incrementing from the last existing
+        // record.
+        recordNumber = 1;
+//std::cout << "toAppendPos:     record # = 1" << std::endl;
+
+        // To read in all of the normal record header set this to 40 bytes.
+        // To read the bare minimum to do the append set this to 24 bytes,
+        // but be sure to comment out lines reading beyond this point in the header.
+        uint32_t headerBytesToRead = 40;
+
+        while (true) {
+            nBytes = 0;
+
+            buffer->clear();
+            buffer->limit(headerBytesToRead);
+
+            while (nBytes < headerBytesToRead) {
+ //std::cout << "Read Header bytes" << std::endl;
+
+                // There is no internal asyncFileChannel position
+                asyncFileChannel->seekg(fileWritingPosition);
+                asyncFileChannel->read(reinterpret_cast<char *>(buffer->array()) + nBytes, headerBytesToRead-nBytes);
+                int partial = asyncFileChannel->gcount();
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error reading record header from " + currentFileName);
+                }
+
+                // TODO: handling EOF seems wrong.............
+                // TODO: If eof hit with nBytes = 0, then header should NOT be parsed ....
+
+                // If EOF ...
+                if (asyncFileChannel->eof()) {
+                    if (nBytes != 0) {
+                        throw EvioException("bad buffer format");
+                    }
+                    // Missing last empty record header
+                    readEOF = true;
+                    break;
+                }
+                nBytes += partial;
+                bytesLeftInFile -= partial;
+            }
+
+            // If we did not read correct # of bytes or didn't run into EOF right away
+            if (nBytes != 0 && nBytes != headerBytesToRead) {
+                throw EvioException("internal file reading error");
+            }
+
+            headerPosition = 0;
+            fileWritingPosition += headerBytesToRead;
+
+            bitInfo    = buffer->getInt(headerPosition + RecordHeader::BIT_INFO_OFFSET);
+            recordLen  = buffer->getInt(headerPosition + RecordHeader::RECORD_LENGTH_OFFSET);
+            eventCount = buffer->getInt(headerPosition + RecordHeader::EVENT_COUNT_OFFSET);
+            lastRecord = RecordHeader::isLastRecord(bitInfo);
+            isTrailer  = RecordHeader::isEvioTrailer(bitInfo);
+
+            ////          If reading entire header, change headerBytesToRead from 24 to 40
+            //            int headerLen     = buffer->getInt(headerPosition + RecordHeader::HEADER_LENGTH_OFFSET);
+            //            int userHeaderLen = buffer->getInt(headerPosition + RecordHeader::USER_LENGTH_OFFSET);
+            //            int indexArrayLen = buffer->getInt(headerPosition + RecordHeader::INDEX_ARRAY_OFFSET);
+            //            int unCompDataLen = buffer->getInt(headerPosition + RecordHeader::UNCOMPRESSED_LENGTH_OFFSET);
+            //
+            //            int compWord      = buffer->getInt(headerPosition + RecordHeader::COMPRESSION_TYPE_OFFSET);
+            //            int compType = compWord >> 28 & 0xff;
+            //            // If there is compression ...
+            //            if (compType != 0) {
+            //                compDataLen = compWord & 0xfffffff;
+            //            }
+
+//            std::cout << "bitInfo      = 0x" << std::hex << bitInfo << std::dec << std::endl;
+//            std::cout << "recordLength = " << recordLen << std::endl;
+//            std::cout << "eventCount   = " << eventCount << std::endl;
+//            std::cout << "lastRecord   = " << lastRecord << std::endl;
+//            std::cout << std::endl;
+
+            // Update vector with record size & event count unless this is the trailer
+            if (!isTrailer) {
+//std::cout << "                 adding to recordLengths append: " << (4 * recordLen) << ", " <<
+//             eventCount << "   ------" << std::endl;
+                recordLengths->push_back(4 * recordLen);
+                recordLengths->push_back(eventCount);
+            }
+
+            // Track total number of events in file/buffer (minus dictionary)
+            eventsWrittenTotal += eventCount;
+
+            recordNumber++;
+//std::cout << "                 next record # = " << recordNumber << std::endl;
+
+            // Stop at the last record. The file may not have a last record if
+            // improperly terminated. Running into an End-Of-File will flag
+            // this condition.
+            if (isTrailer || lastRecord || readEOF) {
+                break;
+            }
+
+            // Hop to next record header
+            if (4*recordLen < headerBytesToRead) {
+                throw EvioException("bad file format");
+            }
+
+            uint32_t bytesToNextBlockHeader = 4*recordLen - headerBytesToRead;
+            if (bytesLeftInFile < bytesToNextBlockHeader) {
+                throw EvioException("bad file format");
+            }
+            fileWritingPosition += bytesToNextBlockHeader;
+            bytesLeftInFile     -= bytesToNextBlockHeader;
+            asyncFileChannel->seekg(fileWritingPosition);
+        }
+
+        if (hasAppendDictionary) {
+            eventsWrittenToFile = eventsWrittenToBuffer = eventsWrittenTotal + 1;
+        }
+        else {
+            eventsWrittenToFile = eventsWrittenToBuffer = eventsWrittenTotal;
+        }
+
+        //-------------------------------------------------------------------------------
+        // If we're here, we've just read the last record header (at least some of it).
+        // File position is just past header, but buffer position is just before it.
+        // Either that or we ran into end of file (last record header missing).
+        //
+        // If EOF, last record header missing, we're good.
+        //
+        // Else check to see if the last record contains data. If it does,
+        // change a single bit so it's not labeled as the last record,
+        // then jump past all data.
+        //
+        // Else if there is no data, position file before it as preparation for writing
+        // the next record.
+        //-------------------------------------------------------------------------------
+
+        // If no last, empty record header in file ...
+        if (readEOF) {
+            // It turns out we need to do nothing. The constructor that
+            // calls this method will write out the next record header.
+            recordNumber--;
+//std::cout << "                 read EOF, record # = " << recordNumber << std::endl;
+        }
+            // else if last record or has NO data in it ...
+        else if (isTrailer || eventCount < 1) {
+            // We already partially read in the record header, now back up so we can overwrite it.
+            // If using buffer, we never incremented the position, so we're OK.
+
+            // Since creating next record does ++recordNumber, we decrement it first
+            recordNumber--;
+
+//std::cout << "                 last rec has no data, is Trailer = " << isTrailer << ", record # = " << recordNumber << std::endl;
+            fileWritingPosition -= headerBytesToRead;
+//std::cout << "toAppendPos: position (bkup) = " << fileWritingPosition << std::endl;
+            asyncFileChannel->seekg(fileWritingPosition);
+        }
+        else {
+            // Clear last record bit in 6th header word
+            bitInfo = RecordHeader::clearLastRecordBit(bitInfo);
+
+            // Rewrite header word with new bit info & hop over record
+
+            // File now positioned right after the last header to be read
+            // Back up to before 6th block header word
+            fileWritingPosition -= headerBytesToRead - RecordHeader::BIT_INFO_OFFSET;
+            asyncFileChannel->seekg(fileWritingPosition);
+
+//std::cout << "toAppendPosition: writing over last block's 6th word, back up " <<
+//             (headerBytesToRead - RecordHeader::BIT_INFO_OFFSET)/4 << " words" << std::endl;
+
+            // Write over 6th block header word
+            buffer->clear();
+            buffer->putInt(bitInfo);
+
+            asyncFileChannel->read(reinterpret_cast<char *>(buffer->array()), 4);
+            if (asyncFileChannel->fail()) {
+                throw EvioException("error updating last record header in " + currentFileName);
+            }
+
+            // Hop over the entire block
+//std::cout << "toAppendPosition: wrote over last block's 6th word, hop over whole record, " <<
+//             ((4 * recordLen) - (RecordHeader::BIT_INFO_OFFSET + 4))/4 << " words" << std::endl;
+            fileWritingPosition += (4 * recordLen) - (RecordHeader::BIT_INFO_OFFSET + 4);
+            asyncFileChannel->seekg(fileWritingPosition);
+        }
+
+        bytesWritten = fileWritingPosition;
+        recordsWritten = recordNumber - 1;
+
+        //        // The when writing the NEXT record, code does an ++recordNumber,
+        //        // so account for that
+        //        recordNumber--;
+//std::cout << "toAppendPos: file pos = " << fileWritingPosition <<
+//             ", recordNumber = " << recordNumber << std::endl;
+
+        // We should now be in a state identical to that if we had
+        // just now written everything currently in the file/buffer.
+        buffer->clear();
+    }
+
+
+    /**
+     * Is there room to write this many bytes to an output buffer as a single event?
+     * Will always return true when writing to a file.
+     * @param bytes number of bytes to write
+     * @return {@code true} if there still room in the output buffer, else {@code false}.
+     */
+    bool EventWriter::hasRoom(uint32_t bytes) {
+        //std::cout << "User buffer size (" << currentRecord->getInternalBufferCapacity() << ") - bytesWritten (" << bytesWritten <<
+        //      ") - trailer (" << trailerBytes() <<  ") = (" <<
+        //         ((currentRecord->getInternalBufferCapacity() - bytesWritten) >= bytes + RecordHeader::HEADER_SIZE_BYTES) <<
+        //      ") >= ? " << bytes << std::endl;
+        return writingToFile() || (((currentRecord->getInternalBufferCapacity() -
+                                    bytesWritten - trailerBytes()) >= bytes) &&
+                                    !currentRecord->oneTooMany());
+    }
+
+
+    /**
+     * Write an event (bank) into a record in evio/hipo version 6 format.
+     * Once the record is full and if writing to a file (for multiple compression
+     * threads), the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     * If writing to a buffer, once the record is full this method returns
+     * false - indicating that the last event was NOT written to the record.
+     * To finish the writing process, call {@link #close()}. This will
+     * compress the data if desired and then write it to the buffer.<p>
+     *
+     * The buffer must contain only the event's data (event header and event data)
+     * and must <b>not</b> be in complete evio file format.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     *<b>kill</b> performance when writing to a file.
+     * A true 3rd arg can be used when the backing buffer
+     * of the node is accessed by multiple threads simultaneously. This allows
+     * that buffer's limit and position to be changed without interfering
+     * with the other threads.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param node       object representing the event to write in buffer form
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param duplicate  if true, duplicate node's buffer so its position and limit
+     *                   can be changed without issue.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return if writing to buffer: true if event was added to record, false if buffer full,
+     *         or record event count limit exceeded.
+     *
+     * @throws EvioException if error writing file
+     *                       if event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if bad eventBuffer format;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing;
+     */
+    bool EventWriter::writeEvent(std::shared_ptr<EvioNode> & node, bool force, bool duplicate, bool ownRecord) {
+
+        std::shared_ptr<ByteBuffer> eventBuffer;
+        auto bb = node->getBuffer();
+
+        // Duplicate buffer so we can set pos & limit without messing others up
+        if (duplicate) {
+            eventBuffer = bb->duplicate();
+            eventBuffer->order(bb->order());
+        }
+        else {
+            eventBuffer = bb;
+        }
+
+        uint32_t pos = node->getPosition();
+        eventBuffer->limit(pos + node->getTotalBytes()).position(pos);
+        return writeEvent(nullptr, eventBuffer, force, ownRecord);
+    }
+
+    /**
+     * Write an event (bank) into a record and eventually to a file in evio/hipo
+     * version 6 format.
+     * Once the record is full and if writing with multiple compression
+     * threads, the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     *
+     * <b>
+     * If splitting files, this method returns false if disk partition is too full
+     * to write the complete, next split file. If force arg is true, write anyway.
+     * DO NOT mix calling this method with calling
+     * {@link #writeEvent()} (all variants).
+     * Results are unpredictable as it messes up the
+     * logic used to quit writing to full disk.
+     * </b>
+     *
+     * The buffer must contain only the event's data (event header and event data)
+     * and must <b>not</b> be in complete evio file format.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     * <b>kill</b> performance when writing to a file.
+     * A true 3rd arg can be used when the backing buffer
+     * of the node is accessed by multiple threads simultaneously. This allows
+     * that buffer's limit and position to be changed without interfering
+     * with the other threads.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param node       object representing the event to write in buffer form
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param duplicate  if true, duplicate node's buffer so its position and limit
+     *                   can be changed without issue.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return true if event was added to record. If splitting files, false if disk
+     *         partition too full to write the complete, next split file.
+     *         False if interrupted. If force arg is true, write anyway.
+     *
+     * @throws EvioException if error writing file
+     *                       if event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if bad eventBuffer format;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing;
+     */
+    bool EventWriter::writeEventToFile(std::shared_ptr<EvioNode> & node, bool force,
+                                       bool duplicate, bool ownRecord) {
+
+        std::shared_ptr<ByteBuffer> eventBuffer;
+        auto bb = node->getBuffer();
+
+        // Duplicate buffer so we can set pos & limit without messing others up
+        if (duplicate) {
+            eventBuffer = bb->duplicate();
+            eventBuffer->order(bb->order());
+        }
+        else {
+            eventBuffer = bb;
+        }
+
+        uint32_t pos = node->getPosition();
+        eventBuffer->limit(pos + node->getTotalBytes()).position(pos);
+        return writeEventToFile(nullptr, eventBuffer, force, ownRecord);
+    }
+
+    /**
+     * Write an event (bank) into a record and eventually to a file in evio/hipo
+     * version 6 format.
+     * Once the record is full and if writing with multiple compression
+     * threads, the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     *
+     * <b>
+     * If splitting files, this method returns false if disk partition is too full
+     * to write the complete, next split file. If force arg is true, write anyway.
+     * DO NOT mix calling this method with calling
+     * {@link #writeEvent()} (all variants).
+     * Results are unpredictable as it messes up the
+     * logic used to quit writing to full disk.
+     * </b>
+     *
+     * The buffer must contain only the event's data (event header and event data)
+     * and must <b>not</b> be in complete evio file format.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     * <b>kill</b> performance when writing to a file.
+     * A true 3rd arg can be used when the backing buffer
+     * of the node is accessed by multiple threads simultaneously. This allows
+     * that buffer's limit and position to be changed without interfering
+     * with the other threads.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param bb         ByteBuffer representing the event.
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param duplicate  if true, duplicate bb so its position and limit
+     *                   can be changed without issue.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return true if event was added to record. If splitting files, false if disk
+     *         partition too full to write the complete, next split file.
+     *         False if interrupted. If force arg is true, write anyway.
+     *
+     * @throws EvioException if error writing file
+     *                       if event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if bad eventBuffer format;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing;
+     */
+    bool EventWriter::writeEventToFile(std::shared_ptr<ByteBuffer> & bb, bool force,
+                                       bool duplicate, bool ownRecord) {
+
+        std::shared_ptr<ByteBuffer> eventBuffer;
+
+        // Duplicate buffer so we can set pos & limit without messing others up
+        if (duplicate) {
+            eventBuffer = bb->duplicate();
+            eventBuffer->order(bb->order());
+        }
+        else {
+            eventBuffer = bb;
+        }
+
+        return writeEventToFile(nullptr, eventBuffer, force, ownRecord);
+    }
+
+
+    /**
+     * Write an event (bank) into a record in evio/hipo version 6 format.
+     * Once the record is full and if writing to a file (for multiple compression
+     * threads), the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     * If writing to a buffer, once the record is full this method returns
+     * false - indicating that the last event was NOT written to the record.
+     * To finish the writing process, call {@link #close()}. This will
+     * compress the data if desired and then write it to the buffer.<p>
+     *
+     * The buffer must contain only the event's data (event header and event data)
+     * and must <b>not</b> be in complete evio file format.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     * <b>kill</b> performance when writing to a file.
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param bankBuffer the bank (as a ByteBuffer object) to write.
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return if writing to buffer: true if event was added to record, false if buffer full,
+     *         or record event count limit exceeded.
+     *
+     * @throws EvioException if error writing file
+     *                       if event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if bad eventBuffer format;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing.
+     */
+    bool EventWriter::writeEvent(std::shared_ptr<ByteBuffer> & bankBuffer, bool force, bool ownRecord) {
+        return writeEvent(nullptr, bankBuffer, force, ownRecord);
+    }
+
+
+    /**
+     * Write an event (bank) into a record in evio/hipo version 6 format.
+     * Once the record is full and if writing to a file (for multiple compression
+     * threads), the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     * If writing to a buffer, once the record is full this method returns
+     * false - indicating that the last event was NOT written to the record.
+     * To finish the writing process, call {@link #close()}. This will
+     * compress the data if desired and then write it to the buffer.<p>
+     *
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * Be warned that injudicious use of the 2nd arg, the force flag, will
+     * <b>kill</b> performance when writing to a file.
+     *
+     * @param bank   the bank to write.
+     * @param force  if writing to disk, force it to write event to the disk.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     * @return if writing to buffer: true if event was added to record, false if buffer full,
+     *         or record event count limit exceeded.
+     *
+     * @throws EvioException if error writing file
+     *                       if close() already called;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing;.
+     */
+    bool EventWriter::writeEvent(std::shared_ptr<EvioBank> bank, bool force, bool ownRecord) {
+        return writeEvent(bank, nullptr, force, ownRecord);
+    }
+
+
+    /**
+     * Write an event (bank) into a record and eventually to a file in evio/hipo
+     * version 6 format.
+     * Once the record is full and if writing with multiple compression
+     * threads, the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     *
+     * <b>
+     * If splitting files, this method returns false if disk partition is too full
+     * to write the complete, next split file. If force arg is true, write anyway.
+     * DO NOT mix calling this method with calling
+     * {@link #writeEvent()} (all variants).
+     * Results are unpredictable as it messes up the
+     * logic used to quit writing to full disk.
+     * </b>
+     *
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     * <b>kill</b> performance when writing to a file.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param bank       the bank (as an EvioBank object) to write.
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return true if event was added to record. If splitting files, false if disk
+     *         partition too full to write the complete, next split file.
+     *         False if interrupted. If force arg is true, write anyway.
+     *
+     * @throws EvioException if error writing file
+     *                       if event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if bad eventBuffer format;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing;
+     */
+    bool EventWriter::writeEventToFile(std::shared_ptr<EvioBank> bank, bool force, bool ownRecord) {
+        return writeEventToFile(bank, nullptr, force, ownRecord);
+    }
+
+
+    /**
+     * Write an event (bank) into a record in evio/hipo version 6 format.
+     * Once the record is full and if writing to a file (for multiple compression
+     * threads), the record will be sent to a thread which may compress the data,
+     * then it will be sent to a thread to write the record to file.
+     * If there is only 1 compression thread, it's all done in the thread which
+     * call this method.<p>
+     * If writing to a buffer, once the record is full this method returns
+     * false - indicating that the last event was NOT written to the record.
+     * To finish the writing process, call {@link #close()}. This will
+     * compress the data if desired and then write it to the buffer.<p>
+     *
+     * The event to be written may be in one of two forms.
+     * The first is as an EvioBank object and the second is as a ByteBuffer
+     * containing only the event's data (event header and event data) and must
+     * <b>not</b> be in complete evio file format.
+     * The first non-null of the bank arguments will be written.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.<p>
+     *
+     * Be warned that injudicious use of a true 2nd arg, the force flag, will
+     *<b>kill</b> performance when writing to a file.<p>
+     *
+     * This method is not used to write the dictionary or the first event
+     * which are both placed in the common record which, in turn, is the
+     * user header part of the file header.<p>
+     *
+     * @param bank       the bank (as an EvioBank object) to write.
+     * @param bankBuffer the bank (as a ByteBuffer object) to write.
+     * @param force      if writing to disk, force it to write event to the disk.
+     * @param ownRecord  if true, write event in its own record regardless
+     *                   of event count and record size limits.
+     *
+     * @return if writing to buffer: true if event was added to record, false if buffer full,
+     *         record event count limit exceeded, or bank and bankBuffer args are both null.
+     *
+     * @throws EvioException if error writing file;
+     *                       if event is opposite byte order of internal buffer;
+     *                       if bad bankBuffer format;
+     *                       if close() already called;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing.
      */
-    bool EventWriter::hasRoom(uint32_t bytes) {
-        //std::cout << "User buffer size (" << currentRecord->getInternalBufferCapacity() << ") - bytesWritten (" << bytesWritten <<
-        //      ") - trailer (" << trailerBytes() <<  ") = (" <<
-        //         ((currentRecord->getInternalBufferCapacity() - bytesWritten) >= bytes + RecordHeader::HEADER_SIZE_BYTES) <<
-        //      ") >= ? " << bytes << std::endl;
-        return writingToFile() || (((currentRecord->getInternalBufferCapacity() -
-                                    bytesWritten - trailerBytes()) >= bytes) &&
-                                    !currentRecord->oneTooMany());
+    bool EventWriter::writeEvent(std::shared_ptr<EvioBank> bank,
+                                 std::shared_ptr<ByteBuffer> bankBuffer,
+                                 bool force, bool ownRecord) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {
+            throw EvioException("close() has already been called");
+        }
+
+        throwAgedRecordError();
+
+        bool fitInRecord;
+        bool splittingFile = false;
+        // See how much space the event will take up
+        size_t currentEventBytes;
+
+        // Which bank do we write?
+        if (bankBuffer != nullptr) {
+            if (bankBuffer->order() != byteOrder) {
+                throw EvioException("event buf is " + bankBuffer->order().getName() +
+                                    ", and writer is " + byteOrder.getName());
+            }
+
+            // Event size in bytes (from buffer ready to read)
+            currentEventBytes = bankBuffer->remaining();
+
+            // Size must be multiple of 4 bytes (whole 32-bit ints)
+            // The following is the equivalent of the mod operation:
+            //  (currentEventBytes % 4 != 0) but is much faster (x mod 2^n == x & (2^n - 1))
+            if ((currentEventBytes & 3) != 0) {
+                throw EvioException("bad bankBuffer format");
+            }
+
+            // Check for inconsistent lengths
+            if (currentEventBytes != 4 * (bankBuffer->getUInt(bankBuffer->position()) + 1)) {
+                throw EvioException("inconsistent event lengths: total bytes from event = " +
+                                            std::to_string(4*(bankBuffer->getUInt(bankBuffer->position()) + 1)) +
+                                    ", from buffer = " + std::to_string(currentEventBytes));
+            }
+        }
+        else if (bank != nullptr) {
+            currentEventBytes = bank->getTotalBytes();
+        }
+        else {
+            return false;
+        }
+
+        // Hold events back until the compression dictionary is trained
+        if (trainingEventCount > 0) {
+            return addTrainingEvent(bank, bankBuffer);
+        }
+
+        // If writing to buffer, we're not multi-threading compression & writing.
+        // Do it all in this thread, right now.
+        if (!toFile) {
+            return writeToBuffer(bank, bankBuffer);
+        }
+
+        // If here, we're writing to a file ...
+
+        // If we're splitting files,
+        // we must have written at least one real event before we
+        // can actually split the file.
+        if ((split > 0) && (splitEventCount > 0)) {
+            // Is event, along with the previous events, large enough to split the file?
+            // For simplicity ignore the headers which will take < 2Kb.
+            // Take any compression roughly into account.
+            uint64_t totalSize = (currentEventBytes + splitEventBytes)*compressionFactor/100;
+
+            // If we're going to split the file, set a couple flags
+            if (totalSize > split) {
+                //                std::cout << "Split at total size = " << totalSize <<
+                //                                   ", ev = " << currentEventBytes <<
+                //                                   ", prev = " << splitEventBytes <<
+                //                                   ", compressed data = " <<
+                //                                   ((currentEventBytes + splitEventBytes)*compressionFactor/100) << std::endl;
+                splittingFile = true;
+            }
+        }
+
+        // First, if multithreaded write, check for any errors that may have
+        // occurred asynchronously in the write or one of the compression threads.
+        if (!singleThreadedCompression && supply->haveError()) {
+            // Wake up any of these threads waiting for another record
+            supply->errorAlert();
+            throw EvioException(supply->getError());
+        }
+
+        // Including this event, this is the total data size & event count
+        // for this split file.
+        splitEventBytes += currentEventBytes;
+        splitEventCount++;
+
+        // If event is big enough to split the file ...
+        if (splittingFile) {
+            if (singleThreadedCompression) {
+                try {
+                    compressAndWriteToFile(false);
+                }
+                catch (boost::thread_interrupted & e) {
+                    return false;
+                }
+                catch (std::exception & e) {
+                    throw EvioException(e);
+                }
+
+                splitFile();
+            }
+            else {
+                // Set flag to split file
+                currentRingItem->splitFileAfterWrite(true);
+                //currentRecord->getHeader().setRecordNumber(recordNumber);
+                // Send current record back to ring without adding event
+                supply->publish(currentRingItem);
+
+                // Get another empty record from ring.
+                // Record number reset for new file.
+                recordNumber = 1;
+                currentRingItem = supply->get();
+                currentRecord = currentRingItem->getRecord();
+                currentRecord->getHeader()->setRecordNumber(recordNumber++);
+                //std::cout << "writeEvent: split after just published rec, new rec# = 1, next = " << recordNumber << std::endl;
+                // Reset record number for records coming after this one
+            }
+
+            // Reset split-tracking variables
+            splitEventBytes = 0L;
+            splitEventCount = 0;
+        }
+
+        // If event to be written in its own record
+        if (ownRecord) {
+            fitInRecord = false;
+        }
+        // Try adding event to current record.
+        // One event is guaranteed to fit in a record no matter the size,
+        // IFF using multithreaded compression.
+        else if (bankBuffer != nullptr) {
+            fitInRecord = currentRecord->addEvent(bankBuffer);
+        }
+        else {
+            fitInRecord = currentRecord->addEvent(bank);
+        }
+
+        // If no room or too many events ...
+        if (!fitInRecord) {
+            if (singleThreadedCompression) {
+                // Only try to write what we have if there's something to write
+                if (currentRecord->getEventCount() > 0) {
+                    try {
+                        compressAndWriteToFile(false);
+                    }
+                    catch (boost::thread_interrupted &e) {
+                        return false;
+                    }
+                    catch (std::exception &e) {
+                        throw EvioException(e);
+                    }
+
+                    // Try add eventing to it (1 very big event many not fit)
+                    if (bankBuffer != nullptr) {
+                        fitInRecord = currentRecord->addEvent(bankBuffer);
+                    }
+                    else {
+                        fitInRecord = currentRecord->addEvent(bank);
+                    }
+                }
+
+                // Since we're here, we have a single event too big to fit in the
+                // allocated buffers. So expand buffers and try again.
+                if (!fitInRecord) {
+//std::cout << "writeEventToFile: expand buffers to " << (currentEventBytes/10*12) << "  bytes" << std::endl;
+                    expandInternalBuffers(currentEventBytes);
+
+                    if (bankBuffer != nullptr) {
+                        fitInRecord = currentRecord->addEvent(bankBuffer);
+                    }
+                    else {
+                        fitInRecord = currentRecord->addEvent(bank);
+                    }
+
+                    if (!fitInRecord) {
+                        throw EvioException("cannot fit event into buffer");
+                    }
+//std::cout << "writeEventToFile: EVENT FINALLY FIT!" << std::endl;
+                }
+            }
+            else {
+                // This "if" is only needed since we may want event in its own record
+                if (currentRecord->getEventCount() > 0) {
+                    // Send current record back to ring without adding event
+                    supply->publish(currentRingItem);
+
+                    // Get another empty record from ring
+                    currentRingItem = supply->get();
+                    currentRecord = currentRingItem->getRecord();
+                    currentRecord->getHeader()->setRecordNumber(recordNumber++);
+//std::cout << "writeEvent: just published rec, new rec# = " << (recordNumber - 1) << ", next = " << recordNumber << std::endl;
+                }
+
+                // Add event to it (guaranteed to fit)
+                if (bankBuffer != nullptr) {
+                    currentRecord->addEvent(bankBuffer);
+                }
+                else {
+                    currentRecord->addEvent(bank);
+                }
+            }
+        }
+
+        // If event must be physically written to disk,
+        // or the event must be written in its own record ...
+        if (force || ownRecord) {
+            if (singleThreadedCompression) {
+                try {
+                    compressAndWriteToFile(force);
+                }
+                catch (boost::thread_interrupted & e) {
+                    return false;
+                }
+                catch (std::exception & e) {
+                    throw EvioException(e);
+                }
+            }
+            else {
+                // Tell writer to force this record to disk
+                currentRingItem->forceToDisk(force);
+                // Send current record back to ring
+                supply->publish(currentRingItem);
+
+                // Get another empty record from ring
+                currentRingItem = supply->get();
+                currentRecord = currentRingItem->getRecord();
+                currentRecord->getHeader()->setRecordNumber(recordNumber++);
+//std::cout << "writeEvent: FORCED published rec, new rec# = " << (recordNumber - 1) << ", next = " << recordNumber << std::endl;
+            }
+        }
+
+        return true;
     }
 
 
     /**
-     * Write an event (bank) into a record in evio/hipo version 6 format.
-     * Once the record is full and if writing to a file (for multiple compression
-     * threads), the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     * If writing to a buffer, once the record is full this method returns
-     * false - indicating that the last event was NOT written to the record.
-     * To finish the writing process, call {@link #close()}. This will
-     * compress the data if desired and then write it to the buffer.<p>
-     *
-     * The buffer must contain only the event's data (event header and event data)
-     * and must <b>not</b> be in complete evio file format.
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     *<b>kill</b> performance when writing to a file.
-     * A true 3rd arg can be used when the backing buffer
-     * of the node is accessed by multiple threads simultaneously. This allows
-     * that buffer's limit and position to be changed without interfering
-     * with the other threads.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
+     * Reserve space for the next event so it can be built directly inside the current
+     * record, instead of being built elsewhere and copied in by writeEvent.
+     * Write the event (bank header and data, in this writer's byte order) into the
+     * returned memory, then call {@link #commitEvent(uint32_t, bool)} with its actual size.
+     * To build it with a CompactEventBuilder, use {@link #reserveEventBuffer(uint32_t)}.<p>
      *
-     * @param node       object representing the event to write in buffer form
-     * @param force      if writing to disk, force it to write event to the disk.
-     * @param duplicate  if true, duplicate node's buffer so its position and limit
-     *                   can be changed without issue.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
+     * The event is written in place when writing to a file. When writing to a buffer,
+     * or while training a compression dictionary, it's held in a separate buffer and
+     * copied on commit as writeEvent does.
+     * If splitting files, maxBytes is used to decide whether the file is split
+     * before this event.<p>
      *
-     * @return if writing to buffer: true if event was added to record, false if buffer full,
-     *         or record event count limit exceeded.
+     * Do not call any other write method, flush, or close between reserveEvent and commitEvent.
+     * Do not call this while simultaneously calling close, flush, setFirstEvent, or getByteBuffer.
      *
-     * @throws EvioException if error writing file
-     *                       if event is opposite byte order of internal buffer;
-     *                       if close() already called;
-     *                       if bad eventBuffer format;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing;
+     * @param maxBytes max number of bytes the event may take.
+     * @return pointer to maxBytes bytes to write the event into; null if interrupted.
+     * @throws EvioException if close() already called;
+     *                       if an event is already reserved and not committed;
+     *                       if maxBytes is 0;
+     *                       if error writing file.
      */
-    bool EventWriter::writeEvent(std::shared_ptr<EvioNode> & node, bool force, bool duplicate, bool ownRecord) {
+    uint8_t * EventWriter::reserveEvent(uint32_t maxBytes) {
 
-        std::shared_ptr<ByteBuffer> eventBuffer;
-        auto bb = node->getBuffer();
+        RecordFlushTimer::Guard guard(flushTimer.get());
 
-        // Duplicate buffer so we can set pos & limit without messing others up
-        if (duplicate) {
-            eventBuffer = bb->duplicate();
-            eventBuffer->order(bb->order());
-        }
-        else {
-            eventBuffer = bb;
+        if (closed) {
+            throw EvioException("close() has already been called");
         }
 
-        uint32_t pos = node->getPosition();
-        eventBuffer->limit(pos + node->getTotalBytes()).position(pos);
-        return writeEvent(nullptr, eventBuffer, force, ownRecord);
-    }
+        throwAgedRecordError();
 
-    /**
-     * Write an event (bank) into a record and eventually to a file in evio/hipo
-     * version 6 format.
-     * Once the record is full and if writing with multiple compression
-     * threads, the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     *
-     * <b>
-     * If splitting files, this method returns false if disk partition is too full
-     * to write the complete, next split file. If force arg is true, write anyway.
-     * DO NOT mix calling this method with calling
-     * {@link #writeEvent()} (all variants).
-     * Results are unpredictable as it messes up the
-     * logic used to quit writing to full disk.
-     * </b>
-     *
-     * The buffer must contain only the event's data (event header and event data)
-     * and must <b>not</b> be in complete evio file format.
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     * <b>kill</b> performance when writing to a file.
-     * A true 3rd arg can be used when the backing buffer
-     * of the node is accessed by multiple threads simultaneously. This allows
-     * that buffer's limit and position to be changed without interfering
-     * with the other threads.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * @param node       object representing the event to write in buffer form
-     * @param force      if writing to disk, force it to write event to the disk.
-     * @param duplicate  if true, duplicate node's buffer so its position and limit
-     *                   can be changed without issue.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
-     *
-     * @return true if event was added to record. If splitting files, false if disk
-     *         partition too full to write the complete, next split file.
-     *         False if interrupted. If force arg is true, write anyway.
-     *
-     * @throws EvioException if error writing file
-     *                       if event is opposite byte order of internal buffer;
-     *                       if close() already called;
-     *                       if bad eventBuffer format;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing;
-     */
-    bool EventWriter::writeEventToFile(std::shared_ptr<EvioNode> & node, bool force,
-                                       bool duplicate, bool ownRecord) {
+        if (eventReserved) {
+            throw EvioException("reserved event not committed");
+        }
 
-        std::shared_ptr<ByteBuffer> eventBuffer;
-        auto bb = node->getBuffer();
+        if (maxBytes == 0) {
+            throw EvioException("no bytes to reserve");
+        }
 
-        // Duplicate buffer so we can set pos & limit without messing others up
-        if (duplicate) {
-            eventBuffer = bb->duplicate();
-            eventBuffer->order(bb->order());
+        // Events written into a buffer or held back for training go through writeEvent
+        if (!toFile || trainingEventCount > 0) {
+            if (reserveBuffer == nullptr || reserveBuffer->capacity() < maxBytes) {
+                reserveBuffer = std::make_shared<ByteBuffer>(maxBytes);
+                reserveBuffer->order(byteOrder);
+            }
+            eventReserved = true;
+            reservedInBuffer = true;
+            reservedBytes = maxBytes;
+            reservedEvent = reserveBuffer->array() + reserveBuffer->arrayOffset();
+            return reservedEvent;
         }
-        else {
-            eventBuffer = bb;
+
+        // If multithreaded write, check for any errors that may have
+        // occurred asynchronously in the write or one of the compression threads.
+        if (!singleThreadedCompression && supply->haveError()) {
+            // Wake up any of these threads waiting for another record
+            supply->errorAlert();
+            throw EvioException(supply->getError());
         }
 
-        uint32_t pos = node->getPosition();
-        eventBuffer->limit(pos + node->getTotalBytes()).position(pos);
-        return writeEventToFile(nullptr, eventBuffer, force, ownRecord);
-    }
+        // If splitting files, split before this event if, at its largest,
+        // it would make the file too big. Must have written at least one real event first.
+        if ((split > 0) && (splitEventCount > 0) &&
+            ((maxBytes + splitEventBytes)*compressionFactor/100 > split)) {
 
-    /**
-     * Write an event (bank) into a record and eventually to a file in evio/hipo
-     * version 6 format.
-     * Once the record is full and if writing with multiple compression
-     * threads, the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     *
-     * <b>
-     * If splitting files, this method returns false if disk partition is too full
-     * to write the complete, next split file. If force arg is true, write anyway.
-     * DO NOT mix calling this method with calling
-     * {@link #writeEvent()} (all variants).
-     * Results are unpredictable as it messes up the
-     * logic used to quit writing to full disk.
-     * </b>
-     *
-     * The buffer must contain only the event's data (event header and event data)
-     * and must <b>not</b> be in complete evio file format.
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     * <b>kill</b> performance when writing to a file.
-     * A true 3rd arg can be used when the backing buffer
-     * of the node is accessed by multiple threads simultaneously. This allows
-     * that buffer's limit and position to be changed without interfering
-     * with the other threads.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * @param bb         ByteBuffer representing the event.
-     * @param force      if writing to disk, force it to write event to the disk.
-     * @param duplicate  if true, duplicate bb so its position and limit
-     *                   can be changed without issue.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
-     *
-     * @return true if event was added to record. If splitting files, false if disk
-     *         partition too full to write the complete, next split file.
-     *         False if interrupted. If force arg is true, write anyway.
-     *
-     * @throws EvioException if error writing file
-     *                       if event is opposite byte order of internal buffer;
-     *                       if close() already called;
-     *                       if bad eventBuffer format;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing;
-     */
-    bool EventWriter::writeEventToFile(std::shared_ptr<ByteBuffer> & bb, bool force,
-                                       bool duplicate, bool ownRecord) {
+            if (singleThreadedCompression) {
+                try {
+                    compressAndWriteToFile(false);
+                }
+                catch (boost::thread_interrupted & e) {
+                    return nullptr;
+                }
+                catch (std::exception & e) {
+                    throw EvioException(e);
+                }
 
-        std::shared_ptr<ByteBuffer> eventBuffer;
+                splitFile();
+            }
+            else {
+                // Set flag to split file
+                currentRingItem->splitFileAfterWrite(true);
+                // Send current record back to ring without adding event
+                supply->publish(currentRingItem);
+
+                // Get another empty record from ring.
+                // Record number reset for new file.
+                recordNumber = 1;
+                currentRingItem = supply->get();
+                currentRecord = currentRingItem->getRecord();
+                currentRecord->getHeader()->setRecordNumber(recordNumber++);
+            }
+
+            // Reset split-tracking variables
+            splitEventBytes = 0L;
+            splitEventCount = 0;
+        }
+
+        uint8_t *event = currentRecord->reserveEvent(maxBytes);
+
+        // If no room or too many events ...
+        if (event == nullptr) {
+            if (singleThreadedCompression) {
+                // Only try to write what we have if there's something to write
+                if (currentRecord->getEventCount() > 0) {
+                    try {
+                        compressAndWriteToFile(false);
+                    }
+                    catch (boost::thread_interrupted &e) {
+                        return nullptr;
+                    }
+                    catch (std::exception &e) {
+                        throw EvioException(e);
+                    }
 
-        // Duplicate buffer so we can set pos & limit without messing others up
-        if (duplicate) {
-            eventBuffer = bb->duplicate();
-            eventBuffer->order(bb->order());
-        }
-        else {
-            eventBuffer = bb;
-        }
+                    event = currentRecord->reserveEvent(maxBytes);
+                }
 
-        return writeEventToFile(nullptr, eventBuffer, force, ownRecord);
-    }
+                // Single event too big to fit in the allocated buffers
+                if (event == nullptr) {
+                    expandInternalBuffers(maxBytes);
+                    event = currentRecord->reserveEvent(maxBytes);
+                }
+            }
+            else {
+                if (currentRecord->getEventCount() > 0) {
+                    // Send current record back to ring
+                    supply->publish(currentRingItem);
 
+                    // Get another empty record from ring
+                    currentRingItem = supply->get();
+                    currentRecord = currentRingItem->getRecord();
+                    currentRecord->getHeader()->setRecordNumber(recordNumber++);
+                }
 
-    /**
-     * Write an event (bank) into a record in evio/hipo version 6 format.
-     * Once the record is full and if writing to a file (for multiple compression
-     * threads), the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     * If writing to a buffer, once the record is full this method returns
-     * false - indicating that the last event was NOT written to the record.
-     * To finish the writing process, call {@link #close()}. This will
-     * compress the data if desired and then write it to the buffer.<p>
-     *
-     * The buffer must contain only the event's data (event header and event data)
-     * and must <b>not</b> be in complete evio file format.
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     * <b>kill</b> performance when writing to a file.
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * @param bankBuffer the bank (as a ByteBuffer object) to write.
-     * @param force      if writing to disk, force it to write event to the disk.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
-     *
-     * @return if writing to buffer: true if event was added to record, false if buffer full,
-     *         or record event count limit exceeded.
-     *
-     * @throws EvioException if error writing file
-     *                       if event is opposite byte order of internal buffer;
-     *                       if close() already called;
-     *                       if bad eventBuffer format;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing.
-     */
-    bool EventWriter::writeEvent(std::shared_ptr<ByteBuffer> & bankBuffer, bool force, bool ownRecord) {
-        return writeEvent(nullptr, bankBuffer, force, ownRecord);
-    }
+                // Guaranteed to fit
+                event = currentRecord->reserveEvent(maxBytes);
+            }
 
+            if (event == nullptr) {
+                throw EvioException("cannot fit event into buffer");
+            }
+        }
 
-    /**
-     * Write an event (bank) into a record in evio/hipo version 6 format.
-     * Once the record is full and if writing to a file (for multiple compression
-     * threads), the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     * If writing to a buffer, once the record is full this method returns
-     * false - indicating that the last event was NOT written to the record.
-     * To finish the writing process, call {@link #close()}. This will
-     * compress the data if desired and then write it to the buffer.<p>
-     *
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * Be warned that injudicious use of the 2nd arg, the force flag, will
-     * <b>kill</b> performance when writing to a file.
-     *
-     * @param bank   the bank to write.
-     * @param force  if writing to disk, force it to write event to the disk.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
-     * @return if writing to buffer: true if event was added to record, false if buffer full,
-     *         or record event count limit exceeded.
-     *
-     * @throws EvioException if error writing file
-     *                       if close() already called;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing;.
-     */
-    bool EventWriter::writeEvent(std::shared_ptr<EvioBank> bank, bool force, bool ownRecord) {
-        return writeEvent(bank, nullptr, force, ownRecord);
+        eventReserved = true;
+        reservedInBuffer = false;
+        reservedBytes = maxBytes;
+        reservedEvent = event;
+        return event;
     }
 
 
     /**
-     * Write an event (bank) into a record and eventually to a file in evio/hipo
-     * version 6 format.
-     * Once the record is full and if writing with multiple compression
-     * threads, the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     *
-     * <b>
-     * If splitting files, this method returns false if disk partition is too full
-     * to write the complete, next split file. If force arg is true, write anyway.
-     * DO NOT mix calling this method with calling
-     * {@link #writeEvent()} (all variants).
-     * Results are unpredictable as it messes up the
-     * logic used to quit writing to full disk.
-     * </b>
-     *
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     * <b>kill</b> performance when writing to a file.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * @param bank       the bank (as an EvioBank object) to write.
-     * @param force      if writing to disk, force it to write event to the disk.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
+     * Reserve space for the next event, as {@link #reserveEvent(uint32_t)} does,
+     * and wrap it in a buffer, of this writer's byte order, which can be given to a
+     * CompactEventBuilder. The buffer does not own its memory and must not be used after
+     * the event is committed.
      *
-     * @return true if event was added to record. If splitting files, false if disk
-     *         partition too full to write the complete, next split file.
-     *         False if interrupted. If force arg is true, write anyway.
-     *
-     * @throws EvioException if error writing file
-     *                       if event is opposite byte order of internal buffer;
-     *                       if close() already called;
-     *                       if bad eventBuffer format;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing;
+     * @param maxBytes max number of bytes the event may take.
+     * @return buffer of maxBytes bytes to write the event into; null if interrupted.
+     * @throws EvioException if close() already called;
+     *                       if an event is already reserved and not committed;
+     *                       if maxBytes is 0;
+     *                       if error writing file.
      */
-    bool EventWriter::writeEventToFile(std::shared_ptr<EvioBank> bank, bool force, bool ownRecord) {
-        return writeEventToFile(bank, nullptr, force, ownRecord);
+    std::shared_ptr<ByteBuffer> EventWriter::reserveEventBuffer(uint32_t maxBytes) {
+        uint8_t *event = reserveEvent(maxBytes);
+        if (event == nullptr) return nullptr;
+
+        // Memory belongs to the record (or reserve buffer), not to the returned buffer
+        auto buf = std::make_shared<ByteBuffer>(std::shared_ptr<uint8_t>(event, null_deleter), maxBytes);
+        buf->order(byteOrder);
+        return buf;
     }
 
 
     /**
-     * Write an event (bank) into a record in evio/hipo version 6 format.
-     * Once the record is full and if writing to a file (for multiple compression
-     * threads), the record will be sent to a thread which may compress the data,
-     * then it will be sent to a thread to write the record to file.
-     * If there is only 1 compression thread, it's all done in the thread which
-     * call this method.<p>
-     * If writing to a buffer, once the record is full this method returns
-     * false - indicating that the last event was NOT written to the record.
-     * To finish the writing process, call {@link #close()}. This will
-     * compress the data if desired and then write it to the buffer.<p>
+     * Add the event written into the space given by {@link #reserveEvent(uint32_t)}.
+     * The size must agree with the length in the event's bank header.
      *
-     * The event to be written may be in one of two forms.
-     * The first is as an EvioBank object and the second is as a ByteBuffer
-     * containing only the event's data (event header and event data) and must
-     * <b>not</b> be in complete evio file format.
-     * The first non-null of the bank arguments will be written.
-     * Do not call this while simultaneously calling
-     * close, flush, setFirstEvent, or getByteBuffer.<p>
-     *
-     * Be warned that injudicious use of a true 2nd arg, the force flag, will
-     *<b>kill</b> performance when writing to a file.<p>
-     *
-     * This method is not used to write the dictionary or the first event
-     * which are both placed in the common record which, in turn, is the
-     * user header part of the file header.<p>
-     *
-     * @param bank       the bank (as an EvioBank object) to write.
-     * @param bankBuffer the bank (as a ByteBuffer object) to write.
+     * @param eventBytes size of the event in bytes. If 0, the reservation is dropped
+     *                   and no event is added.
      * @param force      if writing to disk, force it to write event to the disk.
-     * @param ownRecord  if true, write event in its own record regardless
-     *                   of event count and record size limits.
-     *
-     * @return if writing to buffer: true if event was added to record, false if buffer full,
-     *         record event count limit exceeded, or bank and bankBuffer args are both null.
-     *
-     * @throws EvioException if error writing file;
-     *                       if event is opposite byte order of internal buffer;
-     *                       if bad bankBuffer format;
-     *                       if close() already called;
-     *                       if file could not be opened for writing;
-     *                       if file exists but user requested no over-writing.
+     * @return true if event was added, false if reservation dropped. If writing to a buffer,
+     *         false if buffer full or record event count limit exceeded.
+     * @throws EvioException if close() already called;
+     *                       if no event reserved;
+     *                       if eventBytes is larger than reserved, not a multiple of 4,
+     *                       or inconsistent with the event's length;
+     *                       if error writing file.
      */
-    bool EventWriter::writeEvent(std::shared_ptr<EvioBank> bank,
-                                 std::shared_ptr<ByteBuffer> bankBuffer,
-                                 bool force, bool ownRecord) {
+    bool EventWriter::commitEvent(uint32_t eventBytes, bool force) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
 
         if (closed) {
             throw EvioException("close() has already been called");
         }
 
-        bool fitInRecord;
-        bool splittingFile = false;
-        // See how much space the event will take up
-        size_t currentEventBytes;
-
-        // Which bank do we write?
-        if (bankBuffer != nullptr) {
-            if (bankBuffer->order() != byteOrder) {
-                throw EvioException("event buf is " + bankBuffer->order().getName() +
-                                    ", and writer is " + byteOrder.getName());
-            }
+        throwAgedRecordError();
 
-            // Event size in bytes (from buffer ready to read)
-            currentEventBytes = bankBuffer->remaining();
+        if (!eventReserved) {
+            throw EvioException("no event reserved");
+        }
 
-            // Size must be multiple of 4 bytes (whole 32-bit ints)
-            // The following is the equivalent of the mod operation:
-            //  (currentEventBytes % 4 != 0) but is much faster (x mod 2^n == x & (2^n - 1))
-            if ((currentEventBytes & 3) != 0) {
-                throw EvioException("bad bankBuffer format");
-            }
+        eventReserved = false;
 
-            // Check for inconsistent lengths
-            if (currentEventBytes != 4 * (bankBuffer->getUInt(bankBuffer->position()) + 1)) {
-                throw EvioException("inconsistent event lengths: total bytes from event = " +
-                                            std::to_string(4*(bankBuffer->getUInt(bankBuffer->position()) + 1)) +
-                                    ", from buffer = " + std::to_string(currentEventBytes));
+        if (eventBytes == 0) {
+            if (!reservedInBuffer) {
+                currentRecord->commitEvent(0);
             }
-        }
-        else if (bank != nullptr) {
-            currentEventBytes = bank->getTotalBytes();
-        }
-        else {
             return false;
         }
 
-        // If writing to buffer, we're not multi-threading compression & writing.
-        // Do it all in this thread, right now.
-        if (!toFile) {
-            return writeToBuffer(bank, bankBuffer);
+        if (eventBytes > reservedBytes || (eventBytes & 3) != 0 || eventBytes < 8) {
+            if (!reservedInBuffer) {
+                currentRecord->commitEvent(0);
+            }
+            throw EvioException("bad event size, " + std::to_string(eventBytes) + " bytes, " +
+                                std::to_string(reservedBytes) + " reserved");
         }
 
-        // If here, we're writing to a file ...
-
-        // If we're splitting files,
-        // we must have written at least one real event before we
-        // can actually split the file.
-        if ((split > 0) && (splitEventCount > 0)) {
-            // Is event, along with the previous events, large enough to split the file?
-            // For simplicity ignore the headers which will take < 2Kb.
-            // Take any compression roughly into account.
-            uint64_t totalSize = (currentEventBytes + splitEventBytes)*compressionFactor/100;
-
-            // If we're going to split the file, set a couple flags
-            if (totalSize > split) {
-                //                std::cout << "Split at total size = " << totalSize <<
-                //                                   ", ev = " << currentEventBytes <<
-                //                                   ", prev = " << splitEventBytes <<
-                //                                   ", compressed data = " <<
-                //                                   ((currentEventBytes + splitEventBytes)*compressionFactor/100) << std::endl;
-                splittingFile = true;
+        // Check for inconsistent lengths
+        uint32_t len = *reinterpret_cast<uint32_t *>(reservedEvent);
+        if (!byteOrder.isLocalEndian()) {
+            len = SWAP_32(len);
+        }
+        if (eventBytes != 4*(len + 1)) {
+            if (!reservedInBuffer) {
+                currentRecord->commitEvent(0);
             }
+            throw EvioException("inconsistent event lengths: total bytes from event = " +
+                                std::to_string(4*(len + 1)) + ", committed = " + std::to_string(eventBytes));
         }
 
-        // First, if multithreaded write, check for any errors that may have
-        // occurred asynchronously in the write or one of the compression threads.
-        if (!singleThreadedCompression && supply->haveError()) {
-            // Wake up any of these threads waiting for another record
-            supply->errorAlert();
-            throw EvioException(supply->getError());
+        if (reservedInBuffer) {
+            reserveBuffer->limit(eventBytes).position(0);
+            return writeEvent(reserveBuffer, force);
         }
 
+        currentRecord->commitEvent(eventBytes);
+
         // Including this event, this is the total data size & event count
         // for this split file.
-        splitEventBytes += currentEventBytes;
+        splitEventBytes += eventBytes;
         splitEventCount++;
 
-        // If event is big enough to split the file ...
-        if (splittingFile) {
+        // If event must be physically written to disk ...
+        if (force) {
             if (singleThreadedCompression) {
                 try {
-                    compressAndWriteToFile(false);
+                    compressAndWriteToFile(force);
                 }
                 catch (boost::thread_interrupted & e) {
                     return false;
@@ -2177,142 +3209,266 @@ namespace evio {
                 catch (std::exception & e) {
                     throw EvioException(e);
                 }
-
-                splitFile();
             }
             else {
-                // Set flag to split file
-                currentRingItem->splitFileAfterWrite(true);
-                //currentRecord->getHeader().setRecordNumber(recordNumber);
-                // Send current record back to ring without adding event
+                // Tell writer to force this record to disk
+                currentRingItem->forceToDisk(force);
+                // Send current record back to ring
                 supply->publish(currentRingItem);
 
-                // Get another empty record from ring.
-                // Record number reset for new file.
-                recordNumber = 1;
+                // Get another empty record from ring
                 currentRingItem = supply->get();
                 currentRecord = currentRingItem->getRecord();
                 currentRecord->getHeader()->setRecordNumber(recordNumber++);
-                //std::cout << "writeEvent: split after just published rec, new rec# = 1, next = " << recordNumber << std::endl;
-                // Reset record number for records coming after this one
             }
-
-            // Reset split-tracking variables
-            splitEventBytes = 0L;
-            splitEventCount = 0;
         }
 
-        // If event to be written in its own record
-        if (ownRecord) {
-            fitInRecord = false;
-        }
-        // Try adding event to current record.
-        // One event is guaranteed to fit in a record no matter the size,
-        // IFF using multithreaded compression.
-        else if (bankBuffer != nullptr) {
-            fitInRecord = currentRecord->addEvent(bankBuffer);
+        return true;
+    }
+
+
+    /**
+     * Write a batch of events, each in its own buffer, into records in evio/hipo
+     * version 6 format. The result is the same as calling
+     * {@link #writeEvent(std::shared_ptr<ByteBuffer> &, bool, bool)} for each event,
+     * but it's faster for small events. Events are added to the current record
+     * one after the other, and the checks made for every call of writeEvent
+     * (errors in other threads, file splitting, compression dictionary training)
+     * are made once per record. The event which does not fit in the current record,
+     * or which splits the file, is written by writeEvent.<p>
+     *
+     * Each buffer must contain only one event's data (event header and event data),
+     * from its position to its limit, which are not changed.
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.
+     *
+     * @param events  events to write.
+     * @param force   if writing to disk, force the record with the last event to the disk.
+     * @return number of events written. If writing to buffer, less than all
+     *         if buffer full or record event count limit exceeded. Less than all if interrupted.
+     *
+     * @throws EvioException if error writing file;
+     *                       if an event is opposite byte order of internal buffer;
+     *                       if bad event format;
+     *                       if close() already called;
+     *                       if an event is reserved and not committed;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing.
+     */
+    size_t EventWriter::writeEvents(const std::vector<std::shared_ptr<ByteBuffer>> & events, bool force) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {
+            throw EvioException("close() has already been called");
         }
-        else {
-            fitInRecord = currentRecord->addEvent(bank);
+
+        throwAgedRecordError();
+
+        if (eventReserved) {
+            throw EvioException("reserved event not committed");
         }
 
-        // If no room or too many events ...
-        if (!fitInRecord) {
-            if (singleThreadedCompression) {
-                // Only try to write what we have if there's something to write
-                if (currentRecord->getEventCount() > 0) {
-                    try {
-                        compressAndWriteToFile(false);
+        size_t count = events.size();
+        size_t i = 0;
+
+        while (i < count) {
+
+            // Writing to a buffer or training a dictionary is done one event at a time
+            if (toFile && trainingEventCount == 0) {
+                if (!singleThreadedCompression && supply->haveError()) {
+                    // Wake up any of these threads waiting for another record
+                    supply->errorAlert();
+                    throw EvioException(supply->getError());
+                }
+
+                // Fill the current record with the events that fit, while not splitting the file
+                for (; i < count; i++) {
+                    auto & buf = events[i];
+
+                    if (buf->order() != byteOrder) {
+                        throw EvioException("event buf is " + buf->order().getName() +
+                                            ", and writer is " + byteOrder.getName());
                     }
-                    catch (boost::thread_interrupted &e) {
-                        return false;
+
+                    uint32_t eventBytes = buf->remaining();
+                    if ((eventBytes & 3) != 0) {
+                        throw EvioException("bad bankBuffer format");
                     }
-                    catch (std::exception &e) {
-                        throw EvioException(e);
+                    if (eventBytes != 4 * (buf->getUInt(buf->position()) + 1)) {
+                        throw EvioException("inconsistent event lengths: total bytes from event = " +
+                                            std::to_string(4*(buf->getUInt(buf->position()) + 1)) +
+                                            ", from buffer = " + std::to_string(eventBytes));
                     }
 
-                    // Try add eventing to it (1 very big event many not fit)
-                    if (bankBuffer != nullptr) {
-                        fitInRecord = currentRecord->addEvent(bankBuffer);
+                    if ((split > 0) && (splitEventCount > 0) &&
+                        ((eventBytes + splitEventBytes)*compressionFactor/100 > split)) {
+                        break;
                     }
-                    else {
-                        fitInRecord = currentRecord->addEvent(bank);
+
+                    if (!currentRecord->addEvent(*buf)) {
+                        break;
                     }
+
+                    splitEventBytes += eventBytes;
+                    splitEventCount++;
                 }
 
-                // Since we're here, we have a single event too big to fit in the
-                // allocated buffers. So expand buffers and try again.
-                if (!fitInRecord) {
-//std::cout << "writeEventToFile: expand buffers to " << (currentEventBytes/10*12) << "  bytes" << std::endl;
-                    expandInternalBuffers(currentEventBytes);
+                if (i == count) break;
+            }
 
-                    if (bankBuffer != nullptr) {
-                        fitInRecord = currentRecord->addEvent(bankBuffer);
+            // This event starts a new record or file, or is not written to a record of a file
+            auto buf = events[i];
+            if (!writeEvent(nullptr, buf, false, false)) {
+                return i;
+            }
+            i++;
+        }
+
+        if (force && count > 0 && !forceCurrentRecord()) {
+            return count - 1;
+        }
+
+        return count;
+    }
+
+
+    /**
+     * Write a batch of events, each given as a node, into records in evio/hipo
+     * version 6 format. The result is the same as calling
+     * {@link #writeEvent(std::shared_ptr<EvioNode> &, bool, bool, bool)} for each event,
+     * but it's faster for small events. Events are copied from their backing buffers
+     * straight into the current record, one after the other, and the checks made for
+     * every call of writeEvent are made once per record. The event which does not fit
+     * in the current record, or which splits the file, is written by writeEvent.
+     * The positions and limits of the nodes' buffers are not changed.<p>
+     *
+     * Do not call this while simultaneously calling
+     * close, flush, setFirstEvent, or getByteBuffer.
+     *
+     * @param nodes  events to write.
+     * @param force  if writing to disk, force the record with the last event to the disk.
+     * @return number of events written. If writing to buffer, less than all
+     *         if buffer full or record event count limit exceeded. Less than all if interrupted.
+     *
+     * @throws EvioException if error writing file;
+     *                       if an event is opposite byte order of internal buffer;
+     *                       if close() already called;
+     *                       if an event is reserved and not committed;
+     *                       if file could not be opened for writing;
+     *                       if file exists but user requested no over-writing.
+     */
+    size_t EventWriter::writeEvents(const std::vector<std::shared_ptr<EvioNode>> & nodes, bool force) {
+
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
+        if (closed) {
+            throw EvioException("close() has already been called");
+        }
+
+        throwAgedRecordError();
+
+        if (eventReserved) {
+            throw EvioException("reserved event not committed");
+        }
+
+        size_t count = nodes.size();
+        size_t i = 0;
+
+        while (i < count) {
+
+            // Writing to a buffer or training a dictionary is done one event at a time
+            if (toFile && trainingEventCount == 0) {
+                if (!singleThreadedCompression && supply->haveError()) {
+                    // Wake up any of these threads waiting for another record
+                    supply->errorAlert();
+                    throw EvioException(supply->getError());
+                }
+
+                // Fill the current record with the events that fit, while not splitting the file
+                for (; i < count; i++) {
+                    auto & node = nodes[i];
+                    auto bb = node->getBuffer();
+
+                    if (bb->order() != byteOrder) {
+                        throw EvioException("event buf is " + bb->order().getName() +
+                                            ", and writer is " + byteOrder.getName());
                     }
-                    else {
-                        fitInRecord = currentRecord->addEvent(bank);
+
+                    uint32_t eventBytes = node->getTotalBytes();
+
+                    if ((split > 0) && (splitEventCount > 0) &&
+                        ((eventBytes + splitEventBytes)*compressionFactor/100 > split)) {
+                        break;
                     }
 
-                    if (!fitInRecord) {
-                        throw EvioException("cannot fit event into buffer");
+                    if (!currentRecord->addEvent(bb->array() + bb->arrayOffset() + node->getPosition(),
+                                                 eventBytes)) {
+                        break;
                     }
-//std::cout << "writeEventToFile: EVENT FINALLY FIT!" << std::endl;
-                }
-            }
-            else {
-                // This "if" is only needed since we may want event in its own record
-                if (currentRecord->getEventCount() > 0) {
-                    // Send current record back to ring without adding event
-                    supply->publish(currentRingItem);
 
-                    // Get another empty record from ring
-                    currentRingItem = supply->get();
-                    currentRecord = currentRingItem->getRecord();
-                    currentRecord->getHeader()->setRecordNumber(recordNumber++);
-//std::cout << "writeEvent: just published rec, new rec# = " << (recordNumber - 1) << ", next = " << recordNumber << std::endl;
+                    splitEventBytes += eventBytes;
+                    splitEventCount++;
                 }
 
-                // Add event to it (guaranteed to fit)
-                if (bankBuffer != nullptr) {
-                    currentRecord->addEvent(bankBuffer);
-                }
-                else {
-                    currentRecord->addEvent(bank);
-                }
+                if (i == count) break;
             }
-        }
 
-        // If event must be physically written to disk,
-        // or the event must be written in its own record ...
-        if (force || ownRecord) {
-            if (singleThreadedCompression) {
-                try {
-                    compressAndWriteToFile(force);
-                }
-                catch (boost::thread_interrupted & e) {
-                    return false;
-                }
-                catch (std::exception & e) {
-                    throw EvioException(e);
-                }
+            // This event starts a new record or file, or is not written to a record of a file
+            auto node = nodes[i];
+            if (!writeEvent(node, false, true, false)) {
+                return i;
             }
-            else {
-                // Tell writer to force this record to disk
-                currentRingItem->forceToDisk(force);
-                // Send current record back to ring
-                supply->publish(currentRingItem);
+            i++;
+        }
 
-                // Get another empty record from ring
-                currentRingItem = supply->get();
-                currentRecord = currentRingItem->getRecord();
-                currentRecord->getHeader()->setRecordNumber(recordNumber++);
-//std::cout << "writeEvent: FORCED published rec, new rec# = " << (recordNumber - 1) << ", next = " << recordNumber << std::endl;
+        if (force && count > 0 && !forceCurrentRecord()) {
+            return count - 1;
+        }
+
+        return count;
+    }
+
+
+    /**
+     * Send the current record, if it has events, to be written and forced to disk.
+     * Does nothing if writing to a buffer or training a compression dictionary.
+     * @return false if interrupted, else true.
+     * @throws EvioException if error writing file.
+     */
+    bool EventWriter::forceCurrentRecord() {
+
+        if (!toFile || trainingEventCount > 0 || currentRecord->getEventCount() < 1) {
+            return true;
+        }
+
+        if (singleThreadedCompression) {
+            try {
+                compressAndWriteToFile(true);
+            }
+            catch (boost::thread_interrupted & e) {
+                return false;
             }
+            catch (std::exception & e) {
+                throw EvioException(e);
+            }
+        }
+        else {
+            // Tell writer to force this record to disk
+            currentRingItem->forceToDisk(true);
+            // Send current record back to ring
+            supply->publish(currentRingItem);
+
+            // Get another empty record from ring
+            currentRingItem = supply->get();
+            currentRecord = currentRingItem->getRecord();
+            currentRecord->getHeader()->setRecordNumber(recordNumber++);
         }
 
         return true;
     }
 
+
     /**
      * Write an event (bank) into a record and eventually to a file in evio/hipo
      * version 6 format.
@@ -2370,10 +3526,14 @@ namespace evio {
                                        std::shared_ptr<ByteBuffer> bankBuffer,
                                        bool force, bool ownRecord) {
 
+        RecordFlushTimer::Guard guard(flushTimer.get());
+
         if (closed) {
             throw EvioException("close() has already been called");
         }
 
+        throwAgedRecordError();
+
         if (!toFile) {
             throw EvioException("cannot write to buffer with this method");
         }
@@ -2447,6 +3607,11 @@ namespace evio {
             throw EvioException("both buffer args are null");
         }
 
+        // Hold events back until the compression dictionary is trained
+        if (trainingEventCount > 0) {
+            return addTrainingEvent(bank, bankBuffer);
+        }
+
         // If we're splitting files,
         // we must have written at least one real event before we
         // can actually split the file.
@@ -2702,20 +3867,21 @@ namespace evio {
      * Used when doing compression & writing to file in a single thread.
      *
      * @param force  if true, force writing event physically to disk.
+     * @param flush  if true, flush the record out of the file's write buffer once written.
      *
      * @throws EvioException if this object already closed;
      *                       if file could not be opened for writing;
      *                       if file exists but user requested no over-writing;
      *                       if error opening/writing/forcing write to file.
      */
-    void EventWriter::compressAndWriteToFile(bool force) {
+    void EventWriter::compressAndWriteToFile(bool force, bool flush) {
 
         auto header = currentRecord->getHeader();
         header->setRecordNumber(recordNumber);
         header->setCompressionType(compressionType);
         currentRecord->build();
         // Resets currentRecord too
-        writeToFile(force, false);
+        writeToFile(force, false, flush);
     }
 
 
@@ -2757,6 +3923,7 @@ namespace evio {
      *                  not enough free space on the disk partition for the
      *                  complete intended file, return false without creating or
      *                  writing to file. If force arg is true, write anyway.
+     * @param flush if true, flush the record out of the file's write buffer once written.
      *
      * @return true if everything normal; false if a new file needs to be created
      *         (first write after a split) but there is not enough free space on
@@ -2766,7 +3933,7 @@ namespace evio {
      *                       if file exists but user requested no over-writing;
      *                       if error opening/writing/forcing write to file.
      */
-    bool EventWriter::writeToFile(bool force, bool checkDisk) {
+    bool EventWriter::writeToFile(bool force, bool checkDisk, bool flush) {
         if (closed) {
             throw EvioException("close() has already been called");
         }
@@ -2785,10 +3952,16 @@ namespace evio {
             }
 
             // New shared pointer for each file ...
-            asyncFileChannel = std::make_shared<std::fstream>();
-            asyncFileChannel->open(currentFileName, std::ios::binary | std::ios::trunc | std::ios::out);
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error opening file " + currentFileName);
+            if (directIO) {
+                directFile = std::make_shared<DirectFile>();
+                directFile->open(currentFileName);
+            }
+            else {
+                asyncFileChannel = std::make_shared<std::fstream>();
+                asyncFileChannel->open(currentFileName, std::ios::binary | std::ios::trunc | std::ios::out);
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error opening file " + currentFileName);
+                }
             }
 
             // Right now file is open for writing
@@ -2845,9 +4018,11 @@ namespace evio {
         future1 = std::make_shared<std::future<void>>(std::future<void>(
                 std::async(std::launch::async,  // run in a separate thread
                            staticWriteFunction, // function to run
-                           this,                // arguments to function ...
+                           asyncFileChannel,    // arguments to function ...
+                           directFile,
                            reinterpret_cast<const char *>(buf->array()),
-                           bytesToWrite)));
+                           bytesToWrite,
+                           flush)));
 
         // Keep track of which buffer future1 used so it can be reused when done
         usedBuffer = buf;
@@ -2862,7 +4037,16 @@ namespace evio {
 
         // Force it to write to physical disk (KILLS PERFORMANCE!!!)
         // TODO: This may not work since data may NOT have been written yet!
-        if (force) asyncFileChannel->sync();
+        if (force) {
+            if (directIO) {
+                // The write must finish first since it's not thread safe
+                future1->wait();
+                directFile->sync();
+            }
+            else {
+                asyncFileChannel->sync();
+            }
+        }
 
         // Keep track of what is written to this, one, file
         recordNumber++;
@@ -2910,10 +4094,16 @@ namespace evio {
             //std::cout << "Creating channel to " << currentFileName << std::endl;
 
             // New shared pointer for each file ...
-            asyncFileChannel = std::make_shared<std::fstream>();
-            asyncFileChannel->open(currentFileName, std::ios::binary | std::ios::trunc | std::ios::out);
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error opening file " + currentFileName);
+            if (directIO) {
+                directFile = std::make_shared<DirectFile>();
+                directFile->open(currentFileName);
+            }
+            else {
+                asyncFileChannel = std::make_shared<std::fstream>();
+                asyncFileChannel->open(currentFileName, std::ios::binary | std::ios::trunc | std::ios::out);
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error opening file " + currentFileName);
+                }
             }
 
             // Right now file is open for writing
@@ -2950,9 +4140,6 @@ namespace evio {
         // Trailer's index has count following length
         recordLengths->push_back(eventCount);
 
-        // Data to write
-        auto buf = record->getBinaryBuffer();
-
         if (noFileWriting) {
             future1 = std::make_shared<std::future<void>>(std::future<void>(
                     std::async(std::launch::async,
@@ -2961,12 +4148,14 @@ namespace evio {
 
         }
         else {
+            // Data to write, events of uncompressed records are not in the binary buffer
             future1 = std::make_shared<std::future<void>>(std::future<void>(
-                    std::async(std::launch::async,  // run in a separate thread
-                               staticWriteFunction,        // function to run
-                               this,                       // arguments to function ...
-                               reinterpret_cast<const char *>(buf->array()),
-                               bytesToWrite)));
+                    std::async(std::launch::async,      // run in a separate thread
+                               staticWriteSegmentsFunction,    // function to run
+                               asyncFileChannel,               // arguments to function ...
+                               directFile,
+                               record->getWriteSegments(),
+                               item->flushAfterWrite())));
         }
 
         ringItem1 = item;
@@ -2975,7 +4164,16 @@ namespace evio {
         // but don't bother writing the metadata (arg to force()) since that slows it
         // down even more.
         // TODO: This may not work since data may NOT have been written yet!
-        if (force) asyncFileChannel->sync();
+        if (force) {
+            if (directIO) {
+                // The write must finish first since it's not thread safe
+                future1->wait();
+                directFile->sync();
+            }
+            else {
+                asyncFileChannel->sync();
+            }
+        }
 
         // Keep track of what is written to this, one, file
         //recordNumber++;
@@ -3017,12 +4215,26 @@ namespace evio {
             // Finish writing data & trailer and then close existing file -
             // all in a separate thread for speed. Copy over values so they
             // don't change in the meantime.
-            fileCloser->closeAsyncFile(asyncFileChannel, future1, supply, ringItem1,
+
+            // Single threaded, the next write still gets future1's result,
+            // so the closer can't wait on it. Let the write finish here instead.
+            std::shared_ptr<std::future<void>> closerFuture = future1;
+            if (singleThreadedCompression) {
+                if (future1 != nullptr && future1->valid()) {
+                    future1->wait();
+                }
+                closerFuture = nullptr;
+            }
+
+            fileCloser->closeAsyncFile(asyncFileChannel, directFile, closerFuture, supply, ringItem1,
                                        fileHeader, recordLengths, bytesWritten,
                                        recordNumber,
                                        addingTrailer, addTrailerIndex,
                                        noFileWriting, byteOrder);
 
+            // Closer has its own reference, the next file gets a new one
+            directFile = nullptr;
+
             // Reset for next write
             if (!singleThreadedCompression) {
                 future1 = nullptr;
@@ -3081,6 +4293,10 @@ namespace evio {
      */
     void EventWriter::writeTrailerToFile(bool writeIndex) {
 
+        if (directIO && directFile == nullptr) {
+            throw EvioException("no file open for writing trailer");
+        }
+
         // Keep track of where we are right now which is just before trailer
         uint64_t trailerPosition = bytesWritten;
 
@@ -3092,11 +4308,16 @@ namespace evio {
             // this write completes since it'll just complicate the code.
             // As this is the absolute last write to the file,
             // just make sure it gets done right here.
-            asyncFileChannel->seekg(fileWritingPosition);
-            asyncFileChannel->write(reinterpret_cast<char *>(headerArray.data()),
-                                    RecordHeader::HEADER_SIZE_BYTES);
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error writing to  file " + currentFileName);
+            if (directIO) {
+                directFile->write(headerArray.data(), RecordHeader::HEADER_SIZE_BYTES);
+            }
+            else {
+                asyncFileChannel->seekg(fileWritingPosition);
+                asyncFileChannel->write(reinterpret_cast<char *>(headerArray.data()),
+                                        RecordHeader::HEADER_SIZE_BYTES);
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error writing to  file " + currentFileName);
+                }
             }
         }
         else {
@@ -3115,11 +4336,16 @@ namespace evio {
 
             //std::cout << "\nwriteTrailerToFile: file pos = " << asyncFileChannel->tellg() << ", fileWritingPOsition = " <<
             //                 fileWritingPosition << std::endl;
-            // TODO: is this seekg really necessary?
-            asyncFileChannel->seekg(fileWritingPosition);
-            asyncFileChannel->write(reinterpret_cast<char *>(headerArray.data()), bytesToWrite);
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error writing to  file " + currentFileName);
+            if (directIO) {
+                directFile->write(headerArray.data(), bytesToWrite);
+            }
+            else {
+                // TODO: is this seekg really necessary?
+                asyncFileChannel->seekg(fileWritingPosition);
+                asyncFileChannel->write(reinterpret_cast<char *>(headerArray.data()), bytesToWrite);
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error writing to  file " + currentFileName);
+                }
             }
 
             //            asyncFileChannel->flush();
@@ -3131,24 +4357,35 @@ namespace evio {
         if (!byteOrder.isLocalEndian()) {
             trailerPosition = SWAP_64(trailerPosition);
         }
-        asyncFileChannel->seekg(FileHeader::TRAILER_POSITION_OFFSET);
-        asyncFileChannel->write(reinterpret_cast<char *>(&trailerPosition), sizeof(trailerPosition));
-        if (asyncFileChannel->fail()) {
-            throw EvioException("error writing to  file " + currentFileName);
+        if (directIO) {
+            directFile->writeAt(FileHeader::TRAILER_POSITION_OFFSET, &trailerPosition, sizeof(trailerPosition));
+        }
+        else {
+            asyncFileChannel->seekg(FileHeader::TRAILER_POSITION_OFFSET);
+            asyncFileChannel->write(reinterpret_cast<char *>(&trailerPosition), sizeof(trailerPosition));
+            if (asyncFileChannel->fail()) {
+                throw EvioException("error writing to  file " + currentFileName);
+            }
         }
 
         // Update file header's bit-info word
         if (addTrailerIndex) {
-            uint32_t bitInfo = fileHeader.setBitInfo(fileHeader.hasFirstEvent(),
-                                                     fileHeader.hasDictionary(),
-                                                     true);
+            fileHeader.setBitInfo(fileHeader.hasFirstEvent(),
+                                  fileHeader.hasDictionary(),
+                                  true);
+            uint32_t bitInfo = fileHeader.hasCompressionDictionary(compressionDictionary != nullptr);
             if (!byteOrder.isLocalEndian()) {
                 bitInfo = SWAP_32(bitInfo);
             }
-            asyncFileChannel->seekg(FileHeader::BIT_INFO_OFFSET);
-            asyncFileChannel->write(reinterpret_cast<char *>(&bitInfo), sizeof(bitInfo));
-            if (asyncFileChannel->fail()) {
-                throw EvioException("error writing to  file " + currentFileName);
+            if (directIO) {
+                directFile->writeAt(FileHeader::BIT_INFO_OFFSET, &bitInfo, sizeof(bitInfo));
+            }
+            else {
+                asyncFileChannel->seekg(FileHeader::BIT_INFO_OFFSET);
+                asyncFileChannel->write(reinterpret_cast<char *>(&bitInfo), sizeof(bitInfo));
+                if (asyncFileChannel->fail()) {
+                    throw EvioException("error writing to  file " + currentFileName);
+                }
             }
         }
 
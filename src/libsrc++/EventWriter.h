@@ -53,6 +53,8 @@
 #include "EvioException.h"
 #include "EvioBank.h"
 #include "FileWritingSupport.h"
+#include "DirectFile.h"
+#include "RecordFlushTimer.h"
 
 
 //#include "Disruptor/Util.h"
@@ -169,6 +171,8 @@ namespace evio {
             std::shared_ptr<RecordSupply> supply;
             /** Thread which does the file writing. */
             boost::thread thd;
+            /** CPUs the thread may run on, empty for any. */
+            std::vector<int> cpus;
             /** The highest sequence to have been currently processed. */
             std::atomic_long lastSeqProcessed{-1};
 
@@ -193,7 +197,8 @@ namespace evio {
             RecordWriter(RecordWriter && obj) noexcept :
                     writer(obj.writer),
                     supply(std::move(obj.supply)),
-                    thd(std::move(obj.thd)) {
+                    thd(std::move(obj.thd)),
+                    cpus(std::move(obj.cpus)) {
 
                 lastSeqProcessed.store(obj.lastSeqProcessed);
             }
@@ -204,6 +209,7 @@ namespace evio {
                     lastSeqProcessed.store(obj.lastSeqProcessed);
                     supply = std::move(obj.supply);
                     thd  = std::move(obj.thd);
+                    cpus = std::move(obj.cpus);
                 }
                 return *this;
             }
@@ -218,9 +224,20 @@ namespace evio {
                 }
             }
 
+            /**
+             * Set the CPUs the thread may run on. If it's already running, it's pinned now,
+             * else when started.
+             * @param cpuSet CPUs to run on, empty for any.
+             */
+            void setCpus(std::vector<int> const & cpuSet) {
+                cpus = cpuSet;
+                ThreadPlacement::pinThread(thd, cpus);
+            }
+
             /** Create and start a thread to execute the run() method of this class. */
             void startThread() {
                 thd = boost::thread([this]() {this->run();});
+                ThreadPlacement::pinThread(thd, cpus);
             }
 
             /** Stop the thread. */
@@ -376,8 +393,8 @@ namespace evio {
                                 writer->splitFile();
                             }
 
-                            // Release back to supply
-                            supply->releaseWriter(item);
+                            // Item is released back to supply once its write is done,
+                            // by writeToFileMT() on the next write or by the file closer
                         }
                     }
                 }
@@ -420,7 +437,7 @@ namespace evio {
         uint32_t maxSupplyBytes = 0;
 
         /** Type of compression being done on data
-         *  (0=none, 1=LZ4fastest, 2=LZ4best, 3=gzip). */
+         *  (0=none, 1=LZ4fastest, 2=LZ4best, 3=gzip, 4=zstd). */
         Compressor::CompressionType compressionType{Compressor::UNCOMPRESSED};
 
         /** The estimated ratio of compressed to uncompressed data.
@@ -452,6 +469,28 @@ namespace evio {
          *  Easier to use vector here so we don't have to construct it immediately. */
         std::vector<EventWriter::RecordWriter> recordWriterThread;
 
+        /** CPUs the compression threads may run on, empty for any. */
+        std::vector<int> compressorCpus;
+
+        /** CPUs the writing thread may run on, empty for any. */
+        std::vector<int> writerCpus;
+
+        /** Is space reserved for an event by reserveEvent and not yet committed? */
+        bool eventReserved = false;
+
+        /** Is the reserved event in reserveBuffer, instead of directly in the current record? */
+        bool reservedInBuffer = false;
+
+        /** Number of bytes reserved for the event. */
+        uint32_t reservedBytes = 0;
+
+        /** Start of the reserved event. */
+        uint8_t *reservedEvent = nullptr;
+
+        /** Holds a reserved event when it cannot be written into the current record:
+         *  when writing to a buffer or while training a compression dictionary. */
+        std::shared_ptr<ByteBuffer> reserveBuffer;
+
         /** Number of records written to split-file/buffer at current moment. */
         uint32_t recordsWritten = 0;
 
@@ -474,6 +513,24 @@ namespace evio {
         /** <code>True</code> if we have a "first event" to be written, else <code>false</code>. */
         bool haveFirstEvent = false;
 
+        /**
+         * Dictionary records are compressed with, if any. It's stored in the common record,
+         * after any xml dictionary and first event.
+         */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+        /** Number of events to train a compression dictionary with. 0 if not training. */
+        uint32_t trainingEventCount = 0;
+
+        /** Max size in bytes of the compression dictionary to train. */
+        uint32_t trainingDictionaryBytes = CompressionDictionary::DEFAULT_BYTES;
+
+        /** Events held back, while training a compression dictionary, until it's ready. */
+        std::vector<std::vector<uint8_t>> trainingEvents;
+
+        /** Chooses the type of compression for each record, if any. */
+        std::shared_ptr<AdaptiveCompression> adaptiveCompression;
+
         /** <code>True</code> if {@link #close()} was called, else <code>false</code>. */
         bool closed = false;
 
@@ -577,6 +634,12 @@ namespace evio {
         /** The asynchronous file channel, used for writing a file. */
         std::shared_ptr<std::fstream> asyncFileChannel = nullptr;
 
+        /** Write files with direct I/O through directFile instead of asyncFileChannel? */
+        bool directIO = false;
+
+        /** File being written with direct I/O, null if none. */
+        std::shared_ptr<DirectFile> directFile = nullptr;
+
         /** The location of the next write in the file. */
         uint64_t fileWritingPosition = 0ULL;
 
@@ -656,6 +719,24 @@ namespace evio {
         bool noFileWriting = false;
         //-----------------------
 
+        /** Max time in milliseconds a partially filled record waits before being written, 0 for no limit. */
+        uint32_t maxRecordAge = 0;
+
+        /** Record whose age is being tracked. Records are reused, so the record number is also kept. */
+        RecordOutput *agedRecord = nullptr;
+
+        /** Record number of the record whose age is being tracked. */
+        uint32_t agedRecordNumber = 0;
+
+        /** Time the first event was seen in the record whose age is being tracked. */
+        std::chrono::steady_clock::time_point agedRecordStart;
+
+        /** Error writing an old record in the timer's thread, thrown by the next call that writes. */
+        std::string agedRecordError;
+
+        /** Thread writing records older than maxRecordAge. Last member, so it's stopped first. */
+        std::unique_ptr<RecordFlushTimer> flushTimer;
+
 
     public:
 
@@ -680,7 +761,8 @@ namespace evio {
                     uint32_t splitIncrement = 1, uint32_t streamCount = 1,
                     Compressor::CompressionType compressionType = Compressor::UNCOMPRESSED,
                     uint32_t compressionThreads = 1, uint32_t ringSize = 0,
-                    size_t bufferSize = 32100000);
+                    size_t bufferSize = 32100000,
+                    RecordSupply::WaitStrategy waitStrategy = RecordSupply::SPIN_BACKOFF);
 
 
         //---------------------------------------------
@@ -697,7 +779,13 @@ namespace evio {
         void reInitializeBuffer(std::shared_ptr<ByteBuffer> & buf, const std::bitset<24> *bitInfo,
                                 uint32_t recordNumber, bool useCurrentBitInfo);
 
-        static void staticWriteFunction(EventWriter *pWriter, const char* data, size_t len);
+        static void staticWriteFunction(std::shared_ptr<std::fstream> file,
+                                        std::shared_ptr<DirectFile> dFile,
+                                        const char* data, size_t len, bool flush);
+        static void staticWriteSegmentsFunction(std::shared_ptr<std::fstream> file,
+                                                std::shared_ptr<DirectFile> dFile,
+                                                std::vector<RecordOutput::Segment> segments,
+                                                bool flush);
         static void staticDoNothingFunction(EventWriter *pWriter);
 
     public:
@@ -736,8 +824,34 @@ namespace evio {
         void setFirstEvent(std::shared_ptr<ByteBuffer> buf);
         void setFirstEvent(std::shared_ptr<EvioBank> bank);
 
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+        void trainCompressionDictionary(uint32_t eventCount,
+                                        uint32_t dictBytes = CompressionDictionary::DEFAULT_BYTES);
+        std::shared_ptr<CompressionDictionary> getCompressionDictionary() const;
+
+        void setAdaptiveCompression(double targetMBps,
+                                    std::vector<Compressor::CompressionType> types = {});
+        std::shared_ptr<AdaptiveCompression> getAdaptiveCompression() const;
+
+        void setDataFilter(DataFilter::FilterType type, uint32_t wordSize = 4);
+        void setThreadPlacement(std::vector<int> const & compressorCpus,
+                                std::vector<int> const & writerCpus = {});
+
+        void setDirectIO(bool direct);
+        bool isDirectIO() const;
+
+        void setMaxRecordAge(uint32_t millis);
+        uint32_t getMaxRecordAge() const;
+
     private:
 
+        void shipOldRecord();
+        void throwAgedRecordError();
+
+        void checkCompressionDictionaryAllowed();
+        bool addTrainingEvent(std::shared_ptr<EvioBank> & bank, std::shared_ptr<ByteBuffer> & bankBuffer);
+        void finishTraining();
+
         void createCommonRecord(const std::string & xmlDict,
                                 std::shared_ptr<EvioBank> firstBank,
                                 std::shared_ptr<EvioNode> firstNode,
@@ -778,8 +892,17 @@ namespace evio {
 
         bool writeEventToFile(std::shared_ptr<EvioBank> bank, bool force = false, bool ownRecord = false);
 
+        uint8_t * reserveEvent(uint32_t maxBytes);
+        std::shared_ptr<ByteBuffer> reserveEventBuffer(uint32_t maxBytes);
+        bool commitEvent(uint32_t eventBytes, bool force = false);
+
+        size_t writeEvents(const std::vector<std::shared_ptr<ByteBuffer>> & events, bool force = false);
+        size_t writeEvents(const std::vector<std::shared_ptr<EvioNode>> & nodes, bool force = false);
+
     private:
 
+        bool forceCurrentRecord();
+
         bool writeEvent(std::shared_ptr<EvioBank> bank,
                         std::shared_ptr<ByteBuffer> bankBuffer,
                         bool force, bool ownRecord);
@@ -789,10 +912,10 @@ namespace evio {
 
         bool fullDisk();
 
-        void compressAndWriteToFile(bool force);
+        void compressAndWriteToFile(bool force, bool flush = false);
         bool tryCompressAndWriteToFile(bool force);
 
-        bool writeToFile(bool force, bool checkDisk);
+        bool writeToFile(bool force, bool checkDisk, bool flush = false);
         void writeToFileMT(std::shared_ptr<RecordRingItem> item, bool force);
 
         void splitFile();
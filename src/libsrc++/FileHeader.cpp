@@ -430,6 +430,42 @@ namespace evio {
     }
 
 
+    /**
+     * Set the bit in the file header which says the user header has a compression dictionary.
+     * @param hasDict  true if user header has a compression dictionary.
+     * @return new bitInfo word.
+     */
+    uint32_t FileHeader::hasCompressionDictionary(bool hasDict) {
+        if (hasDict) {
+            // set bit
+            bitInfo |= COMPRESSION_DICTIONARY_BIT;
+        }
+        else {
+            // clear bit
+            bitInfo &= ~COMPRESSION_DICTIONARY_BIT;
+        }
+
+        return bitInfo;
+    }
+
+
+    /**
+     * Does this file have a compression dictionary in the user header?
+     * @return true if file has a compression dictionary in the user header, else false.
+     */
+    bool FileHeader::hasCompressionDictionary() const {return ((bitInfo & COMPRESSION_DICTIONARY_BIT) != 0);}
+
+
+    /**
+     * Does this bitInfo arg indicate the existence of a compression dictionary in the user header?
+     * @param bitInfo bitInfo word.
+     * @return true if file has a compression dictionary in the user header, else false.
+     */
+    bool FileHeader::hasCompressionDictionary(uint32_t bitInfo) {
+        return ((bitInfo & COMPRESSION_DICTIONARY_BIT) != 0);
+    }
+
+
     /**
      * Is this header followed by a user header?
      * @return true if header followed by a user header, else false.
@@ -736,6 +772,7 @@ namespace evio {
         ss << std::setw(24) << "has dictionary"   << " : " << hasDictionary() << std::endl;
         ss << std::setw(24) << "has firstEvent"   << " : " << hasFirstEvent() << std::endl;
         ss << std::setw(24) << "has trailer w/ index" << " : " << hasTrailerWithIndex() << std::endl;
+        ss << std::setw(24) << "has compression dict" << " : " << hasCompressionDictionary() << std::endl;
         ss << std::dec;
         ss << std::setw(24) << "record entries"   << " : " << entries << std::endl;
         ss << std::setw(24) << "index length"     << " : " << indexLength << std::endl;
@@ -72,7 +72,8 @@ namespace evio {
      *     8    = true if dictionary is included (relevant for first record only)
      *     9    = true if this file has "first" event (in every split file)
      *    10    = File trailer with index array of record lengths exists
-     *    11-19 = reserved
+     *    11    = true if user header has compression dictionary (in every split file)
+     *    12-19 = reserved
      *    20-21 = pad 1
      *    22-23 = pad 2
      *    24-25 = pad 3 (always 0)
@@ -141,6 +142,8 @@ namespace evio {
         static const uint32_t   FIRST_EVENT_BIT = 0x200;
         /** 10th bit set in bitInfo word in file header means file trailer with index array exists. */
         static const uint32_t   TRAILER_WITH_INDEX_BIT = 0x400;
+        /** 11th bit set in bitInfo word in file header means user header has compression dictionary. */
+        static const uint32_t   COMPRESSION_DICTIONARY_BIT = 0x800;
 
     private:
 
@@ -258,12 +261,16 @@ namespace evio {
         uint32_t hasTrailerWithIndex(bool hasTrailerWithIndex);
         bool     hasTrailerWithIndex() const;
 
+        uint32_t hasCompressionDictionary(bool hasDict);
+        bool     hasCompressionDictionary() const;
+
         bool hasUserHeader() const;
         bool hasIndex() const;
 
         static bool hasFirstEvent(uint32_t bitInfo);
         static bool hasDictionary(uint32_t bitInfo);
         static bool hasTrailerWithIndex(uint32_t bitInfo);
+        static bool hasCompressionDictionary(uint32_t bitInfo);
 
         // Setters
 
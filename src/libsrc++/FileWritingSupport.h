@@ -15,6 +15,8 @@
 #include <exception>
 #include <atomic>
 #include <future>
+#include <mutex>
+#include <algorithm>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 
@@ -22,6 +24,7 @@
 #include "RecordHeader.h"
 #include "RecordSupply.h"
 #include "EvioException.h"
+#include "DirectFile.h"
 
 
 #include <boost/thread.hpp>
@@ -45,6 +48,7 @@ namespace evio {
             // Store quantities from exterior classes or store quantities that
             // may change between when this object is created and when this thread is run.
             std::shared_ptr <std::fstream> afChannel;
+            std::shared_ptr <DirectFile> directFile;
             std::shared_ptr <std::future<void>> future;
             std::shared_ptr <RecordSupply> supply;
             std::shared_ptr <RecordRingItem> item;
@@ -73,6 +77,7 @@ namespace evio {
 
             /** Constructor.  */
             CloseAsyncFChan(std::shared_ptr <std::fstream> &afc,
+                            std::shared_ptr <DirectFile> &df,
                             std::shared_ptr <std::future<void>> &future1,
                             std::shared_ptr <RecordSupply> &supply,
                             std::shared_ptr <RecordRingItem> &ringItem,
@@ -81,11 +86,12 @@ namespace evio {
                             bool addingTrailer, bool writeIndex, bool noWriting,
                             ByteOrder &order, FileCloser *fc) :
 
-                    afChannel(afc), future(future1), supply(supply),
+                    afChannel(afc), directFile(df), future(future1), supply(supply),
                     item(ringItem), byteOrder(order) {
 
                 fHeader = fileHeader;
-                recLengths = recordLengths;
+                // Writer reuses its vector for the next file
+                recLengths = std::make_shared<std::vector<uint32_t>>(*recordLengths);
                 bytesWrittenToFile = bytesWritten;
                 recordNum = recordNumber;
                 addTrailer = addingTrailer;
@@ -132,8 +138,10 @@ namespace evio {
                         return;
                     }
 
-                    // If that didn't work, send Alert signal to ring
-                    supply->errorAlert();
+                    // If that didn't work, send Alert signal to ring (if writing with multiple threads)
+                    if (supply != nullptr) {
+                        supply->errorAlert();
+                    }
 
                     if (thd.joinable()) {
                         thd.join();
@@ -143,7 +151,7 @@ namespace evio {
 
                 try {
                     // When this thread is done, remove itself from vector
-                    closer->removeThread(sharedPtrOfMe);
+                    closer->removeThread(this);
                 }
                 catch (std::exception &e) {}
             }
@@ -167,10 +175,12 @@ namespace evio {
                     catch (std::exception &e) {}
                 }
 
-                // Release resources back to the ring
-                std::cout << "Closer: releaseWriterSequential, will release item seq = " << item->getSequence()
-                          << std::endl;
-                supply->releaseWriterSequential(item);
+                // Release resources back to the ring, if writing with multiple threads
+                if (item != nullptr) {
+                    std::cout << "Closer: releaseWriterSequential, will release item seq = " << item->getSequence()
+                              << std::endl;
+                    supply->releaseWriterSequential(item);
+                }
 
                 try {
                     if (addTrailer && !noFileWriting) {
@@ -180,7 +190,12 @@ namespace evio {
                 catch (std::exception &e) {}
 
                 try {
-                    afChannel->close();
+                    if (directFile != nullptr) {
+                        directFile->close();
+                    }
+                    else {
+                        afChannel->close();
+                    }
                 }
                 catch (std::exception &e) {
                     std::cout << e.what() << std::endl;
@@ -188,7 +203,7 @@ namespace evio {
 
                 try {
                     // When this thread is done, remove itself from vector
-                    closer->removeThread(sharedPtrOfMe);
+                    closer->removeThread(this);
                 }
                 catch (std::exception &e) {}
             }
@@ -218,11 +233,7 @@ namespace evio {
                     }
                     catch (EvioException &e) {/* never happen */}
 
-                    afChannel->write(reinterpret_cast<char *>(hdrArray),
-                                     RecordHeader::HEADER_SIZE_BYTES);
-                    if (afChannel->fail()) {
-                        throw EvioException("error writing to file");
-                    }
+                    write(hdrArray, RecordHeader::HEADER_SIZE_BYTES);
                 }
                 else {
                     // Write trailer with index
@@ -242,10 +253,7 @@ namespace evio {
                         RecordHeader::writeTrailer(hdrBuffer, (size_t) 0, recordNum, recLengths);
                     }
                     catch (EvioException &e) {/* never happen */}
-                    afChannel->write(reinterpret_cast<char *>(hdrArray), bytesToWrite);
-                    if (afChannel->fail()) {
-                        throw EvioException("error writing to file");
-                    }
+                    write(hdrArray, bytesToWrite);
                 }
 
                 // Update file header's trailer position word
@@ -253,25 +261,20 @@ namespace evio {
                     trailerPosition = SWAP_64(trailerPosition);
                 }
 
-                afChannel->seekg(FileHeader::TRAILER_POSITION_OFFSET);
-                afChannel->write(reinterpret_cast<char *>(&trailerPosition), sizeof(trailerPosition));
-                if (afChannel->fail()) {
-                    throw EvioException("error writing to file");
-                }
+                writeAt(FileHeader::TRAILER_POSITION_OFFSET, &trailerPosition, sizeof(trailerPosition));
 
                 // Update file header's bit-info word
                 if (writeIndx) {
-                    uint32_t bitInfo = fHeader.setBitInfo(fHeader.hasFirstEvent(),
-                                                          fHeader.hasDictionary(),
-                                                          true);
+                    // setBitInfo clears the compression dictionary bit, so put it back
+                    bool hasCompDict = fHeader.hasCompressionDictionary();
+                    fHeader.setBitInfo(fHeader.hasFirstEvent(),
+                                       fHeader.hasDictionary(),
+                                       true);
+                    uint32_t bitInfo = fHeader.hasCompressionDictionary(hasCompDict);
                     if (!byteOrder.isLocalEndian()) {
                         bitInfo = SWAP_32(bitInfo);
                     }
-                    afChannel->seekg(FileHeader::BIT_INFO_OFFSET);
-                    afChannel->write(reinterpret_cast<char *>(&bitInfo), sizeof(bitInfo));
-                    if (afChannel->fail()) {
-                        throw EvioException("error writing to  file");
-                    }
+                    writeAt(FileHeader::BIT_INFO_OFFSET, &bitInfo, sizeof(bitInfo));
                 }
 
                 // Update file header's record count word
@@ -279,12 +282,43 @@ namespace evio {
                 if (!byteOrder.isLocalEndian()) {
                     recordCount = SWAP_32(recordCount);
                 }
-                afChannel->seekg(FileHeader::RECORD_COUNT_OFFSET);
-                afChannel->write(reinterpret_cast<char *>(&recordCount), sizeof(recordCount));
+                writeAt(FileHeader::RECORD_COUNT_OFFSET, &recordCount, sizeof(recordCount));
+            }
+
+
+            /**
+             * Append data to the file being closed.
+             * @param data  data to write.
+             * @param bytes number of bytes to write.
+             * @throws EvioException if problems writing to file.
+             */
+            void write(const void *data, size_t bytes) {
+                if (directFile != nullptr) {
+                    directFile->write(data, bytes);
+                    return;
+                }
+                afChannel->write(reinterpret_cast<const char *>(data), bytes);
                 if (afChannel->fail()) {
                     throw EvioException("error writing to file");
                 }
             }
+
+
+            /**
+             * Overwrite data at the given position of the file being closed.
+             * @param pos   position in file.
+             * @param data  data to write.
+             * @param bytes number of bytes to write.
+             * @throws EvioException if problems writing to file.
+             */
+            void writeAt(uint64_t pos, const void *data, size_t bytes) {
+                if (directFile != nullptr) {
+                    directFile->writeAt(pos, data, bytes);
+                    return;
+                }
+                afChannel->seekg(pos);
+                write(data, bytes);
+            }
         };
 
 
@@ -294,15 +328,27 @@ namespace evio {
         /** Store all currently active closing threads. */
         std::vector <std::shared_ptr<CloseAsyncFChan>> threads;
 
+        /** Protects threads, which closing threads remove themselves from. */
+        std::mutex threadsMutex;
+
 
     public:
 
 
         /** Stop & delete every thread that was started. */
         void close() {
-            for (const std::shared_ptr <CloseAsyncFChan> &thread: threads) {
+            // Each thread removes itself from the vector when done, so go through a copy
+            std::vector <std::shared_ptr<CloseAsyncFChan>> closing;
+            {
+                std::lock_guard<std::mutex> lock(threadsMutex);
+                closing = threads;
+            }
+
+            for (const std::shared_ptr <CloseAsyncFChan> &thread: closing) {
                 thread->stopThread();
             }
+
+            std::lock_guard<std::mutex> lock(threadsMutex);
             threads.clear();
         }
 
@@ -311,15 +357,19 @@ namespace evio {
          * Remove thread from vector.
          * @param thread thread object to remove.
          */
-        void removeThread(std::shared_ptr <CloseAsyncFChan> &thread) {
+        void removeThread(CloseAsyncFChan *thread) {
             // Look for this pointer among the shared pointers
-            threads.erase(std::remove(threads.begin(), threads.end(), thread), threads.end());
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.erase(std::remove_if(threads.begin(), threads.end(),
+                                         [thread](std::shared_ptr <CloseAsyncFChan> const &t) {return t.get() == thread;}),
+                          threads.end());
         }
 
 
         /**
          * Close the given file, in the order received, in a separate thread.
          * @param afc file channel to close
+         * @param df  file written with direct I/O to close instead, null if none
          * @param future1
          * @param supply
          * @param ringItem
@@ -333,6 +383,7 @@ namespace evio {
          * @param order
          */
         void closeAsyncFile(std::shared_ptr <std::fstream> &afc,
+                            std::shared_ptr <DirectFile> &df,
                             std::shared_ptr <std::future<void>> &future1,
                             std::shared_ptr <RecordSupply> &supply,
                             std::shared_ptr <RecordRingItem> &ringItem,
@@ -341,12 +392,13 @@ namespace evio {
                             bool addingTrailer, bool writeIndex, bool noFileWriting,
                             ByteOrder &order) {
 
-            auto a = std::make_shared<CloseAsyncFChan>(afc, future1, supply, ringItem,
+            auto a = std::make_shared<CloseAsyncFChan>(afc, df, future1, supply, ringItem,
                                                        fileHeader, recordLengths,
                                                        bytesWritten, recordNumber,
                                                        addingTrailer, writeIndex,
                                                        noFileWriting, order, this);
 
+            std::lock_guard<std::mutex> lock(threadsMutex);
             threads.push_back(a);
             a->setSharedPointerOfThis(a);
         }
@@ -0,0 +1,357 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "ParallelReader.h"
+
+
+namespace evio {
+
+
+    /**
+     * Constructor. Scans the file (or reads its index file) to find its records
+     * and partitions them among the workers.
+     *
+     * @param fileName     name of file to read.
+     * @param workerCount  number of threads reading & decompressing records.
+     *                     Values &lt; 1 are set to 1. Values &gt; number of records are
+     *                     set to number of records.
+     * @param useIndexFile if true, use (and if necessary write) an index file so
+     *                     files without a record index are scanned only once.
+     * @throws EvioException if file cannot be opened, read, or is not evio version 6.
+     */
+    ParallelReader::ParallelReader(std::string const & fileName, uint32_t workerCount, bool useIndexFile) :
+            fileName(fileName) {
+
+        Reader reader;
+        reader.setUseIndexFile(useIndexFile);
+        reader.open(fileName);
+        compressionDictionary = reader.getCompressionDictionary();
+
+        std::vector<size_t> recordLengths;
+        auto & positions = reader.getRecordPositions();
+        recordPositions.reserve(positions.size());
+        recordLengths.reserve(positions.size());
+        recordFirstEvents.reserve(positions.size());
+
+        for (auto const & recPos : positions) {
+            recordPositions.push_back(recPos.getPosition());
+            recordLengths.push_back(recPos.getLength());
+            recordFirstEvents.push_back(eventCount);
+            eventCount += recPos.getCount();
+        }
+
+        reader.close();
+
+        partition(workerCount, recordLengths);
+    }
+
+
+    /**
+     * Divide the records into contiguous ranges of about equal numbers of bytes,
+     * one for each worker. Each worker gets at least one record if there are any.
+     * @param workerCount   number of workers, reduced to the number of records if more.
+     * @param recordLengths length in bytes of each record.
+     */
+    void ParallelReader::partition(uint32_t workerCount, std::vector<size_t> const & recordLengths) {
+        if (workerCount < 1) workerCount = 1;
+        if (workerCount > recordPositions.size()) {
+            workerCount = recordPositions.empty() ? 1 : recordPositions.size();
+        }
+
+        size_t totalBytes = 0;
+        for (size_t len : recordLengths) totalBytes += len;
+
+        uint32_t recordCount = recordPositions.size();
+        uint32_t record = 0;
+        size_t bytesSoFar = 0;
+
+        for (uint32_t i=0; i < workerCount; i++) {
+            Partition part;
+            part.firstRecord = record;
+            part.firstEvent  = record < recordCount ? recordFirstEvents[record] : eventCount;
+
+            // Leave at least one record for each of the remaining workers
+            uint32_t lastAllowed = recordCount - (workerCount - i - 1);
+            size_t targetBytes = totalBytes * (i + 1) / workerCount;
+
+            do {
+                if (record >= lastAllowed) break;
+                part.bytes += recordLengths[record];
+                bytesSoFar += recordLengths[record];
+                part.recordCount++;
+                record++;
+            } while (bytesSoFar < targetBytes || i == workerCount - 1);
+
+            partitions.push_back(part);
+        }
+    }
+
+
+    /**
+     * Get the number of worker threads.
+     * @return number of worker threads.
+     */
+    uint32_t ParallelReader::getWorkerCount() const {return partitions.size();}
+
+
+    /**
+     * Get the number of records in the file.
+     * @return number of records in the file.
+     */
+    uint32_t ParallelReader::getRecordCount() const {return recordPositions.size();}
+
+
+    /**
+     * Get the number of events in the file.
+     * @return number of events in the file.
+     */
+    uint64_t ParallelReader::getEventCount() const {return eventCount;}
+
+
+    /**
+     * Get the range of records read by each worker in {@link #forEachEvent}.
+     * @return range of records read by each worker.
+     */
+    std::vector<ParallelReader::Partition> const & ParallelReader::getPartitions() const {return partitions;}
+
+
+    /**
+     * Give each event of a record to the handler.
+     * @param worker      worker number.
+     * @param record      record holding events.
+     * @param recordIndex index of record in file.
+     * @param handler     function to call for each event.
+     */
+    void ParallelReader::handleEvents(uint32_t worker, RecordInput & record, uint32_t recordIndex,
+                                      EventHandler const & handler) const {
+        uint64_t firstEvent = recordFirstEvents[recordIndex];
+        uint32_t count = record.getEntries();
+        for (uint32_t i=0; i < count; i++) {
+            handler(worker, firstEvent + i, record.getEventView(i));
+        }
+    }
+
+
+    /**
+     * Method run by each worker thread of {@link #forEachEvent}.
+     * Reads the worker's partition, giving each event to the handler.
+     *
+     * @param worker  worker number.
+     * @param handler function to call for each event.
+     * @param stop    set by any worker when it fails, telling all to quit.
+     * @param error   set to error message if this worker fails.
+     */
+    void ParallelReader::readPartition(uint32_t worker, EventHandler const & handler,
+                                       std::atomic<bool> & stop, std::string & error) {
+        try {
+            std::ifstream file;
+            file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            file.open(fileName, std::ios::binary);
+
+            RecordInput record;
+            record.setCompressionDictionary(compressionDictionary);
+            Partition const & part = partitions[worker];
+
+            for (uint32_t i=0; i < part.recordCount; i++) {
+                if (stop.load(std::memory_order_relaxed)) return;
+                uint32_t recordIndex = part.firstRecord + i;
+                record.readRecord(file, recordPositions[recordIndex]);
+                handleEvents(worker, record, recordIndex, handler);
+            }
+        }
+        catch (std::exception & e) {
+            error = e.what();
+            stop = true;
+        }
+    }
+
+
+    /**
+     * Read all events of the file, using one thread per partition.
+     * The handler is called from the worker threads, so it must be thread safe.
+     * Events of the same worker arrive in file order, but those of
+     * different workers arrive concurrently. The EventView given to the
+     * handler is only valid during the call.
+     * If any worker fails (or the handler throws), all workers stop.
+     *
+     * @param handler function called for each event.
+     * @throws EvioException if error reading or decompressing a record, or if the handler threw.
+     */
+    void ParallelReader::forEachEvent(EventHandler const & handler) {
+
+        uint32_t workerCount = partitions.size();
+        std::atomic<bool> stop {false};
+        std::vector<std::string> errors(workerCount);
+        std::vector<boost::thread> threads;
+        threads.reserve(workerCount);
+
+        for (uint32_t i=0; i < workerCount; i++) {
+            threads.emplace_back([this, i, &handler, &stop, &errors]() {
+                this->readPartition(i, handler, stop, errors[i]);
+            });
+        }
+
+        for (auto & thd : threads) {
+            thd.join();
+        }
+
+        for (auto const & error : errors) {
+            if (!error.empty()) {
+                throw EvioException(error);
+            }
+        }
+    }
+
+
+    /**
+     * Method run by each worker thread of {@link #forEachEventInOrder}.
+     * Reads records #worker, #(worker + workerCount), ... into the worker's queue,
+     * waiting whenever all its records are full.
+     *
+     * @param worker      worker number.
+     * @param workerCount number of workers.
+     * @param queue       worker's queue of records.
+     * @param mtx         protects all queues and stop.
+     * @param cond        signals any change in queues or stop.
+     * @param stop        time for workers to quit.
+     */
+    void ParallelReader::readRecordsInOrder(uint32_t worker, uint32_t workerCount, WorkerQueue & queue,
+                                            std::mutex & mtx, std::condition_variable & cond, bool & stop) {
+        std::ifstream file;
+        std::string error;
+
+        try {
+            file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            file.open(fileName, std::ios::binary);
+        }
+        catch (std::exception & e) {
+            error = "cannot open " + fileName + ", " + e.what();
+        }
+
+        for (size_t recordIndex = worker; recordIndex < recordPositions.size(); recordIndex += workerCount) {
+
+            std::shared_ptr<RecordInput> record;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cond.wait(lock, [&queue, &stop]() {return stop || !queue.unused.empty();});
+                if (stop) return;
+                record = queue.unused.back();
+                queue.unused.pop_back();
+            }
+
+            if (error.empty()) {
+                try {
+                    record->readRecord(file, recordPositions[recordIndex]);
+                }
+                catch (std::exception & e) {
+                    error = e.what();
+                }
+            }
+
+            {
+                // A null record tells the caller to look at the error
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!error.empty()) {
+                    queue.error = error;
+                    record = nullptr;
+                }
+                queue.ready.push_back(record);
+            }
+            cond.notify_all();
+
+            if (!error.empty()) return;
+        }
+    }
+
+
+    /**
+     * Read all events of the file, in order, using all workers.
+     * Worker threads read and decompress records ahead, while the handler
+     * is called from the calling thread with events in file order.
+     * The EventView given to the handler is only valid during the call.
+     *
+     * @param handler          function called for each event.
+     * @param recordsPerWorker max number of records each worker reads ahead.
+     *                         Values &lt; 1 are set to 1.
+     * @throws EvioException if error reading or decompressing a record.
+     *                       Exceptions thrown by the handler are passed on.
+     */
+    void ParallelReader::forEachEventInOrder(EventHandler const & handler, uint32_t recordsPerWorker) {
+
+        if (recordsPerWorker < 1) recordsPerWorker = 1;
+
+        uint32_t workerCount = partitions.size();
+        std::vector<WorkerQueue> queues(workerCount);
+        std::mutex mtx;
+        std::condition_variable cond;
+        bool stop = false;
+
+        for (auto & queue : queues) {
+            for (uint32_t i=0; i < recordsPerWorker; i++) {
+                auto record = std::make_shared<RecordInput>();
+                record->setCompressionDictionary(compressionDictionary);
+                queue.unused.push_back(record);
+            }
+        }
+
+        std::vector<boost::thread> threads;
+        threads.reserve(workerCount);
+        for (uint32_t i=0; i < workerCount; i++) {
+            threads.emplace_back([this, i, workerCount, &queues, &mtx, &cond, &stop]() {
+                this->readRecordsInOrder(i, workerCount, queues[i], mtx, cond, stop);
+            });
+        }
+
+        auto stopWorkers = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                stop = true;
+            }
+            cond.notify_all();
+            for (auto & thd : threads) {
+                thd.join();
+            }
+        };
+
+        try {
+            for (size_t recordIndex = 0; recordIndex < recordPositions.size(); recordIndex++) {
+                uint32_t worker = recordIndex % workerCount;
+                WorkerQueue & queue = queues[worker];
+                std::shared_ptr<RecordInput> record;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cond.wait(lock, [&queue]() {return !queue.ready.empty();});
+                    record = queue.ready.front();
+                    queue.ready.pop_front();
+                }
+
+                if (record == nullptr) {
+                    throw EvioException(queue.error);
+                }
+
+                handleEvents(worker, *record, recordIndex, handler);
+
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    queue.unused.push_back(record);
+                }
+                cond.notify_all();
+            }
+        }
+        catch (...) {
+            stopWorkers();
+            throw;
+        }
+
+        stopWorkers();
+    }
+
+}
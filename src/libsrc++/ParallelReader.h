@@ -0,0 +1,140 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_PARALLELREADER_H
+#define EVIO_6_0_PARALLELREADER_H
+
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+#include "Reader.h"
+#include "RecordInput.h"
+#include "EventView.h"
+#include "EvioException.h"
+
+
+#include <boost/thread.hpp>
+
+
+namespace evio {
+
+
+    /**
+     * Class to read a single evio version 6 / hipo file with multiple threads.
+     * The file's records are partitioned into contiguous ranges of about equal
+     * size in bytes, one range per worker thread. Each worker has its own file
+     * stream, its own {@link RecordInput} and does its own decompression.<p>
+     *
+     * Events are given to a handler either directly from each worker thread
+     * ({@link #forEachEvent}), in which case the handler must be thread safe,
+     * or from the calling thread in the file's order ({@link #forEachEventInOrder}).
+     * In the latter case, so that all workers stay busy, records are dealt out
+     * to workers one by one (record #n to worker #(n % workers)) instead of
+     * by partition.
+     * Events are passed as {@link EventView}s, valid only for the duration of the call.<p>
+     *
+     * <pre><code>
+     *   ParallelReader pReader("myFile.evio", 8);
+     *   pReader.forEachEvent([](uint32_t worker, uint64_t eventIndex, EventView const & event) {
+     *       // process event.data(), event.length() ...
+     *   });
+     * </code></pre>
+     *
+     * @date 10/15/2026
+     * @author timmer
+     */
+    class ParallelReader {
+
+    public:
+
+        /**
+         * Function called for each event.
+         * Arguments are the worker number (starting at 0), the index of the event
+         * in the file (starting at 0), and a view of the event.
+         */
+        typedef std::function<void(uint32_t, uint64_t, EventView const &)> EventHandler;
+
+        /** Contiguous range of records read by one worker. */
+        struct Partition {
+            /** Index of first record. */
+            uint32_t firstRecord = 0;
+            /** Number of records. */
+            uint32_t recordCount = 0;
+            /** Index, in file, of first event. */
+            uint64_t firstEvent = 0;
+            /** Number of bytes of all records. */
+            size_t bytes = 0;
+        };
+
+    private:
+
+        /** Name of file being read. */
+        std::string fileName;
+        /** Position of each record in the file. */
+        std::vector<size_t> recordPositions;
+        /** Index, in file, of the first event of each record. */
+        std::vector<uint64_t> recordFirstEvents;
+        /** Range of records read by each worker. */
+        std::vector<Partition> partitions;
+        /** Total number of events in file. */
+        uint64_t eventCount = 0;
+        /** Dictionary to uncompress records with, if any. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+
+        /** Records, read by one worker, waiting to be handed out in order. */
+        struct WorkerQueue {
+            /** Records read and ready to be taken, in order. Null if error. */
+            std::deque<std::shared_ptr<RecordInput>> ready;
+            /** Records available to be read into. */
+            std::vector<std::shared_ptr<RecordInput>> unused;
+            /** Error reading record, if any. */
+            std::string error;
+        };
+
+        void partition(uint32_t workerCount, std::vector<size_t> const & recordLengths);
+        void readPartition(uint32_t worker, EventHandler const & handler,
+                           std::atomic<bool> & stop, std::string & error);
+        void readRecordsInOrder(uint32_t worker, uint32_t workerCount, WorkerQueue & queue,
+                                std::mutex & mtx, std::condition_variable & cond, bool & stop);
+        void handleEvents(uint32_t worker, RecordInput & record, uint32_t recordIndex,
+                          EventHandler const & handler) const;
+
+    public:
+
+        ParallelReader(std::string const & fileName, uint32_t workerCount, bool useIndexFile = false);
+
+        ParallelReader(const ParallelReader & other) = delete;
+        ParallelReader & operator=(const ParallelReader & other) = delete;
+
+        ~ParallelReader() = default;
+
+        uint32_t getWorkerCount() const;
+        uint32_t getRecordCount() const;
+        uint64_t getEventCount() const;
+        std::vector<Partition> const & getPartitions() const;
+
+        void forEachEvent(EventHandler const & handler);
+        void forEachEventInOrder(EventHandler const & handler, uint32_t recordsPerWorker = 2);
+    };
+
+}
+
+
+#endif //EVIO_6_0_PARALLELREADER_H
@@ -10,6 +10,15 @@
 
 #include "Reader.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <poll.h>
+#ifdef __linux__
+    #include <sys/inotify.h>
+#endif
+
 
 namespace evio {
 
@@ -52,6 +61,27 @@ namespace evio {
     }
 
 
+    /**
+     * Constructor with filename. Creates instance and opens
+     * the input stream with given name.
+     * If the file is memory mapped, records are read & decompressed directly from
+     * the mapped pages. Events of uncompressed records are not copied at all, but returned
+     * by {@link #getEvent(uint32_t, uint32_t *)} as pointers into the mapped memory.
+     * @param filename input file name.
+     * @param checkRecordNumSeq if true, check to see if all record numbers are in order,
+     *                          if not throw exception. Only works if forceScan = true.
+     * @param forceScan if true, force a scan of file, else use existing indexes first.
+     * @param useMappedMem if true, memory map the file instead of reading it with a stream.
+     * @throws EvioException if file is not in the proper format or earlier than version 6,
+     *                       or error reading or mapping the file.
+     */
+    Reader::Reader(std::string const & filename, bool checkRecordNumSeq, bool forceScan, bool useMappedMem) {
+        checkRecordNumberSequence = checkRecordNumSeq;
+        open(filename, false, useMappedMem);
+        scanFile(forceScan);
+    }
+
+
     /**
      * Constructor for reading buffer with evio data.
      * Buffer must be ready to read with position and limit set properly.
@@ -84,6 +114,49 @@ namespace evio {
     }
 
 
+    /**
+     * Constructor for reading buffer with evio data, with the option of lazily
+     * decompressing it. Buffer must be ready to read with position and limit set properly.
+     * In lazy decompression mode, only the record headers of a compressed buffer are scanned
+     * here. Each record is decompressed the first time one of its events is accessed, and
+     * the buffer remains the internal buffer of this object. This avoids having both the
+     * compressed and the entire uncompressed data in memory at once and makes the first
+     * event available much sooner. EvioNode objects are not available in this mode.
+     *
+     * @param buffer buffer with evio data.
+     * @param checkRecordNumSeq if true, check to see if all record numbers are in order,
+     *                          if not throw exception.
+     * @param lazyDecompress if true, decompress records only when their events are accessed.
+     * @param maxResidentRecs max number of decompressed records kept in memory, including the
+     *                        one currently being read. 0 means no limit.
+     * @throws EvioException if buffer too small, not in the proper format, or earlier than version 6;
+     *                       if checkRecordNumSeq is true and records are out of sequence.
+     */
+    Reader::Reader(std::shared_ptr<ByteBuffer> & buffer, bool checkRecordNumSeq,
+                   bool lazyDecompress, uint32_t maxResidentRecs) {
+        this->buffer = buffer;
+        bufferOffset = buffer->position();
+        bufferLimit  = buffer->limit();
+        byteOrder = buffer->order();
+        fromFile = false;
+        checkRecordNumberSequence = checkRecordNumSeq;
+        lazyDecompression = lazyDecompress;
+        recordCacheSize = maxResidentRecs;
+
+        auto bb = scanBuffer();
+        if (compressed && !lazyDecompression) {
+            this->buffer = bb;
+            compressed = false;
+        }
+    }
+
+
+    /** Destructor. */
+    Reader::~Reader() {
+        stopFollowing();
+    }
+
+
     /**
      * The equivalent of rewinding the file. What it actually does
      * is set the position of the sequential index back to the beginning.
@@ -93,14 +166,16 @@ namespace evio {
 
 
     /**
-     * Opens an input stream in binary mode. Scans for
+     * Opens an input stream in binary mode, or memory maps the file. Scans for
      * records in the file and stores record information
      * in internal array. Each record can be read from the file.
      * @param filename input file name
      * @param scan if true, call scanFile(false).
+     * @param useMappedMem if true, memory map the file instead of opening a stream.
+     *                     Records are then read & decompressed directly from the mapped pages.
      * @throws EvioException if error handling file
      */
-    void Reader::open(std::string const & filename, bool scan) {
+    void Reader::open(std::string const & filename, bool scan, bool useMappedMem) {
         // Throw exception if logical or read/write error on io operation
         inStreamRandom.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
@@ -109,6 +184,11 @@ namespace evio {
 //std::cout << "[READER] ---> closing current file : " << fileName << std::endl;
                 inStreamRandom.close();
             }
+            // Any previous mapping is released once nothing else refers to it
+            readAhead = nullptr;
+            asyncIO = nullptr;
+            clearRecordCache();
+            mappedBuffer = nullptr;
 
             // This may be called after using a buffer as input, so zero some things out
             buffer = nullptr;
@@ -117,14 +197,23 @@ namespace evio {
             fromFile = true;
 
             fileName = filename;
+            compressionDictionary = nullptr;
+            // A mapping cannot grow with the file being followed
+            useMappedMemory = useMappedMem && !followMode;
+            stopFollowing();
 
+            if (useMappedMemory) {
+                mapFile(filename);
+            }
+            else {
 //std::cout << "[READER] ---> opening file : " << filename << std::endl;
-            // "ate" mode flag will go immediately to file's end (do this to get its size)
-            inStreamRandom.open(filename, std::ios::binary | std::ios::ate);
+                // "ate" mode flag will go immediately to file's end (do this to get its size)
+                inStreamRandom.open(filename, std::ios::binary | std::ios::ate);
 
-            fileSize = inStreamRandom.tellg();
-            // Go back to beginning of file
-            inStreamRandom.seekg(0);
+                fileSize = inStreamRandom.tellg();
+                // Go back to beginning of file
+                inStreamRandom.seekg(0);
+            }
             fromFile = true;
             if (scan) {
                 scanFile(false);
@@ -142,14 +231,90 @@ namespace evio {
             return;
         }
 
+        // Stop any threads reading ahead
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        clearRecordCache();
+        stopFollowing();
+
         if (fromFile) {
-            inStreamRandom.close();
+            if (useMappedMemory) {
+                // Memory is unmapped once events pointing into it are released
+                mappedBuffer = nullptr;
+            }
+            else {
+                inStreamRandom.close();
+            }
         }
 
         closed = true;
     }
 
 
+    /**
+     * Memory map the given file, read-only as far as the file is concerned.
+     * The mapping is private, so any changes made to the memory (e.g. to an event
+     * obtained from {@link #getEvent(uint32_t, uint32_t *)}) are never written to the file.
+     * @param filename name of file to map.
+     * @throws EvioException if file cannot be opened, is empty, or cannot be mapped.
+     */
+    void Reader::mapFile(std::string const & filename) {
+        int fd;
+        void *pmem;
+        struct stat fileStat {};
+
+        if ((fd = ::open(filename.c_str(), O_RDONLY)) < 0) {
+            throw EvioException("cannot open file " + filename);
+        }
+
+        if (::fstat(fd, &fileStat) < 0) {
+            ::close(fd);
+            throw EvioException("cannot find size of file " + filename);
+        }
+
+        fileSize = fileStat.st_size;
+        if (fileSize < 1) {
+            ::close(fd);
+            throw EvioException("cannot map empty file " + filename);
+        }
+
+        // Map file to process space. Copy-on-write so memory can be changed, but not file.
+        if ((pmem = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE, fd, (off_t)0)) == MAP_FAILED) {
+            ::close(fd);
+            throw EvioException("fail to map file " + filename);
+        }
+
+        // Close fd for mapped mem since no longer needed
+        ::close(fd);
+
+        // Mapped memory is unmapped in the ByteBuffer's destructor
+        mappedBuffer = std::make_shared<ByteBuffer>(static_cast<char *>(pmem), fileSize, true);
+    }
+
+
+    /**
+     * Read bytes from the file, either from the memory mapped file or from the input stream.
+     * @param dest     where to put the bytes read.
+     * @param position position in file to read from.
+     * @param len      number of bytes to read.
+     * @throws EvioException if reading past the end of mapped file.
+     * @throws std::ifstream::failure if error reading file stream.
+     */
+    void Reader::readFromFile(char *dest, size_t position, size_t len) {
+        if (useMappedMemory) {
+            if (position + len > fileSize) {
+                throw EvioException("attempt to read past end of file");
+            }
+            std::memcpy(dest, mappedBuffer->array() + position, len);
+            return;
+        }
+
+        inStreamRandom.seekg(position);
+        inStreamRandom.read(dest, len);
+    }
+
+
     /**
      * Has {@link #close()} been called (without reopening by calling
      * {@link #setBuffer(std::shared_ptr<ByteBuffer>)})?
@@ -166,6 +331,150 @@ namespace evio {
     bool Reader::isFile() const {return fromFile;}
 
 
+    /**
+     * Is the file being read memory mapped?
+     * @return {@code true} if a file is being read through memory mapping.
+     */
+    bool Reader::isMemoryMapped() const {return fromFile && useMappedMemory;}
+
+
+    /**
+     * Read and decompress records of a file ahead of the one currently being read,
+     * using a pool of threads. This speeds up sequential reading of compressed files
+     * since decompression of the next records overlaps with processing of the current one.
+     * Reading a record out of order is still allowed, but starts reading ahead over again
+     * from that record. Has no effect when reading a buffer.
+     * Takes effect when the next record is read.
+     *
+     * @param threadCount number of threads reading ahead, 0 turns reading ahead off.
+     * @param recordCount max number of records read ahead of the current one,
+     *                    each needing its own memory. If 0, it's set to 2*threadCount.
+     */
+    void Reader::setReadAhead(uint32_t threadCount, uint32_t recordCount) {
+        readAhead = nullptr;
+        clearRecordCache();
+        readAheadThreads = threadCount;
+        readAheadRecords = recordCount == 0 ? 2*threadCount : recordCount;
+    }
+
+
+    /**
+     * Get the number of threads reading records ahead of the current one.
+     * @return number of threads reading records ahead of the current one, 0 if none.
+     */
+    uint32_t Reader::getReadAheadThreads() const {return readAheadThreads;}
+
+
+    /**
+     * Get the max number of records read ahead of the current one.
+     * @return max number of records read ahead of the current one.
+     */
+    uint32_t Reader::getReadAheadRecords() const {return readAheadRecords;}
+
+
+    /**
+     * Set how records of a file are read from disk. The default, IFSTREAM, reads each record's
+     * header and then its payload through a std::ifstream. PREAD reads each whole record with
+     * a single pread. IO_URING (Linux only) keeps reads of the next queueDepth records
+     * outstanding at once through an io_uring, which helps reach the full throughput of fast
+     * (NVMe) storage. If io_uring is not available, PREAD is used.
+     * Has no effect when reading a buffer, a memory mapped file, or when reading ahead with threads.
+     * Takes effect when the next record is read.
+     *
+     * @param engine     how to read records.
+     * @param queueDepth max number of records read at once by io_uring. Values &lt; 1 are set to 1.
+     */
+    void Reader::setIoEngine(AsyncRecordIO::IoEngine engine, uint32_t queueDepth) {
+        asyncIO = nullptr;
+        clearRecordCache();
+        ioEngine = engine;
+        ioQueueDepth = queueDepth < 1 ? 1 : queueDepth;
+    }
+
+
+    /**
+     * Get how records of a file are read from disk. Once a record has been read,
+     * this is the engine actually used, so PREAD is returned if IO_URING was
+     * asked for but is not available.
+     * @return how records of a file are read from disk.
+     */
+    AsyncRecordIO::IoEngine Reader::getIoEngine() const {
+        if (asyncIO != nullptr) {
+            return asyncIO->getEngine();
+        }
+        return ioEngine;
+    }
+
+
+    /**
+     * Set whether a compressed buffer given in {@link #setBuffer} is decompressed lazily.
+     * If so, only its record headers are scanned and each record is decompressed the first
+     * time one of its events is accessed. Otherwise all records are decompressed into a new
+     * buffer when scanned. EvioNode objects are not available in lazy mode.
+     * Takes effect at the next call to {@link #setBuffer}.
+     *
+     * @param lazy if true, decompress records only when their events are accessed.
+     * @param maxResidentRecs max number of decompressed records kept in memory, including the
+     *                        one currently being read. 0 means no limit.
+     *                        Same as {@link #setRecordCacheSize(uint32_t)}.
+     */
+    void Reader::setLazyDecompression(bool lazy, uint32_t maxResidentRecs) {
+        lazyDecompression = lazy;
+        setRecordCacheSize(maxResidentRecs);
+    }
+
+
+    /**
+     * Are compressed buffers decompressed lazily, record by record?
+     * @return true if compressed buffers are decompressed lazily.
+     */
+    bool Reader::isLazyDecompression() const {return lazyDecompression;}
+
+
+    /**
+     * Set the max number of decompressed records kept in memory, including the one currently
+     * being read. If &gt; 1, the most recently used records are cached so that random or
+     * interleaved access to events (e.g. event mixing) reads and decompresses each record
+     * only once, as long as it stays in the cache. Each cached record needs its own memory.
+     * Not used while reading ahead with threads (see {@link #setReadAhead}).
+     * This is the same setting as the max number of resident records in lazy decompression mode.
+     *
+     * @param recordCount max number of records kept in memory. 1 means no caching, 0 means no limit.
+     */
+    void Reader::setRecordCacheSize(uint32_t recordCount) {
+        clearRecordCache();
+        recordCacheSize = recordCount;
+    }
+
+
+    /**
+     * Get the max number of decompressed records kept in memory, including the current one.
+     * @return max number of decompressed records kept in memory, 0 means no limit.
+     */
+    uint32_t Reader::getRecordCacheSize() const {return recordCacheSize;}
+
+
+    /**
+     * Get the number of times a record was found in the record cache when needed.
+     * Only counted while the record cache is used (see {@link #setRecordCacheSize(uint32_t)}).
+     * @return number of record cache hits.
+     */
+    uint64_t Reader::getRecordCacheHits() const {return recordCacheHits;}
+
+
+    /**
+     * Get the number of times a record was not found in the record cache when needed,
+     * and had to be read (and decompressed).
+     * Only counted while the record cache is used (see {@link #setRecordCacheSize(uint32_t)}).
+     * @return number of record cache misses.
+     */
+    uint64_t Reader::getRecordCacheMisses() const {return recordCacheMisses;}
+
+
+    /** Set the record cache hit and miss counts to 0. */
+    void Reader::resetRecordCacheStats() {recordCacheHits = recordCacheMisses = 0;}
+
+
     /**
      * This method can be used to avoid creating additional Reader
      * objects by reusing this one with another buffer.
@@ -183,6 +492,10 @@ namespace evio {
         fromFile = false;
 
         close();
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        mappedBuffer = nullptr;
+        clearRecordCache();
 
         buffer       = buf;
         bufferLimit  = buffer->limit();
@@ -204,7 +517,7 @@ namespace evio {
         currentRecordLoaded = 0;
 
         auto bb = scanBuffer();
-        if (compressed) {
+        if (compressed && !lazyDecompression) {
             // scanBuffer() will uncompress all data in buffer
             // and store it in the returned buffer (bb).
             // Make that our internal buffer so we don't have to do any more uncompression.
@@ -359,6 +672,33 @@ namespace evio {
     }
 
 
+    /**
+     * Get the dictionary used to uncompress records. For a file, this is the one stored
+     * in its file header, if any, unless set by {@link #setCompressionDictionary}.
+     * @return dictionary used to uncompress records, null if none.
+     */
+    std::shared_ptr<CompressionDictionary> Reader::getCompressionDictionary() {
+        loadCompressionDictionary();
+        return compressionDictionary;
+    }
+
+
+    /**
+     * Set the dictionary used to uncompress records compressed with one.
+     * A file's dictionary, stored in its file header, is loaded automatically,
+     * so this is only needed for data whose dictionary is kept elsewhere,
+     * as for records copied into a buffer. Call this after opening a file
+     * or before calling {@link #setBuffer}.
+     * @param dict dictionary used to uncompress records, null if none.
+     */
+    void Reader::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        compressionDictionary = std::move(dict);
+        // Threads reading ahead have their own copy
+        readAhead = nullptr;
+        clearRecordCache();
+    }
+
+
     /**
      * Get the number of events in file/buffer.
      * @return number of events in file/buffer.
@@ -434,6 +774,11 @@ namespace evio {
         auto array = getEvent(sequentialIndex++, len);
         lastCalledSeqNext = true;
 
+        // If following a file being written, look for newly appended records
+        if (array == nullptr && followMode && updateFollowedFile() > 0) {
+            array = getEvent(sequentialIndex - 1, len);
+        }
+
         if (array == nullptr) {
 //std::cout << "getNextEvent hit limit at index " << (sequentialIndex - 1) <<
 //             ", set to " << (sequentialIndex - 1) << std::endl << std::endl;
@@ -532,8 +877,7 @@ namespace evio {
             // This is turned into shared memory in ByteBuffer constructor below
             auto userBytes = new char[userLen];
 
-            inStreamRandom.seekg(fileHeader.getHeaderLength() + fileHeader.getIndexLength());
-            inStreamRandom.read(userBytes, userLen);
+            readFromFile(userBytes, fileHeader.getHeaderLength() + fileHeader.getIndexLength(), userLen);
             // This is a local object and will go out of scope! Copying ByteBuffer is necessary,
             // but data is in shared_ptr and doesn't get copied since it's moved.
             auto buf = std::make_shared<ByteBuffer>(userBytes, userLen);
@@ -544,10 +888,7 @@ namespace evio {
             int userLen = firstRecordHeader->getUserHeaderLength();
 // std::cout << "  " << firstRecordHeader->getUserHeaderLength() << "  " << firstRecordHeader->getHeaderLength() <<
 //              "  " << firstRecordHeader->getIndexLength() << std::endl;
-            auto userBytes = new uint8_t[userLen];
-
-            buffer->position(firstRecordHeader->getHeaderLength() + firstRecordHeader->getIndexLength());
-            buffer->getBytes(userBytes, userLen);
+            auto userBytes = copyFirstRecordUserHeader(userLen);
 
             auto buf = std::make_shared<ByteBuffer>(userBytes, userLen);
             buf->order(firstRecordHeader->getByteOrder());
@@ -556,6 +897,36 @@ namespace evio {
     }
 
 
+    /**
+     * Get a view of the specified event from the file/buffer without copying or allocating
+     * anything (other than reading the event's record if it's not the current one).
+     * The view points into the current record's decompressed data and is valid only
+     * until the next record is read, which may happen when another event is asked for.
+     * If index is out of bounds, an empty view is returned.
+     * @param index index of specified event within the entire file/buffer,
+     *              contiguous starting at 0.
+     * @return view of the specified event, empty if index is out of bounds.
+     * @throws EvioException if file/buffer not in hipo format
+     */
+    EventView Reader::getEventView(uint32_t index) {
+
+        if (index >= eventIndex.getMaxEvents()) {
+            return EventView();
+        }
+
+        if (eventIndex.setEvent(index)) {
+            // If here, the event is in another record
+            readRecord(eventIndex.getRecordNumber());
+        }
+
+        if (needsRecordRead()) {
+            readRecord(eventIndex.getRecordNumber());
+        }
+
+        return inputRecordStream.getEventView(eventIndex.getRecordEventNumber());
+    }
+
+
     /**
      * Get a byte array representing the specified event from the file/buffer.
      * If index is out of bounds, null is returned.
@@ -580,7 +951,7 @@ namespace evio {
             readRecord(eventIndex.getRecordNumber());
         }
 
-        if (inputRecordStream.getEntries() == 0) {
+        if (needsRecordRead()) {
 //std::cout << "[READER] getEvent: first time reading record at index = " << eventIndex.getRecordNumber() << std::endl;
             readRecord(eventIndex.getRecordNumber());
         }
@@ -614,7 +985,7 @@ namespace evio {
             // If here, the event is in the next record
             readRecord(eventIndex.getRecordNumber());
         }
-        if (inputRecordStream.getEntries() == 0) {
+        if (needsRecordRead()) {
             //std::cout << "[READER] first time reading buffer" << std::endl;
             readRecord(eventIndex.getRecordNumber());
         }
@@ -661,7 +1032,7 @@ namespace evio {
 //std::cout << "[READER] getEventLength: read record" << std::endl;
             readRecord(eventIndex.getRecordNumber());
         }
-        if (inputRecordStream.getEntries() == 0) {
+        if (needsRecordRead()) {
             // First time reading buffer
 //std::cout << "[READER] getEventLength: first time reading record" << std::endl;
             readRecord(eventIndex.getRecordNumber());
@@ -675,9 +1046,9 @@ namespace evio {
      * If index is out of bounds, nullptr is returned.
      * @param index index of specified event within the entire buffer,
      *              starting at 0.
-     * @return EvioNode representing the specified event or null if
-     *         index is out of bounds, reading a file or data is compressed.
-     * @throws EvioException index too large or reading from file.
+     * @return EvioNode representing the specified event.
+     * @throws EvioException index too large, reading from file, or buffer is
+     *                       decompressed lazily so it has no EvioNodes.
      */
     std::shared_ptr<EvioNode>  Reader::getEventNode(uint32_t index) {
 //std::cout << "     getEventNode: index = " << index << " >? " << eventIndex.getMaxEvents() <<
@@ -685,6 +1056,10 @@ namespace evio {
         if (index >= eventIndex.getMaxEvents() || fromFile) {
             throw EvioException("index too large or reading from file");
         }
+        // Still compressed only if decompressed lazily, and then no nodes are made
+        if (compressed) {
+            throw EvioException("no EvioNodes when compressed buffer is decompressed lazily");
+        }
 //std::cout << "     getEventNode: Getting node at index = " << index << std::endl;
         return eventNodes[index];
     }
@@ -737,10 +1112,21 @@ namespace evio {
 
         if (index < recordPositions.size()) {
             size_t pos = recordPositions[index].getPosition();
-            if (fromFile) {
-                inputRecordStream.readRecord(inStreamRandom, pos);
+            loadCompressionDictionary();
+            if (fromFile && readAheadThreads > 0) {
+                if (readAhead == nullptr) {
+                    startReadAhead();
+                }
+                readAhead->getRecord(index, inputRecordStream);
+            }
+            else if (usesRecordCache()) {
+                loadCachedRecord(index, pos);
+            }
+            else if (fromFile) {
+                readFileRecord(inputRecordStream, index, pos);
             }
             else {
+                inputRecordStream.setCompressionDictionary(compressionDictionary);
                 inputRecordStream.readRecord(*(buffer.get()), pos);
             }
             currentRecordLoaded = index;
@@ -750,6 +1136,168 @@ namespace evio {
     }
 
 
+    /**
+     * Are records read through the record cache? That's the case if more than 1 record
+     * is to be kept in memory, or in lazy decompression mode. Threads reading ahead
+     * take precedence over the cache.
+     * @return true if records are read through the record cache.
+     */
+    bool Reader::usesRecordCache() const {
+        if (fromFile) {
+            return recordCacheSize != 1 && readAheadThreads == 0;
+        }
+        return recordCacheSize != 1 || compressed;
+    }
+
+
+    /**
+     * Does the current event's record need to be read before accessing the event?
+     * Besides an empty current record, when using the record cache the current record
+     * may be left over from a previous file or buffer.
+     * @return true if the current event's record needs to be read.
+     */
+    bool Reader::needsRecordRead() const {
+        return inputRecordStream.getEntries() == 0 || (usesRecordCache() && !haveCachedCurrent);
+    }
+
+
+    /** Remove all records from the record cache. */
+    void Reader::clearRecordCache() {
+        cachedRecords.clear();
+        haveCachedCurrent = false;
+    }
+
+
+    /**
+     * Make the record of the given index the current one (inputRecordStream) using the
+     * record cache. If the record is in the cache, it's simply swapped with the current one.
+     * If not, it's read (and decompressed) and the current record goes into the cache,
+     * pushing out the least recently used one, whose memory is reused, if there are too many.
+     *
+     * @param index record index (starting at 0).
+     * @param pos   position of record in file/buffer.
+     * @throws EvioException if file/buffer not in hipo format
+     */
+    void Reader::loadCachedRecord(uint32_t index, size_t pos) {
+
+        bool haveCurrent = haveCachedCurrent;
+
+        for (auto it = cachedRecords.begin(); it != cachedRecords.end(); ++it) {
+            if (it->first == index) {
+                recordCacheHits++;
+                auto rec = it->second;
+                cachedRecords.erase(it);
+                std::swap(inputRecordStream, *rec);
+                if (haveCurrent) {
+                    cachedRecords.emplace_front(currentRecordLoaded, rec);
+                }
+                haveCachedCurrent = true;
+                return;
+            }
+        }
+
+        recordCacheMisses++;
+
+        if (haveCurrent && recordCacheSize != 1) {
+            std::shared_ptr<RecordInput> rec;
+            if (recordCacheSize > 0 && cachedRecords.size() + 1 >= recordCacheSize) {
+                // Reuse memory of least recently used record
+                rec = cachedRecords.back().second;
+                cachedRecords.pop_back();
+            }
+            else {
+                rec = std::make_shared<RecordInput>();
+            }
+            std::swap(inputRecordStream, *rec);
+            cachedRecords.emplace_front(currentRecordLoaded, rec);
+        }
+
+        haveCachedCurrent = false;
+        if (!fromFile) {
+            inputRecordStream.setCompressionDictionary(compressionDictionary);
+            inputRecordStream.readRecord(*(buffer.get()), pos);
+        }
+        else {
+            readFileRecord(inputRecordStream, index, pos);
+        }
+        haveCachedCurrent = true;
+    }
+
+
+    /**
+     * Read a record of the file, from mapped memory, through the io engine, or from the stream.
+     * @param record object to read into.
+     * @param index  index of record.
+     * @param pos    position of record in file.
+     */
+    void Reader::readFileRecord(RecordInput & record, uint32_t index, size_t pos) {
+        record.setCompressionDictionary(compressionDictionary);
+        if (useMappedMemory) {
+            // Decompress directly from, or point into, mapped memory
+            record.readRecord(mappedBuffer, pos);
+        }
+        else if (ioEngine != AsyncRecordIO::IFSTREAM) {
+            if (asyncIO == nullptr) {
+                std::vector<size_t> positions;
+                std::vector<uint32_t> lengths;
+                positions.reserve(recordPositions.size());
+                lengths.reserve(recordPositions.size());
+                for (auto const & recPos : recordPositions) {
+                    positions.push_back(recPos.getPosition());
+                    lengths.push_back(recPos.getLength());
+                }
+                asyncIO = std::make_shared<AsyncRecordIO>(fileName, positions, lengths,
+                                                          ioEngine, ioQueueDepth);
+            }
+            asyncIO->readRecord(index, record);
+        }
+        else {
+            record.readRecord(inStreamRandom, pos);
+        }
+    }
+
+
+    /**
+     * Copy the user header of the first record in the buffer into a new array.
+     * If the buffer is still compressed (lazy decompression mode), the record is decompressed first.
+     * @param userLen length of user header in bytes.
+     * @return newly allocated array containing user header.
+     */
+    uint8_t* Reader::copyFirstRecordUserHeader(uint32_t userLen) {
+        auto userBytes = new uint8_t[userLen];
+
+        if (compressed) {
+            RecordInput record(byteOrder);
+            record.setCompressionDictionary(compressionDictionary);
+            record.readRecord(*(buffer.get()), bufferOffset);
+            std::memcpy(userBytes, record.getUserHeader().get(), userLen);
+        }
+        else {
+            // Position right before record header's user header
+            buffer->position(bufferOffset +
+                             firstRecordHeader->getHeaderLength() +
+                             firstRecordHeader->getIndexLength());
+            buffer->getBytes(userBytes, userLen);
+        }
+
+        return userBytes;
+    }
+
+
+    /** Start threads reading & decompressing records ahead of the current one. */
+    void Reader::startReadAhead() {
+        std::vector<size_t> positions;
+        positions.reserve(recordPositions.size());
+        for (auto const & recPos : recordPositions) {
+            positions.push_back(recPos.getPosition());
+        }
+
+        readAhead = std::make_shared<RecordReadAhead>(fileName, useMappedMemory ? mappedBuffer : nullptr,
+                                                      positions, readAheadThreads, readAheadRecords,
+                                                      compressionDictionary);
+    }
+
+
     /** Extract dictionary and first event from file/buffer if possible, else do nothing. */
     void Reader::extractDictionaryAndFirstEvent() {
         // If already read & parsed ...
@@ -785,13 +1333,8 @@ namespace evio {
         RecordInput record;
 
         try {
-            // Position right before record header's user header
-            buffer->position(bufferOffset +
-                             firstRecordHeader->getHeaderLength() +
-                             firstRecordHeader->getIndexLength());
             // Read user header
-            auto userBytes = new uint8_t[userLen];
-            buffer->getBytes(userBytes, userLen);
+            auto userBytes = copyFirstRecordUserHeader(userLen);
             ByteBuffer userBuffer(userBytes, userLen);
 
             // Parse user header as record
@@ -825,8 +1368,10 @@ namespace evio {
     void Reader::extractDictionaryFromFile() {
 //std::cout << "extractDictionaryFromFile: IN, hasFirst = " << fileHeader.hasFirstEvent() << std::endl;
 
-        // If no dictionary or first event ...
-        if (!fileHeader.hasDictionary() && !fileHeader.hasFirstEvent()) {
+        bool needCompressionDict = fileHeader.hasCompressionDictionary() && compressionDictionary == nullptr;
+
+        // If no dictionary, first event, or compression dictionary still needed ...
+        if (!fileHeader.hasDictionary() && !fileHeader.hasFirstEvent() && !needCompressionDict) {
             return;
         }
 
@@ -840,11 +1385,9 @@ namespace evio {
 
         try {
 //std::cout << "extractDictionaryFromFile: Read " << userLen << " bytes for record" << std::endl;
-            // Position right before file header's user header
-            inStreamRandom.seekg(fileHeader.getHeaderLength() + fileHeader.getIndexLength());
-            // Read user header
+            // Read user header which is right after file header and index
             auto userBytes = new char[userLen];
-            inStreamRandom.read(userBytes, userLen);
+            readFromFile(userBytes, fileHeader.getHeaderLength() + fileHeader.getIndexLength(), userLen);
             // userBytes will be made into a shared pointer in next line
             ByteBuffer userBuffer(userBytes, userLen);
             // Parse user header as record
@@ -873,9 +1416,27 @@ namespace evio {
 
         // First event comes next
         if (fileHeader.hasFirstEvent()) {
-            firstEvent = record.getEvent(evIndex, &len);
+            firstEvent = record.getEvent(evIndex++, &len);
             firstEventSize = len;
         }
+
+        // Compression dictionary comes last
+        if (needCompressionDict && evIndex < (int)record.getEntries()) {
+            auto dict = record.getEvent(evIndex, &len);
+            compressionDictionary = std::make_shared<CompressionDictionary>(dict.get(), len);
+        }
+    }
+
+
+    /**
+     * Load the compression dictionary stored in the file header, if there is one
+     * and it has not been loaded yet. It must be available before reading any
+     * record compressed with it.
+     */
+    void Reader::loadCompressionDictionary() {
+        if (fromFile && compressionDictionary == nullptr && fileHeader.hasCompressionDictionary()) {
+            extractDictionaryFromFile();
+        }
     }
 
 
@@ -1070,7 +1631,13 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 
         compressed = true;
 
-        // The previous method call will set the endianness of the buffer properly.
+        if (lazyDecompression) {
+            // Leave the decompressing to when events are accessed
+            scanCompressedBufferHeaders();
+            return buffer;
+        }
+
+        // The previous method call will set the endianness of the buffer properly.
         // Hop through ALL RECORDS to find their total lengths. This does NOT
         // change pos/limit of buffer. Results returned in headerInfo[0] & [1].
         // All other values in headerInfo reflect the LAST record (ususally trailer).
@@ -1112,7 +1679,8 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 
             // Uncompress record in buffer & place into bigEnoughBuf, then READ RECORD HEADER
             int origRecordBytes = RecordInput::uncompressRecord(
-                    buf, recordPos, *(bigEnoughBuf.get()), recordHeader);
+                    buf, recordPos, *(bigEnoughBuf.get()), recordHeader,
+                    compressionDictionary.get());
 
             // The only certainty at this point about pos/limit is that
             // bigEnoughBuf->position = after header/index/user, just before data.
@@ -1296,6 +1864,72 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
     }
 
 
+    /**
+     * Scan buffer containing compressed data to find all records and store their position,
+     * length, and event count. Only record headers are read, nothing is decompressed.
+     * Used in lazy decompression mode in which no EvioNode objects are created.
+     * @throws EvioException if buffer too small, not in the proper format, or earlier than version 6;
+     *                       if checkRecordNumberSequence is true and records are out of sequence.
+     */
+    void Reader::scanCompressedBufferHeaders() {
+
+        ByteBuffer headerBuffer(RecordHeader::HEADER_SIZE_BYTES);
+        auto headerBytes = headerBuffer.array();
+
+        RecordHeader recordHeader;
+        bool haveFirstRecordHeader = false;
+
+        size_t position = bufferOffset;
+        ssize_t bytesLeft = bufferLimit - bufferOffset;
+
+        eventNodes.clear();
+        recordPositions.clear();
+        eventIndex.clear();
+        clearRecordCache();
+        recordNumberExpected = 1;
+
+        while (bytesLeft >= RecordHeader::HEADER_SIZE_BYTES) {
+            // Read record header
+            buffer->position(position);
+            buffer->getBytes(headerBytes, RecordHeader::HEADER_SIZE_BYTES);
+            recordHeader.readHeader(headerBuffer);
+
+            uint32_t eventCount = recordHeader.getEntries();
+            uint32_t recordBytes = recordHeader.getLength();
+
+            if (!haveFirstRecordHeader) {
+                byteOrder = recordHeader.getByteOrder();
+                buffer->order(byteOrder);
+                evioVersion = recordHeader.getVersion();
+                firstRecordHeader = std::make_shared<RecordHeader>(recordHeader);
+                haveFirstRecordHeader = true;
+            }
+
+            if (checkRecordNumberSequence) {
+                if (recordHeader.getRecordNumber() != recordNumberExpected) {
+                    throw EvioException("bad record # sequence");
+                }
+                recordNumberExpected++;
+            }
+
+            // Check to see if the whole record is there
+            if (recordBytes > bytesLeft || recordBytes < RecordHeader::HEADER_SIZE_BYTES) {
+                throw EvioException("Bad hipo format: not enough data to read record");
+            }
+
+            recordPositions.emplace_back(position, recordBytes, eventCount);
+            eventIndex.addEventSize(eventCount);
+
+            position  += recordBytes;
+            bytesLeft -= recordBytes;
+
+            if (recordHeader.isLastRecord()) break;
+        }
+
+        buffer->position(bufferOffset);
+    }
+
+
     /**
       * Scan buffer containing uncompressed data to find all records and store their position,
       * length, and event count.
@@ -1496,6 +2130,11 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
      */
     void Reader::forceScanFile() {
 
+        // Record positions may change
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        clearRecordCache();
+
 //std::cout << "\n\nforceScanFile ---> force a file scan" << std::endl;
 
         auto headerBytes = new char[RecordHeader::HEADER_SIZE_BYTES];
@@ -1503,9 +2142,8 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 
         // Read and parse file header even if we have already done so in scanFile()
         fileHeader = FileHeader();
-        // Go to file beginning
-        inStreamRandom.seekg(0L);
-        inStreamRandom.read(headerBytes, RecordHeader::HEADER_SIZE_BYTES);
+        // Read from file beginning
+        readFromFile(headerBytes, 0L, RecordHeader::HEADER_SIZE_BYTES);
         // headerBuffer position does not change in following call
         fileHeader.readHeader(headerBuffer);
         byteOrder = fileHeader.getByteOrder();
@@ -1521,6 +2159,14 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 
         // Scan file by reading each record header and
         // storing its position, length, and event count.
+        // Rather than reading each header separately, read large aligned chunks
+        // and walk the headers inside, reading another chunk only when the next
+        // header is not entirely in the current one.
+        // If records are bigger than a chunk, each chunk would hold only 1 header,
+        // so in that case read just the header.
+        ByteBuffer chunkBuffer(SCAN_CHUNK_BYTES);
+        auto chunkBytes = reinterpret_cast<char *>(chunkBuffer.array());
+        size_t chunkStart = 0, chunkLen = 0;
 
         // Don't go beyond 1 header length before EOF since we'll be reading in 1 header
         size_t maximumSize = fileSize - RecordHeader::HEADER_SIZE_BYTES;
@@ -1532,10 +2178,23 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
                                 fileHeader.getUserHeaderLengthPadding();
 
         int recordCount = 0;
+        recordLen = 0;
         while (recordPosition < maximumSize) {
-            inStreamRandom.seekg(recordPosition);
-            inStreamRandom.read(headerBytes, RecordHeader::HEADER_SIZE_BYTES);
-            recordHeader.readHeader(headerBuffer);
+            if (recordPosition < chunkStart ||
+                recordPosition + RecordHeader::HEADER_SIZE_BYTES > chunkStart + chunkLen) {
+
+                if ((uint32_t)recordLen >= SCAN_CHUNK_BYTES) {
+                    chunkStart = recordPosition;
+                    chunkLen = RecordHeader::HEADER_SIZE_BYTES;
+                }
+                else {
+                    chunkStart = recordPosition - (recordPosition % SCAN_CHUNK_ALIGN);
+                    chunkLen = std::min((size_t)SCAN_CHUNK_BYTES, fileSize - chunkStart);
+                }
+                readFromFile(chunkBytes, chunkStart, chunkLen);
+            }
+
+            recordHeader.readHeader(chunkBuffer, recordPosition - chunkStart);
 //std::cout << "forceScanFile: record header " << recordCount << " @ pos = " <<
 //     recordPosition << " -->" << std::endl << recordHeader.toString() << std::endl;
             recordCount++;
@@ -1573,6 +2232,496 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
     }
 
 
+    /**
+     * Find all record positions of a file which has no index of its own.
+     * If so configured (see {@link #setUseIndexFile(bool)}), they're loaded from
+     * the index file if it's valid. Otherwise the file is scanned and,
+     * if so configured, the index file is written for next time.
+     * @throws EvioException if file is not in the proper format or earlier than version 6
+     */
+    void Reader::scanFileWithoutIndex() {
+        if (useIndexFile && readIndexFile()) {
+            return;
+        }
+
+        forceScanFile();
+
+        if (useIndexFile) {
+            try {
+                writeIndexFile();
+            }
+            catch (EvioException & e) {
+                // Not being able to write the index file (e.g. read-only directory)
+                // only means the file will be scanned again next time.
+            }
+        }
+    }
+
+
+    /**
+     * Set whether an index file is used to find the records of a file which has no index of
+     * its own (neither in its file header nor in its trailer). If so, when scanning such a file,
+     * the index file written by a previous scan (see {@link #getIndexFileName()}) is loaded
+     * as long as the file's size and modification time have not changed since.
+     * This takes constant I/O instead of reading every record header of the file.
+     * If the index file does not exist or is out of date, the file is scanned and the index
+     * file is written. To have an effect, call this before {@link #open}.
+     *
+     * @param use true to use an index file.
+     */
+    void Reader::setUseIndexFile(bool use) {useIndexFile = use;}
+
+
+    /**
+     * Is an index file used to find the records of a file without an index?
+     * @return true if an index file is used.
+     */
+    bool Reader::usesIndexFile() const {return useIndexFile;}
+
+
+    /**
+     * Get the default name of the index file of the file being read,
+     * which is the file's name with ".idx" appended.
+     * @return default name of the index file, or empty string if not reading a file.
+     */
+    std::string Reader::getIndexFileName() const {
+        if (!fromFile || fileName.empty()) {
+            return "";
+        }
+        return fileName + ".idx";
+    }
+
+
+    /**
+     * Load the record positions and event counts of the file being read from an index file
+     * previously written by {@link #writeIndexFile}, instead of scanning the file.
+     * The index file is only used if the size and modification time of the file are
+     * the same as when the index file was written, if it's in this machine's byte order,
+     * and if its records fit in the file.
+     * The file header and first record header are read from the file.
+     *
+     * @param indexFileName name of index file. If empty, use {@link #getIndexFileName()}.
+     * @return true if a valid index file was loaded, false if it does not exist or is not valid
+     *         (in which case nothing is changed).
+     * @throws EvioException if not reading a file;
+     *                       if file is not in the proper format or earlier than version 6.
+     */
+    bool Reader::readIndexFile(std::string const & indexFileName) {
+
+        if (!fromFile) {
+            throw EvioException("not reading a file");
+        }
+
+        std::string name = indexFileName.empty() ? getIndexFileName() : indexFileName;
+
+        struct stat fileStat {};
+        if (::stat(fileName.c_str(), &fileStat) != 0) {
+            return false;
+        }
+
+        std::ifstream in(name, std::ios::binary);
+        if (!in.is_open()) {
+            return false;
+        }
+
+        // Header: magic, version, record count, unused, file size, mtime seconds & nanoseconds
+        uint32_t hdr[4];
+        int64_t fileInfo[3];
+        in.read(reinterpret_cast<char *>(hdr), sizeof(hdr));
+        in.read(reinterpret_cast<char *>(fileInfo), sizeof(fileInfo));
+        if (!in || hdr[0] != INDEX_FILE_MAGIC || hdr[1] != INDEX_FILE_VERSION) {
+            return false;
+        }
+
+#ifdef __APPLE__
+        int64_t mtimeNsec = fileStat.st_mtimespec.tv_nsec;
+#else
+        int64_t mtimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+        if (fileInfo[0] != (int64_t)fileStat.st_size ||
+            fileInfo[1] != (int64_t)fileStat.st_mtime ||
+            fileInfo[2] != mtimeNsec) {
+            return false;
+        }
+
+        // Each record: position (8 bytes), length (4), event count (4).
+        // Check the count against the index file's size before trusting it.
+        uint32_t recordCount = hdr[2];
+        struct stat indexStat {};
+        if (::stat(name.c_str(), &indexStat) != 0 ||
+            (uint64_t)indexStat.st_size != sizeof(hdr) + sizeof(fileInfo) + 16*(uint64_t)recordCount) {
+            return false;
+        }
+
+        std::vector<char> recordData(16*(size_t)recordCount);
+        in.read(recordData.data(), (std::streamsize)recordData.size());
+        if (!in) {
+            return false;
+        }
+
+        std::vector<RecordPosition> positions;
+        positions.reserve(recordCount);
+        const char *pData = recordData.data();
+        for (uint32_t i=0; i < recordCount; i++) {
+            uint64_t pos;
+            uint32_t len, count;
+            std::memcpy(&pos,   pData,      8);
+            std::memcpy(&len,   pData + 8,  4);
+            std::memcpy(&count, pData + 12, 4);
+            pData += 16;
+            if (pos + len > (uint64_t)fileStat.st_size) {
+                return false;
+            }
+            positions.emplace_back(pos, len, count);
+        }
+
+        // Read file header and first record header, as when scanning
+        ByteBuffer headerBuffer(FileHeader::HEADER_SIZE_BYTES);
+        auto headerBytes = reinterpret_cast<char *>(headerBuffer.array());
+
+        readFromFile(headerBytes, 0L, FileHeader::HEADER_SIZE_BYTES);
+        fileHeader = FileHeader();
+        fileHeader.readHeader(headerBuffer);
+        byteOrder = fileHeader.getByteOrder();
+        evioVersion = fileHeader.getVersion();
+
+        if (!positions.empty()) {
+            readFromFile(headerBytes, positions[0].getPosition(), RecordHeader::HEADER_SIZE_BYTES);
+            firstRecordHeader = std::make_shared<RecordHeader>();
+            firstRecordHeader->readHeader(headerBuffer);
+            compressed = firstRecordHeader->getCompressionType() != Compressor::UNCOMPRESSED;
+        }
+
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        clearRecordCache();
+        eventIndex.clear();
+        recordPositions = std::move(positions);
+        for (auto const & recPos : recordPositions) {
+            eventIndex.addEventSize(recPos.getCount());
+        }
+
+        return true;
+    }
+
+
+    /**
+     * Write the record positions and event counts of the file being read into an index file,
+     * so that later, {@link #readIndexFile} can load them instead of scanning the file.
+     * The size and modification time of the file are stored along with them.
+     * The index file is written in this machine's byte order. It's first written under
+     * a temporary name and then renamed, so readers never see a partially written index file.
+     *
+     * @param indexFileName name of index file. If empty, use {@link #getIndexFileName()}.
+     * @throws EvioException if not reading a file; if index file cannot be written.
+     */
+    void Reader::writeIndexFile(std::string const & indexFileName) {
+
+        if (!fromFile) {
+            throw EvioException("not reading a file");
+        }
+
+        std::string name = indexFileName.empty() ? getIndexFileName() : indexFileName;
+
+        struct stat fileStat {};
+        if (::stat(fileName.c_str(), &fileStat) != 0) {
+            throw EvioException("cannot stat " + fileName);
+        }
+
+#ifdef __APPLE__
+        int64_t mtimeNsec = fileStat.st_mtimespec.tv_nsec;
+#else
+        int64_t mtimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+
+        uint32_t hdr[4] = {INDEX_FILE_MAGIC, INDEX_FILE_VERSION, (uint32_t)recordPositions.size(), 0};
+        int64_t fileInfo[3] = {(int64_t)fileStat.st_size, (int64_t)fileStat.st_mtime, mtimeNsec};
+
+        std::vector<char> recordData(16*recordPositions.size());
+        char *pData = recordData.data();
+        for (auto const & recPos : recordPositions) {
+            uint64_t pos = recPos.getPosition();
+            uint32_t len = recPos.getLength(), count = recPos.getCount();
+            std::memcpy(pData,      &pos,   8);
+            std::memcpy(pData + 8,  &len,   4);
+            std::memcpy(pData + 12, &count, 4);
+            pData += 16;
+        }
+
+        std::string tmpName = name + ".tmp" + std::to_string(::getpid());
+        {
+            std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(hdr), sizeof(hdr));
+            out.write(reinterpret_cast<const char *>(fileInfo), sizeof(fileInfo));
+            out.write(recordData.data(), (std::streamsize)recordData.size());
+            out.close();
+            if (!out) {
+                std::remove(tmpName.c_str());
+                throw EvioException("cannot write index file " + name);
+            }
+        }
+
+        if (std::rename(tmpName.c_str(), name.c_str()) != 0) {
+            std::remove(tmpName.c_str());
+            throw EvioException("cannot write index file " + name);
+        }
+    }
+
+
+    /**
+     * Set whether the file is followed while it's still being written (e.g. by {@link EventWriter}),
+     * like "tail -f". In follow mode, opening a file only finds the complete records
+     * written so far. When {@link #getNextEvent(uint32_t *)} runs out of events, the file
+     * is checked for newly appended complete records, whose events are then returned.
+     * A null return means no new events yet, unless {@link #isEndOfStream()} is true, meaning
+     * the trailer (or a record marked as last) has been reached and the file is complete.
+     * Use {@link #waitForEvents(uint32_t)} to wait for new events.
+     * Any index in the file or an index file is ignored, and the file is never memory mapped.
+     * Files written with direct I/O can be followed too, the zero padding left after
+     * a forced write is skipped until the writer fills it in.
+     * Must be called before {@link #open(std::string const &, bool, bool)}.
+     *
+     * @param follow true to follow a file being written.
+     */
+    void Reader::setFollowMode(bool follow) {followMode = follow;}
+
+
+    /**
+     * Is the file followed while it's still being written?
+     * @return true if the file is followed while it's still being written.
+     */
+    bool Reader::isFollowMode() const {return followMode;}
+
+
+    /**
+     * In follow mode, has the end of the file been reached? That's the case once
+     * the trailer, or a record marked as the last one, has been found.
+     * Not in follow mode, this is always true.
+     * @return true if no more records will be appended to the file.
+     */
+    bool Reader::isEndOfStream() const {return !followMode || endOfStream;}
+
+
+    /**
+     * Start following the file: forget any records found so far,
+     * then look for all the complete records written so far.
+     * @throws EvioException if error reading file or file is not in the proper format.
+     */
+    void Reader::startFollowing() {
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        clearRecordCache();
+        eventIndex.clear();
+        recordPositions.clear();
+        firstRecordHeader = nullptr;
+        endOfStream = false;
+        followPosition = 0;
+
+        updateFollowedFile();
+    }
+
+
+    /** Stop following the file and release anything used to wait for it to change. */
+    void Reader::stopFollowing() {
+        if (followNotifyFd >= 0) {
+            ::close(followNotifyFd);
+            followNotifyFd = -1;
+        }
+    }
+
+
+    /**
+     * Are all the given bytes zero?
+     * @param bytes pointer to bytes.
+     * @param len   number of bytes.
+     * @return true if all bytes are zero.
+     */
+    static bool isZeroFilled(const uint8_t *bytes, size_t len) {
+        return std::all_of(bytes, bytes + len, [](uint8_t b) {return b == 0;});
+    }
+
+
+    /**
+     * In follow mode, look for complete records appended to the file since last looked.
+     * A record is only added once all its bytes are in the file. Finding the trailer,
+     * or a record marked as the last one, ends the stream. A header of all zeros is
+     * taken as not yet written, since a writer using direct I/O pads the file with zeros
+     * to a whole block when forcing data to disk, then overwrites them with the next record.
+     * This is called by {@link #getNextEvent(uint32_t *)} when it runs out of events.
+     *
+     * @return number of events in the records found.
+     * @throws EvioException if error reading file or file is not in the proper format.
+     */
+    uint32_t Reader::updateFollowedFile() {
+
+        if (!followMode || !fromFile || endOfStream) {
+            return 0;
+        }
+
+        struct stat fileStat {};
+        if (::stat(fileName.c_str(), &fileStat) != 0) {
+            throw EvioException("cannot stat " + fileName);
+        }
+        fileSize = fileStat.st_size;
+
+        ByteBuffer headerBuffer(FileHeader::HEADER_SIZE_BYTES);
+        auto headerBytes = reinterpret_cast<char *>(headerBuffer.array());
+
+        try {
+            if (followPosition == 0) {
+                // Writer may not have written the file header yet
+                if (fileSize < FileHeader::HEADER_SIZE_BYTES) {
+                    return 0;
+                }
+
+                FileHeader header;
+                readFromFile(headerBytes, 0L, FileHeader::HEADER_SIZE_BYTES);
+
+                // Zeros are space a direct I/O writer has padded out but not yet written
+                if (isZeroFilled(headerBuffer.array(), FileHeader::HEADER_SIZE_BYTES)) {
+                    return 0;
+                }
+                header.readHeader(headerBuffer);
+
+                // Wait for the file's index and user header too
+                if (fileSize < header.getLength()) {
+                    return 0;
+                }
+
+                fileHeader = header;
+                byteOrder = fileHeader.getByteOrder();
+                evioVersion = fileHeader.getVersion();
+                followPosition = fileHeader.getLength();
+            }
+
+            uint32_t newEvents = 0;
+            uint32_t recordCount = recordPositions.size();
+            RecordHeader recordHeader;
+
+            while (followPosition + RecordHeader::HEADER_SIZE_BYTES <= fileSize) {
+                readFromFile(headerBytes, followPosition, RecordHeader::HEADER_SIZE_BYTES);
+                if (isZeroFilled(headerBuffer.array(), RecordHeader::HEADER_SIZE_BYTES)) {
+                    break;
+                }
+                recordHeader.readHeader(headerBuffer);
+
+                if (recordHeader.getHeaderType().isTrailer()) {
+                    endOfStream = true;
+                    break;
+                }
+
+                // Wait until the whole record is written
+                uint32_t recordLen = recordHeader.getLength();
+                if (followPosition + recordLen > fileSize) {
+                    break;
+                }
+
+                if (firstRecordHeader == nullptr) {
+                    firstRecordHeader = std::make_shared<RecordHeader>(recordHeader);
+                    compressed = firstRecordHeader->getCompressionType() != Compressor::UNCOMPRESSED;
+                }
+
+                recordPositions.emplace_back(followPosition, recordLen, recordHeader.getEntries());
+                eventIndex.addEventSize(recordHeader.getEntries());
+                newEvents += recordHeader.getEntries();
+                followPosition += recordLen;
+
+                if (recordHeader.isLastRecord()) {
+                    endOfStream = true;
+                    break;
+                }
+            }
+
+            if (recordPositions.size() > recordCount) {
+                // These work from a fixed list of records
+                readAhead = nullptr;
+                asyncIO = nullptr;
+            }
+
+            return newEvents;
+        }
+        catch (std::ifstream::failure & e) {
+            throw EvioException(e.what());
+        }
+    }
+
+
+    /**
+     * In follow mode, wait until there's an event after the last one returned by
+     * {@link #getNextEvent(uint32_t *)}, or the end of the stream is reached, or
+     * the timeout expires. On Linux, inotify tells when the file changes, so new records
+     * are found with low latency; otherwise (or on network filesystems where inotify does not
+     * see other hosts' writes), the file is checked every {@link #FOLLOW_POLL_MILLISEC} ms.
+     * Not in follow mode, this returns immediately.
+     *
+     * @param timeoutMillisec max time to wait in milliseconds.
+     * @return true if the next event is available, false if not (timeout or end of stream).
+     * @throws EvioException if error reading file or file is not in the proper format.
+     */
+    bool Reader::waitForEvents(uint32_t timeoutMillisec) {
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillisec);
+
+        while (true) {
+            // Index of event the next getNextEvent will return
+            uint32_t nextIndex = 0;
+            if (sequentialIndex >= 0) {
+                nextIndex = lastCalledSeqNext ? sequentialIndex : sequentialIndex + 1;
+            }
+
+            if (nextIndex < eventIndex.getMaxEvents()) {
+                return true;
+            }
+
+            if (!followMode || !fromFile || endOfStream) {
+                return false;
+            }
+
+            if (updateFollowedFile() > 0) {
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (endOfStream || now >= deadline) {
+                return false;
+            }
+
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            waitForFileChange((uint32_t) left + 1);
+        }
+    }
+
+
+    /**
+     * Wait for the followed file to change, or a short time if that cannot be known.
+     * @param timeoutMillisec max time to wait in milliseconds.
+     */
+    void Reader::waitForFileChange(uint32_t timeoutMillisec) {
+#ifdef __linux__
+        if (followNotifyFd < 0) {
+            followNotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (followNotifyFd >= 0 &&
+                ::inotify_add_watch(followNotifyFd, fileName.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+                ::close(followNotifyFd);
+                followNotifyFd = -1;
+            }
+        }
+
+        if (followNotifyFd >= 0) {
+            struct pollfd pfd {followNotifyFd, POLLIN, 0};
+            int n = ::poll(&pfd, 1, (int) std::min(timeoutMillisec, FOLLOW_NOTIFY_MILLISEC));
+            if (n > 0) {
+                // Drain notifications, their content does not matter
+                char events[4096];
+                while (::read(followNotifyFd, events, sizeof(events)) > 0) {}
+            }
+            return;
+        }
+#endif
+        ::poll(nullptr, 0, (int) std::min(timeoutMillisec, FOLLOW_POLL_MILLISEC));
+    }
+
+
     /**
      * Scans the file to index all the record positions.
      * It takes advantage of any existing indexes in file.
@@ -1583,12 +2732,20 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
      */
     void Reader::scanFile(bool force) {
 
+        if (followMode) {
+            startFollowing();
+            return;
+        }
+
         if (force) {
 //std::cout << "\nscanFile ---> calling forceScanFile ..." << std::endl;
             forceScanFile();
             return;
         }
 
+        readAhead = nullptr;
+        asyncIO = nullptr;
+        clearRecordCache();
         eventIndex.clear();
         recordPositions.clear();
         // recordNumberExpected = 1;
@@ -1599,11 +2756,8 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 
         fileHeader = FileHeader();
 
-        // Go to file beginning
-        inStreamRandom.seekg(0L);
-
-        // Read and parse file header
-        inStreamRandom.read(headerBytes, FileHeader::HEADER_SIZE_BYTES);
+        // Read and parse file header at file beginning
+        readFromFile(headerBytes, 0L, FileHeader::HEADER_SIZE_BYTES);
         fileHeader.readHeader(headerBuffer);
         byteOrder = fileHeader.getByteOrder();
         evioVersion = fileHeader.getVersion();
@@ -1620,7 +2774,7 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
         // If there is no index, scan file
         if (!fileHasIndex) {
 //std::cout << "scanFile: CALL forceScanFile" << std::endl;
-            forceScanFile();
+            scanFileWithoutIndex();
             return;
         }
 
@@ -1637,7 +2791,7 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
                 }
                 else {
                     // Scan if no viable index exists
-                    forceScanFile();
+                    scanFileWithoutIndex();
                     return;
                 }
             }
@@ -1648,37 +2802,37 @@ std::cout << "findRecInfo: buf cap = " << buf.capacity() << ", offset = " << off
 //std::cout << "scanFile: record position (past file's header + index + user header) = " << recordPosition << std::endl;
 
         // Move to first record and save the header
-        inStreamRandom.seekg(recordPosition);
-        inStreamRandom.read(headerBytes, RecordHeader::HEADER_SIZE_BYTES);
+        readFromFile(headerBytes, recordPosition, RecordHeader::HEADER_SIZE_BYTES);
         firstRecordHeader = std::make_shared<RecordHeader>();
         firstRecordHeader->readHeader(headerBuffer);
         compressed = firstRecordHeader->getCompressionType() != Compressor::UNCOMPRESSED;
 //std::cout << "scanFile: read first record header ->\n" << firstRecordHeader->toString() << std::endl;
 
         int indexLength;
+        size_t indexPosition;
 
         // If we have a trailer with indexes ...
         if (useTrailer) {
             // Position read right before trailing header
-            inStreamRandom.seekg(fileHeader.getTrailerPosition());
 //std::cout << "scanFile: position file to trailer = " << fileHeader.getTrailerPosition() << std::endl;
             // Read trailer
-            inStreamRandom.read(headerBytes, RecordHeader::HEADER_SIZE_BYTES);
+            readFromFile(headerBytes, fileHeader.getTrailerPosition(), RecordHeader::HEADER_SIZE_BYTES);
             RecordHeader recordHeader;
             recordHeader.readHeader(headerBuffer);
             indexLength = recordHeader.getIndexLength();
+            // Index immediately follows trailer
+            indexPosition = fileHeader.getTrailerPosition() + RecordHeader::HEADER_SIZE_BYTES;
         }
         else {
-            // Move back to immediately past file header
+            // Index immediately follows file header in this case,
             // while taking care of non-standard size
-            inStreamRandom.seekg(fileHeader.getHeaderLength());
-            // Index immediately follows file header in this case
             indexLength = fileHeader.getIndexLength();
+            indexPosition = fileHeader.getHeaderLength();
         }
 
         // Read indexes
         char index[indexLength];
-        inStreamRandom.read(index, indexLength);
+        readFromFile(index, indexPosition, indexLength);
         // Turn bytes into record lengths & event counts
         uint32_t intData[indexLength/4];
 
@@ -16,12 +16,14 @@
 #include <cstring>
 #include <string>
 #include <vector>
+#include <list>
 #include <fstream>
 #include <ios>
 #include <iostream>
 #include <stdexcept>
 #include <memory>
-
+#include <chrono>
+#include <algorithm>
 
 #include "ByteOrder.h"
 #include "ByteBuffer.h"
@@ -29,6 +31,8 @@
 #include "RecordHeader.h"
 #include "FileEventIndex.h"
 #include "RecordInput.h"
+#include "RecordReadAhead.h"
+#include "AsyncRecordIO.h"
 #include "EvioException.h"
 #include "EvioNode.h"
 #include "IBlockHeader.h"
@@ -194,6 +198,75 @@ namespace evio {
         std::vector<RecordPosition> recordPositions;
         /** Object for reading file. */
         std::ifstream inStreamRandom;
+        /** If true, memory map the file instead of reading it through inStreamRandom. */
+        bool useMappedMemory = false;
+        /** Buffer wrapping the memory mapped file, if any. */
+        std::shared_ptr<ByteBuffer> mappedBuffer = nullptr;
+        /** Number of threads reading & decompressing records ahead of the current one, 0 = none. */
+        uint32_t readAheadThreads = 0;
+        /** Max number of records read & decompressed ahead of the current one. */
+        uint32_t readAheadRecords = 0;
+        /** Object reading records ahead, created when the first record is read. */
+        std::shared_ptr<RecordReadAhead> readAhead = nullptr;
+        /** How records of a file are read from disk. */
+        AsyncRecordIO::IoEngine ioEngine = AsyncRecordIO::IFSTREAM;
+        /** Max number of records read at once by io_uring. */
+        uint32_t ioQueueDepth = 8;
+        /** Object reading records for the PREAD and IO_URING engines, created when the first record is read. */
+        std::shared_ptr<AsyncRecordIO> asyncIO = nullptr;
+
+        /**
+         * If true, a compressed buffer is not decompressed all at once when scanned.
+         * Only its record headers are scanned and each record is decompressed the
+         * first time one of its events is accessed.
+         */
+        bool lazyDecompression = false;
+        /**
+         * Max number of decompressed records kept in memory, including the current one.
+         * 0 = no limit. If &gt; 1, records are cached so that going back to a recently read
+         * record does not read and decompress it again.
+         */
+        uint32_t recordCacheSize = 1;
+        /** Cached records, other than the current one, keyed by record index. Most recently used first. */
+        std::list<std::pair<uint32_t, std::shared_ptr<RecordInput>>> cachedRecords;
+        /** When using the record cache, does inputRecordStream hold a record of the current file/buffer? */
+        bool haveCachedCurrent = false;
+        /** Number of records found in cache when read. */
+        uint64_t recordCacheHits = 0;
+        /** Number of records not found in cache when read. */
+        uint64_t recordCacheMisses = 0;
+
+        /**
+         * If true, and the file has no index of its own, record positions are
+         * loaded from an index file (see {@link #readIndexFile}) instead of scanning
+         * the file. If that index file does not exist or is out of date,
+         * the file is scanned and the index file (re)written.
+         */
+        bool useIndexFile = false;
+        /** Magic number at the start of an index file. */
+        static const uint32_t INDEX_FILE_MAGIC = 0x65766978;
+        /** Version of index file format. */
+        static const uint32_t INDEX_FILE_VERSION = 1;
+        /**
+         * If true, the file is still being written and newly appended records
+         * are looked for when all known events have been read.
+         */
+        bool followMode = false;
+        /** In follow mode, has the trailer (or last record) been found? */
+        bool endOfStream = false;
+        /** In follow mode, position of the next record to look for, 0 if file header not yet read. */
+        size_t followPosition = 0;
+        /** In follow mode, inotify file descriptor used to wait for the file to change, -1 if none. */
+        int followNotifyFd = -1;
+        /** In follow mode, max time in milliseconds to wait for a file change before checking again. */
+        static const uint32_t FOLLOW_POLL_MILLISEC = 10;
+        /** In follow mode, same as above but when notified of file changes by inotify. */
+        static const uint32_t FOLLOW_NOTIFY_MILLISEC = 100;
+
+        /** Number of bytes read at once when scanning a file's record headers. */
+        static const uint32_t SCAN_CHUNK_BYTES = 1048576;
+        /** Alignment of the start of each chunk read when scanning a file. */
+        static const uint32_t SCAN_CHUNK_ALIGN = 4096;
         /** File name. */
         std::string fileName {""};
         /** File size in bytes. */
@@ -233,6 +306,8 @@ namespace evio {
         std::shared_ptr<uint8_t> firstEvent = nullptr;
         /** First event size in bytes. */
         uint32_t firstEventSize = 0;
+        /** Files may have a dictionary, used to compress records, in the user header of the file header. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
 
         // TODO: The HIPO library is NOT evio dependent!!!!
 
@@ -267,6 +342,16 @@ namespace evio {
 
 
         void setByteOrder(ByteOrder & order);
+        void mapFile(std::string const & filename);
+        void startReadAhead();
+        void loadCachedRecord(uint32_t index, size_t pos);
+        void readFileRecord(RecordInput & record, uint32_t index, size_t pos);
+        void clearRecordCache();
+        bool usesRecordCache() const;
+        bool needsRecordRead() const;
+        void scanCompressedBufferHeaders();
+        uint8_t* copyFirstRecordUserHeader(uint32_t userLen);
+        void readFromFile(char *dest, size_t position, size_t len);
         static uint32_t getTotalByteCounts(ByteBuffer & buf, uint32_t* info, uint32_t infoLen);
         static uint32_t getTotalByteCounts(std::shared_ptr<ByteBuffer> buf, uint32_t* info, uint32_t infoLen);
         //static std::string getStringArray(ByteBuffer & buffer, int wrap, int max);
@@ -277,16 +362,48 @@ namespace evio {
         Reader();
         explicit Reader(std::string const & filename);
         Reader(std::string const & filename, bool checkRecordNumSeq, bool forceScan = true);
+        Reader(std::string const & filename, bool checkRecordNumSeq, bool forceScan, bool useMappedMem);
         explicit Reader(std::shared_ptr<ByteBuffer> & buffer, bool checkRecordNumSeq = false);
+        Reader(std::shared_ptr<ByteBuffer> & buffer, bool checkRecordNumSeq,
+               bool lazyDecompress, uint32_t maxResidentRecs = 1);
 
-        ~Reader() = default;
+        ~Reader();
 
         void rewind();
-        void open(std::string const & filename, bool scan = true);
+        void open(std::string const & filename, bool scan = true, bool useMappedMem = false);
         void close();
 
         bool isClosed() const;
         bool isFile() const;
+        bool isMemoryMapped() const;
+
+        void setReadAhead(uint32_t threadCount, uint32_t recordCount);
+        uint32_t getReadAheadThreads() const;
+        uint32_t getReadAheadRecords() const;
+
+        void setIoEngine(AsyncRecordIO::IoEngine engine, uint32_t queueDepth = 8);
+        AsyncRecordIO::IoEngine getIoEngine() const;
+
+        void setLazyDecompression(bool lazy, uint32_t maxResidentRecs = 1);
+        bool isLazyDecompression() const;
+
+        void setRecordCacheSize(uint32_t recordCount);
+        uint32_t getRecordCacheSize() const;
+        uint64_t getRecordCacheHits() const;
+        uint64_t getRecordCacheMisses() const;
+        void resetRecordCacheStats();
+
+        void setUseIndexFile(bool use);
+        bool usesIndexFile() const;
+        std::string getIndexFileName() const;
+        bool readIndexFile(std::string const & indexFileName = "");
+        void writeIndexFile(std::string const & indexFileName = "");
+
+        void setFollowMode(bool follow);
+        bool isFollowMode() const;
+        bool isEndOfStream() const;
+        uint32_t updateFollowedFile();
+        bool waitForEvents(uint32_t timeoutMillisec);
 
         std::string getFileName() const;
         size_t getFileSize() const;
@@ -309,6 +426,9 @@ namespace evio {
         uint32_t getFirstEventSize();
         bool hasFirstEvent() const;
 
+        std::shared_ptr<CompressionDictionary> getCompressionDictionary();
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+
         uint32_t getEventCount() const;
         uint32_t getRecordCount() const;
 
@@ -326,6 +446,7 @@ namespace evio {
         std::shared_ptr<ByteBuffer> readUserHeader();
 
         std::shared_ptr<uint8_t> getEvent(uint32_t index, uint32_t * len);
+        EventView getEventView(uint32_t index);
         ByteBuffer & getEvent(ByteBuffer & buf, uint32_t index);
         std::shared_ptr<ByteBuffer> getEvent(std::shared_ptr<ByteBuffer> buf, uint32_t index);
         uint32_t getEventLength(uint32_t index);
@@ -345,6 +466,7 @@ namespace evio {
         void extractDictionaryAndFirstEvent();
         void extractDictionaryFromBuffer();
         void extractDictionaryFromFile();
+        void loadCompressionDictionary();
 
 
         static void findRecordInfo(std::shared_ptr<ByteBuffer> & buf, uint32_t offset,
@@ -357,6 +479,10 @@ namespace evio {
         void scanUncompressedBuffer();
         void forceScanFile();
         void scanFile(bool force);
+        void scanFileWithoutIndex();
+        void startFollowing();
+        void stopFollowing();
+        void waitForFileChange(uint32_t timeoutMillisec);
 
         // Is called by removeStructure method, below
         std::shared_ptr<ByteBuffer> & removeEvent(std::shared_ptr<EvioNode> & removeNode);
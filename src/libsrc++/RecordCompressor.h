@@ -23,6 +23,7 @@
 #include "RecordHeader.h"
 #include "Compressor.h"
 #include "RecordSupply.h"
+#include "ThreadPlacement.h"
 
 
 #include "Disruptor/Util.h"
@@ -53,6 +54,8 @@ namespace evio {
         std::shared_ptr<RecordSupply> supply;
         /** Thread which does the compression. */
         boost::thread thd;
+        /** CPUs the thread may run on, empty for any. */
+        std::vector<int> cpus;
 
     public:
 
@@ -80,7 +83,8 @@ namespace evio {
                 threadNumber(obj.threadNumber),
                 compressionType(obj.compressionType),
                 supply(std::move(obj.supply)),
-                thd(std::move(obj.thd)) {
+                thd(std::move(obj.thd)),
+                cpus(std::move(obj.cpus)) {
         }
 
         /** Define equal operator. */
@@ -90,6 +94,7 @@ namespace evio {
                 compressionType = obj.compressionType;
                 supply = std::move(obj.supply);
                 thd  = std::move(obj.thd);
+                cpus = std::move(obj.cpus);
             }
             return *this;
         }
@@ -104,9 +109,20 @@ namespace evio {
             }
         }
 
+        /**
+         * Set the CPUs the thread may run on. If it's already running, it's pinned now,
+         * else when started.
+         * @param cpuSet CPUs to run on, empty for any.
+         */
+        void setCpus(std::vector<int> const & cpuSet) {
+            cpus = cpuSet;
+            ThreadPlacement::pinThread(thd, cpus);
+        }
+
         /** Create and start a thread to execute the run() method of this class. */
         void startThread() {
             thd = boost::thread([this]() {this->run();});
+            ThreadPlacement::pinThread(thd, cpus);
         }
 
         /** Stop the thread. */
@@ -177,6 +193,12 @@ namespace evio {
                 // Never happen since we don't use timeout wait strategy
                 //cout << "RecordCompressor thd " << threadNumber << ": INTERRUPTED, return" << endl;
             }
+            catch (std::runtime_error & e) {
+                // Compression failed, let the writer report it
+                std::string err = e.what();
+                supply->haveError(true);
+                supply->setError(err);
+            }
         }
     };
 
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "RecordFlushTimer.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#endif
+
+
+namespace evio {
+
+
+    /**
+     * Constructor. Starts the thread.
+     * @param periodMillis milliseconds between calls to the function, at least 1.
+     * @param tick function to run with the writing thread kept out.
+     */
+    RecordFlushTimer::RecordFlushTimer(uint32_t periodMillis, std::function<void()> tick) :
+            periodMillis(std::max(periodMillis, 1U)),
+            tick(std::move(tick)),
+            asymmetric(registerMembarrier()) {
+
+        thd = boost::thread([this]() {this->run();});
+    }
+
+
+    /** Destructor. Stops the thread. */
+    RecordFlushTimer::~RecordFlushTimer() {
+        stop();
+    }
+
+
+    /**
+     * Register this process for expedited private membarrier calls.
+     * @return true if membarrier can be used.
+     */
+    bool RecordFlushTimer::registerMembarrier() {
+#if defined(__linux__) && defined(SYS_membarrier)
+        long cmds = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+        if (cmds < 0 || !(cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) return false;
+        return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+
+    /** Make every running thread of this process execute a full memory barrier. */
+    void RecordFlushTimer::heavyBarrier() {
+#if defined(__linux__) && defined(SYS_membarrier)
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+
+    /** Body of the thread. Every period, wait for the writing thread to leave and run the function. */
+    void RecordFlushTimer::run() {
+        try {
+            while (true) {
+                boost::this_thread::sleep_for(boost::chrono::milliseconds(periodMillis));
+
+                std::lock_guard<std::mutex> lock(timerMutex);
+                timerActive.store(true, std::memory_order_relaxed);
+                if (asymmetric) heavyBarrier();
+                else std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                // The writing thread now either sees timerActive and steps back,
+                // or it's already in and we see userActive
+                try {
+                    while (userActive.load(std::memory_order_acquire)) {
+                        boost::this_thread::sleep_for(boost::chrono::microseconds(50));
+                    }
+                    tick();
+                }
+                catch (boost::thread_interrupted & e) {
+                    timerActive.store(false, std::memory_order_release);
+                    throw;
+                }
+                timerActive.store(false, std::memory_order_release);
+            }
+        }
+        catch (boost::thread_interrupted & e) {}
+    }
+
+
+    /** Stop the thread and wait for it to end. Any call of the function in progress finishes first. */
+    void RecordFlushTimer::stop() {
+        if (thd.joinable()) {
+            thd.interrupt();
+            thd.join();
+        }
+    }
+
+
+    /** @return milliseconds between calls to the function. */
+    uint32_t RecordFlushTimer::getPeriod() const {return periodMillis;}
+
+}
@@ -0,0 +1,139 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_RECORDFLUSHTIMER_H
+#define EVIO_6_0_RECORDFLUSHTIMER_H
+
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+
+#include <boost/thread.hpp>
+
+
+namespace evio {
+
+
+    /**
+     * Class used by {@link EventWriter} to run a function at regular intervals in its own
+     * thread while the thread writing events is kept out, so that function may
+     * safely send off the record being filled once it gets too old.<p>
+     *
+     * The writing thread marks the time it spends in the writer's methods with a
+     * {@link Guard}. This costs two plain stores and a plain load per call, with no
+     * locked instruction or memory fence. The timer thread does the expensive part:
+     * after announcing that it wants in, it makes every thread of the process execute a
+     * memory barrier through the Linux membarrier system call, then waits for the writing
+     * thread to leave. Where membarrier is not available, the writing thread uses a
+     * full memory fence instead.<p>
+     *
+     * Only one thread may write events, as is already required by the writer.
+     * <b>This is for internal use only.</b>
+     *
+     * @date 10/16/2026
+     * @author timmer
+     */
+    class RecordFlushTimer {
+
+    public:
+
+        /** Marks, for its lifetime, that the writing thread is using the writer. May be nested. */
+        class Guard {
+            RecordFlushTimer *timer;
+        public:
+            explicit Guard(RecordFlushTimer *t) : timer(t) {if (timer != nullptr) timer->enter();}
+            ~Guard() {if (timer != nullptr) timer->exit();}
+            Guard(const Guard &) = delete;
+            Guard & operator=(const Guard &) = delete;
+        };
+
+    private:
+
+        /** Milliseconds between calls to the function. */
+        uint32_t periodMillis;
+
+        /** Function to run with the writing thread kept out. */
+        std::function<void()> tick;
+
+        /** Is the writing thread using the writer? */
+        std::atomic<bool> userActive{false};
+
+        /** Does the timer thread want in or is it in? */
+        std::atomic<bool> timerActive{false};
+
+        /** Held by the timer thread while it runs the function, so the writing thread can wait on it. */
+        std::mutex timerMutex;
+
+        /** Depth of nested guards in the writing thread. Only used by that thread. */
+        uint32_t depth = 0;
+
+        /** Does membarrier make the writing thread's memory fence unnecessary? */
+        bool asymmetric;
+
+        /** Thread running the function. */
+        boost::thread thd;
+
+
+        static bool registerMembarrier();
+        static void heavyBarrier();
+
+        void run();
+
+
+        /** Called by the writing thread when it starts using the writer. */
+        void enter() {
+            if (depth++ > 0) return;
+
+            while (true) {
+                userActive.store(true, std::memory_order_relaxed);
+
+                // Order the store before the load. With membarrier, the timer thread
+                // forces that order on this thread's CPU, so only the compiler must keep it.
+                if (asymmetric) {
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                }
+                else {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                }
+
+                if (!timerActive.load(std::memory_order_acquire)) return;
+
+                // Timer thread is running, step back and wait for it to finish
+                userActive.store(false, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(timerMutex);
+            }
+        }
+
+
+        /** Called by the writing thread when it stops using the writer. */
+        void exit() {
+            if (--depth == 0) {
+                userActive.store(false, std::memory_order_release);
+            }
+        }
+
+    public:
+
+        RecordFlushTimer(uint32_t periodMillis, std::function<void()> tick);
+        ~RecordFlushTimer();
+
+        RecordFlushTimer(const RecordFlushTimer &) = delete;
+        RecordFlushTimer & operator=(const RecordFlushTimer &) = delete;
+
+        void stop();
+        uint32_t getPeriod() const;
+    };
+
+}
+
+#endif //EVIO_6_0_RECORDFLUSHTIMER_H
@@ -293,7 +293,7 @@ namespace evio {
 
 
     /**
-     * Get the type of compression used. 0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip.
+     * Get the type of compression used. 0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip, 4=zstd.
      * @return type of compression used.
      */
     Compressor::CompressionType  RecordHeader::getCompressionType() {return compressionType;}
@@ -651,6 +651,74 @@ namespace evio {
     bool RecordHeader::isLastRecord(uint32_t bitInfo) {return ((bitInfo & LAST_RECORD_BIT) != 0);}
 
 
+    /**
+     * Set the bit which says record is compressed with the file's compression dictionary.
+     * @param hasDict  true if record is compressed with the file's compression dictionary.
+     * @return new bitInfo word.
+     */
+    uint32_t RecordHeader::hasCompressionDictionary(bool hasDict) {
+        if (hasDict) {
+            // set bit
+            bitInfo |= COMPRESSION_DICTIONARY_BIT;
+        }
+        else {
+            // clear bit
+            bitInfo &= ~COMPRESSION_DICTIONARY_BIT;
+        }
+
+        return bitInfo;
+    }
+
+
+    /**
+     * Is this record compressed with the file's compression dictionary?
+     * @return true if record is compressed with the file's compression dictionary, else false.
+     */
+    bool RecordHeader::hasCompressionDictionary() const {return ((bitInfo & COMPRESSION_DICTIONARY_BIT) != 0);}
+
+
+    /**
+     * Does this bitInfo arg indicate a record compressed with the file's compression dictionary?
+     * @param bitInfo bitInfo word.
+     * @return true if record is compressed with the file's compression dictionary, else false.
+     */
+    bool RecordHeader::hasCompressionDictionary(uint32_t bitInfo) {return ((bitInfo & COMPRESSION_DICTIONARY_BIT) != 0);}
+
+
+    /**
+     * Set the bits which say what filter was applied to the data before compression.
+     * @param type     type of filter.
+     * @param wordSize size in bytes of words filtered, 4 or 8.
+     * @return new bitInfo word.
+     */
+    uint32_t RecordHeader::setDataFilter(DataFilter::FilterType type, uint32_t wordSize) {
+        bitInfo &= ~(DATA_FILTER_MASK | DATA_FILTER_WORD8_BIT);
+        bitInfo |= ((uint32_t)type << 16) & DATA_FILTER_MASK;
+        if (type != DataFilter::NONE && wordSize == 8) {
+            bitInfo |= DATA_FILTER_WORD8_BIT;
+        }
+        return bitInfo;
+    }
+
+
+    /**
+     * Get the filter applied to the data before compression.
+     * @return filter applied to the data before compression.
+     */
+    DataFilter::FilterType RecordHeader::getDataFilter() const {
+        return DataFilter::toFilterType((bitInfo & DATA_FILTER_MASK) >> 16);
+    }
+
+
+    /**
+     * Get the size in bytes of the words the data filter works on.
+     * @return size in bytes of the words the data filter works on, 4 or 8.
+     */
+    uint32_t RecordHeader::getDataFilterWordSize() const {
+        return ((bitInfo & DATA_FILTER_WORD8_BIT) != 0) ? 8 : 4;
+    }
+
+
     /**
      * Clear the bit in the given arg to indicate it is NOT the last record.
      * @param i integer in which to clear the last-record bit
@@ -894,7 +962,7 @@ namespace evio {
 
 
     /**
-     * Set the compression type. 0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip.
+     * Set the compression type. 0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip, 4=zstd.
      * No compression for other values.
      * @param type compression type.
      * @return this object.
@@ -1504,6 +1572,9 @@ namespace evio {
         ss << setw(24) << "has dictionary"  << "   : " << hasDictionary() << endl;
         ss << setw(24) << "has 1st event"   << "   : " << hasFirstEvent() << endl;
         ss << setw(24) << "is last record"  << "   : " << isLastRecord()  << endl;
+        ss << setw(24) << "has compression dict" << "   : " << hasCompressionDictionary() << endl;
+        ss << setw(24) << "data filter"     << "   : " << getDataFilter() << " (" <<
+                                                          getDataFilterWordSize() << " byte words)" << endl;
 
         ss << dec;
         ss << setw(24) << "data type"  << "   : " << eventTypeToString() << " (" << eventType << ")" << endl;
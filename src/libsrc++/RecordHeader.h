@@ -29,6 +29,7 @@
 #include "IBlockHeader.h"
 #include "EvioException.h"
 #include "Compressor.h"
+#include "DataFilter.h"
 #include "Util.h"
 
 
@@ -95,8 +96,13 @@ namespace evio {
      *                                      9 = PhysicsStreaming
      *                                     15 = Other
      *    14    = true if this record has "first" event (to be in every split file)
-     *
-     *    16-19 = reserved
+     *    15    = true if this record is compressed with the file's compression dictionary
+     *    16-17 = filter applied to data before compression: 0 = none,
+     *                                                       1 = byte shuffle,
+     *                                                       2 = delta,
+     *                                                       3 = delta then byte shuffle
+     *    18    = true if data filter works on 8 byte words, else 4 byte words
+     *    19    = reserved
      *    20-21 = pad 1
      *    22-23 = pad 2
      *    24-25 = pad 3
@@ -234,6 +240,12 @@ namespace evio {
         static const uint32_t   LAST_RECORD_BIT = 0x200;
         /** 14th bit set in bitInfo word in header means contains first event. */
         static const uint32_t   FIRSTEVENT_BIT  = 0x4000;
+        /** 15th bit set in bitInfo word in header means compressed with file's compression dictionary. */
+        static const uint32_t   COMPRESSION_DICTIONARY_BIT = 0x8000;
+        /** 16th & 17th bits in bitInfo word in header hold filter applied to data before compression. */
+        static const uint32_t   DATA_FILTER_MASK = 0x30000;
+        /** 18th bit set in bitInfo word in header means data filter works on 8 byte words. */
+        static const uint32_t   DATA_FILTER_WORD8_BIT = 0x40000;
 
         /** 10-13th bits in bitInfo word in header for CODA data type, ROC raw = 0. */
         static const uint32_t   DATA_ROC_RAW_BITS = 0x000;
@@ -341,7 +353,7 @@ namespace evio {
         /** Byte order of file/buffer this header was read from. */
         ByteOrder byteOrder {ByteOrder::ENDIAN_LOCAL};
 
-        /** Type of data compression (0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip).
+        /** Type of data compression (0=none, 1=LZ4 fast, 2=LZ4 best, 3=gzip, 4=zstd).
           * Highest 4 bits of 10th word. */
         Compressor::CompressionType compressionType {Compressor::UNCOMPRESSED};
 
@@ -420,6 +432,14 @@ namespace evio {
         bool        isLastRecord() const;
         static bool isLastRecord(uint32_t bitInfo);
 
+        uint32_t    hasCompressionDictionary(bool hasDict);
+        bool        hasCompressionDictionary() const;
+        static bool hasCompressionDictionary(uint32_t bitInfo);
+
+        uint32_t    setDataFilter(DataFilter::FilterType type, uint32_t wordSize);
+        DataFilter::FilterType getDataFilter() const;
+        uint32_t    getDataFilterWordSize() const;
+
         bool        isCompressed() override;
 
         bool        isEvioTrailer() const;
@@ -18,9 +18,126 @@
 namespace evio {
 
 
+    /** Source of unique generation values across all RecordInput objects. */
+    std::atomic<uint64_t> RecordInput::generationCount {0};
+
+    /** Bytes copied in memory by all RecordInput objects. */
+    std::atomic<uint64_t> RecordInput::totalBytesCopied {0};
+
+
+    /**
+     * Get the dictionary needed to uncompress a record compressed with one.
+     * @param dict dictionary, may be null.
+     * @return dictionary.
+     * @throws EvioException if dict is null.
+     */
+    static CompressionDictionary const & neededDictionary(CompressionDictionary const * dict) {
+        if (dict == nullptr) {
+            throw EvioException("record compressed with dictionary, but none available");
+        }
+        return *dict;
+    }
+
+
+    /**
+     * Uncompress the data of a record (index, user header, events) directly into its
+     * destination, then undo any filter applied to it before compression.
+     * Shuffled data cannot be unshuffled in place, so it alone is uncompressed
+     * into temporary storage and unshuffled from there into the destination.
+     *
+     * @param hdr    header of the record.
+     * @param src    compressed data.
+     * @param srcLen number of compressed bytes.
+     * @param dst    destination of uncompressed data.
+     * @param dstCap number of bytes available at dst, no more than the record's uncompressed
+     *               length since shuffled data is first uncompressed into storage of this size.
+     * @param dict   dictionary the record may have been compressed with, null if none.
+     * @param order  byte order of the record.
+     * @return number of uncompressed bytes.
+     * @throws EvioException if dst is too small, data is malformed,
+     *                       record was compressed with a dictionary and dict is null, or
+     *                       record was compressed with a type not compiled in.
+     */
+    static uint32_t uncompressData(RecordHeader & hdr, uint8_t *src, uint32_t srcLen,
+                                   uint8_t *dst, uint32_t dstCap,
+                                   CompressionDictionary const * dict, ByteOrder const & order) {
+
+        DataFilter::FilterType filter = hdr.getDataFilter();
+        bool shuffled = (filter == DataFilter::SHUFFLE || filter == DataFilter::DELTA_SHUFFLE);
+
+        static thread_local std::vector<uint8_t> scratch;
+        uint8_t *out = dst;
+        if (shuffled) {
+            if (scratch.size() < dstCap) scratch.resize(dstCap);
+            out = scratch.data();
+        }
+
+        auto & comp = Compressor::getInstance();
+        int size = 0;
+
+        switch (hdr.getCompressionType()) {
+            case Compressor::LZ4:
+            case Compressor::LZ4_BEST:
+                if (hdr.hasCompressionDictionary()) {
+                    size = comp.uncompressLZ4(src, 0, srcLen, out, 0, dstCap, neededDictionary(dict));
+                }
+                else {
+                    size = comp.uncompressLZ4(src, 0, srcLen, out, 0, dstCap);
+                }
+                break;
+
+            case Compressor::ZSTD:
+#ifdef USE_ZSTD
+                if (hdr.hasCompressionDictionary()) {
+                    size = comp.uncompressZSTD(src, 0, srcLen, out, 0, dstCap, neededDictionary(dict));
+                }
+                else {
+                    size = comp.uncompressZSTD(src, 0, srcLen, out, 0, dstCap);
+                }
+#else
+                throw EvioException("record compressed with zstd, but zstd support not compiled in");
+#endif
+                break;
+
+            case Compressor::GZIP:
+#ifdef USE_GZIP
+                size = comp.uncompressGZIP(src, 0, srcLen, out, 0, dstCap);
+#else
+                throw EvioException("record compressed with gzip, but gzip support not compiled in");
+#endif
+                break;
+
+            default:
+                return 0;
+        }
+
+        if (filter == DataFilter::NONE) {
+            return size;
+        }
+
+        // Same bytes that were filtered & compressed (events are not padded)
+        size_t bytes = hdr.getIndexLength() + 4*hdr.getUserHeaderLengthWords() + hdr.getDataLength();
+        if (bytes > (size_t)size) bytes = size;
+        bool swap = !order.isLocalEndian();
+
+        if (shuffled) {
+            DataFilter::decode(filter, hdr.getDataFilterWordSize(), swap, out, dst, bytes);
+            if ((size_t)size > bytes) {
+                std::memcpy(dst + bytes, out + bytes, size - bytes);
+            }
+        }
+        else {
+            DataFilter::decode(filter, hdr.getDataFilterWordSize(), swap, dst, bytes, scratch);
+        }
+
+        return size;
+    }
+
+
     /** Default constructor. */
     RecordInput::RecordInput() : headerBuffer(RecordHeader::HEADER_SIZE_BYTES) {
         header = std::make_shared<RecordHeader>();
+        generation = std::make_shared<std::atomic<uint64_t>>(0);
         allocate(DEFAULT_BUF_SIZE);
         headerBuffer.order(byteOrder);
     }
@@ -64,6 +181,11 @@ namespace evio {
             eventsOffset             = srcRec.eventsOffset;
             uncompressedEventsLength = srcRec.uncompressedEventsLength;
             byteOrder                = srcRec.byteOrder;
+            externalBuffer           = srcRec.externalBuffer;
+            externalOffset           = srcRec.externalOffset;
+            generation               = srcRec.generation;
+            compressionDictionary    = srcRec.compressionDictionary;
+            bytesCopied              = srcRec.bytesCopied;
         }
     }
 
@@ -98,6 +220,11 @@ namespace evio {
             eventsOffset             = other.eventsOffset;
             uncompressedEventsLength = other.uncompressedEventsLength;
             byteOrder                = other.byteOrder;
+            externalBuffer           = std::move(other.externalBuffer);
+            externalOffset           = other.externalOffset;
+            generation               = std::move(other.generation);
+            compressionDictionary    = std::move(other.compressionDictionary);
+            bytesCopied              = other.bytesCopied;
         }
         return *this;
     }
@@ -121,6 +248,11 @@ namespace evio {
             eventsOffset             = other.eventsOffset;
             uncompressedEventsLength = other.uncompressedEventsLength;
             byteOrder                = other.byteOrder;
+            externalBuffer           = other.externalBuffer;
+            externalOffset           = other.externalOffset;
+            generation               = other.generation;
+            compressionDictionary    = other.compressionDictionary;
+            bytesCopied              = other.bytesCopied;
         }
         return *this;
     }
@@ -159,11 +291,55 @@ namespace evio {
      * @return  the buffer with uncompressed event data in it.
      */
     std::shared_ptr<ByteBuffer> RecordInput::getUncompressedDataBuffer() {
+        if (externalBuffer != nullptr) {
+            // Event data was never copied, so return a view into the buffer holding it.
+            // The view shares the memory without allocating, so a mapped file stays mapped while it is used.
+            auto buf = externalBuffer->duplicate();
+            size_t evPos = externalOffset + eventsOffset - userHeaderOffset;
+            buf->limit(evPos + uncompressedEventsLength).position(evPos);
+            return buf;
+        }
         dataBuffer->limit(eventsOffset + uncompressedEventsLength).position(eventsOffset);
         return dataBuffer;
     }
 
 
+    /**
+     * Get the dictionary used to uncompress records compressed with one.
+     * @return dictionary used to uncompress records, null if none.
+     */
+    std::shared_ptr<CompressionDictionary> RecordInput::getCompressionDictionary() const {
+        return compressionDictionary;
+    }
+
+
+    /**
+     * Set the dictionary used to uncompress records compressed with one.
+     * Usually this is the dictionary stored in the file header of the file being read.
+     * @param dict dictionary used to uncompress records, null if none.
+     */
+    void RecordInput::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        compressionDictionary = std::move(dict);
+    }
+
+
+    /**
+     * Get a pointer to the uncompressed data at the given offset. The offset is
+     * relative to the beginning of the index array as it is laid out in dataBuffer.
+     * This takes into account a user header and events which were not copied into
+     * dataBuffer, but are still sitting in the buffer they were read from.
+     * @param offset byte offset to user header or event data.
+     * @return pointer to the uncompressed data at the given offset.
+     */
+    uint8_t* RecordInput::dataPointer(uint32_t offset) const {
+        if (externalBuffer != nullptr) {
+            return externalBuffer->array() + externalBuffer->arrayOffset() +
+                   externalOffset + (offset - userHeaderOffset);
+        }
+        return dataBuffer->array() + offset;
+    }
+
+
     /**
      * Does this record contain an event index?
      * @return true if record contains an event index, else false.
@@ -201,19 +377,67 @@ namespace evio {
         uint32_t length = lastPosition - firstPosition;
         uint32_t offset = eventsOffset + firstPosition;
 
+        if (len != nullptr) {
+            *len = length;
+        }
+
+        if (externalBuffer != nullptr) {
+            // Event was never copied out of the buffer it was read from, so share it.
+            // The returned pointer keeps that buffer alive.
+            return std::shared_ptr<uint8_t>(externalBuffer, dataPointer(offset));
+        }
+
         // TODO: Allocating memory here!!!
         auto event = std::shared_ptr<uint8_t>(new uint8_t[length], std::default_delete<uint8_t[]>());
 
         std::memcpy((void *)event.get(), (const void *)(dataBuffer->array() + offset), length);
-        if (len != nullptr) {
-            *len = length;
-        }
 
 //std::cout << "getEvent: reading from " << offset << ",  length = " << length << std::endl;
         return event;
     }
 
 
+    /**
+     * Get a view of the event at the given index without copying it.
+     * The view points into this record's internal buffer (or into the buffer the
+     * record was read from if it was never copied) and is only valid until the
+     * next record is read.
+     *
+     * @param index index of event starting at 0. If index too large, it's set to largest valid index.
+     * @return view of the event.
+     */
+    EventView RecordInput::getEventView(uint32_t index) const {
+        uint32_t firstPosition = 0;
+
+        if (index > 0) {
+            if (index >= header->getEntries()) {
+                index = header->getEntries() - 1;
+            }
+            firstPosition = dataBuffer->getInt( (index-1)*4 );
+        }
+
+        uint32_t lastPosition = dataBuffer->getUInt(index*4);
+
+        return EventView(dataPointer(eventsOffset + firstPosition), lastPosition - firstPosition,
+                         byteOrder, generation->load(std::memory_order_relaxed), generation);
+    }
+
+
+    /**
+     * Get the generation of the data held. This changes each time a record is read
+     * and is unique among all RecordInput objects. An {@link EventView} obtained from
+     * this record is stale if its generation differs from this.
+     * @return generation of the data held.
+     */
+    uint64_t RecordInput::getGeneration() const {return generation->load(std::memory_order_relaxed);}
+
+
+    /** Give the data about to be read a new, unique generation value. */
+    void RecordInput::nextGeneration() {
+        generation->store(++generationCount, std::memory_order_release);
+    }
+
+
     /**
      * Get the event at the given index and return it in the provided array.
      *
@@ -246,7 +470,7 @@ namespace evio {
                                       std::to_string(length) + ")");
         }
 
-        std::memcpy((void *)event, (const void *)(dataBuffer->array() + offset), length);
+        std::memcpy((void *)event, (const void *)dataPointer(offset), length);
         return length;
     }
 
@@ -367,7 +591,7 @@ namespace evio {
         buffer.order(byteOrder);
 
         std::memcpy((void *)(buffer.array() + buffer.arrayOffset() + bufOffset),
-                    (const void *)(dataBuffer->array() + offset), length);
+                    (const void *)dataPointer(offset), length);
 
         // Make buffer ready to read.
         // Always set limit first, else you can cause exception.
@@ -386,7 +610,7 @@ namespace evio {
         uint32_t length = header->getUserHeaderLength();
         auto userHeader = std::shared_ptr<uint8_t>(new uint8_t[length], std::default_delete<uint8_t[]>());
         std::memcpy((void *)(userHeader.get()),
-                    (const void *)(dataBuffer->array() + userHeaderOffset), length);
+                    (const void *)dataPointer(userHeaderOffset), length);
 
         return userHeader;
     }
@@ -436,7 +660,7 @@ namespace evio {
         buffer.order(byteOrder);
 
         std::memcpy((void *)(buffer.array() + buffer.arrayOffset() + bufOffset),
-                    (const void *)(dataBuffer->array() + userHeaderOffset), length);
+                    (const void *)dataPointer(userHeaderOffset), length);
 
         // Make buffer ready to read.
         // Always set limit first, else you can cause exception.
@@ -497,6 +721,8 @@ namespace evio {
         if (!file.is_open()) {
             throw EvioException("file not open");
         }
+        nextGeneration();
+        externalBuffer = nullptr;
         file.seekg(position);
         file.read(reinterpret_cast<char *>(headerBuffer.array()), RecordHeader::HEADER_SIZE_BYTES);
 
@@ -534,6 +760,7 @@ namespace evio {
         uncompressedEventsLength = 4*header->getDataLengthWords();
         // Everything except the header & don't forget padding:
         uint32_t neededSpace =  indexLen + userHdrLen +uncompressedEventsLength;
+        uint32_t uncompressedSpace = neededSpace;
 
         // Handle rare situation in which compressed data takes up more room.
         // This also determines size of recordBuffer in which compressed
@@ -553,33 +780,28 @@ namespace evio {
         // Go here to read rest of record
         file.seekg(position + headerLength);
 
+        bytesCopied = 0;
+
         // Decompress data
         switch (header->getCompressionType()) {
-            case 1:
-            case 2:
-                // LZ4
-                // Read compressed data
-                file.read(reinterpret_cast<char *>(recordBuffer.array()), cLength);
-                Compressor::getInstance().uncompressLZ4(recordBuffer, cLength, *(dataBuffer.get()));
-                break;
-
-            case 3:
-                // GZIP
-#ifdef USE_GZIP
+            case Compressor::CompressionType::LZ4 :
+            case Compressor::CompressionType::LZ4_BEST :
+            case Compressor::CompressionType::GZIP :
+            case Compressor::CompressionType::ZSTD :
                 {
-            file.read(reinterpret_cast<char *>(recordBuffer.array()), cLength);
-            // size of destination buffer on entry, uncompressed bytes on exit
-            uint32_t uncompLen = recordBuffer.capacity();
-            uint8_t* ungzipped = Compressor::getInstance().uncompressGZIP(recordBuffer.array(), 0,
-                                                                          cLength, &uncompLen,
-                                                                          uncompressedEventsLength);
-            dataBuffer->put(ungzipped, uncompLen);
-            delete[] ungzipped;
-        }
-#endif
+                    // Read compressed data, then uncompress it straight into dataBuffer
+                    // (leaving room in front for any reconstructed index array)
+                    file.read(reinterpret_cast<char *>(recordBuffer.array()), cLength);
+                    uint32_t dstOff = findEvLens ? indexLen : 0;
+                    uint32_t size = uncompressData(*header, recordBuffer.array(), cLength,
+                                                   dataBuffer->array() + dstOff,
+                                                   uncompressedSpace - dstOff,
+                                                   compressionDictionary.get(), headerBuffer.order());
+                    dataBuffer->limit(dstOff + size).position(dstOff);
+                }
                 break;
 
-            case 0:
+            case Compressor::CompressionType::UNCOMPRESSED :
             default:
                 // Read uncompressed data - rest of record
                 uint32_t len = recordLengthBytes - headerLength;
@@ -634,6 +856,9 @@ namespace evio {
      */
     void RecordInput::readRecord(ByteBuffer & buffer, size_t offset) {
 
+        nextGeneration();
+        externalBuffer = nullptr;
+
         // This will switch buffer to proper byte order
         header->readHeader(buffer, offset);
 
@@ -681,25 +906,24 @@ namespace evio {
             dataBuffer->position(indexLen);
         }
 
+        bytesCopied = 0;
+
         // Decompress data
         switch (header->getCompressionType()) {
             case Compressor::CompressionType::LZ4 :
             case Compressor::CompressionType::LZ4_BEST :
-                // Read LZ4 compressed data (WARNING: this does set limit on dataBuffer!)
-                Compressor::getInstance().uncompressLZ4(buffer, compDataOffset, cLength, *(dataBuffer.get()));
-                break;
-
             case Compressor::CompressionType::GZIP :
-#ifdef USE_GZIP
+            case Compressor::CompressionType::ZSTD :
                 {
-                // Read GZIP compressed data
-                uint32_t uncompLen = neededSpace;
-                buffer.limit(compDataOffset + cLength).position(compDataOffset);
-                uint8_t* ungzipped = Compressor::getInstance().uncompressGZIP(buffer, &uncompLen);
-                dataBuffer->put(ungzipped, uncompLen);
-                delete[] ungzipped;
-            }
-#endif
+                    // Uncompress straight from buffer into dataBuffer
+                    // (leaving room in front for any reconstructed index array)
+                    uint32_t dstOff = findEvLens ? indexLen : 0;
+                    uint32_t size = uncompressData(*header, buffer.array() + buffer.arrayOffset() + compDataOffset,
+                                                   cLength, dataBuffer->array() + dstOff,
+                                                   neededSpace - dstOff,
+                                                   compressionDictionary.get(), buffer.order());
+                    dataBuffer->limit(dstOff + size).position(dstOff);
+                }
                 break;
 
             case Compressor::CompressionType::UNCOMPRESSED :
@@ -721,7 +945,9 @@ namespace evio {
                     std::memcpy((void *)dataBuffer->array(),
                                 (const void *)(buffer.array() + buffer.arrayOffset() + compDataOffset), len);
                 }
+                bytesCopied = len;
         }
+        totalBytesCopied += bytesCopied;
 
         // Offset in dataBuffer past index array, to user header
         userHeaderOffset = indexLen;
@@ -752,6 +978,110 @@ namespace evio {
     }
 
 
+    /**
+     * Reads a record from the buffer at the given offset. Call this method or
+     * {@link #readRecord(std::ifstream &, size_t)} before calling any other.
+     * Any compressed data is decompressed directly from the buffer.
+     * Unlike {@link #readRecord(ByteBuffer &, size_t)}, the user header and events of an
+     * uncompressed record are <b>not</b> copied. Only its index array is. Events are
+     * accessed in place and {@link #getEvent(uint32_t, uint32_t *)} returns a pointer
+     * into the given buffer, without allocating or copying, which keeps it alive.
+     * Thus the buffer's data must not be changed as long as this record is in use.
+     * Handles the case in which index array length = 0.
+     *
+     * @param buffer buffer containing record data.
+     * @param offset offset into buffer to beginning of record data.
+     * @throws EvioException if buffer contains too little data,
+     *                       is not in proper format, or version earlier than 6 or
+     *                       error in uncompressing gzipped data.
+     */
+    void RecordInput::readRecord(std::shared_ptr<ByteBuffer> & buffer, size_t offset) {
+
+        nextGeneration();
+
+        // This will switch buffer to proper byte order
+        header->readHeader(*buffer, offset);
+
+        if (header->getCompressionType() != Compressor::UNCOMPRESSED) {
+            // Data must be decompressed into dataBuffer anyway
+            readRecord(*buffer, offset);
+            return;
+        }
+
+        // Make sure all internal buffers have the same byte order
+        setByteOrder(buffer->order());
+
+        uint32_t recordLengthBytes = header->getLength();
+        uint32_t headerLength      = header->getHeaderLength();
+        nEntries                   = header->getEntries();     // # of events
+        uint32_t indexLen          = header->getIndexLength(); // bytes
+        uint32_t userHdrLen        = 4*header->getUserHeaderLengthWords(); // bytes + padding
+
+        if (offset + recordLengthBytes > buffer->limit()) {
+            throw EvioException("buffer contains too little data for record");
+        }
+
+        // Handle the case of len = 0 for index array in header,
+        // it must be reconstructed here by scanning the record.
+        bool findEvLens = false;
+        if (indexLen == 0) {
+            findEvLens = true;
+        }
+        else if (indexLen != 4*nEntries) {
+            // Header info is goofed up
+            throw EvioException("Record header index array len " + std::to_string(indexLen) +
+                                " does not match 4*(event cnt) " + std::to_string(4*nEntries));
+        }
+
+        uncompressedEventsLength = 4*header->getDataLengthWords();
+
+        // Only the index array lives in dataBuffer
+        if (dataBuffer->capacity() < 4*nEntries) {
+            allocate(4*nEntries);
+        }
+        dataBuffer->clear();
+
+        bytesCopied = 0;
+        if (!findEvLens) {
+            std::memcpy((void *)dataBuffer->array(),
+                        (const void *)(buffer->array() + buffer->arrayOffset() + offset + headerLength),
+                        indexLen);
+            bytesCopied = indexLen;
+            totalBytesCopied += bytesCopied;
+        }
+
+        // User header and events stay where they are
+        externalBuffer = buffer;
+        externalOffset = offset + headerLength + indexLen;
+
+        // Offset in dataBuffer past index array, to user header
+        userHeaderOffset = 4*nEntries;
+        // Offset in dataBuffer just past index + user header, to events
+        eventsOffset = userHeaderOffset + userHdrLen;
+
+        // Overwrite event lengths with event offsets.
+        // First offset is to beginning of 2nd (starting at 1) event, etc.
+        uint32_t event_pos = 0;
+        size_t read_pos = externalOffset + userHdrLen;
+
+        for (uint32_t i = 0; i < nEntries; i++) {
+            uint32_t size;
+            if (findEvLens) {
+                // In the case there is no index array, evio MUST be the format!
+                // Reconstruct index - the first bank word = len - 1 words.
+                size = 4*(buffer->getUInt(read_pos) + 1);
+                read_pos += size;
+            }
+            else {
+                // ev size in index array
+                size = dataBuffer->getUInt(i * 4);
+            }
+            event_pos += size;
+            dataBuffer->putInt(i*4, event_pos);
+        }
+    }
+
+
     /**
      * Uncompress the data of a record from the source buffer at the given offset
      * into the destination buffer.
@@ -763,14 +1093,16 @@ namespace evio {
      * @param srcOff offset into srcBuf to beginning of record data.
      * @param dstBuf buffer into which the record is uncompressed.
      * @param hdr    RecordHeader to be used to read the record header in srcBuf.
+     * @param dict   dictionary the record may have been compressed with, null if none.
      * @return the original record size in srcBuf (bytes).
      * @throws EvioException if srcBuf contains too little data,
-     *                       is not in proper format, or version earlier than 6.
+     *                       is not in proper format, version earlier than 6, or
+     *                       record was compressed with a dictionary and dict is null.
      */
     uint32_t RecordInput::uncompressRecord(std::shared_ptr<ByteBuffer> & srcBuf, size_t srcOff,
                                            std::shared_ptr<ByteBuffer> & dstBuf,
-                                           RecordHeader & hdr) {
-        return uncompressRecord(*srcBuf, srcOff, *dstBuf, hdr);
+                                           RecordHeader & hdr, CompressionDictionary const * dict) {
+        return uncompressRecord(*srcBuf, srcOff, *dstBuf, hdr, dict);
     }
 
 
@@ -785,12 +1117,14 @@ namespace evio {
      * @param srcOff offset into srcBuf to beginning of record data.
      * @param dstBuf buffer into which the record is uncompressed.
      * @param hdr    RecordHeader to be used to read the record header in srcBuf.
+     * @param dict   dictionary the record may have been compressed with, null if none.
      * @return the original record size in srcBuf (bytes).
      * @throws EvioException if srcBuf contains too little data,
-     *                       is not in proper format, or version earlier than 6.
+     *                       is not in proper format, version earlier than 6, or
+     *                       record was compressed with a dictionary and dict is null.
      */
     uint32_t RecordInput::uncompressRecord(ByteBuffer & srcBuf, size_t srcOff, ByteBuffer & dstBuf,
-                                           RecordHeader & hdr) {
+                                           RecordHeader & hdr, CompressionDictionary const * dict) {
 
         size_t dstOff = dstBuf.position();
 
@@ -821,6 +1155,7 @@ namespace evio {
                         (const void *)(srcBuf.array() + srcOff + srcBuf.arrayOffset()), headerBytes);
 
             dstBuf.position(dstOff + headerBytes);
+            totalBytesCopied += headerBytes;
         }
         else {
             // Since everything is uncompressed, copy it all over as is
@@ -828,37 +1163,34 @@ namespace evio {
                         (const void *)(srcBuf.array() + srcOff + srcBuf.arrayOffset()), headerBytes + neededSpace);
 
             dstBuf.position(dstOff + headerBytes);
+            totalBytesCopied += headerBytes + neededSpace;
         }
 
-        // Decompress data
+        // Decompress data straight into dstBuf, just past the header
         switch (compressionType) {
-            case 1:
-            case 2:
-                // Read LZ4 compressed data
-                Compressor::getInstance().uncompressLZ4(srcBuf, compressedDataOffset,
-                                                        compressedDataLength, dstBuf);
+            case Compressor::CompressionType::LZ4 :
+            case Compressor::CompressionType::LZ4_BEST :
+            case Compressor::CompressionType::GZIP :
+            case Compressor::CompressionType::ZSTD :
+                uncompressData(hdr, srcBuf.array() + srcBuf.arrayOffset() + compressedDataOffset,
+                               compressedDataLength,
+                               dstBuf.array() + dstBuf.arrayOffset() + dstOff + headerBytes,
+                               neededSpace, dict, srcBuf.order());
                 dstBuf.limit(dstBuf.capacity());
                 break;
 
-            case 3:
-                // Read GZIP compressed data
-#ifdef USE_GZIP
-                {
-                 uint32_t uncompLen = neededSpace;
-                 srcBuf.limit(compressedDataOffset + compressedDataLength).position(compressedDataOffset);
-                 uint8_t* ungzipped = Compressor::getInstance().uncompressGZIP(srcBuf, &uncompLen);
-                 dstBuf.put(ungzipped, uncompLen);
-                 delete[] ungzipped;
-      }
-#endif
-                break;
-
-            case 0:
+            case Compressor::CompressionType::UNCOMPRESSED :
             default:
                 // Everything copied over above
                 break;
         }
 
+        // Any filter was undone above
+        if (hdr.getDataFilter() != DataFilter::NONE) {
+            hdr.setDataFilter(DataFilter::NONE, 4);
+            dstBuf.putInt(dstOff + RecordHeader::BIT_INFO_OFFSET, hdr.getBitInfoWord());
+        }
+
         srcBuf.limit(srcBuf.capacity());
 
         // Position dstBuf just before the data so it can be scanned for EvioNodes.
@@ -896,6 +1228,24 @@ namespace evio {
     }
 
 
+    /**
+     * Get the number of bytes copied from one place in memory to another while reading
+     * the last record. Records read from a file or compressed records are read or
+     * uncompressed directly into place, so this is 0 for them.
+     * @return number of bytes copied while reading the last record.
+     */
+    uint32_t RecordInput::getBytesCopied() const {return bytesCopied;}
+
+
+    /**
+     * Get the number of bytes copied from one place in memory to another while
+     * reading or uncompressing records, by all RecordInput objects since the start
+     * of the program. This includes {@link #uncompressRecord}.
+     * @return number of bytes copied by all RecordInput objects.
+     */
+    uint64_t RecordInput::getTotalBytesCopied() {return totalBytesCopied;}
+
+
     /**
      * Returns number of the events packed in the record.
      * @return number of the events packed in the record
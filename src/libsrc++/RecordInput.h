@@ -16,6 +16,7 @@
 #include <fstream>
 #include <memory>
 #include <stdexcept>
+#include <atomic>
 
 
 #include "ByteOrder.h"
@@ -23,6 +24,7 @@
 #include "RecordHeader.h"
 #include "Compressor.h"
 #include "EvioException.h"
+#include "EventView.h"
 
 
 namespace evio {
@@ -148,12 +150,44 @@ namespace evio {
         /** Record's header is read into this buffer. */
         ByteBuffer headerBuffer;
 
+        /**
+         * If not null, this buffer holds the user header and events of an uncompressed
+         * record which were not copied into dataBuffer (see
+         * {@link #readRecord(std::shared_ptr<ByteBuffer> &, size_t)}).
+         * In that case, only the index array is contained in dataBuffer.
+         */
+        std::shared_ptr<ByteBuffer> externalBuffer;
+
+        /** Offset into externalBuffer of the record's user header (just past index). */
+        size_t externalOffset = 0;
+
+        /**
+         * Generation of the data held, changed each time a record is read.
+         * Shared with {@link EventView}s, so they can tell if they're stale.
+         */
+        std::shared_ptr<std::atomic<uint64_t>> generation;
+
+        /** Source of unique generation values across all RecordInput objects. */
+        static std::atomic<uint64_t> generationCount;
+
+        /** Dictionary to uncompress records compressed with one. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+        /** Bytes copied from one place in memory to another while reading the last record. */
+        uint32_t bytesCopied = 0;
+
+        /** Bytes copied from one place in memory to another by all RecordInput objects
+         *  (including {@link #uncompressRecord}), which shows how much copying is avoided. */
+        static std::atomic<uint64_t> totalBytesCopied;
+
 
     private:
 
         void allocate(size_t size);
         void setByteOrder(const ByteOrder & order);
         void showIndex() const;
+        uint8_t* dataPointer(uint32_t offset) const;
+        void nextGeneration();
 
     public:
 
@@ -171,12 +205,20 @@ namespace evio {
         const ByteOrder & getByteOrder();
         std::shared_ptr<ByteBuffer> getUncompressedDataBuffer();
 
+        std::shared_ptr<CompressionDictionary> getCompressionDictionary() const;
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+
+        uint32_t getBytesCopied() const;
+        static uint64_t getTotalBytesCopied();
+
         bool hasIndex() const;
         bool hasUserHeader() const;
 
 
         std::shared_ptr<uint8_t> getEvent(uint32_t index, uint32_t *len);
         uint32_t getEvent(uint8_t *event, uint32_t index, uint32_t evLen);
+        EventView getEventView(uint32_t index) const;
+        uint64_t getGeneration() const;
 
         std::shared_ptr<ByteBuffer> & getEvent(std::shared_ptr<ByteBuffer> & uffer, uint32_t index);
         std::shared_ptr<ByteBuffer> & getEvent(std::shared_ptr<ByteBuffer> & buffer, size_t bufOffset, uint32_t index);
@@ -197,13 +239,16 @@ namespace evio {
 
         void readRecord(std::ifstream & file, size_t position);
         void readRecord(ByteBuffer & buffer, size_t offset);
+        void readRecord(std::shared_ptr<ByteBuffer> & buffer, size_t offset);
 
         static uint32_t uncompressRecord(std::shared_ptr<ByteBuffer> & srcBuf, size_t srcOff,
                                          std::shared_ptr<ByteBuffer> & dstBuf,
-                                         RecordHeader & hdr);
+                                         RecordHeader & hdr,
+                                         CompressionDictionary const * dict = nullptr);
        static uint32_t uncompressRecord(ByteBuffer & srcBuf, size_t srcOff,
                                         ByteBuffer & dstBuf,
-                                        RecordHeader & header);
+                                        RecordHeader & header,
+                                        CompressionDictionary const * dict = nullptr);
     };
 
 }
@@ -28,7 +28,7 @@ namespace evio {
      *                      Value <= O means use default (1M).
      * @param maxBufferSize max number of uncompressed data bytes this record can hold.
      *                      Value of < 8MB results in default of 8MB.
-     * @param compressionType type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip).
+     * @param compressionType type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip, 4=zstd).
      * @param hType           type of record header to use.
      */
     RecordOutput::RecordOutput(const ByteOrder & order, uint32_t maxEventCount, uint32_t maxBufferSize,
@@ -71,7 +71,7 @@ namespace evio {
      *               Must have position and limit set to accept new data.
      * @param maxEventCount max number of events this record can hold.
      *                      Value <= O means use default (1M).
-     * @param compressionType type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip).
+     * @param compressionType type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip, 4=zstd).
      * @param hType           type of record header to use.
      */
     RecordOutput::RecordOutput(std::shared_ptr<ByteBuffer> & buffer, uint32_t maxEventCount,
@@ -166,6 +166,12 @@ namespace evio {
             userBufferSize     = other.userBufferSize;
             startingPosition   = other.startingPosition;
             userProvidedBuffer = other.userProvidedBuffer;
+            compressionDictionary = other.compressionDictionary;
+            adaptiveCompression   = other.adaptiveCompression;
+            dataFilter            = other.dataFilter;
+            dataFilterWordSize    = other.dataFilterWordSize;
+            vectoredWrite         = other.vectoredWrite;
+            eventsGathered        = other.eventsGathered;
 
             // Copy construct header (nothing needs moving)
             header = std::make_shared<RecordHeader>(*(other.header.get()));
@@ -176,6 +182,7 @@ namespace evio {
             recordEvents = std::move(other.recordEvents);
             recordIndex  = std::move(other.recordIndex);
             recordData   = std::move(other.recordData);
+            numaNodes    = std::move(other.numaNodes);
         }
 
         return *this;
@@ -270,6 +277,11 @@ namespace evio {
         eventSize  = rec.eventSize;
         byteOrder  = rec.byteOrder;
         startingPosition = rec.startingPosition;
+        compressionDictionary = rec.compressionDictionary;
+        adaptiveCompression   = rec.adaptiveCompression;
+        dataFilter            = rec.dataFilter;
+        dataFilterWordSize    = rec.dataFilterWordSize;
+        eventsGathered        = rec.eventsGathered;
 
         // Copy construct header
         header = std::make_shared<RecordHeader>(*(rec.header.get()));
@@ -318,6 +330,9 @@ namespace evio {
         std::memcpy((void *)recordEvents->array(), (const void *)rec.recordEvents->array(), eventSize);
         std::memcpy((void *)recordBinary->array(), (const void *)rec.recordBinary->array(), rec.recordBinary->limit());
 
+        // Keep reallocated buffers on the same NUMA nodes
+        placeBuffers();
+
         // Don't set limits or positions of buffers in this method
     }
 
@@ -370,6 +385,58 @@ namespace evio {
     uint32_t RecordOutput::getEventCount() const {return eventCount;}
 
 
+    /**
+     * Does build leave the events of an uncompressed record out of the internal buffer?
+     * @return true if build leaves the events of an uncompressed record out of the internal buffer.
+     * @see #setVectoredWrite(bool)
+     */
+    bool RecordOutput::getVectoredWrite() const {return vectoredWrite;}
+
+
+    /**
+     * Have build leave the events of an uncompressed record where addEvent put them,
+     * instead of copying them into the internal buffer after the header and index.
+     * The internal buffer then holds only the header and index, and the record
+     * must be written from {@link #getWriteSegments()}, so events are never moved
+     * after being added. Compressed records, and records with a user header,
+     * are built whole as before.
+     * Use only when the record is written to a file, not read from its internal buffer.
+     * @param vectored true to leave events of uncompressed records out of the internal buffer.
+     */
+    void RecordOutput::setVectoredWrite(bool vectored) {vectoredWrite = vectored;}
+
+
+    /**
+     * Get the pieces of memory which, written one after the other, make up the record
+     * as last built. That is the internal buffer, unless build left the events of an
+     * uncompressed record out of it, in which case it's the header and index,
+     * the events, and any padding.
+     * @return memory of the built record, in order.
+     * @see #setVectoredWrite(bool)
+     */
+    std::vector<RecordOutput::Segment> RecordOutput::getWriteSegments() const {
+        static const uint8_t zeros[4] = {0, 0, 0, 0};
+
+        std::vector<Segment> segments;
+        const uint8_t *start = recordBinary->array() + recordBinary->arrayOffset() + startingPosition;
+        uint32_t recordBytes = header->getLength();
+
+        if (!eventsGathered) {
+            segments.push_back({start, recordBytes});
+            return segments;
+        }
+
+        uint32_t headBytes = RecordHeader::HEADER_SIZE_BYTES + indexSize;
+        segments.push_back({start, headBytes});
+        segments.push_back({recordEvents->array() + recordEvents->arrayOffset(), eventSize});
+        // Record length is padded, event data may not be
+        if (recordBytes > headBytes + eventSize) {
+            segments.push_back({zeros, recordBytes - headBytes - eventSize});
+        }
+        return segments;
+    }
+
+
     /**
      * Get the internal ByteBuffer used to construct binary representation of this record.
      * @return internal ByteBuffer used to construct binary representation of this record.
@@ -399,6 +466,110 @@ namespace evio {
     }
 
 
+    /**
+     * Get the dictionary used to compress this record.
+     * @return dictionary used to compress this record, null if none.
+     */
+    std::shared_ptr<CompressionDictionary> RecordOutput::getCompressionDictionary() const {
+        return compressionDictionary;
+    }
+
+
+    /**
+     * Set the dictionary used to compress this record from now on.
+     * It's only used for LZ4 and zstd compression. Records compressed
+     * with it are marked as such in their header.
+     * @param dict dictionary used to compress this record, null for none.
+     */
+    void RecordOutput::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        compressionDictionary = std::move(dict);
+    }
+
+
+    /**
+     * Get the object choosing the type of compression for each record built.
+     * @return object choosing the type of compression, null if none.
+     */
+    std::shared_ptr<AdaptiveCompression> RecordOutput::getAdaptiveCompression() const {
+        return adaptiveCompression;
+    }
+
+
+    /**
+     * Set the object choosing the type of compression each time this record is built.
+     * The type chosen overrides that set in the header.
+     * @param adaptive object choosing the type of compression, null for none.
+     */
+    void RecordOutput::setAdaptiveCompression(std::shared_ptr<AdaptiveCompression> adaptive) {
+        adaptiveCompression = std::move(adaptive);
+    }
+
+
+    /**
+     * Get the filter applied to the data of compressed records before compression.
+     * @return filter applied to the data of compressed records.
+     */
+    DataFilter::FilterType RecordOutput::getDataFilter() const {return dataFilter;}
+
+
+    /**
+     * Get the size in bytes of the words the data filter works on.
+     * @return size in bytes of the words the data filter works on, 4 or 8.
+     */
+    uint32_t RecordOutput::getDataFilterWordSize() const {return dataFilterWordSize;}
+
+
+    /**
+     * Set the filter applied to the data of this record before compressing it,
+     * each time it is built. It is recorded in the header and undone by {@link RecordInput}.
+     * Uncompressed records are never filtered.
+     * @param type     type of filter.
+     * @param wordSize size in bytes of the words filtered, 4 or 8.
+     * @throws EvioException if wordSize is not 4 or 8.
+     */
+    void RecordOutput::setDataFilter(DataFilter::FilterType type, uint32_t wordSize) {
+        if (wordSize != 4 && wordSize != 8) {
+            throw EvioException("filter word size must be 4 or 8");
+        }
+        dataFilter = type;
+        dataFilterWordSize = wordSize;
+    }
+
+
+    /**
+     * Get the NUMA nodes the internal buffers are placed on.
+     * @return NUMA nodes the internal buffers are placed on, empty if not placed.
+     */
+    const std::vector<int> & RecordOutput::getNumaNodes() const {return numaNodes;}
+
+
+    /**
+     * Place the memory of the internal buffers on the given NUMA nodes,
+     * so the threads which fill, compress and write this record, running on
+     * CPUs of those nodes, use local memory. A buffer provided by the user is left alone.
+     * Buffers allocated later, for a larger event or when copying a larger record, are placed too.
+     * @param nodes NUMA nodes, empty to stop placing newly allocated buffers.
+     * @see ThreadPlacement
+     */
+    void RecordOutput::setNumaNodes(std::vector<int> const & nodes) {
+        numaNodes = nodes;
+        placeBuffers();
+    }
+
+
+    /** Place the internal buffers on the NUMA nodes given in {@link #setNumaNodes}, if any. */
+    void RecordOutput::placeBuffers() {
+        if (numaNodes.empty()) return;
+
+        ThreadPlacement::bindBuffer(recordIndex,  numaNodes);
+        ThreadPlacement::bindBuffer(recordEvents, numaNodes);
+        ThreadPlacement::bindBuffer(recordData,   numaNodes);
+        if (!userProvidedBuffer) {
+            ThreadPlacement::bindBuffer(recordBinary, numaNodes);
+        }
+    }
+
+
     /**
      * Was the internal buffer provided by the user?
      * @return true if internal buffer provided by user.
@@ -427,6 +598,8 @@ namespace evio {
             recordBinary = std::make_shared<ByteBuffer>(RECORD_BUFFER_SIZE);
             recordBinary->order(byteOrder);
         }
+
+        placeBuffers();
     }
 
     /**
@@ -514,6 +687,75 @@ namespace evio {
     }
 
 
+    /**
+     * Reserve space for an event to be written directly into this record,
+     * instead of being copied in with addEvent. Write the event into the returned
+     * memory, then call {@link #commitEvent(uint32_t)} with its actual length.
+     * Nothing else may be added to this record in between.
+     * As with addEvent, if the first event is too large for the internal buffers,
+     * more memory is allocated.<p>
+     * <b>The byte order of event must match the byte order given in constructor!</b>
+     *
+     * @param maxLen       max number of bytes the event may take.
+     * @param extraDataLen additional data bytes to follow event (e.g. trailer length).
+     * @return pointer to maxLen bytes to write the event into; null if the count limit
+     *         would be exceeded or the buffer is full and cannot be expanded since it's
+     *         user-provided.
+     */
+    uint8_t * RecordOutput::reserveEvent(uint32_t maxLen, uint32_t extraDataLen) {
+
+        reservedBytes = 0;
+
+        if (eventCount < 1 && !roomForEvent(maxLen + extraDataLen)) {
+            if (userProvidedBuffer) {
+                return nullptr;
+            }
+
+            // Allocate roughly what we need + 1MB
+            MAX_BUFFER_SIZE = maxLen + ONE_MEG;
+            RECORD_BUFFER_SIZE = MAX_BUFFER_SIZE + ONE_MEG;
+            allocate();
+            // This does NOT reset record type, compression type, or byte order
+            reset();
+        }
+
+        if (oneTooMany() || !roomForEvent(maxLen)) {
+            return nullptr;
+        }
+
+        reservedBytes = maxLen;
+        return recordEvents->array() + recordEvents->arrayOffset() + recordEvents->position();
+    }
+
+
+    /**
+     * Add the event written into the space given by {@link #reserveEvent(uint32_t, uint32_t)}
+     * to this record.
+     * @param eventLen actual length of event in bytes. If 0, the reservation is dropped
+     *                 and no event is added.
+     * @throws EvioException if no space was reserved, or eventLen is larger than reserved.
+     */
+    void RecordOutput::commitEvent(uint32_t eventLen) {
+        if (reservedBytes == 0) {
+            throw EvioException("no space reserved for event");
+        }
+        if (eventLen > reservedBytes) {
+            throw EvioException("event of " + std::to_string(eventLen) + " bytes exceeds the " +
+                                std::to_string(reservedBytes) + " reserved");
+        }
+        reservedBytes = 0;
+        if (eventLen == 0) return;
+
+        // Event is already in place
+        recordEvents->position(recordEvents->position() + eventLen);
+        eventSize += eventLen;
+
+        recordIndex->putInt(indexSize, eventLen);
+        indexSize += 4;
+        eventCount++;
+    }
+
+
     /**
      * Adds an event's ByteBuffer into the record.
      * If a single event is too large for the internal buffers,
@@ -779,6 +1021,8 @@ namespace evio {
         indexSize  = 0;
         eventSize  = 0;
         eventCount = 0;
+        reservedBytes = 0;
+        eventsGathered = false;
         //startingPosition = 0;
 
         recordData->clear();
@@ -811,9 +1055,14 @@ namespace evio {
      * then header & data written into internal buffer.
      * This method may be called multiple times in succession without
      * any problem.
+     * @throws EvioException if compressing the data fails.
      */
     void RecordOutput::build() {
 
+        // Set below if compressed with dictionary
+        header->hasCompressionDictionary(false);
+        eventsGathered = false;
+
         // If no events have been added yet, just write a header
         if (eventCount < 1) {
             header->setEntries(0);
@@ -834,6 +1083,12 @@ namespace evio {
 
         uint32_t compressionType = header->getCompressionType();
 
+        // Let adaptive compression choose the type for this record
+        if (adaptiveCompression != nullptr) {
+            compressionType = adaptiveCompression->select();
+            header->setCompressionType(Compressor::toCompressionType(compressionType));
+        }
+
         // Position in recordBinary buffer of just past the record header
         size_t recBinPastHdr = startingPosition + RecordHeader::HEADER_SIZE_BYTES;
 //std::cout << "build: pos past header = " << recBinPastHdr << std::endl;
@@ -871,7 +1126,13 @@ namespace evio {
 //             ", eventSize = " << eventSize << ", recordEvents buffer capacity = " <<
 //             recordEvents->capacity() << std::endl;
 
-            recordBinary->put(recordEvents->array(), eventSize);
+            // Events are written to file from where they are if vectored writing
+            if (vectoredWrite) {
+                eventsGathered = true;
+            }
+            else {
+                recordBinary->put(recordEvents->array(), eventSize);
+            }
         }
 
         // Evio data is padded, but not necessarily all hipo data.
@@ -881,20 +1142,47 @@ namespace evio {
 //std::cout << "build: writing index of size " << indexSize << ", events of size " <<
 //             eventSize << ", total = " << uncompressedDataSize << std::endl;
 
-#ifdef USE_GZIP
-        uint8_t* gzippedData = nullptr;
-#endif
+
+        // Filter data before compressing it
+        uint8_t *compressSrc = recordData->array();
+        DataFilter::FilterType filter = dataFilter;
+        if (compressionType == Compressor::UNCOMPRESSED) {
+            filter = DataFilter::NONE;
+        }
+        header->setDataFilter(filter, dataFilterWordSize);
+        if (filter != DataFilter::NONE) {
+            if (filteredData.size() < uncompressedDataSize) {
+                filteredData.resize(uncompressedDataSize);
+            }
+            DataFilter::encode(filter, dataFilterWordSize, !byteOrder.isLocalEndian(),
+                               recordData->array(), filteredData.data(), uncompressedDataSize,
+                               filterScratch);
+            compressSrc = filteredData.data();
+        }
 
         // Compress that temporary buffer into destination buffer
         // (skipping over where record header will be written).
+        // Only compression is timed, so filtering is not charged to the type being tried
+        auto compressStart = std::chrono::steady_clock::now();
+
         try {
             switch (compressionType) {
                 case 1:
                     // LZ4 fastest compression
-                    compressedSize = Compressor::getInstance().compressLZ4(
-                            recordData->array(), 0, uncompressedDataSize,
-                            recordBinary->array(), recBinPastHdrAbsolute,
-                            (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressLZ4(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressLZ4(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
 
                     // Length of compressed data in bytes
                     header->setCompressedDataLength(compressedSize);
@@ -905,10 +1193,20 @@ namespace evio {
 
                 case 2:
                     // LZ4 highest compression
-                    compressedSize = Compressor::getInstance().compressLZ4Best(
-                            recordData->array(), 0, uncompressedDataSize,
-                            recordBinary->array(), recBinPastHdrAbsolute,
-                            (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressLZ4Best(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressLZ4Best(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
 
 //std::cout << "Compressing data array from offset = 0, size = " << uncompressedDataSize <<
 //             " to output.array offset = " << recBinPastHdrAbsolute << ", compressed size = " <<  compressedSize <<
@@ -931,17 +1229,40 @@ namespace evio {
                 case 3:
                     // GZIP compression
 #ifdef USE_GZIP
-                    gzippedData = Compressor::getInstance().compressGZIP(recordData->array(), 0,
-                                                                     uncompressedDataSize, &compressedSize);
-                    recordBinary->position(recBinPastHdr);
-                    recordBinary->put(gzippedData, compressedSize);
-                    delete[] gzippedData;
+                    compressedSize = Compressor::getInstance().compressGZIP(
+                            compressSrc, 0, uncompressedDataSize,
+                            recordBinary->array(), recBinPastHdrAbsolute,
+                            (recordBinary->capacity() - recBinPastHdrAbsolute));
                     header->setCompressedDataLength(compressedSize);
                     header->setLength(4*header->getCompressedDataLengthWords() +
                                      RecordHeader::HEADER_SIZE_BYTES);
 #endif
                     break;
 
+                case 4:
+                    // ZSTD compression
+#ifdef USE_ZSTD
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressZSTD(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                0, *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressZSTD(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
+
+                    header->setCompressedDataLength(compressedSize);
+                    header->setLength(4*header->getCompressedDataLengthWords() +
+                                      RecordHeader::HEADER_SIZE_BYTES);
+#endif
+                    break;
+
                 case 0:
                 default:
                     // No compression. The uncompressed data size may not be padded to a 4byte boundary,
@@ -953,7 +1274,16 @@ namespace evio {
 //std::cout << "  build(): set header length = " << header->getLength() << ", uncompressed data size = " << uncompressedDataSize << std::endl;
             }
         }
-        catch (EvioException & e) {/* should not happen */}
+        catch (EvioException & e) {
+            // Header would claim compressed data which was never written
+            throw EvioException("error compressing record, " + std::string(e.what()));
+        }
+
+        if (adaptiveCompression != nullptr) {
+            std::chrono::duration<double> compressTime = std::chrono::steady_clock::now() - compressStart;
+            adaptiveCompression->update(Compressor::toCompressionType(compressionType),
+                                        uncompressedDataSize, compressedSize, compressTime.count());
+        }
 
         // Set the rest of the header values
         header->setEntries(eventCount);
@@ -972,7 +1302,13 @@ namespace evio {
         catch (EvioException & e) {/* never happen */}
 
         // Make ready to read
-        recordBinary->limit(startingPosition + header->getLength()).position(0);
+        if (eventsGathered) {
+            // Only header and index are here
+            recordBinary->limit(recBinPastHdr + indexSize).position(0);
+        }
+        else {
+            recordBinary->limit(startingPosition + header->getLength()).position(0);
+        }
     }
 
 
@@ -998,6 +1334,7 @@ namespace evio {
      * any problem.
      *
      * @param userHeader user's ByteBuffer which must be READY-TO-READ!
+     * @throws EvioException if compressing the data fails.
      */
     void RecordOutput::build(const ByteBuffer & userHeader) {
 
@@ -1009,10 +1346,21 @@ namespace evio {
             return;
         }
 
+        // Set below if compressed with dictionary
+        header->hasCompressionDictionary(false);
+        // Records with a user header are always built whole
+        eventsGathered = false;
+
 //std::cout << "  buld: indexSize = " << indexSize << ", index + userHeader =  " << (indexSize + userHeaderSize) <<
 //             ",  userheader = " << userHeaderSize << std::endl;
 
         uint32_t compressionType = header->getCompressionType();
+
+        // Let adaptive compression choose the type for this record
+        if (adaptiveCompression != nullptr) {
+            compressionType = adaptiveCompression->select();
+            header->setCompressionType(Compressor::toCompressionType(compressionType));
+        }
         uint32_t uncompressedDataSize = indexSize;
 
         // Position in recordBinary buffer of just past the record header
@@ -1075,20 +1423,48 @@ namespace evio {
             uncompressedDataSize += eventSize;
         }
 
+        uint32_t compressedSize = 0;
+
+        // Filter data before compressing it
+        uint8_t *compressSrc = recordData->array();
+        DataFilter::FilterType filter = dataFilter;
+        if (compressionType == Compressor::UNCOMPRESSED) {
+            filter = DataFilter::NONE;
+        }
+        header->setDataFilter(filter, dataFilterWordSize);
+        if (filter != DataFilter::NONE) {
+            if (filteredData.size() < uncompressedDataSize) {
+                filteredData.resize(uncompressedDataSize);
+            }
+            DataFilter::encode(filter, dataFilterWordSize, !byteOrder.isLocalEndian(),
+                               recordData->array(), filteredData.data(), uncompressedDataSize,
+                               filterScratch);
+            compressSrc = filteredData.data();
+        }
+
         // Compress that temporary buffer into destination buffer
         // (skipping over where record header will be written).
-        uint32_t compressedSize = 0;
-#ifdef USE_GZIP
-        uint8_t* gzippedData = nullptr;
-#endif
+        // Only compression is timed, so filtering is not charged to the type being tried
+        auto compressStart = std::chrono::steady_clock::now();
+
         try {
             switch (compressionType) {
                 case 1:
                     // LZ4 fastest compression
-                    compressedSize = Compressor::getInstance().compressLZ4(
-                            recordData->array(), 0, uncompressedDataSize,
-                            recordBinary->array(), recBinPastHdrAbsolute,
-                            (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressLZ4(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressLZ4(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
 
                     // Length of compressed data in bytes
                     header->setCompressedDataLength(compressedSize);
@@ -1099,10 +1475,20 @@ namespace evio {
 
                 case 2:
                     // LZ4 highest compression
-                    compressedSize = Compressor::getInstance().compressLZ4Best(
-                            recordData->array(), 0, uncompressedDataSize,
-                            recordBinary->array(), recBinPastHdrAbsolute,
-                            (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressLZ4Best(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressLZ4Best(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
 
                     header->setCompressedDataLength(compressedSize);
                     header->setLength(4*header->getCompressedDataLengthWords() +
@@ -1112,17 +1498,40 @@ namespace evio {
                 case 3:
                     // GZIP compression
 #ifdef USE_GZIP
-                gzippedData = Compressor::getInstance().compressGZIP(recordData->array(), 0,
-                                                                     uncompressedDataSize, &compressedSize);
-                recordBinary->position(recBinPastHdr);
-                recordBinary->put(gzippedData, compressedSize);
-                delete[] gzippedData;
+                compressedSize = Compressor::getInstance().compressGZIP(
+                        compressSrc, 0, uncompressedDataSize,
+                        recordBinary->array(), recBinPastHdrAbsolute,
+                        (recordBinary->capacity() - recBinPastHdrAbsolute));
                 header->setCompressedDataLength(compressedSize);
                 header->setLength(4*header->getCompressedDataLengthWords() +
                                  RecordHeader::HEADER_SIZE_BYTES);
 #endif
                     break;
 
+                case 4:
+                    // ZSTD compression
+#ifdef USE_ZSTD
+                    if (compressionDictionary != nullptr) {
+                        compressedSize = Compressor::getInstance().compressZSTD(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute),
+                                0, *compressionDictionary);
+                        header->hasCompressionDictionary(true);
+                    }
+                    else {
+                        compressedSize = Compressor::getInstance().compressZSTD(
+                                compressSrc, 0, uncompressedDataSize,
+                                recordBinary->array(), recBinPastHdrAbsolute,
+                                (recordBinary->capacity() - recBinPastHdrAbsolute));
+                    }
+
+                    header->setCompressedDataLength(compressedSize);
+                    header->setLength(4*header->getCompressedDataLengthWords() +
+                                      RecordHeader::HEADER_SIZE_BYTES);
+#endif
+                    break;
+
                 case 0:
                 default:
                     // No compression. The uncompressed data size may not be padded to a 4byte boundary,
@@ -1133,7 +1542,16 @@ namespace evio {
                     header->setLength(words*4 + RecordHeader::HEADER_SIZE_BYTES);
             }
         }
-        catch (EvioException & e) {/* should not happen */}
+        catch (EvioException & e) {
+            // Header would claim compressed data which was never written
+            throw EvioException("error compressing record, " + std::string(e.what()));
+        }
+
+        if (adaptiveCompression != nullptr) {
+            std::chrono::duration<double> compressTime = std::chrono::steady_clock::now() - compressStart;
+            adaptiveCompression->update(Compressor::toCompressionType(compressionType),
+                                        uncompressedDataSize, compressedSize, compressTime.count());
+        }
 
         //std::cout << " COMPRESSED SIZE = " << compressedSize << std::endl;
 
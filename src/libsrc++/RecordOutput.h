@@ -19,6 +19,7 @@
 #include <cstddef>
 #include <vector>
 #include <memory>
+#include <chrono>
 
 
 #include "ByteBuffer.h"
@@ -28,6 +29,9 @@
 #include "RecordHeader.h"
 #include "FileHeader.h"
 #include "Compressor.h"
+#include "AdaptiveCompression.h"
+#include "DataFilter.h"
+#include "ThreadPlacement.h"
 #include "EvioException.h"
 
 
@@ -175,9 +179,48 @@ namespace evio {
         /** Is recordBinary a user provided buffer? */
         bool userProvidedBuffer = false;
 
+        /** Dictionary to compress with, if any. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+        /** Chooses the type of compression for each build, if any. */
+        std::shared_ptr<AdaptiveCompression> adaptiveCompression;
+
+        /** Filter applied to data before compression. */
+        DataFilter::FilterType dataFilter = DataFilter::NONE;
+
+        /** Size in bytes of words the data filter works on. */
+        uint32_t dataFilterWordSize = 4;
+
+        /** Filtered data, to be compressed. */
+        std::vector<uint8_t> filteredData;
+
+        /** Temporary storage used in filtering. */
+        std::vector<uint8_t> filterScratch;
+
+        /** NUMA nodes the internal buffers are placed on, empty if not placed. */
+        std::vector<int> numaNodes;
+
+        /** Number of bytes reserved for an event written in place, 0 if none. */
+        uint32_t reservedBytes = 0;
+
+        /** If true, build leaves the events of an uncompressed record in recordEvents
+         *  to be written from there, see {@link #getWriteSegments()}. */
+        bool vectoredWrite = false;
+
+        /** Did the last build leave the events out of recordBinary? */
+        bool eventsGathered = false;
+
 
     public:
 
+        /** Memory holding part of a built record. */
+        struct Segment {
+            /** Start of memory. */
+            const uint8_t *data;
+            /** Number of bytes. */
+            size_t bytes;
+        };
+
 
         RecordOutput();
 
@@ -203,6 +246,7 @@ namespace evio {
 
 
         void allocate();
+        void placeBuffers();
         bool allowedIntoRecord(uint32_t length);
         void copy(const RecordOutput & rec);
 
@@ -225,6 +269,23 @@ namespace evio {
         const Compressor::CompressionType getCompressionType() const;
         const HeaderType getHeaderType() const;
 
+        std::shared_ptr<CompressionDictionary> getCompressionDictionary() const;
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+
+        std::shared_ptr<AdaptiveCompression> getAdaptiveCompression() const;
+        void setAdaptiveCompression(std::shared_ptr<AdaptiveCompression> adaptive);
+
+        DataFilter::FilterType getDataFilter() const;
+        uint32_t getDataFilterWordSize() const;
+        void setDataFilter(DataFilter::FilterType type, uint32_t wordSize = 4);
+
+        const std::vector<int> & getNumaNodes() const;
+        void setNumaNodes(std::vector<int> const & nodes);
+
+        bool getVectoredWrite() const;
+        void setVectoredWrite(bool vectored);
+        std::vector<Segment> getWriteSegments() const;
+
         bool hasUserProvidedBuffer() const;
         bool roomForEvent(uint32_t length) const;
         bool oneTooMany() const;
@@ -242,6 +303,9 @@ namespace evio {
         bool addEvent(EvioBank & event, uint32_t extraDataLen);
         bool addEvent(std::shared_ptr<EvioBank> event, uint32_t extraDataLen = 0);
 
+        uint8_t * reserveEvent(uint32_t maxLen, uint32_t extraDataLen = 0);
+        void commitEvent(uint32_t eventLen);
+
         void reset();
 
         void setStartingBufferPosition(size_t pos);
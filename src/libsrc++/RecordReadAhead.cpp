@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "RecordReadAhead.h"
+
+
+namespace evio {
+
+
+    /**
+     * Constructor. Starts the threads which immediately begin reading
+     * and decompressing records, starting with the first.
+     *
+     * @param fileName     name of file to read.
+     * @param mappedBuffer buffer of memory mapped file. If null, each thread opens its own stream.
+     * @param positions    position of each record in the file.
+     * @param threadCount  number of threads reading & decompressing records.
+     *                     Values &lt; 1 are set to 1. Values &gt; recordCount are set to recordCount.
+     * @param recordCount  max number of records read ahead of the current one.
+     *                     Values &lt; 1 are set to 1.
+     * @param compressionDict dictionary to uncompress records with, null if none.
+     */
+    RecordReadAhead::RecordReadAhead(std::string const & fileName,
+                                     std::shared_ptr<ByteBuffer> mappedBuffer,
+                                     std::vector<size_t> const & positions,
+                                     uint32_t threadCount, uint32_t recordCount,
+                                     std::shared_ptr<CompressionDictionary> compressionDict) :
+            fileName(fileName), mappedBuffer(std::move(mappedBuffer)), recordPositions(positions),
+            compressionDictionary(std::move(compressionDict)) {
+
+        if (recordCount < 1) recordCount = 1;
+        if (threadCount < 1) threadCount = 1;
+        if (threadCount > recordCount) threadCount = recordCount;
+
+        slots.resize(recordCount);
+
+        threads.reserve(threadCount);
+        for (uint32_t i=0; i < threadCount; i++) {
+            threads.emplace_back([this]() {this->run();});
+        }
+    }
+
+
+    /** Destructor. Stops and joins all threads. */
+    RecordReadAhead::~RecordReadAhead() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopThreads = true;
+        }
+        cond.notify_all();
+
+        for (auto & thd : threads) {
+            if (thd.joinable()) {
+                thd.join();
+            }
+        }
+    }
+
+
+    /**
+     * Start reading ahead from the given record.
+     * Records already read which are still ahead of the given one are kept.
+     * Must be called with mtx locked.
+     * @param recordIndex index of record to start from.
+     */
+    void RecordReadAhead::startOver(uint32_t recordIndex) {
+        nextToTake = nextToRead = recordIndex;
+
+        for (auto & slot : slots) {
+            if (slot.state == READY &&
+                (slot.recordIndex < recordIndex || slot.recordIndex >= recordIndex + slots.size())) {
+                slot.state = EMPTY;
+            }
+        }
+        cond.notify_all();
+    }
+
+
+    /**
+     * Get the record of the given index. If it's the next record expected, it's
+     * taken from those already read ahead (waiting if it's still being read).
+     * If it's not, reading ahead starts over from this record.
+     * The given record object is swapped with the one read, so its
+     * memory can be reused for reading ahead.
+     *
+     * @param recordIndex index of the record (starting at 0).
+     * @param record      object to fill with the record.
+     * @throws EvioException if index too large or error reading or decompressing record.
+     */
+    void RecordReadAhead::getRecord(uint32_t recordIndex, RecordInput & record) {
+
+        std::unique_lock<std::mutex> lock(mtx);
+
+        if (recordIndex >= recordPositions.size()) {
+            throw EvioException("record index too large");
+        }
+
+        if (recordIndex != nextToTake) {
+            startOver(recordIndex);
+        }
+
+        Slot & slot = slots[recordIndex % slots.size()];
+        cond.wait(lock, [&slot, recordIndex]() {
+            return slot.state == READY && slot.recordIndex == recordIndex;
+        });
+
+        std::string error = slot.error;
+        std::swap(record, slot.record);
+        slot.state = EMPTY;
+        nextToTake = recordIndex + 1;
+        lock.unlock();
+        cond.notify_all();
+
+        if (!error.empty()) {
+            throw EvioException(error);
+        }
+    }
+
+
+    /** Method run by each thread to read & decompress records ahead of the reader. */
+    void RecordReadAhead::run() {
+
+        std::ifstream file;
+        std::string openError;
+
+        if (mappedBuffer == nullptr) {
+            try {
+                file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+                file.open(fileName, std::ios::binary);
+            }
+            catch (std::exception & e) {
+                openError = "cannot open " + fileName + ", " + e.what();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mtx);
+
+        while (!stopThreads) {
+
+            if (nextToRead < recordPositions.size() && nextToRead < nextToTake + slots.size()) {
+                uint32_t index = nextToRead;
+                Slot & slot = slots[index % slots.size()];
+
+                // Already read before starting over at an earlier record
+                if (slot.state == READY && slot.recordIndex == index) {
+                    nextToRead++;
+                    continue;
+                }
+
+                // Wait if slot is still being filled with a record no longer wanted
+                if (slot.state != LOADING) {
+                    slot.state = LOADING;
+                    slot.recordIndex = index;
+                    nextToRead++;
+                    lock.unlock();
+
+                    std::string error = openError;
+                    if (error.empty()) {
+                        try {
+                            // Record may have been swapped with one from outside
+                            slot.record.setCompressionDictionary(compressionDictionary);
+                            if (mappedBuffer == nullptr) {
+                                slot.record.readRecord(file, recordPositions[index]);
+                            }
+                            else {
+                                // Reading changes the buffer's byte order and limit, so use a separate
+                                // view of the mapped memory. It shares that memory, so events
+                                // pointing into the view keep the file mapped.
+                                auto view = mappedBuffer->duplicate();
+                                slot.record.readRecord(view, recordPositions[index]);
+                            }
+                        }
+                        catch (std::exception & e) {
+                            error = e.what();
+                        }
+                    }
+
+                    lock.lock();
+                    slot.error = error;
+                    slot.state = READY;
+                    cond.notify_all();
+                    continue;
+                }
+            }
+
+            cond.wait(lock);
+        }
+    }
+
+}
@@ -0,0 +1,124 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_RECORDREADAHEAD_H
+#define EVIO_6_0_RECORDREADAHEAD_H
+
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+
+
+#include "ByteBuffer.h"
+#include "RecordInput.h"
+#include "EvioException.h"
+
+
+#include <boost/thread.hpp>
+
+
+namespace evio {
+
+
+    /**
+     * Class used by {@link Reader} to read and decompress records of a file
+     * ahead of the record currently being read.
+     * A pool of threads reads and decompresses the next records, in parallel,
+     * into a ring of RecordInput objects. Each thread has its own file stream
+     * (or its own view of a memory mapped file).
+     * Records are handed out in order, one by one, by {@link #getRecord(uint32_t, RecordInput &)}.
+     * If a record other than the next one is asked for, reading ahead starts over
+     * from that record.
+     * <b>This is for internal use only.</b>
+     *
+     * @date 10/15/2026
+     * @author timmer
+     */
+    class RecordReadAhead {
+
+    private:
+
+        /** State of a ring slot. */
+        enum SlotState {
+            /** No record or stale record. */
+            EMPTY = 0,
+            /** Record is being read by a thread. */
+            LOADING,
+            /** Record is read and ready to be taken. */
+            READY
+        };
+
+        /** Each slot of the ring holds one record. */
+        struct Slot {
+            /** Record being read into or already read. */
+            RecordInput record;
+            /** Index of the record held in this slot. */
+            uint32_t recordIndex = 0;
+            /** State of this slot. */
+            SlotState state = EMPTY;
+            /** Non-empty if error reading record. */
+            std::string error;
+        };
+
+
+        /** Name of file being read. */
+        std::string fileName;
+        /** Memory mapped file, if any. */
+        std::shared_ptr<ByteBuffer> mappedBuffer;
+        /** Position of each record in the file. */
+        std::vector<size_t> recordPositions;
+        /** Dictionary to uncompress records with, if any. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+        /** Ring of slots. Record #n always goes into slot #(n % slots.size()). */
+        std::vector<Slot> slots;
+        /** Threads reading and decompressing records. */
+        std::vector<boost::thread> threads;
+
+        /** Protects all members below. */
+        std::mutex mtx;
+        /** Signals any change in slot state or in reading position. */
+        std::condition_variable cond;
+
+        /** Index of the next record expected to be taken by the reader. */
+        uint32_t nextToTake = 0;
+        /** Index of the next record to be read by a thread. */
+        uint32_t nextToRead = 0;
+        /** Time for threads to quit. */
+        bool stopThreads = false;
+
+
+        void run();
+        void startOver(uint32_t recordIndex);
+
+    public:
+
+        RecordReadAhead(std::string const & fileName,
+                        std::shared_ptr<ByteBuffer> mappedBuffer,
+                        std::vector<size_t> const & positions,
+                        uint32_t threadCount, uint32_t recordCount,
+                        std::shared_ptr<CompressionDictionary> compressionDict = nullptr);
+
+        RecordReadAhead(const RecordReadAhead & other) = delete;
+        RecordReadAhead & operator=(const RecordReadAhead & other) = delete;
+
+        ~RecordReadAhead();
+
+        void getRecord(uint32_t recordIndex, RecordInput & record);
+    };
+
+}
+
+
+#endif //EVIO_6_0_RECORDREADAHEAD_H
@@ -90,6 +90,7 @@ namespace evio {
             lastItem.store(item.lastItem);
             checkDisk.store(item.checkDisk);
             forceToDiskBool.store(item.forceToDiskBool);
+            flushAfterWriteBool.store(item.flushAfterWriteBool);
             splitFileAfterWriteBool.store(item.splitFileAfterWriteBool);
             alreadyReleased = true;
 
@@ -136,6 +137,7 @@ namespace evio {
         lastItem.store(false);
         checkDisk.store(false);
         forceToDiskBool.store(false);
+        flushAfterWriteBool.store(false);
         splitFileAfterWriteBool.store(false);
         alreadyReleased = false;
     }
@@ -217,6 +219,21 @@ namespace evio {
     void RecordRingItem::forceToDisk(bool force) {forceToDiskBool = force;}
 
 
+    /**
+     * Get whether a file writer flushes this record out of its write buffer once written,
+     * so it reaches the file (or the kernel) without waiting for following records.
+     * @return true if file writer flushes this record once written.
+     */
+    bool RecordRingItem::flushAfterWrite() {return flushAfterWriteBool.load();}
+
+
+    /**
+     * Set whether a file writer flushes this record out of its write buffer once written.
+     * @param flush if true, file writer flushes this record once written, else false.
+     */
+    void RecordRingItem::flushAfterWrite(bool flush) {flushAfterWriteBool = flush;}
+
+
     /**
      * Get whether there is not enough free space on the disk partition for the
      * next, complete file to be written, resulting in not creating or writing to file.
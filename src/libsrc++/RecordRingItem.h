@@ -70,6 +70,9 @@ namespace evio {
         /** Do we force the record to be physically written to disk? */
         std::atomic<bool> forceToDiskBool{false};
 
+        /** Do we flush the record out of any write buffer once written? */
+        std::atomic<bool> flushAfterWriteBool{false};
+
         /** If a new file needs to be created ({@link #splitFileAfterWrite} is true),
          * but there is not enough free space on the disk partition for the
          * next, complete file, return without creating or writing to file.
@@ -118,6 +121,9 @@ namespace evio {
         bool forceToDisk();
         void forceToDisk(bool force);
 
+        bool flushAfterWrite();
+        void flushAfterWrite(bool flush);
+
         bool isCheckDisk();
         void setCheckDisk(bool check);
 
@@ -38,15 +38,20 @@ namespace evio {
      *                         (Compressor::UNCOMPRESSED = 0 = none,
      *                          Compressor::LZ4 = 1 = lz4 fast,
      *                          Compressor::LZ4_BEST = 2 = lz4 best,
-     *                          Compressor::GZIP = 3 = gzip).
+     *                          Compressor::GZIP = 3 = gzip,
+     *                          Compressor::ZSTD = 4 = zstd).
+     * @param strategy        how compression and writing threads wait for records.
      * @throws EvioException if args < 1, ringSize not power of 2,
-     *                                  threadCount > ringSize.
+     *                                  threadCount > ringSize,
+     *                                  compressionType not compiled in.
      */
     RecordSupply::RecordSupply(uint32_t ringSize, ByteOrder order,
                                uint32_t threadCount, uint32_t maxEventCount, uint32_t maxBufferSize,
-                               Compressor::CompressionType & compressionType) :
+                               Compressor::CompressionType & compressionType,
+                               WaitStrategy strategy) :
 
-            order(order), maxBufferSize(maxBufferSize), compressionType(compressionType), ringSize(ringSize)
+            order(order), maxBufferSize(maxBufferSize), compressionType(compressionType),
+            ringSize(ringSize), waitStrategy(strategy)
     {
 
         if (ringSize < 1 || !Disruptor::Util::isPowerOf2(ringSize)) {
@@ -57,6 +62,10 @@ namespace evio {
             throw EvioException("threadCount must be <= ringSize");
         }
 
+        if (!Compressor::isSupported(compressionType)) {
+            throw EvioException("compression type " + std::to_string(compressionType) + " not compiled in");
+        }
+
         // # compression threads defaults to 1 if given bad value
         if (threadCount > 0) {
             compressionThreadCount = threadCount;
@@ -65,12 +74,28 @@ namespace evio {
         // Set RecordRingItem static values to be used when eventFactory is creating RecordRingItem objects
         RecordRingItem::setEventFactorySettings(order, maxEventCount, maxBufferSize, compressionType);
 
-        // Spin first then block
-        auto blockingStrategy = std::make_shared< Disruptor::BlockingWaitStrategy >();
-        auto waitStrategy = std::make_shared< Disruptor::SpinCountBackoffWaitStrategy >(10000, blockingStrategy);
+        std::shared_ptr<Disruptor::IWaitStrategy> waitStrat;
+        switch (strategy) {
+            case BLOCKING:
+                waitStrat = std::make_shared< Disruptor::BlockingWaitStrategy >();
+                break;
+            case YIELDING:
+                waitStrat = std::make_shared< Disruptor::YieldingWaitStrategy >();
+                break;
+            case BUSY_SPIN:
+                waitStrat = std::make_shared< Disruptor::BusySpinWaitStrategy >();
+                break;
+            case SPIN_BACKOFF:
+            default: {
+                // Spin first then block
+                auto blockingStrategy = std::make_shared< Disruptor::BlockingWaitStrategy >();
+                waitStrat = std::make_shared< Disruptor::SpinCountBackoffWaitStrategy >(10000, blockingStrategy);
+            }
+        }
+
         // Create ring buffer with "ringSize" # of elements
         ringBuffer = Disruptor::RingBuffer<std::shared_ptr<RecordRingItem>>::createSingleProducer(
-                RecordRingItem::eventFactory(), ringSize, waitStrategy);
+                RecordRingItem::eventFactory(), ringSize, waitStrat);
 
         // Thread which fills records is considered the "producer" and doesn't need a barrier
 
@@ -133,6 +158,93 @@ namespace evio {
     uint32_t RecordSupply::getMaxRingBytes() const {return (int) (ringSize*1.1*maxBufferSize);}
 
 
+    /**
+     * Set the dictionary all records in this supply are compressed with.
+     * Only call this before any record has been gotten with {@link #get()}.
+     * @param dict dictionary to compress with, null for none.
+     */
+    void RecordSupply::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        for (uint32_t i=0; i < ringSize; i++) {
+            (*ringBuffer.get())[i]->getRecord()->setCompressionDictionary(dict);
+        }
+    }
+
+
+    /**
+     * Set the object which chooses the type of compression of all records in this supply.
+     * Only call this before any record has been gotten with {@link #get()}.
+     * @param adaptive object choosing the type of compression, null for none.
+     */
+    void RecordSupply::setAdaptiveCompression(std::shared_ptr<AdaptiveCompression> adaptive) {
+        for (uint32_t i=0; i < ringSize; i++) {
+            (*ringBuffer.get())[i]->getRecord()->setAdaptiveCompression(adaptive);
+        }
+    }
+
+
+    /**
+     * Set the filter applied to the data of all records in this supply before compression.
+     * Only call this before any record has been gotten with {@link #get()}.
+     * @param type     type of filter.
+     * @param wordSize size in bytes of the words filtered, 4 or 8.
+     * @throws EvioException if wordSize is not 4 or 8.
+     */
+    void RecordSupply::setDataFilter(DataFilter::FilterType type, uint32_t wordSize) {
+        for (uint32_t i=0; i < ringSize; i++) {
+            (*ringBuffer.get())[i]->getRecord()->setDataFilter(type, wordSize);
+        }
+    }
+
+
+    /**
+     * Place the buffers of all records in this supply on the given NUMA nodes.
+     * @param nodes NUMA nodes, empty to stop placing newly allocated buffers.
+     * @see RecordOutput#setNumaNodes(std::vector<int> const &)
+     */
+    void RecordSupply::setNumaNodes(std::vector<int> const & nodes) {
+        for (uint32_t i=0; i < ringSize; i++) {
+            (*ringBuffer.get())[i]->getRecord()->setNumaNodes(nodes);
+        }
+    }
+
+
+    /**
+     * Have all records in this supply leave the events of uncompressed records
+     * out of their binary buffers when built, to be written from where they were added.
+     * Only for records written to file, which are not reused before being written.
+     * @param vectored true to leave events out of the binary buffers.
+     * @see RecordOutput#setVectoredWrite(bool)
+     */
+    void RecordSupply::setVectoredWrite(bool vectored) {
+        for (uint32_t i=0; i < ringSize; i++) {
+            (*ringBuffer.get())[i]->getRecord()->setVectoredWrite(vectored);
+        }
+    }
+
+
+    /**
+     * Get the name of a wait strategy.
+     * @param strategy wait strategy.
+     * @return name of wait strategy.
+     */
+    std::string RecordSupply::waitStrategyName(WaitStrategy strategy) {
+        switch (strategy) {
+            case BLOCKING:     return "blocking";
+            case YIELDING:     return "yielding";
+            case SPIN_BACKOFF: return "spin-backoff";
+            case BUSY_SPIN:    return "busy-spin";
+            default:           return "unknown";
+        }
+    }
+
+
+    /**
+     * Get how compression and writing threads wait for records.
+     * @return how compression and writing threads wait for records.
+     */
+    RecordSupply::WaitStrategy RecordSupply::getWaitStrategy() const {return waitStrategy;}
+
+
     /**
      * Get the number of records in this supply.
      * @return number of records in this supply.
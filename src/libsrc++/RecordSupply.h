@@ -30,6 +30,9 @@
 #include "Disruptor/ISequenceBarrier.h"
 #include "Disruptor/AlertException.h"
 #include "Disruptor/TimeoutException.h"
+#include "Disruptor/BlockingWaitStrategy.h"
+#include "Disruptor/YieldingWaitStrategy.h"
+#include "Disruptor/BusySpinWaitStrategy.h"
 #include "Disruptor/SpinCountBackoffWaitStrategy.h"
 
 
@@ -101,6 +104,26 @@ namespace evio {
      */
     class RecordSupply {
 
+    public:
+
+        /**
+         * How the compression and writing threads wait for records.
+         * Trades latency against CPU used while waiting.
+         */
+        enum WaitStrategy {
+            /** Sleep on a lock until woken. Least CPU, most latency. For shared machines. */
+            BLOCKING = 0,
+            /** Spin briefly, then yield the CPU to other threads between checks. */
+            YIELDING = 1,
+            /** Spin a while, then block. The default. */
+            SPIN_BACKOFF = 2,
+            /** Spin without ever giving up the CPU. Least latency, but each waiting
+             *  thread uses a whole core. For dedicated machines. */
+            BUSY_SPIN = 3
+        };
+
+        static std::string waitStrategyName(WaitStrategy strategy);
+
     private:
 
         /** Mutex for thread safety when setting error code or releasing resources. */
@@ -115,12 +138,14 @@ namespace evio {
         /** Max number of uncompressed data bytes each record can hold.
          *  Value of < 8MB results in default of 8MB. */
         uint32_t maxBufferSize = 0;
-        /** Type type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip). */
+        /** Type type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip, 4=zstd). */
         Compressor::CompressionType compressionType = Compressor::CompressionType::UNCOMPRESSED;
         /** Number of threads doing compression simultaneously. */
         uint32_t compressionThreadCount = 1;
         /** Number of records held in this supply. */
         uint32_t ringSize = 0;
+        /** How threads wait for records. */
+        WaitStrategy waitStrategy = SPIN_BACKOFF;
 
         // Stuff for reporting errors
 
@@ -179,7 +204,8 @@ namespace evio {
         RecordSupply(const RecordSupply & supply) = delete;
         RecordSupply(uint32_t ringSize, ByteOrder order,
                      uint32_t threadCount, uint32_t maxEventCount, uint32_t maxBufferSize,
-                     Compressor::CompressionType & compressionType);
+                     Compressor::CompressionType & compressionType,
+                     WaitStrategy strategy = SPIN_BACKOFF);
 
         ~RecordSupply() {
             compressSeqs.clear();
@@ -193,7 +219,13 @@ namespace evio {
         void errorAlert();
 
         uint32_t getMaxRingBytes() const ;
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+        void setAdaptiveCompression(std::shared_ptr<AdaptiveCompression> adaptive);
+        void setDataFilter(DataFilter::FilterType type, uint32_t wordSize);
+        void setNumaNodes(std::vector<int> const & nodes);
+        void setVectoredWrite(bool vectored);
         uint32_t getRingSize() const ;
+        WaitStrategy getWaitStrategy() const;
         ByteOrder & getOrder();
         uint64_t getFillLevel();
         int64_t getLastSequence();
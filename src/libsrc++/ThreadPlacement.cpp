@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2026, Jefferson Science Associates
+//
+// Thomas Jefferson National Accelerator Facility
+// EPSCI Group
+//
+// 12000, Jefferson Ave, Newport News, VA 23606
+// Phone : (757)-269-7100
+//
+
+
+#include "ThreadPlacement.h"
+#include "EvioException.h"
+
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/mempolicy.h>
+#endif
+
+
+namespace evio {
+
+
+    /** Largest number of NUMA nodes handled in a node mask. */
+    static const int MAX_NODES = 1024;
+
+
+    /**
+     * Parse a list of CPUs, or of NUMA nodes, in the form used by Linux
+     * (taskset -c, /sys/devices/system/node/node0/cpulist), for example "0-3,8,10-11".
+     * @param list comma separated list of numbers and ranges of numbers.
+     * @return sorted numbers in the list, each only once.
+     * @throws EvioException if list is badly formatted.
+     */
+    std::vector<int> ThreadPlacement::parseCpuList(std::string const & list) {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string item;
+
+        while (std::getline(ss, item, ',')) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+            if (item.empty()) continue;
+
+            try {
+                size_t dash = item.find('-');
+                int first = std::stoi(item.substr(0, dash));
+                int last  = (dash == std::string::npos) ? first : std::stoi(item.substr(dash + 1));
+                if (first < 0 || last < first) {
+                    throw EvioException("");
+                }
+                for (int i = first; i <= last; i++) {
+                    cpus.push_back(i);
+                }
+            }
+            catch (std::exception & e) {
+                throw EvioException("bad cpu list: " + list);
+            }
+        }
+
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+
+    /**
+     * Get the number of NUMA nodes of this machine.
+     * @return number of NUMA nodes, 1 if not known.
+     */
+    uint32_t ThreadPlacement::getNumaNodeCount() {
+#ifdef __linux__
+        std::ifstream in("/sys/devices/system/node/possible");
+        std::string list;
+        if (in >> list) {
+            try {
+                auto nodes = parseCpuList(list);
+                if (!nodes.empty()) return nodes.back() + 1;
+            }
+            catch (EvioException & e) {}
+        }
+#endif
+        return 1;
+    }
+
+
+    /**
+     * Get the CPUs of a NUMA node.
+     * @param node NUMA node.
+     * @return CPUs of node, empty if not known.
+     */
+    std::vector<int> ThreadPlacement::getNodeCpus(int node) {
+#ifdef __linux__
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (in >> list) {
+            try {
+                return parseCpuList(list);
+            }
+            catch (EvioException & e) {}
+        }
+#endif
+        return std::vector<int>();
+    }
+
+
+    /**
+     * Get the NUMA nodes the given CPUs belong to.
+     * @param cpus CPUs.
+     * @return sorted NUMA nodes, each only once, empty if not known.
+     */
+    std::vector<int> ThreadPlacement::getNumaNodes(std::vector<int> const & cpus) {
+        std::vector<int> nodes;
+#ifdef __linux__
+        for (int cpu : cpus) {
+            // The directory of each cpu contains a link named for its node
+            std::string dirName = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+            DIR *dir = opendir(dirName.c_str());
+            if (dir == nullptr) continue;
+
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr) {
+                std::string name(entry->d_name);
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                    std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                    nodes.push_back(std::stoi(name.substr(4)));
+                    break;
+                }
+            }
+            closedir(dir);
+        }
+
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+#endif
+        return nodes;
+    }
+
+
+    /**
+     * Allow a thread to run only on the given CPUs.
+     * Works on a thread which is already running.
+     * @param thd  thread to pin.
+     * @param cpus CPUs to run on. If empty, nothing is done.
+     * @return true if thread was pinned, false if not running, cpus is empty,
+     *         a CPU does not exist, or not supported.
+     */
+    bool ThreadPlacement::pinThread(boost::thread & thd, std::vector<int> const & cpus) {
+#ifdef __linux__
+        if (cpus.empty() || !thd.joinable()) return false;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+            CPU_SET(cpu, &set);
+        }
+
+        return pthread_setaffinity_np(thd.native_handle(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+
+    /**
+     * Place the memory of the given range on the given NUMA nodes.
+     * Pages already used are moved, later ones are allocated there.
+     * Only whole pages inside the range are placed, so memory next to it is left alone.
+     * @param addr  start of memory.
+     * @param bytes number of bytes.
+     * @param nodes NUMA nodes to place memory on. If empty, nothing is done.
+     * @return true if memory was placed, false if nodes is empty, range has no whole page,
+     *         a node does not exist, or not supported.
+     */
+    bool ThreadPlacement::bindMemory(void *addr, size_t bytes, std::vector<int> const & nodes) {
+#ifdef __linux__
+        if (nodes.empty() || addr == nullptr) return false;
+
+        static const size_t pageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t start = ((uintptr_t)addr + pageSize - 1) & ~(pageSize - 1);
+        uintptr_t end   = ((uintptr_t)addr + bytes) & ~(pageSize - 1);
+        if (end <= start) return false;
+
+        const int bitsPerWord = 8*sizeof(unsigned long);
+        unsigned long mask[MAX_NODES/bitsPerWord] = {};
+        for (int node : nodes) {
+            if (node < 0 || node >= MAX_NODES) return false;
+            mask[node/bitsPerWord] |= 1UL << (node % bitsPerWord);
+        }
+
+        // Kernel reads one bit less than maxnode
+        long err = syscall(SYS_mbind, (void *)start, end - start, MPOL_BIND,
+                           mask, MAX_NODES + 1, MPOL_MF_MOVE);
+        return err == 0;
+#else
+        return false;
+#endif
+    }
+
+
+    /**
+     * Place the memory of a buffer's backing array on the given NUMA nodes.
+     * If the buffer is later expanded, its new array is not placed.
+     * @param buf   buffer.
+     * @param nodes NUMA nodes to place memory on.
+     * @return true if memory was placed, else false.
+     * @see #bindMemory(void *, size_t, std::vector<int> const &)
+     */
+    bool ThreadPlacement::bindBuffer(std::shared_ptr<ByteBuffer> const & buf, std::vector<int> const & nodes) {
+        if (buf == nullptr) return false;
+        return bindMemory(buf->array() + buf->arrayOffset(), buf->capacity(), nodes);
+    }
+
+}
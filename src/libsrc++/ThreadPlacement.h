@@ -0,0 +1,62 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+#ifndef EVIO_6_0_THREADPLACEMENT_H
+#define EVIO_6_0_THREADPLACEMENT_H
+
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+
+#include "ByteBuffer.h"
+#include <boost/thread.hpp>
+
+
+namespace evio {
+
+
+    /**
+     * Class of static methods to place the threads of a writer on chosen CPUs and
+     * its record buffers in the memory of the matching NUMA nodes.
+     * On multi-socket machines, threads otherwise migrate across sockets and end up
+     * working on memory attached to another socket.<p>
+     *
+     * Threads are pinned with pthread_setaffinity_np. Memory is placed with the mbind
+     * system call, which also moves pages already touched, so libnuma is not needed.
+     * CPUs and NUMA nodes are found in /sys/devices/system.
+     * All of this only works on Linux. Elsewhere, methods do nothing and return false
+     * or empty results.
+     *
+     * @date 10/16/2026
+     * @author timmer
+     */
+    class ThreadPlacement {
+
+    public:
+
+        static std::vector<int> parseCpuList(std::string const & list);
+
+        static uint32_t getNumaNodeCount();
+        static std::vector<int> getNodeCpus(int node);
+        static std::vector<int> getNumaNodes(std::vector<int> const & cpus);
+
+        static bool pinThread(boost::thread & thd, std::vector<int> const & cpus);
+
+        static bool bindMemory(void *addr, size_t bytes, std::vector<int> const & nodes);
+        static bool bindBuffer(std::shared_ptr<ByteBuffer> const & buf, std::vector<int> const & nodes);
+    };
+
+}
+
+#endif //EVIO_6_0_THREADPLACEMENT_H
@@ -74,7 +74,7 @@ namespace evio {
      * @param firstEvent      byte array containing an evio event to be included in userHeader.
      *                        It must be in the same byte order as the order argument.
      * @param firstEventLen   number of bytes in firstEvent.
-     * @param compType        type of data compression to do (one, lz4 fast, lz4 best, gzip)
+     * @param compType        type of data compression to do (none, lz4 fast, lz4 best, gzip, zstd)
      * @param addTrailerIndex if true, we add a record index to the trailer.
      */
     Writer::Writer(const HeaderType & hType, const ByteOrder & order,
@@ -89,6 +89,9 @@ namespace evio {
             firstEventLen = 0;
         }
         firstEventLength = firstEventLen;
+        if (!Compressor::isSupported(compType)) {
+            throw EvioException("compression type " + std::to_string(compType) + " not compiled in");
+        }
         compressionType = compType;
         this->addTrailerIndex = addTrailerIndex;
 
@@ -386,8 +389,12 @@ namespace evio {
      * When writing to the file, record data will be compressed
      * according to the given type.
      * @param compression compression type
+     * @throws EvioException if compression type is not compiled in.
      */
     void Writer::setCompressionType(Compressor::CompressionType compression) {
+        if (!Compressor::isSupported(compression)) {
+            throw EvioException("compression type " + std::to_string(compression) + " not compiled in");
+        }
         if (toFile) {
             compressionType = compression;
             outputRecord->getHeader()->setCompressionType(compression);
@@ -641,7 +648,7 @@ namespace evio {
     /**
      * STATIC.
      * Create a buffer representation of a record
-     * containing dictionary and/or first event.
+     * containing dictionary, first event, and/or compression dictionary, in that order.
      * No compression.
      *
      * @param dict      dictionary xml string
@@ -650,20 +657,22 @@ namespace evio {
      * @param order     byte order of returned byte array
      * @param fileHdr   file header to update with dictionary/first-event info (may be null).
      * @param recordHdr record header to update with dictionary info (may be null).
-     * @return buffer representation of record containing dictionary and/or first event.
-     *         Null pointer if both are empty/null.
+     * @param compressionDict dictionary used to compress records (may be null).
+     * @return buffer representation of record containing dictionary, first event,
+     *         and/or compression dictionary. Null pointer if all are empty/null.
      */
     std::shared_ptr<ByteBuffer> Writer::createRecord(const std::string & dict, uint8_t* firstEv, uint32_t firstEvLen,
                                                      const ByteOrder & order, FileHeader* fileHdr,
-                                                     RecordHeader* recordHdr) {
+                                                     RecordHeader* recordHdr,
+                                                     CompressionDictionary const * compressionDict) {
 
-        if (dict.empty() && firstEv == nullptr) {
+        if (dict.empty() && firstEv == nullptr && compressionDict == nullptr) {
             return nullptr;
         }
 
         // Create record.
         // Bit of chicken&egg problem, so start with default internal buf size.
-        RecordOutput record(order, 2, 0, Compressor::UNCOMPRESSED);
+        RecordOutput record(order, 3, 0, Compressor::UNCOMPRESSED);
 
         // How much data we got?
         size_t bytes=0;
@@ -677,9 +686,13 @@ namespace evio {
             bytes += firstEvLen;
         }
 
+        if (compressionDict != nullptr) {
+            bytes += compressionDict->getSize();
+        }
+
         // If we have huge dictionary/first event ...
         if (bytes > record.getInternalBufferCapacity()) {
-            record = RecordOutput(order, 2, bytes, Compressor::UNCOMPRESSED);
+            record = RecordOutput(order, 3, bytes, Compressor::UNCOMPRESSED);
         }
 
         // Add dictionary to record
@@ -699,6 +712,12 @@ namespace evio {
             //if (recordHdr != nullptr) recordHdr->hasFirstEvent(true);
         }
 
+        // Compression dictionary goes in file header only
+        if (compressionDict != nullptr) {
+            record.addEvent(compressionDict->getData(), compressionDict->getSize(), 0);
+            if (fileHdr   != nullptr)   fileHdr->hasCompressionDictionary(true);
+        }
+
         // Make events into record. Pos = 0, limit = # valid bytes.
         record.build();
 
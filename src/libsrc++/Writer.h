@@ -198,7 +198,8 @@ namespace evio {
                                                         uint8_t* firstEvent, uint32_t firstEventLen,
                                                         const ByteOrder & byteOrder,
                                                         FileHeader* fileHeader,
-                                                        RecordHeader* recordHeader);
+                                                        RecordHeader* recordHeader,
+                                                        CompressionDictionary const * compressionDict = nullptr);
 
         std::shared_ptr<ByteBuffer> createHeader(uint8_t* userHdr, uint32_t userLen);
         std::shared_ptr<ByteBuffer> createHeader(ByteBuffer & userHdr);
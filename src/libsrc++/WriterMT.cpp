@@ -37,7 +37,7 @@ namespace evio {
      *                      Value of O means use default (1M).
      * @param maxBufferSize max number of uncompressed data bytes a record can hold.
      *                      Value of < 8MB results in default of 8MB.
-     * @param compType      type of data compression to do (one, lz4 fast, lz4 best, gzip).
+     * @param compType      type of data compression to do (none, lz4 fast, lz4 best, gzip, zstd).
      * @param compressionThreads number of threads doing compression simultaneously.
      */
     WriterMT::WriterMT(const ByteOrder & order, uint32_t maxEventCount, uint32_t maxBufferSize,
@@ -62,17 +62,20 @@ namespace evio {
      * @param firstEvent    byte array containing an evio event to be included in userHeader.
      *                      It must be in the same byte order as the order argument.
      * @param firstEventLen number of valid bytes in firstEvent.
-     * @param compType      type of data compression to do (one, lz4 fast, lz4 best, gzip)
+     * @param compType      type of data compression to do (none, lz4 fast, lz4 best, gzip, zstd)
      * @param compressionThreads number of threads doing compression simultaneously
      * @param addTrailerIndex if true, we add a record index to the trailer.
      * @param ringSize      number of records in supply ring, must be multiple of 2
      *                      and >= compressionThreads.
+     * @param waitStrategy  how compression and writing threads wait for records: blocking uses
+     *                      the least CPU, busy-spin the least latency.
      */
     WriterMT::WriterMT(const HeaderType & hType, const ByteOrder & order,
                        uint32_t maxEventCount, uint32_t maxBufferSize,
                        const std::string & dictionary, uint8_t* firstEvent, uint32_t firstEventLen,
                        Compressor::CompressionType compType, uint32_t compressionThreads,
-                       bool addTrailerIndex, uint32_t ringSize) {
+                       bool addTrailerIndex, uint32_t ringSize,
+                       RecordSupply::WaitStrategy waitStrategy) {
 
         byteOrder = order;
         this->dictionary = dictionary;
@@ -85,6 +88,9 @@ namespace evio {
         this->maxBufferSize = maxBufferSize;
         this->addTrailerIndex = addTrailerIndex;
 
+        if (!Compressor::isSupported(compType)) {
+            throw EvioException("compression type " + std::to_string(compType) + " not compiled in");
+        }
         compressionType = compType;
         compressionThreadCount = compressionThreads;
 
@@ -120,7 +126,11 @@ namespace evio {
         supply = std::make_shared<RecordSupply>(finalRingSize, byteOrder,
                                                 compressionThreads,
                                                 maxEventCount, maxBufferSize,
-                                                compressionType);
+                                                compressionType, waitStrategy);
+
+        // Records are written to file before being reused, so uncompressed
+        // events can be written from where they were added
+        supply->setVectoredWrite(true);
 
         // Get a single blank record to start writing into
         ringItem = supply->get();
@@ -152,7 +162,7 @@ namespace evio {
      *                      Value of O means use default (1M).
      * @param maxBufferSize max number of uncompressed data bytes a record can hold.
      *                      Value of < 8MB results in default of 8MB.
-     * @param compType      type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip)
+     * @param compType      type of data compression to do (0=none, 1=lz4 fast, 2=lz4 best, 3=gzip, 4=zstd)
      * @param compressionThreads number of threads doing compression simultaneously
      */
     WriterMT::WriterMT(const std::string & filename, const ByteOrder & order, uint32_t maxEventCount, uint32_t maxBufferSize,
@@ -244,6 +254,256 @@ namespace evio {
     }
 
 
+    /**
+     * Set the dictionary with which to compress records. Records holding many small,
+     * similar events compress much better with one. It's only used for LZ4 and zstd
+     * compression and is ignored otherwise. The dictionary is stored in the file header's
+     * user header, after any xml dictionary and first event. A {@link Reader} loads it
+     * automatically. It cannot be used along with a user header given to
+     * {@link #open(const std::string &, uint8_t*, uint32_t, bool)}.
+     *
+     * @param dict dictionary with which to compress records.
+     * @throws EvioException if open() was already called;
+     *                       if a compression dictionary was already set or is being trained.
+     */
+    void WriterMT::setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        if (opened) {
+            throw EvioException("compression dictionary must be set before open()");
+        }
+
+        if (compressionDictionary != nullptr || trainingEventCount > 0) {
+            throw EvioException("compression dictionary already set");
+        }
+
+        useCompressionDictionary(dict);
+    }
+
+
+    /**
+     * Train a dictionary with which to compress records from the first events added,
+     * then compress all records with it, including those holding the training events.
+     * Those events are held back, as is writing the file header, until the given number
+     * of them is reached or until {@link #close()} or {@link #writeRecord} is called.
+     * See {@link #setCompressionDictionary} for more details.
+     * Only useful for LZ4 and zstd compression and is ignored otherwise.
+     *
+     * @param eventCount number of events to train with. Hundreds or more work best.
+     *                   0 means do not train.
+     * @param dictBytes  max size of dictionary in bytes.
+     * @throws EvioException if open() was already called;
+     *                       if a compression dictionary was already set or is being trained.
+     */
+    void WriterMT::trainCompressionDictionary(uint32_t eventCount, uint32_t dictBytes) {
+        if (opened) {
+            throw EvioException("compression dictionary must be trained before open()");
+        }
+
+        if (compressionDictionary != nullptr || trainingEventCount > 0) {
+            throw EvioException("compression dictionary already set");
+        }
+
+        if (compressionType == Compressor::UNCOMPRESSED ||
+            compressionType == Compressor::GZIP) {
+            return;
+        }
+
+        trainingEventCount = eventCount;
+        trainingDictionaryBytes = dictBytes;
+    }
+
+
+    /**
+     * Get the dictionary records are compressed with.
+     * @return dictionary records are compressed with, null if none (yet).
+     */
+    std::shared_ptr<CompressionDictionary> WriterMT::getCompressionDictionary() const {
+        return compressionDictionary;
+    }
+
+
+    /**
+     * Choose the type of compression for each record, instead of always using the
+     * type given in the constructor, so that records are as small as possible while
+     * compression keeps up with the given rate. Data which does not compress well,
+     * such as random ADC noise, is left uncompressed. Since each record header holds
+     * its own compression type, any reader handles the resulting mix of types.
+     * See {@link AdaptiveCompression}.
+     *
+     * @param targetMBps rate in MB/s of uncompressed data which all compression threads
+     *                   together must keep up with. 0 to stop adaptive compression.
+     * @param types      compression types to choose from, besides no compression.
+     *                   If empty, LZ4, LZ4 best and, if available, zstd.
+     * @throws EvioException if open() was already called; if targetMBps < 0.
+     */
+    void WriterMT::setAdaptiveCompression(double targetMBps,
+                                          std::vector<Compressor::CompressionType> types) {
+        if (opened) {
+            throw EvioException("adaptive compression must be set before open()");
+        }
+
+        if (targetMBps < 0.) {
+            throw EvioException("target rate must be >= 0");
+        }
+
+        adaptiveCompression = nullptr;
+        if (targetMBps > 0.) {
+            // Each compression thread must keep up with its share
+            adaptiveCompression = std::make_shared<AdaptiveCompression>(targetMBps / compressionThreadCount,
+                                                                        types);
+        }
+        supply->setAdaptiveCompression(adaptiveCompression);
+    }
+
+
+    /**
+     * Get the object choosing the type of compression for each record,
+     * which also holds the ratio and rate achieved by each type.
+     * @return object choosing the type of compression for each record, null if none.
+     */
+    std::shared_ptr<AdaptiveCompression> WriterMT::getAdaptiveCompression() const {
+        return adaptiveCompression;
+    }
+
+
+    /**
+     * Filter the data of each compressed record before compressing it, which helps
+     * compress arrays of 32 or 64 bit integers. Byte shuffle groups the bytes of equal
+     * significance of all words together; delta encoding stores the differences between
+     * successive words. The filter is recorded in each record header and undone when
+     * reading. Uncompressed records are not filtered. See {@link DataFilter}.
+     * Since older versions of evio cannot undo the filter, only use it if all readers
+     * of the data are this version or later.<p>
+     *
+     * Must be called before {@link #open}.
+     *
+     * @param type     type of filter.
+     * @param wordSize size in bytes of the words filtered, 4 or 8.
+     * @throws EvioException if open() was already called;
+     *                       if wordSize is not 4 or 8.
+     */
+    void WriterMT::setDataFilter(DataFilter::FilterType type, uint32_t wordSize) {
+        if (opened) {
+            throw EvioException("data filter must be set before open()");
+        }
+        supply->setDataFilter(type, wordSize);
+    }
+
+
+    /**
+     * Write the file with direct I/O (O_DIRECT), bypassing the kernel's page cache,
+     * which avoids writeback stalls and keeps other programs' data cached at high rates.
+     * Records are gathered in an aligned buffer and written in whole blocks,
+     * and the file header is updated in place at close. See {@link DirectFile}.
+     * If the file system cannot do direct I/O, the file is written normally.
+     *
+     * @param direct true to write with direct I/O.
+     * @throws EvioException if called after open().
+     */
+    void WriterMT::setDirectIO(bool direct) {
+        if (opened) {
+            throw EvioException("direct I/O must be set before open()");
+        }
+        directIO = direct;
+    }
+
+
+    /**
+     * Is the file written with direct I/O?
+     * @return true if the file is written with direct I/O.
+     */
+    bool WriterMT::isDirectIO() const {return directIO;}
+
+
+    /**
+     * Pin the compression threads and the writing thread to the given CPUs, and place
+     * the memory of records on the NUMA nodes of the compression threads' CPUs
+     * (of the writing thread's CPUs if compCpus is empty). On machines with
+     * several sockets, this keeps the threads from migrating between sockets and
+     * working on memory attached to another one. All compression threads share the CPU set.
+     * See {@link ThreadPlacement} for finding CPUs.<p>
+     *
+     * Must be called before {@link #open}, since records cannot be moved
+     * while compression threads are using them.
+     * Only works on Linux, elsewhere this does nothing.
+     *
+     * @param compCpus  CPUs the compression threads may run on, empty for any.
+     * @param writeCpus CPUs the writing thread may run on, empty for any.
+     * @throws EvioException if called after open().
+     */
+    void WriterMT::setThreadPlacement(std::vector<int> const & compCpus, std::vector<int> const & writeCpus) {
+        if (opened) {
+            throw EvioException("thread placement must be set before open()");
+        }
+
+        // Threads are created and pinned in open()
+        compressorCpus = compCpus;
+        writerCpus = writeCpus;
+
+        supply->setNumaNodes(ThreadPlacement::getNumaNodes(compressorCpus.empty() ? writerCpus : compressorCpus));
+    }
+
+
+    /**
+     * Compress all records with the given dictionary from now on
+     * and place it in the record which becomes the file header's user header.
+     * Ignored unless using LZ4 or zstd compression.
+     * @param dict dictionary with which to compress records.
+     */
+    void WriterMT::useCompressionDictionary(std::shared_ptr<CompressionDictionary> dict) {
+        if (dict == nullptr ||
+            compressionType == Compressor::UNCOMPRESSED ||
+            compressionType == Compressor::GZIP) {
+            return;
+        }
+
+        compressionDictionary = dict;
+        supply->setCompressionDictionary(dict);
+        dictionaryFirstEventBuffer = createDictionaryRecord();
+    }
+
+
+    /**
+     * Hold back an event, added while training a compression dictionary, as a training sample.
+     * Once enough are held, train the dictionary and write them all.
+     * @param event  event data.
+     * @param length event length in bytes.
+     */
+    void WriterMT::addTrainingEvent(const uint8_t *event, uint32_t length) {
+        trainingEvents.emplace_back(event, event + length);
+
+        if (trainingEvents.size() >= trainingEventCount) {
+            finishTraining();
+        }
+    }
+
+
+    /**
+     * If training a compression dictionary, train it with the events held back,
+     * start compressing with it, write the file header, and add those events.
+     * If training fails (no data), records are compressed without dictionary.
+     */
+    void WriterMT::finishTraining() {
+        if (trainingEventCount == 0) {
+            return;
+        }
+
+        trainingEventCount = 0;
+        std::vector<std::vector<uint8_t>> events = std::move(trainingEvents);
+        trainingEvents.clear();
+
+        useCompressionDictionary(CompressionDictionary::train(events, trainingDictionaryBytes));
+
+        // No records have been written yet, so the file header still goes first
+        if (opened) {
+            writeFileHeader(nullptr, 0);
+        }
+
+        for (auto const & event : events) {
+            addEvent(const_cast<uint8_t *>(event.data()), 0, event.size());
+        }
+    }
+
+
     /** Called by open(), needed if open called multiple times in succession. */
     void WriterMT::clear() {
         // outputRecord belongs to ringItem which is taken from supply and is put back in close()
@@ -296,32 +556,14 @@ namespace evio {
             throw EvioException("bad filename");
         }
 
-        clear();
-
-        std::shared_ptr<ByteBuffer> fileHeaderBuffer;
-        haveUserHeader = false;
-
         // User header given as arg has precedent
-        if (userHdr != nullptr) {
-            haveUserHeader = true;
-//std::cout << "writerMT::open: given a valid user header to write" << std::endl;
-            fileHeaderBuffer = createHeader(userHdr, userLen);
-        }
-        else {
-            // If dictionary & firstEvent not defined and user header not given ...
-            if (dictionaryFirstEventBuffer == nullptr ||
-                dictionaryFirstEventBuffer->remaining() < 1) {
-//std::cout << "writerMT::open: given a null user header to write, userLen = " << userLen <<  std::endl;
-                fileHeaderBuffer = createHeader(nullptr, 0);
-            }
-            // else place dictionary and/or firstEvent into
-            // record which becomes user header
-            else {
-//std::cout << "writerMT::open: given a valid dict/first ev header to write" << std::endl;
-                fileHeaderBuffer = createHeader(*(dictionaryFirstEventBuffer.get()));
-            }
+        haveUserHeader = (userHdr != nullptr);
+        if (haveUserHeader && (compressionDictionary != nullptr || trainingEventCount > 0)) {
+            throw EvioException("compression dictionary cannot be stored with a user header");
         }
 
+        clear();
+
         // Write this to file
         fileName = filename;
         if (!overwrite) {
@@ -332,18 +574,29 @@ namespace evio {
             }
         }
 
-        outFile.open(filename, std::ios::binary);
-        outFile.write(reinterpret_cast<const char*>(fileHeaderBuffer->array()), fileHeaderBuffer->remaining());
+        if (directIO) {
+            directFile = std::make_shared<DirectFile>();
+            directFile->open(filename);
+        }
+        else {
+            outFile.open(filename, std::ios::binary);
+        }
+
+        // When training a compression dictionary, the file header,
+        // which holds it, is written once training is done
+        if (trainingEventCount == 0) {
+            writeFileHeader(userHdr, userLen);
+        }
+
         if (outFile.fail()) {
             throw EvioException("error opening file " + filename);
         }
 
-        writerBytesWritten = (size_t) (fileHeader.getLength());
-
         // Create compression threads
         recordCompressorThreads.reserve(compressionThreadCount);
         for (uint32_t i=0; i < compressionThreadCount; i++) {
             recordCompressorThreads.emplace_back(i, compressionType, supply);
+            recordCompressorThreads[i].setCpus(compressorCpus);
         }
 
         // Start compression threads
@@ -353,6 +606,7 @@ namespace evio {
 
         // Create & start writing thread
         recordWriterThreads.emplace_back(this,supply);
+        recordWriterThreads[0].setCpus(writerCpus);
         recordWriterThreads[0].startThread();
 
         opened = true;
@@ -368,7 +622,49 @@ namespace evio {
      */
     std::shared_ptr<ByteBuffer> WriterMT::createDictionaryRecord() {
         return Writer::createRecord(dictionary, firstEvent, firstEventLength,
-                                    byteOrder, &fileHeader, nullptr);
+                                    byteOrder, &fileHeader, nullptr,
+                                    compressionDictionary.get());
+    }
+
+
+    /**
+     * Write the file header, followed by the given user header or, if there is none,
+     * by the record containing any dictionary, first event, and compression dictionary.
+     * Must be the first thing written to the file.
+     *
+     * @param userHdr byte array containing a user-defined header, may be null.
+     * @param userLen array length in bytes.
+     */
+    void WriterMT::writeFileHeader(uint8_t* userHdr, uint32_t userLen) {
+
+        std::shared_ptr<ByteBuffer> fileHeaderBuffer;
+
+        if (userHdr != nullptr) {
+//std::cout << "writerMT::open: given a valid user header to write" << std::endl;
+            fileHeaderBuffer = createHeader(userHdr, userLen);
+        }
+        else {
+            // If dictionary & firstEvent not defined and user header not given ...
+            if (dictionaryFirstEventBuffer == nullptr ||
+                dictionaryFirstEventBuffer->remaining() < 1) {
+//std::cout << "writerMT::open: given a null user header to write, userLen = " << userLen <<  std::endl;
+                fileHeaderBuffer = createHeader(nullptr, 0);
+            }
+            // else place dictionary and/or firstEvent into
+            // record which becomes user header
+            else {
+//std::cout << "writerMT::open: given a valid dict/first ev header to write" << std::endl;
+                fileHeaderBuffer = createHeader(*(dictionaryFirstEventBuffer.get()));
+            }
+        }
+
+        if (directFile != nullptr) {
+            directFile->write(fileHeaderBuffer->array(), fileHeaderBuffer->remaining());
+        }
+        else {
+            outFile.write(reinterpret_cast<const char*>(fileHeaderBuffer->array()), fileHeaderBuffer->remaining());
+        }
+        writerBytesWritten = (size_t) (fileHeader.getLength());
     }
 
 
@@ -396,6 +692,7 @@ namespace evio {
         }
         else {
             fileHeader.setBitInfo(haveFirstEvent, haveDictionary, addTrailerIndex);
+            fileHeader.hasCompressionDictionary(compressionDictionary != nullptr);
         }
         fileHeader.setUserHeaderLength(userHeaderBytes);
 
@@ -441,6 +738,7 @@ namespace evio {
         }
         else {
             fileHeader.setBitInfo(haveFirstEvent, haveDictionary, addTrailerIndex);
+            fileHeader.hasCompressionDictionary(compressionDictionary != nullptr);
         }
         fileHeader.setUserHeaderLength(userHeaderBytes);
 
@@ -487,7 +785,12 @@ namespace evio {
             RecordHeader::writeTrailer(headerArray, 0, recordNum, byteOrder, nullptr);
 
             writerBytesWritten += RecordHeader::HEADER_SIZE_BYTES;
-            outFile.write(reinterpret_cast<const char *>(&headerArray[0]), RecordHeader::HEADER_SIZE_BYTES);
+            if (directFile != nullptr) {
+                directFile->write(&headerArray[0], RecordHeader::HEADER_SIZE_BYTES);
+            }
+            else {
+                outFile.write(reinterpret_cast<const char *>(&headerArray[0]), RecordHeader::HEADER_SIZE_BYTES);
+            }
             if (outFile.fail()) {
                 throw EvioException("error writing file " + fileName);
             }
@@ -508,31 +811,40 @@ namespace evio {
             RecordHeader::writeTrailer(headerArray, 0, recordNum, byteOrder, recordLengths);
 
             writerBytesWritten += dataBytes;
-            outFile.write(reinterpret_cast<const char *>(&headerArray[0]), dataBytes);
+            if (directFile != nullptr) {
+                directFile->write(&headerArray[0], dataBytes);
+            }
+            else {
+                outFile.write(reinterpret_cast<const char *>(&headerArray[0]), dataBytes);
+            }
             if (outFile.fail()) {
                 throw EvioException("error opening file " + fileName);
             }
         }
 
         // Find & update file header's trailer position word
-        outFile.seekp(FileHeader::TRAILER_POSITION_OFFSET);
         if (byteOrder != ByteOrder::ENDIAN_LOCAL) {
-            uint64_t pos = SWAP_64(trailerPosition);
-            outFile.write(reinterpret_cast<const char *>(&pos), sizeof(uint64_t));
+            trailerPosition = SWAP_64(trailerPosition);
+        }
+        if (directFile != nullptr) {
+            directFile->writeAt(FileHeader::TRAILER_POSITION_OFFSET, &trailerPosition, sizeof(uint64_t));
         }
         else {
+            outFile.seekp(FileHeader::TRAILER_POSITION_OFFSET);
             outFile.write(reinterpret_cast<const char *>(&trailerPosition), sizeof(uint64_t));
         }
 
         // Find & update file header's bit-info word
         if (writeIndex && addTrailerIndex) {
-            outFile.seekp(RecordHeader::BIT_INFO_OFFSET);
-            int bitInfo = fileHeader.hasTrailerWithIndex(true);
+            uint32_t bitInfo = fileHeader.hasTrailerWithIndex(true);
             if (byteOrder != ByteOrder::ENDIAN_LOCAL) {
-                uint32_t bitSwap = SWAP_32(bitInfo);
-                outFile.write(reinterpret_cast<const char *>(&bitSwap), sizeof(uint32_t));
+                bitInfo = SWAP_32(bitInfo);
+            }
+            if (directFile != nullptr) {
+                directFile->writeAt(RecordHeader::BIT_INFO_OFFSET, &bitInfo, sizeof(uint32_t));
             }
             else {
+                outFile.seekp(RecordHeader::BIT_INFO_OFFSET);
                 outFile.write(reinterpret_cast<const char *>(&bitInfo), sizeof(uint32_t));
             }
         }
@@ -551,6 +863,9 @@ namespace evio {
             throw EvioException("record byte order is wrong");
         }
 
+        // Records must follow any events held back for training
+        finishTraining();
+
         // If we have already written stuff into our current internal record ...
         if (outputRecord->getEventCount() > 0) {
             // Put it back in supply for compressing
@@ -588,6 +903,11 @@ namespace evio {
      * @param length number of bytes to write from array.
      */
     void WriterMT::addEvent(uint8_t *buffer, uint32_t offset, uint32_t length) {
+        if (trainingEventCount > 0) {
+            addTrainingEvent(buffer + offset, length);
+            return;
+        }
+
         // Try putting data into current record being filled
         bool status = outputRecord->addEvent(buffer, offset, length);
 
@@ -626,6 +946,11 @@ namespace evio {
             throw EvioException("buffer arg byte order is wrong");
         }
 
+        if (trainingEventCount > 0) {
+            addTrainingEvent(buffer->array() + buffer->arrayOffset() + buffer->position(), buffer->remaining());
+            return;
+        }
+
         bool status = outputRecord->addEvent(buffer);
 
         // If record is full ...
@@ -663,6 +988,11 @@ namespace evio {
             throw EvioException("buffer arg byte order is wrong");
         }
 
+        if (trainingEventCount > 0) {
+            addTrainingEvent(buffer.array() + buffer.arrayOffset() + buffer.position(), buffer.remaining());
+            return;
+        }
+
         bool status = outputRecord->addEvent(buffer);
 
         // If record is full ...
@@ -700,6 +1030,12 @@ namespace evio {
             throw EvioException("buffer arg byte order is wrong");
         }
 
+        if (trainingEventCount > 0) {
+            auto buf = node->getBuffer();
+            addTrainingEvent(buf->array() + buf->arrayOffset() + node->getPosition(), node->getTotalBytes());
+            return;
+        }
+
         bool status = outputRecord->addEvent(node);
 
         // If record is full ...
@@ -731,6 +1067,13 @@ namespace evio {
      */
     void WriterMT::addEvent(std::shared_ptr<EvioBank> bank) {
 
+        if (trainingEventCount > 0) {
+            std::vector<uint8_t> event(bank->getTotalBytes());
+            bank->write(event.data(), byteOrder);
+            addTrainingEvent(event.data(), event.size());
+            return;
+        }
+
         bool status = outputRecord->addEvent(bank);
 
         // If record is full ...
@@ -762,6 +1105,9 @@ namespace evio {
     void WriterMT::close() {
         if (closed) return;
 
+        // Write any events held back for training
+        finishTraining();
+
         // If we're in the middle of building a record, send it off since we're done
         if (outputRecord->getEventCount() > 0) {
             // Put it in queue for compressing
@@ -794,12 +1140,19 @@ namespace evio {
             }
 
             // Need to update the record count in file header
-            outFile.seekp(FileHeader::RECORD_COUNT_OFFSET);
             if (byteOrder != ByteOrder::ENDIAN_LOCAL) {
                 recordCount = SWAP_32(recordCount);
             }
-            outFile.write(reinterpret_cast<const char *>(&recordCount), sizeof(uint32_t));
-            outFile.close();
+            if (directFile != nullptr) {
+                directFile->writeAt(FileHeader::RECORD_COUNT_OFFSET, &recordCount, sizeof(uint32_t));
+                directFile->close();
+                directFile = nullptr;
+            }
+            else {
+                outFile.seekp(FileHeader::RECORD_COUNT_OFFSET);
+                outFile.write(reinterpret_cast<const char *>(&recordCount), sizeof(uint32_t));
+                outFile.close();
+            }
             recordLengths->clear();
         }
         catch (EvioException & ex) {
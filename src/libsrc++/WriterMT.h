@@ -35,6 +35,7 @@
 #include "RecordCompressor.h"
 #include "Util.h"
 #include "EvioException.h"
+#include "DirectFile.h"
 
 
 #include "Disruptor/Util.h"
@@ -82,6 +83,8 @@ namespace evio {
             std::shared_ptr<RecordSupply> supply;
             /** Thread which does the file writing. */
             boost::thread thd;
+            /** CPUs the thread may run on, empty for any. */
+            std::vector<int> cpus;
             /** The highest sequence to have been currently processed. */
             std::atomic_long lastSeqProcessed{-1};
 
@@ -103,7 +106,8 @@ namespace evio {
             RecordWriter(RecordWriter && obj) noexcept :
                     writer(obj.writer),
                     supply(std::move(obj.supply)),
-                    thd(std::move(obj.thd)) {
+                    thd(std::move(obj.thd)),
+                    cpus(std::move(obj.cpus)) {
 
                 lastSeqProcessed.store(obj.lastSeqProcessed);
             }
@@ -114,6 +118,7 @@ namespace evio {
                     lastSeqProcessed.store(obj.lastSeqProcessed);
                     supply = std::move(obj.supply);
                     thd  = std::move(obj.thd);
+                    cpus = std::move(obj.cpus);
                 }
                 return *this;
             }
@@ -128,9 +133,20 @@ namespace evio {
                 }
             }
 
+            /**
+             * Set the CPUs the thread may run on. If it's already running, it's pinned now,
+             * else when started.
+             * @param cpuSet CPUs to run on, empty for any.
+             */
+            void setCpus(std::vector<int> const & cpuSet) {
+                cpus = cpuSet;
+                ThreadPlacement::pinThread(thd, cpus);
+            }
+
             /** Create and start a thread to execute the run() method of this class. */
             void startThread() {
                 thd = boost::thread([this]() {this->run();});
+                ThreadPlacement::pinThread(thd, cpus);
             }
 
             /** Stop the thread. */
@@ -205,10 +221,15 @@ namespace evio {
                             writer->recordLengths->push_back(header->getEntries());
                             writer->writerBytesWritten += bytesToWrite;
 
-                            auto buf = record->getBinaryBuffer();
-//                            std::cout << "   RecordWriter: use outFile to write file, buf pos = " << buf->position() <<
-//                                 ", lim = " << buf->limit() << ", bytesToWrite = " << bytesToWrite << std::endl;
-                            writer->outFile.write(reinterpret_cast<const char *>(buf->array()), bytesToWrite);
+                            // Events of uncompressed records are not in the binary buffer
+                            for (auto const & seg : record->getWriteSegments()) {
+                                if (writer->directFile != nullptr) {
+                                    writer->directFile->write(seg.data, seg.bytes);
+                                }
+                                else {
+                                    writer->outFile.write(reinterpret_cast<const char *>(seg.data), seg.bytes);
+                                }
+                            }
                             if (writer->outFile.fail()) {
                                 throw EvioException("failed write to file");
                             }
@@ -269,15 +290,37 @@ namespace evio {
         /** Object for writing file. */
         std::ofstream outFile;
 
+        /** Write file with direct I/O through directFile instead of outFile? */
+        bool directIO = false;
+
+        /** Object for writing file with direct I/O, null if not used. */
+        std::shared_ptr<DirectFile> directFile;
+
         /** Header to write to file, created in constructor. */
         FileHeader fileHeader;
 
         /** String containing evio-format XML dictionary to store in file header's user header. */
         std::string dictionary;
 
-        /** If dictionary and or firstEvent exist, this buffer contains them both as a record. */
+        /** If dictionary and or firstEvent exist, this buffer contains them both as a record.
+         *  Any compression dictionary follows them. */
         std::shared_ptr<ByteBuffer> dictionaryFirstEventBuffer;
 
+        /** Dictionary records are compressed with, if any. */
+        std::shared_ptr<CompressionDictionary> compressionDictionary;
+
+        /** Number of events to train a compression dictionary with. 0 if not training. */
+        uint32_t trainingEventCount = 0;
+
+        /** Max size in bytes of the compression dictionary to train. */
+        uint32_t trainingDictionaryBytes = CompressionDictionary::DEFAULT_BYTES;
+
+        /** Events held back, while training a compression dictionary, until it's ready. */
+        std::vector<std::vector<uint8_t>> trainingEvents;
+
+        /** Chooses the type of compression for each record, if any. */
+        std::shared_ptr<AdaptiveCompression> adaptiveCompression;
+
         /** Byte order of data to write to file/buffer. */
         ByteOrder byteOrder {ByteOrder::ENDIAN_LOCAL};
 
@@ -304,6 +347,12 @@ namespace evio {
         /** Threads used to compress data. */
         std::vector<RecordCompressor> recordCompressorThreads;
 
+        /** CPUs the compression threads may run on, empty for any. */
+        std::vector<int> compressorCpus;
+
+        /** CPUs the writing thread may run on, empty for any. */
+        std::vector<int> writerCpus;
+
         /** Current ring Item from which current record is taken. */
         std::shared_ptr<RecordRingItem> ringItem;
 
@@ -342,7 +391,8 @@ namespace evio {
                 Compressor::CompressionType compressionType = Compressor::UNCOMPRESSED,
                 uint32_t compressionThreads = 1,
                 bool addTrailerIndex = false,
-                uint32_t ringSize = 16);
+                uint32_t ringSize = 16,
+                RecordSupply::WaitStrategy waitStrategy = RecordSupply::SPIN_BACKOFF);
 
         explicit WriterMT(const std::string & filename);
 
@@ -356,9 +406,14 @@ namespace evio {
     private:
 
         std::shared_ptr<ByteBuffer> createDictionaryRecord();
+        void writeFileHeader(uint8_t* userHdr, uint32_t userLen);
         void writeTrailer(bool writeIndex, uint32_t recordNum);
         void clear();
 
+        void useCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+        void addTrainingEvent(const uint8_t *event, uint32_t length);
+        void finishTraining();
+
     public:
 
         const ByteOrder & getByteOrder() const;
@@ -373,6 +428,21 @@ namespace evio {
         bool addTrailerWithIndex();
         void addTrailerWithIndex(bool addTrailingIndex);
 
+        void setCompressionDictionary(std::shared_ptr<CompressionDictionary> dict);
+        void trainCompressionDictionary(uint32_t eventCount,
+                                        uint32_t dictBytes = CompressionDictionary::DEFAULT_BYTES);
+        std::shared_ptr<CompressionDictionary> getCompressionDictionary() const;
+
+        void setAdaptiveCompression(double targetMBps,
+                                    std::vector<Compressor::CompressionType> types = {});
+        std::shared_ptr<AdaptiveCompression> getAdaptiveCompression() const;
+
+        void setDataFilter(DataFilter::FilterType type, uint32_t wordSize = 4);
+        void setDirectIO(bool direct);
+        bool isDirectIO() const;
+        void setThreadPlacement(std::vector<int> const & compressorCpus,
+                                std::vector<int> const & writerCpus = {});
+
         void open(const std::string & filename);
         void open(const std::string & filename, uint8_t* userHdr, uint32_t userLen, bool overwrite = true);
 
@@ -12,6 +12,7 @@
 #define EVIO_6_0_EVIO_CC_H
 
 
+#include "AdaptiveCompression.h"
 #include "BankHeader.h"
 #include "BaseStructure.h"
 #include "BaseStructureHeader.h"
@@ -20,12 +21,17 @@
 
 #include "CompactEventBuilder.h"
 #include "CompositeData.h"
+#include "CompressionDictionary.h"
 #include "Compressor.h"
+#include "DataFilter.h"
 #include "DataType.h"
+#include "DirectFile.h"
+#include "RecordFlushTimer.h"
 
 #include "EventBuilder.h"
 #include "EventHeaderParser.h"
 #include "EventParser.h"
+#include "EventView.h"
 #include "EventWriter.h"
 #include "EventWriterV4.h"
 
@@ -46,6 +52,8 @@
 #include "FileHeader.h"
 #include "HeaderType.h"
 
+#include "ParallelReader.h"
+
 #include "Reader.h"
 #include "RecordCompressor.h"
 #include "RecordHeader.h"
@@ -58,6 +66,7 @@
 #include "StructureTransformer.h"
 #include "StructureType.h"
 #include "TagSegmentHeader.h"
+#include "ThreadPlacement.h"
 #include "Util.h"
 
 #include "Writer.h"
@@ -0,0 +1,346 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Measure every record compression type on real records, to choose the compression
+// type, record size and number of compression threads of a writer.
+//
+// 1) For each record size and compression type, records are built (RecordOutput::build)
+//    and read back (RecordInput::readRecord) on a single core. Compression ratio and
+//    the compress and decompress rates per core, in MB/s of uncompressed events, are printed.
+// 2) For each compressed type, events are written to a file by an EventWriter with
+//    1, 2, 4, ... RecordCompressor threads. The total rate, rate per thread and
+//    speedup over 1 thread are printed. Use a fast disk or tmpfs so it's not the limit.
+//
+// Events come from the evio files given on the command line or, without any, are
+// generated with CompactEventBuilder: a bank of banks holding a time stamp, hits
+// (slot/channel ids, times and noisy ADC values) of several slots and cluster energies.
+
+
+#include <chrono>
+#include <vector>
+#include <random>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Compression types measured. */
+static std::vector<Compressor::CompressionType> types() {
+    std::vector<Compressor::CompressionType> t = {Compressor::UNCOMPRESSED, Compressor::LZ4,
+                                                  Compressor::LZ4_BEST};
+#ifdef USE_GZIP
+    t.push_back(Compressor::GZIP);
+#endif
+#ifdef USE_ZSTD
+    t.push_back(Compressor::ZSTD);
+#endif
+    return t;
+}
+
+
+static std::string typeName(Compressor::CompressionType type) {
+    static const char *names[] = {"none", "lz4", "lz4 best", "gzip", "zstd"};
+    return names[type];
+}
+
+
+/** Add the events of the given file. */
+static void readEvents(std::string const & fileName, std::vector<std::vector<uint8_t>> & events) {
+    Reader reader(fileName);
+    uint32_t len;
+
+    for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+        std::shared_ptr<uint8_t> event = reader.getEvent(i, &len);
+        events.emplace_back(event.get(), event.get() + len);
+    }
+}
+
+
+/** Generate the given number of events with CompactEventBuilder. */
+static void makeEvents(uint32_t count, std::vector<std::vector<uint8_t>> & events) {
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> pedestal(200., 3.);
+    std::exponential_distribution<double> signal(1./400.);
+    std::exponential_distribution<double> energy(1./150.);
+    std::uniform_int_distribution<uint32_t> hitCount(4, 40);
+    std::uniform_int_distribution<uint32_t> channel(0, 15);
+    std::uniform_int_distribution<uint32_t> clusterCount(1, 8);
+    uint64_t timeStamp = 0;
+
+    std::vector<uint32_t> ids, times, adcs;
+    std::vector<float> energies;
+
+    for (uint32_t ev = 0; ev < count; ev++) {
+        CompactEventBuilder builder(32768, ByteOrder::nativeOrder());
+        timeStamp += 1000 + channel(rng);
+
+        builder.openBank(1, DataType::BANK, 1);
+
+        // Trigger bank: event number and time stamp
+        uint64_t trigger[2] = {ev, timeStamp};
+        builder.openBank(2, DataType::ULONG64, 0);
+        builder.addULongData(trigger, 2);
+        builder.closeStructure();
+
+        // Hits of each slot
+        for (uint8_t slot = 3; slot < 11; slot++) {
+            uint32_t hits = hitCount(rng);
+            ids.clear(); times.clear(); adcs.clear();
+            for (uint32_t h = 0; h < hits; h++) {
+                ids.push_back((slot << 16) | channel(rng));
+                times.push_back(100 + channel(rng));
+                uint32_t adc = pedestal(rng);
+                if (h % 4 == 0) adc += signal(rng);
+                adcs.push_back(adc);
+            }
+
+            builder.openBank(10 + slot, DataType::BANK, slot);
+            builder.openBank(20, DataType::UINT32, 1);
+            builder.addUIntData(ids.data(), hits);
+            builder.closeStructure();
+            builder.openBank(21, DataType::UINT32, 2);
+            builder.addUIntData(times.data(), hits);
+            builder.closeStructure();
+            builder.openBank(22, DataType::UINT32, 3);
+            builder.addUIntData(adcs.data(), hits);
+            builder.closeStructure();
+            builder.closeStructure();
+        }
+
+        // Cluster energies
+        energies.clear();
+        uint32_t clusters = clusterCount(rng);
+        for (uint32_t c = 0; c < clusters; c++) {
+            energies.push_back(energy(rng));
+        }
+        builder.openBank(30, DataType::FLOAT32, 0);
+        builder.addFloatData(energies.data(), clusters);
+        builder.closeAll();
+
+        auto & buf = builder.getBuffer();
+        events.emplace_back(buf->array() + buf->arrayOffset(),
+                            buf->array() + buf->arrayOffset() + buf->limit());
+    }
+}
+
+
+/**
+ * Build records of the given size and compression type out of all events,
+ * the given number of times, then read them all back. Print ratio and rates.
+ */
+static void runRecords(std::vector<std::vector<uint8_t>> const & events, uint32_t recordBytes,
+                       Compressor::CompressionType type, int loops) {
+
+    RecordOutput record(ByteOrder::nativeOrder(), 1000000, recordBytes, type);
+    RecordInput input;
+    std::vector<std::shared_ptr<ByteBuffer>> built;
+
+    size_t eventBytes = 0, recordTotal = 0;
+    double compSecs = 0., uncompSecs = 0.;
+
+    auto buildRecord = [&]() {
+        auto t0 = std::chrono::steady_clock::now();
+        record.build();
+        compSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        auto buf = record.getBinaryBuffer();
+        uint32_t len = record.getHeader()->getLength();
+        recordTotal += len;
+        auto copy = std::make_shared<ByteBuffer>(len);
+        copy->order(ByteOrder::nativeOrder());
+        std::memcpy(copy->array(), buf->array() + buf->arrayOffset(), len);
+        built.push_back(copy);
+        record.reset();
+    };
+
+    for (int loop = 0; loop < loops; loop++) {
+        built.clear();
+        for (auto const & ev : events) {
+            if (!record.addEvent(ev.data(), ev.size())) {
+                buildRecord();
+                if (!record.addEvent(ev.data(), ev.size())) {
+                    throw EvioException("event of " + std::to_string(ev.size()) +
+                                        " bytes does not fit in record");
+                }
+            }
+            eventBytes += ev.size();
+        }
+        if (record.getEventCount() > 0) buildRecord();
+
+        for (auto & rec : built) {
+            auto t0 = std::chrono::steady_clock::now();
+            input.readRecord(*rec, 0);
+            uncompSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+    }
+
+    std::cout << std::setw(8) << recordBytes/1024 << " kB  " << std::left << std::setw(9)
+              << typeName(type) << std::right << std::fixed << std::setprecision(3)
+              << "  ratio " << std::setw(6) << (double)eventBytes/recordTotal
+              << std::setprecision(1)
+              << "   compress " << std::setw(8) << eventBytes/1.e6/compSecs << " MB/s"
+              << "   decompress " << std::setw(8) << eventBytes/1.e6/uncompSecs << " MB/s" << std::endl;
+}
+
+
+/**
+ * Write events totaling at least the given number of bytes to a file with the given
+ * compression type and number of compression threads.
+ * @return rate in MB/s of uncompressed events.
+ */
+static double runWriter(std::vector<std::vector<uint8_t>> const & events, std::string fileName,
+                        uint32_t recordBytes, Compressor::CompressionType type,
+                        uint32_t threads, size_t totalBytes) {
+
+    std::string directory, runType;
+    size_t bytes = 0;
+
+    std::vector<std::shared_ptr<ByteBuffer>> buffers;
+    for (auto const & ev : events) {
+        auto buf = std::make_shared<ByteBuffer>(ev.size());
+        buf->order(ByteOrder::nativeOrder());
+        std::memcpy(buf->array(), ev.data(), ev.size());
+        buffers.push_back(buf);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        EventWriter writer(fileName, directory, runType, 1, 0, recordBytes, 1000000,
+                           ByteOrder::nativeOrder(), "", true, false, nullptr,
+                           1, 0, 1, 1, type, threads);
+
+        while (bytes < totalBytes) {
+            for (auto & buf : buffers) {
+                buf->clear();
+                writer.writeEvent(buf);
+                bytes += buf->limit();
+            }
+        }
+        writer.close();
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::remove(fileName.c_str());
+    return bytes/1.e6/secs;
+}
+
+
+static void usage(char *name) {
+    std::cout << "Usage: " << name << " [-s <kB,kB,...>] [-l <loops>] [-t <max threads>]" << std::endl
+              << "          [-m <MB written per run>] [-o <output file>] [<evio file> ...]" << std::endl
+              << "  -s  record sizes in kB (default 64,256,1024,4096)" << std::endl
+              << "  -l  times all events are compressed per record size & type (default 3)" << std::endl
+              << "  -t  max number of compression threads, 0 to skip (default # of cores)" << std::endl
+              << "  -m  MB of events written per thread count & type (default 256)" << std::endl
+              << "  -o  file written while measuring threads (default ./codecBenchmark.evio)" << std::endl
+              << "  Without evio files, events are generated" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+
+    std::vector<uint32_t> recordSizes = {64*1024, 256*1024, 1024*1024, 4096*1024};
+    std::vector<std::string> files;
+    std::string outFile = "./codecBenchmark.evio";
+    uint32_t maxThreads = std::thread::hardware_concurrency();
+    size_t writeBytes = 256*1000000UL;
+    int loops = 3;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "-help") {
+            usage(argv[0]);
+            return 0;
+        }
+        else if (arg[0] == '-' && arg.size() == 2 && i + 1 < argc) {
+            std::string val = argv[++i];
+            switch (arg[1]) {
+                case 's': {
+                    recordSizes.clear();
+                    std::stringstream ss(val);
+                    std::string kB;
+                    while (std::getline(ss, kB, ',')) {
+                        recordSizes.push_back(1024*std::stoul(kB));
+                    }
+                    break;
+                }
+                case 'l': loops      = std::stoi(val); break;
+                case 't': maxThreads = std::stoul(val); break;
+                case 'm': writeBytes = 1000000UL*std::stoul(val); break;
+                case 'o': outFile    = val; break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+        else {
+            files.push_back(arg);
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> events;
+    if (files.empty()) {
+        makeEvents(20000, events);
+        std::cout << "Generated events";
+    }
+    else {
+        for (auto const & file : files) {
+            readEvents(file, events);
+        }
+        std::cout << "Events from " << files.size() << " file(s)";
+    }
+
+    if (events.empty()) {
+        std::cout << ", none" << std::endl;
+        return 1;
+    }
+
+    size_t bytes = 0;
+    for (auto const & ev : events) bytes += ev.size();
+    std::cout << ", " << events.size() << " events, " << bytes/1.e6 << " MB, avg "
+              << bytes/events.size() << " bytes" << std::endl << std::endl;
+
+    std::cout << "Single core, " << loops << " loops:" << std::endl;
+    for (auto size : recordSizes) {
+        for (auto type : types()) {
+            runRecords(events, size, type, loops);
+        }
+        std::cout << std::endl;
+    }
+
+    if (maxThreads == 0) return 0;
+
+    // Scaling with number of compression threads, at the largest record size
+    uint32_t recordBytes = recordSizes.back();
+    std::cout << "EventWriter, " << recordBytes/1024 << " kB records, " << writeBytes/1000000
+              << " MB per run, to " << outFile << ":" << std::endl;
+
+    for (auto type : types()) {
+        if (type == Compressor::UNCOMPRESSED) continue;
+
+        double rate1 = 0.;
+        for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+            double rate = runWriter(events, outFile, recordBytes, type, threads, writeBytes);
+            if (threads == 1) rate1 = rate;
+            std::cout << std::left << std::setw(9) << typeName(type) << std::right
+                      << std::setw(4) << threads << " threads" << std::fixed << std::setprecision(1)
+                      << "   " << std::setw(8) << rate << " MB/s"
+                      << "   " << std::setw(8) << rate/threads << " MB/s/thread"
+                      << std::setprecision(2) << "   speedup " << std::setw(5) << rate/rate1 << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
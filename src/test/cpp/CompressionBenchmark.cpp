@@ -0,0 +1,255 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Compare compression ratio and throughput of the record compression types:
+// LZ4, LZ4 best, zstd at several levels and, if compiled in, gzip.
+// Then LZ4 and zstd again, with the data first run through each DataFilter.
+// Data is compressed in record sized blocks, just as RecordOutput does.
+// With a file argument, the events of that evio file are used as data.
+// Without one, evio banks of simulated detector hits are generated
+// (slot/channel ids, slowly rising time stamps and noisy ADC values).
+
+
+#include <chrono>
+#include <vector>
+#include <random>
+#include <functional>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Size of each block compressed, about that of a record. */
+static const uint32_t BLOCK_BYTES = 1000000;
+
+
+/** Fill blocks with events of the given file. */
+static void readBlocks(std::string const & fileName, std::vector<std::vector<uint8_t>> & blocks) {
+    Reader reader(fileName);
+    std::vector<uint8_t> block;
+    block.reserve(BLOCK_BYTES);
+    uint32_t len;
+
+    for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+        std::shared_ptr<uint8_t> event = reader.getEvent(i, &len);
+        if (block.size() + len > BLOCK_BYTES && !block.empty()) {
+            blocks.push_back(std::move(block));
+            block = std::vector<uint8_t>();
+            block.reserve(BLOCK_BYTES);
+        }
+        block.insert(block.end(), event.get(), event.get() + len);
+    }
+    if (!block.empty()) blocks.push_back(std::move(block));
+}
+
+
+/** Fill blocks with generated banks of detector hits. */
+static void makeBlocks(uint32_t blockCount, std::vector<std::vector<uint8_t>> & blocks) {
+    std::mt19937 rng(12345);
+    std::normal_distribution<double> pedestal(200., 3.);
+    std::exponential_distribution<double> signal(1./400.);
+    std::uniform_int_distribution<uint32_t> hitCount(20, 120);
+    std::uniform_int_distribution<uint32_t> channel(0, 15);
+    uint64_t timeStamp = 0;
+
+    for (uint32_t b = 0; b < blockCount; b++) {
+        std::vector<uint32_t> words;
+        words.reserve(BLOCK_BYTES/4);
+
+        while (4*words.size() < BLOCK_BYTES - 4*(3*120 + 4)) {
+            uint32_t hits = hitCount(rng);
+            timeStamp += 1000 + channel(rng);
+
+            words.push_back(3*hits + 3);                 // bank length
+            words.push_back((1 << 16) | (0x1 << 8));     // tag = 1, type = uint32
+            words.push_back(timeStamp & 0xffffffff);
+            words.push_back(timeStamp >> 32);
+            for (uint32_t h = 0; h < hits; h++) {
+                uint32_t slot = 3 + h/16;
+                words.push_back((slot << 16) | channel(rng));
+                words.push_back(100 + channel(rng));     // hit time
+                uint32_t adc = pedestal(rng);
+                if (h % 4 == 0) adc += signal(rng);
+                words.push_back(adc);
+            }
+        }
+
+        std::vector<uint8_t> block(4*words.size());
+        std::memcpy(block.data(), words.data(), block.size());
+        blocks.push_back(std::move(block));
+    }
+}
+
+
+/**
+ * Compress and uncompress all blocks, the given number of times, and print the result.
+ * The compress function returns compressed size, the uncompress function
+ * returns uncompressed size.
+ */
+static void run(std::string const & name, std::vector<std::vector<uint8_t>> & blocks, int loops,
+                std::function<int(uint8_t *, int, uint8_t *, int)> const & compress,
+                std::function<int(uint8_t *, int, uint8_t *, int)> const & uncompress) {
+
+    std::vector<uint8_t> comp(2*BLOCK_BYTES + 1024), uncomp(BLOCK_BYTES);
+    size_t inBytes = 0, outBytes = 0;
+    double compSecs = 0., uncompSecs = 0.;
+
+    for (int loop = 0; loop < loops; loop++) {
+        for (auto & block : blocks) {
+            auto t0 = std::chrono::steady_clock::now();
+            int compSize = compress(block.data(), block.size(), comp.data(), comp.size());
+            auto t1 = std::chrono::steady_clock::now();
+            int size = uncompress(comp.data(), compSize, uncomp.data(), uncomp.size());
+            auto t2 = std::chrono::steady_clock::now();
+
+            if (size != (int)block.size() || std::memcmp(uncomp.data(), block.data(), size) != 0) {
+                throw EvioException(name + ": uncompressed data differs from original");
+            }
+
+            inBytes  += block.size();
+            outBytes += compSize;
+            compSecs   += std::chrono::duration<double>(t1 - t0).count();
+            uncompSecs += std::chrono::duration<double>(t2 - t1).count();
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+              << "  ratio " << std::setw(6) << (double)inBytes/outBytes
+              << std::setprecision(1)
+              << "   compress " << std::setw(7) << inBytes/1000000./compSecs << " MB/s"
+              << "   uncompress " << std::setw(7) << inBytes/1000000./uncompSecs << " MB/s" << std::endl;
+}
+
+
+/**
+ * Wrap compress and uncompress functions so data is filtered before compressing
+ * and unfiltered after uncompressing, as RecordOutput and RecordInput do.
+ * Filter time is included in the compress and uncompress times.
+ */
+static void runFiltered(std::string const & name, std::vector<std::vector<uint8_t>> & blocks, int loops,
+                        DataFilter::FilterType type, uint32_t wordSize,
+                        std::function<int(uint8_t *, int, uint8_t *, int)> const & compress,
+                        std::function<int(uint8_t *, int, uint8_t *, int)> const & uncompress) {
+
+    std::vector<uint8_t> filtered(BLOCK_BYTES), scratch;
+
+    run(name, blocks, loops,
+        [&](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            DataFilter::encode(type, wordSize, false, src, filtered.data(), srcSize, scratch);
+            return compress(filtered.data(), srcSize, dst, dstCap);
+        },
+        [&](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            int size = uncompress(src, srcSize, dst, dstCap);
+            DataFilter::decode(type, wordSize, false, dst, size, scratch);
+            return size;
+        });
+}
+
+
+int main(int argc, char **argv) {
+
+    std::vector<std::vector<uint8_t>> blocks;
+    int loops = 3;
+
+    if (argc > 2) loops = std::stoi(argv[2]);
+
+    if (argc > 1 && std::string(argv[1]) != "-") {
+        readBlocks(argv[1], blocks);
+        std::cout << "Data from " << argv[1];
+    }
+    else {
+        std::cout << "Usage: " << argv[0] << " [<evio file>|- [<loops>]]" << std::endl;
+        makeBlocks(50, blocks);
+        std::cout << "Generated data";
+    }
+
+    size_t bytes = 0;
+    for (auto const & block : blocks) bytes += block.size();
+    std::cout << ", " << blocks.size() << " blocks, " << bytes/1000000. << " MB, "
+              << loops << " loops" << std::endl << std::endl;
+
+    auto & comp = Compressor::getInstance();
+
+    auto lz4Uncompress = [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+        return comp.uncompressLZ4(src, 0, srcSize, dst, 0, dstCap);
+    };
+
+    run("lz4", blocks, loops,
+        [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            return comp.compressLZ4(src, 0, srcSize, dst, 0, dstCap);
+        }, lz4Uncompress);
+
+    run("lz4 best", blocks, loops,
+        [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            return comp.compressLZ4Best(src, 0, srcSize, dst, 0, dstCap);
+        }, lz4Uncompress);
+
+#ifdef USE_ZSTD
+    for (int level : {-5, -1, 1, 3, 6, 9, 19}) {
+        run("zstd " + std::to_string(level), blocks, loops,
+            [&comp, level](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+                return comp.compressZSTD(src, 0, srcSize, dst, 0, dstCap, level);
+            },
+            [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+                return comp.uncompressZSTD(src, 0, srcSize, dst, 0, dstCap);
+            });
+    }
+#else
+    std::cout << "zstd        not compiled in (USE_ZSTD)" << std::endl;
+#endif
+
+#ifdef USE_GZIP
+    run("gzip", blocks, loops,
+        [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            uint32_t compSize;
+            uint8_t *gzipped = comp.compressGZIP(src, 0, srcSize, &compSize);
+            std::memcpy(dst, gzipped, compSize);
+            delete[] gzipped;
+            return (int)compSize;
+        },
+        [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+            uint32_t uncompSize = dstCap;
+            uint8_t *ungzipped = comp.uncompressGZIP(src, 0, srcSize, &uncompSize, dstCap);
+            std::memcpy(dst, ungzipped, uncompSize);
+            delete[] ungzipped;
+            return (int)uncompSize;
+        });
+#endif
+
+    std::cout << std::endl;
+
+    struct Filter {std::string name; DataFilter::FilterType type; uint32_t wordSize;};
+    std::vector<Filter> filters = {{"shuf4",  DataFilter::SHUFFLE,       4},
+                                   {"delta4", DataFilter::DELTA,         4},
+                                   {"dshuf4", DataFilter::DELTA_SHUFFLE, 4},
+                                   {"shuf8",  DataFilter::SHUFFLE,       8}};
+
+    for (auto const & f : filters) {
+        runFiltered("lz4+" + f.name, blocks, loops, f.type, f.wordSize,
+                    [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+                        return comp.compressLZ4(src, 0, srcSize, dst, 0, dstCap);
+                    }, lz4Uncompress);
+    }
+
+#ifdef USE_ZSTD
+    for (auto const & f : filters) {
+        runFiltered("zstd3+" + f.name, blocks, loops, f.type, f.wordSize,
+                    [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+                        return comp.compressZSTD(src, 0, srcSize, dst, 0, dstCap, 3);
+                    },
+                    [&comp](uint8_t *src, int srcSize, uint8_t *dst, int dstCap) {
+                        return comp.uncompressZSTD(src, 0, srcSize, dst, 0, dstCap);
+                    });
+    }
+#endif
+
+    return 0;
+}
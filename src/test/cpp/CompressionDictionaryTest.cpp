@@ -0,0 +1,98 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check that split files written with a trained compression dictionary and a trailer
+// index can all be read back. Each file must have the dictionary bit set in its file
+// header, the dictionary must be loaded by the Reader, and every event must come back
+// as written. This is done with 1 and with several compression threads.
+
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+static void testSplitFiles(uint32_t compressionThreads,
+                           std::vector<std::shared_ptr<ByteBuffer>> const & events) {
+
+    std::string what = "LZ4 with trained dictionary, " +
+                       std::to_string(compressionThreads) + " compression threads";
+    std::string dir = "compressionDictionaryTest";
+
+    try {
+        makeDirectory(dir);
+
+        // Split files every 200kB, at most 50 events per record, with trailer index
+        std::string baseName = "compressionDictionaryTest.evio", runType;
+        EventWriter writer(baseName, dir, runType, 1, 200000, 1000000, 50,
+                           ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                           1, 0, 1, 1, Compressor::LZ4, compressionThreads);
+        writer.trainCompressionDictionary(200);
+        for (auto buf : events) {
+            writer.writeEvent(buf);
+        }
+        writer.close();
+
+        auto names = listFiles(dir);
+        if (names.size() < 2) {
+            fail(what + ", files not split");
+        }
+
+        uint32_t eventNumber = 0, len;
+        for (auto const & name : names) {
+            Reader reader(dir + "/" + name);
+
+            if (!reader.getFileHeader().hasCompressionDictionary() ||
+                !reader.getFileHeader().hasTrailerWithIndex() ||
+                reader.getCompressionDictionary() == nullptr) {
+                fail(what + ", file " + name + " has no compression dictionary or index");
+                continue;
+            }
+
+            for (uint32_t i = 0; i < reader.getEventCount(); i++, eventNumber++) {
+                auto event = reader.getEvent(i, &len);
+                auto & expected = events[eventNumber];
+                if (len != expected->limit() ||
+                    std::memcmp(event.get(), expected->array(), len) != 0) {
+                    fail(what + ", file " + name + ", event " + std::to_string(i) + " differs");
+                    break;
+                }
+            }
+        }
+
+        if (eventNumber != events.size()) {
+            fail(what + ", read " + std::to_string(eventNumber) + " events of " +
+                 std::to_string(events.size()));
+        }
+        else {
+            std::cout << what << ": " << names.size() << " files read back" << std::endl;
+        }
+    }
+    catch (std::exception & e) {
+        fail(what + ": " + e.what());
+    }
+
+    boost::filesystem::remove_all(dir);
+}
+
+
+int main(int argc, char **argv) {
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    for (uint32_t i = 0; i < 3000; i++) {
+        events.push_back(makeEvent(i));
+    }
+
+    testSplitFiles(1, events);
+    testSplitFiles(3, events);
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check that compression is thread safe.
+// 1) Many threads at once compress and uncompress blocks of different
+//    data with gzip, lz4 and zstd, each checking its own result.
+// 2) A file is written with several compression threads, then read by
+//    several concurrent Readers and by a ParallelReader, checking every event.
+// Run with a compression type (default 3 = gzip) and a thread count.
+// Built without USE_GZIP, it prints SKIPPED and returns 77, which ctest counts as skipped.
+
+
+#include <atomic>
+#include <vector>
+#include <random>
+#include <functional>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Data of the given size, different for each seed, somewhat compressible. */
+static std::vector<uint8_t> makeData(uint32_t seed, uint32_t bytes) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> small(0, 31);
+    std::vector<uint8_t> data(bytes);
+    for (uint32_t i = 0; i < bytes; i++) {
+        data[i] = (i % 4 == 0) ? (uint8_t)(seed + i/64) : (uint8_t)small(rng);
+    }
+    return data;
+}
+
+
+/** Compress & uncompress many blocks with one compression type, checking each. */
+static void codecWorker(uint32_t thread, Compressor::CompressionType type, uint32_t loops) {
+    auto & comp = Compressor::getInstance();
+
+    try {
+        for (uint32_t loop = 0; loop < loops; loop++) {
+            uint32_t seed = 1000*thread + loop;
+            uint32_t size = 1000 + (seed * 7919) % 200000;
+            std::vector<uint8_t> data = makeData(seed, size);
+            std::vector<uint8_t> out(size);
+            std::vector<uint8_t> packed(size + size/2 + 1024);
+            int outSize = 0;
+
+            switch (type) {
+                case Compressor::GZIP: {
+#ifdef USE_GZIP
+                    uint32_t compSize, uncompSize = size;
+                    uint8_t *gzipped = comp.compressGZIP(data.data(), 0, size, &compSize);
+                    uint8_t *ungzipped = comp.uncompressGZIP(gzipped, 0, compSize, &uncompSize, size);
+                    std::memcpy(out.data(), ungzipped, uncompSize);
+                    outSize = uncompSize;
+                    delete[] gzipped;
+                    delete[] ungzipped;
+#endif
+                    break;
+                }
+                case Compressor::ZSTD: {
+#ifdef USE_ZSTD
+                    int compSize = comp.compressZSTD(data.data(), 0, size, packed.data(), 0, packed.size());
+                    outSize = comp.uncompressZSTD(packed.data(), 0, compSize, out.data(), 0, out.size());
+#endif
+                    break;
+                }
+                default: {
+                    int compSize = comp.compressLZ4(data.data(), 0, size, packed.data(), 0, packed.size());
+                    outSize = comp.uncompressLZ4(packed.data(), 0, compSize, out.data(), 0, out.size());
+                }
+            }
+
+            if (outSize != (int)size || out != data) {
+                fail("thread " + std::to_string(thread) + ", type " + std::to_string(type) +
+                     ", loop " + std::to_string(loop) + ": data differs");
+                return;
+            }
+        }
+    }
+    catch (std::exception & e) {
+        fail("thread " + std::to_string(thread) + ": " + e.what());
+    }
+}
+
+
+/** Run many threads of each compression type at once. */
+static void testCodecs(uint32_t threadCount) {
+    std::vector<Compressor::CompressionType> types {Compressor::LZ4};
+#ifdef USE_GZIP
+    types.push_back(Compressor::GZIP);
+#endif
+#ifdef USE_ZSTD
+    types.push_back(Compressor::ZSTD);
+#endif
+
+    std::vector<boost::thread> threads;
+    for (uint32_t i = 0; i < threadCount; i++) {
+        for (auto type : types) {
+            threads.emplace_back(codecWorker, threads.size(), type, 40);
+        }
+    }
+    for (auto & thd : threads) thd.join();
+
+    std::cout << "Codecs: " << threads.size() << " threads done" << std::endl;
+}
+
+
+/** Value of word #j of event #i. */
+static uint32_t eventWord(uint32_t i, uint32_t j) {return i * 31 + (j % 17);}
+
+
+/** Check all words of event #i. */
+static bool checkEvent(uint8_t const *data, uint32_t len, uint64_t i, uint32_t words) {
+    if (len != 4*(words + 2)) return false;
+    auto ints = reinterpret_cast<uint32_t const *>(data);
+    for (uint32_t j = 0; j < words; j++) {
+        if (ints[j + 2] != eventWord(i, j)) return false;
+    }
+    return true;
+}
+
+
+/** Write file with several compression threads, read it back with several threads at once. */
+static void testFile(Compressor::CompressionType type, uint32_t threadCount) {
+    std::string fileName = "compressionStressTest.evio";
+    std::string directory, runType;
+    uint32_t events = 20000, words = 200;
+
+    {
+        EventWriter writer(fileName, directory, runType, 1, 0, 4194304, 200,
+                           ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                           1, 0, 1, 1, type, threadCount);
+
+        auto buf = std::make_shared<ByteBuffer>(4*(words + 2));
+        buf->order(ByteOrder::ENDIAN_LOCAL);
+        for (uint32_t i = 0; i < events; i++) {
+            buf->clear();
+            buf->putInt(words + 1);
+            buf->putInt((1 << 16) | (0x1 << 8));
+            for (uint32_t j = 0; j < words; j++) buf->putInt(eventWord(i, j));
+            buf->flip();
+            writer.writeEvent(buf);
+        }
+        writer.close();
+    }
+
+    // Several Readers, each reading ahead with several threads, all at once
+    std::vector<boost::thread> threads;
+    for (uint32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&fileName, events, words, threadCount]() {
+            try {
+                Reader reader(fileName);
+                reader.setReadAhead(threadCount, 0);
+                if (reader.getEventCount() != events) {
+                    fail("reader found " + std::to_string(reader.getEventCount()) + " events");
+                    return;
+                }
+                uint32_t len;
+                for (uint32_t i = 0; i < events; i++) {
+                    auto data = reader.getNextEvent(&len);
+                    if (data == nullptr || !checkEvent(data.get(), len, i, words)) {
+                        fail("reader, bad event " + std::to_string(i));
+                        return;
+                    }
+                }
+            }
+            catch (std::exception & e) {
+                fail(std::string("reader: ") + e.what());
+            }
+        });
+    }
+    for (auto & thd : threads) thd.join();
+
+    std::atomic<uint64_t> good {0};
+    ParallelReader pReader(fileName, threadCount);
+    pReader.forEachEvent([&good, words](uint32_t, uint64_t i, EventView const & event) {
+        if (checkEvent(event.data(), event.length(), i, words)) good++;
+    });
+    if (good != events) {
+        fail("parallel reader, " + std::to_string(events - good) + " bad events");
+    }
+
+    std::cout << "File: type " << type << ", " << threadCount << " compression threads, "
+              << threadCount << " readers, " << pReader.getWorkerCount() << " parallel workers done" << std::endl;
+
+    std::remove(fileName.c_str());
+}
+
+
+int main(int argc, char **argv) {
+
+#ifndef USE_GZIP
+    // Gzip is what most needs checking, so a build without it must not pass
+    std::cout << "SKIPPED: built without USE_GZIP, gzip cannot be tested" << std::endl;
+    return 77;
+#endif
+
+    auto type = Compressor::GZIP;
+    uint32_t threadCount = 8;
+
+    if (argc > 1) type = Compressor::toCompressionType(std::stoi(argv[1]));
+    if (argc > 2) threadCount = std::stoi(argv[2]);
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " [<compression type> [<threads>]]" << std::endl;
+    }
+
+    testCodecs(threadCount);
+    testFile(type, threadCount);
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,198 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check the data filters applied to records before compression.
+// 1) Every filter type with 4 and 8 byte words, in local and swapped byte order,
+//    must give back the data it was given, for lengths which are not a multiple
+//    of the word size, or shorter than a word. The bytes past the last whole word
+//    must be left as they are. Delta encoding of swapped words must be the swapped
+//    delta encoding of the same words in local order.
+// 2) Files written with LZ4 and each filter, with 1 and with several compression
+//    threads and in both byte orders, must be read back by a Reader event for event.
+
+
+#include <random>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+static const std::vector<DataFilter::FilterType> filterTypes =
+        {DataFilter::NONE, DataFilter::SHUFFLE, DataFilter::DELTA, DataFilter::DELTA_SHUFFLE};
+
+
+/** Data of the given size: slowly growing words, with some random bytes. */
+static std::vector<uint8_t> makeData(size_t bytes, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> step(0, 300);
+    std::vector<uint8_t> data(bytes);
+    uint32_t val = rng();
+    for (size_t i = 0; i < bytes; i++) {
+        if (i % 4 == 0) val += step(rng);
+        data[i] = (i % 16 == 15) ? (uint8_t)rng() : (uint8_t)(val >> (8*(i % 4)));
+    }
+    return data;
+}
+
+
+/** Swap the bytes of each whole word, leaving the bytes past the last one. */
+static std::vector<uint8_t> swapWords(std::vector<uint8_t> const & data, uint32_t wordSize) {
+    std::vector<uint8_t> swapped(data);
+    for (size_t i = 0; i + wordSize <= data.size(); i += wordSize) {
+        std::reverse(swapped.begin() + i, swapped.begin() + i + wordSize);
+    }
+    return swapped;
+}
+
+
+static void testRoundTrip(DataFilter::FilterType type, uint32_t wordSize, bool swap, size_t bytes) {
+
+    std::string what = "Filter " + std::to_string(type) + ", " + std::to_string(wordSize) +
+                       " byte words, " + (swap ? "swapped, " : "") + std::to_string(bytes) + " bytes";
+
+    auto data = makeData(bytes, bytes);
+    std::vector<uint8_t> encoded(bytes), decoded(bytes), scratch;
+
+    DataFilter::encode(type, wordSize, swap, data.data(), encoded.data(), bytes, scratch);
+
+    size_t tail = bytes - bytes % wordSize;
+    if (!std::equal(data.begin() + tail, data.end(), encoded.begin() + tail)) {
+        fail(what + ", bytes past last word changed");
+    }
+
+    // Decoding into another buffer
+    DataFilter::decode(type, wordSize, swap, encoded.data(), decoded.data(), bytes);
+    if (decoded != data) {
+        fail(what + ", decoding into another buffer differs");
+    }
+
+    // Decoding in place
+    DataFilter::decode(type, wordSize, swap, encoded.data(), bytes, scratch);
+    if (encoded != data) {
+        fail(what + ", decoding in place differs");
+    }
+}
+
+
+/** Delta encoding words in the other byte order must swap the result. */
+static void testSwappedDelta(uint32_t wordSize, size_t bytes) {
+
+    std::string what = "Delta of swapped " + std::to_string(wordSize) + " byte words, " +
+                       std::to_string(bytes) + " bytes";
+
+    auto data = makeData(bytes, bytes + 1);
+    auto swappedData = swapWords(data, wordSize);
+    std::vector<uint8_t> encoded(bytes), swappedEncoded(bytes), scratch;
+
+    DataFilter::encode(DataFilter::DELTA, wordSize, false, data.data(), encoded.data(), bytes, scratch);
+    DataFilter::encode(DataFilter::DELTA, wordSize, true, swappedData.data(), swappedEncoded.data(), bytes, scratch);
+
+    if (swappedEncoded != swapWords(encoded, wordSize)) {
+        fail(what + ", not the swapped encoding of local words");
+    }
+}
+
+
+static void testFile(DataFilter::FilterType type, uint32_t wordSize, ByteOrder const & order,
+                     uint32_t compressionThreads) {
+
+    std::string what = "LZ4 file, filter " + std::to_string(type) + ", " + std::to_string(wordSize) +
+                       " byte words, " + order.getName() + ", " +
+                       std::to_string(compressionThreads) + " compression threads";
+    std::string dir = "dataFilterTest";
+    std::string baseName = "dataFilterTest.evio", runType;
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    for (uint32_t i = 0; i < 2000; i++) {
+        events.push_back(makeEvent(i, order));
+    }
+
+    try {
+        makeDirectory(dir);
+
+        // At most 300 events per record, so there are several records
+        EventWriter writer(baseName, dir, runType, 1, 0, 1000000, 300,
+                           order, "", true, false, nullptr,
+                           1, 0, 1, 1, Compressor::LZ4, compressionThreads);
+        writer.setDataFilter(type, wordSize);
+        std::string fileName = writer.getCurrentFilePath();
+        for (auto & buf : events) {
+            writer.writeEvent(buf);
+        }
+        writer.close();
+
+        Reader reader(fileName);
+        auto header = reader.getFirstRecordHeader();
+        if (header->getDataFilter() != type ||
+            (type != DataFilter::NONE && header->getDataFilterWordSize() != wordSize)) {
+            fail(what + ", filter not in record header");
+        }
+
+        if (reader.getEventCount() != events.size()) {
+            fail(what + ", read " + std::to_string(reader.getEventCount()) + " events of " +
+                 std::to_string(events.size()));
+        }
+
+        uint32_t len;
+        for (uint32_t i = 0; i < reader.getEventCount() && i < events.size(); i++) {
+            auto event = reader.getEvent(i, &len);
+            if (len != events[i]->limit() ||
+                std::memcmp(event.get(), events[i]->array(), len) != 0) {
+                fail(what + ", event " + std::to_string(i) + " differs");
+                break;
+            }
+        }
+    }
+    catch (std::exception & e) {
+        fail(what + ": " + e.what());
+    }
+
+    boost::filesystem::remove_all(dir);
+}
+
+
+int main(int argc, char **argv) {
+
+    // Lengths around word sizes, and long enough to use SSE2 with tails of each size
+    std::vector<size_t> lengths = {0, 1, 2, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 31, 32, 33,
+                                   63, 64, 65, 127, 128, 129, 1000, 1001, 1002, 1003,
+                                   4096, 4099, 4100, 4101, 4103, 4104};
+
+    for (auto type : filterTypes) {
+        for (uint32_t wordSize : {4, 8}) {
+            for (bool swap : {false, true}) {
+                for (size_t bytes : lengths) {
+                    testRoundTrip(type, wordSize, swap, bytes);
+                }
+            }
+        }
+    }
+
+    for (uint32_t wordSize : {4, 8}) {
+        for (size_t bytes : lengths) {
+            testSwappedDelta(wordSize, bytes);
+        }
+    }
+
+    std::cout << "Round trips done" << std::endl;
+
+    ByteOrder swappedOrder = ByteOrder::ENDIAN_LOCAL.getOppositeEndian();
+    for (auto type : filterTypes) {
+        for (uint32_t wordSize : {4, 8}) {
+            testFile(type, wordSize, ByteOrder::ENDIAN_LOCAL, 1);
+            testFile(type, wordSize, ByteOrder::ENDIAN_LOCAL, 3);
+            testFile(type, wordSize, swappedOrder, 1);
+        }
+    }
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Compare writing a file through the page cache with writing it with direct I/O
+// (O_DIRECT), for both EventWriter and WriterMT. See EventWriter::setDirectIO.
+//
+// For each writer and each mode, the same events are written and these are printed:
+// 1) the rate in MB/s up to close(),
+// 2) the rate in MB/s until the data is on disk, which for buffered writes
+//    includes an fsync after close(),
+// 3) the longest time and the 99.9th percentile time taken by a single call
+//    to write an event, which shows stalls caused by page cache writeback.
+// Use a file on the fast disk to be measured, not tmpfs, and write more
+// than the machine's dirty page limit to see writeback stalls.
+
+
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Result of one run. */
+struct Result {
+    double closeMBps = 0.;
+    double diskMBps = 0.;
+    double maxCallMs = 0.;
+    double p999CallMs = 0.;
+};
+
+
+/** Force a closed file to disk. */
+static void syncFile(std::string const & fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+
+/** Fill in the result from the times of all calls and of the whole run. */
+static Result makeResult(std::vector<double> & callMs, size_t bytes,
+                         std::chrono::steady_clock::time_point t0,
+                         std::chrono::steady_clock::time_point tClose,
+                         std::chrono::steady_clock::time_point tDisk) {
+    Result r;
+    r.closeMBps = bytes/1.e6/std::chrono::duration<double>(tClose - t0).count();
+    r.diskMBps  = bytes/1.e6/std::chrono::duration<double>(tDisk  - t0).count();
+    if (!callMs.empty()) {
+        std::sort(callMs.begin(), callMs.end());
+        r.maxCallMs  = callMs.back();
+        r.p999CallMs = callMs[std::min(callMs.size() - 1, (size_t)(0.999*callMs.size()))];
+    }
+    return r;
+}
+
+
+/** Write events totaling at least the given number of bytes with an EventWriter. */
+static Result runEventWriter(std::vector<std::shared_ptr<ByteBuffer>> & events, std::string fileName,
+                             Compressor::CompressionType type, uint32_t threads, size_t totalBytes,
+                             bool direct) {
+    std::string directory, runType;
+    std::vector<double> callMs;
+    size_t bytes = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        EventWriter writer(fileName, directory, runType, 1, 0, 16*1024*1024, 100000,
+                           ByteOrder::nativeOrder(), "", true, false, nullptr,
+                           1, 0, 1, 1, type, threads);
+        writer.setDirectIO(direct);
+
+        while (bytes < totalBytes) {
+            for (auto & buf : events) {
+                buf->clear();
+                auto c0 = std::chrono::steady_clock::now();
+                writer.writeEvent(buf);
+                callMs.push_back(std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - c0).count());
+                bytes += buf->limit();
+            }
+        }
+        writer.close();
+    }
+    auto tClose = std::chrono::steady_clock::now();
+    if (!direct) syncFile(fileName);
+    auto tDisk = std::chrono::steady_clock::now();
+
+    std::remove(fileName.c_str());
+    return makeResult(callMs, bytes, t0, tClose, tDisk);
+}
+
+
+/** Write events totaling at least the given number of bytes with a WriterMT. */
+static Result runWriterMT(std::vector<std::shared_ptr<ByteBuffer>> & events, std::string const & fileName,
+                          Compressor::CompressionType type, uint32_t threads, size_t totalBytes,
+                          bool direct) {
+    std::vector<double> callMs;
+    size_t bytes = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        WriterMT writer(HeaderType::EVIO_FILE, ByteOrder::nativeOrder(), 100000, 16*1024*1024,
+                        "", nullptr, 0, type, threads);
+        writer.setDirectIO(direct);
+        writer.open(fileName);
+
+        while (bytes < totalBytes) {
+            for (auto & buf : events) {
+                buf->clear();
+                auto c0 = std::chrono::steady_clock::now();
+                writer.addEvent(buf);
+                callMs.push_back(std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - c0).count());
+                bytes += buf->limit();
+            }
+        }
+        writer.close();
+    }
+    auto tClose = std::chrono::steady_clock::now();
+    if (!direct) syncFile(fileName);
+    auto tDisk = std::chrono::steady_clock::now();
+
+    std::remove(fileName.c_str());
+    return makeResult(callMs, bytes, t0, tClose, tDisk);
+}
+
+
+static void usage(char *name) {
+    std::cout << "Usage: " << name << " [-t <threads>] [-m <MB>] [-r <runs>] [-z <type>] [-o <output file>]" << std::endl
+              << "  -t  number of compression threads (default 2)" << std::endl
+              << "  -m  MB of events written per run (default 4000)" << std::endl
+              << "  -r  runs of each mode, best rate is printed (default 3)" << std::endl
+              << "  -z  compression type, 0 = none, 1 = lz4, 2 = lz4 best, 3 = gzip, 4 = zstd (default 0)" << std::endl
+              << "  -o  file written (default ./directIOBenchmark.evio)" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+
+    std::string outFile = "./directIOBenchmark.evio";
+    uint32_t threads = 2;
+    size_t writeBytes = 4000*1000000UL;
+    int runs = 3;
+    auto type = Compressor::UNCOMPRESSED;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg[0] == '-' && arg.size() == 2 && i + 1 < argc) {
+            std::string val = argv[++i];
+            switch (arg[1]) {
+                case 't': threads    = std::stoul(val); break;
+                case 'm': writeBytes = 1000000UL*std::stoul(val); break;
+                case 'r': runs       = std::stoi(val); break;
+                case 'z': type       = Compressor::toCompressionType(std::stoul(val)); break;
+                case 'o': outFile    = val; break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+        else {
+            usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    makeHitEvents(5000, 130, 800, events);
+
+    {
+        DirectFile probe;
+        probe.open(outFile);
+        if (!probe.isDirect()) {
+            std::cout << "File system of " << outFile << " does not do direct I/O, "
+                      << "both modes go through the page cache" << std::endl;
+        }
+        probe.close();
+        std::remove(outFile.c_str());
+    }
+
+    std::cout << events.size() << " generated events, " << threads << " compression threads, type "
+              << type << ", " << writeBytes/1000000 << " MB per run, best of " << runs
+              << ", to " << outFile << ":" << std::endl;
+    std::cout << std::left << std::setw(24) << "writer / mode" << std::right
+              << std::setw(14) << "to close" << std::setw(14) << "to disk"
+              << std::setw(16) << "max call" << std::setw(16) << "99.9% call" << std::endl;
+
+    for (int w = 0; w < 2; w++) {
+        for (bool direct : {false, true}) {
+            Result best;
+            for (int r = 0; r < runs; r++) {
+                Result res = (w == 0) ? runEventWriter(events, outFile, type, threads, writeBytes, direct) :
+                                        runWriterMT(events, outFile, type, threads, writeBytes, direct);
+                if (res.diskMBps > best.diskMBps) best = res;
+            }
+
+            std::string name = std::string(w == 0 ? "EventWriter" : "WriterMT") +
+                               (direct ? " / direct" : " / buffered");
+            std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+                      << std::setprecision(1)
+                      << std::setw(9) << best.closeMBps << " MB/s"
+                      << std::setw(9) << best.diskMBps << " MB/s"
+                      << std::setprecision(3)
+                      << std::setw(13) << best.maxCallMs << " ms"
+                      << std::setw(13) << best.p999CallMs << " ms" << std::endl;
+        }
+    }
+
+    return 0;
+}
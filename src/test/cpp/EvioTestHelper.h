@@ -20,6 +20,10 @@
 #include <unistd.h>
 #include <random>
 #include <iostream>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 
 #include "eviocc.h"
 
@@ -169,4 +173,100 @@ using namespace evio;
         std::bitset<24>* bitInfo = nullptr; // EventWriterV4 only, set of bits to include in first block header
     };
 
+
+    //--------------------------------------------------------------------
+    // Shared by the tests which report each failure and keep going
+    //--------------------------------------------------------------------
+
+    /** Number of failures so far, may be counted from several threads. */
+    inline std::atomic<int> failures {0};
+
+
+    /** Print a failure and count it. */
+    inline void fail(std::string const & msg) {
+        std::cout << "FAIL: " << msg << std::endl;
+        failures++;
+    }
+
+
+    /** Event #i, a bank of the given number of ints, in the given byte order. */
+    inline std::shared_ptr<ByteBuffer> makeEvent(uint32_t i, uint32_t words, ByteOrder const & order) {
+        auto buf = std::make_shared<ByteBuffer>(4*(words + 2));
+        buf->order(order);
+        buf->putInt(words + 1);
+        buf->putInt((1 << 16) | (0x1 << 8) | (i % 256));
+        for (uint32_t j = 0; j < words; j++) buf->putInt(i * 1000 + j);
+        buf->flip();
+        return buf;
+    }
+
+
+    /** Event #i, a bank of ints of a size depending on i, in the given byte order. */
+    inline std::shared_ptr<ByteBuffer> makeEvent(uint32_t i, ByteOrder const & order = ByteOrder::ENDIAN_LOCAL) {
+        return makeEvent(i, 20 + (i * 53) % 400, order);
+    }
+
+
+    /** Create an empty directory. */
+    inline void makeDirectory(std::string const & dir) {
+        boost::filesystem::remove_all(dir);
+        boost::filesystem::create_directories(dir);
+    }
+
+
+    /** Names of the files in a directory, sorted. */
+    inline std::vector<std::string> listFiles(std::string const & dir) {
+        std::vector<std::string> names;
+        for (auto & entry : boost::filesystem::directory_iterator(dir)) {
+            names.push_back(entry.path().filename().string());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+
+    /**
+     * Make events of generated banks of detector hits, for benchmarks.
+     * Each is a bank of uints: a 64 bit time stamp, then the id, time & adc of each hit.
+     * The events are the same every time this is called.
+     *
+     * @param count   number of events to make.
+     * @param minHits least number of hits in an event.
+     * @param maxHits most number of hits in an event.
+     * @param events  vector to add the events to.
+     */
+    inline void makeHitEvents(uint32_t count, uint32_t minHits, uint32_t maxHits,
+                              std::vector<std::shared_ptr<ByteBuffer>> & events) {
+        std::mt19937 rng(12345);
+        std::normal_distribution<double> pedestal(200., 3.);
+        std::exponential_distribution<double> signal(1./400.);
+        std::uniform_int_distribution<uint32_t> hitCount(minHits, maxHits);
+        std::uniform_int_distribution<uint32_t> channel(0, 15);
+        uint64_t timeStamp = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::vector<uint32_t> words;
+            uint32_t hits = hitCount(rng);
+            timeStamp += 1000 + channel(rng);
+
+            words.push_back(3*hits + 3);                 // bank length
+            words.push_back((1 << 16) | (0x1 << 8));     // tag = 1, type = uint32
+            words.push_back(timeStamp & 0xffffffff);
+            words.push_back(timeStamp >> 32);
+            for (uint32_t h = 0; h < hits; h++) {
+                uint32_t slot = 3 + h/16;
+                words.push_back((slot << 16) | channel(rng));
+                words.push_back(100 + channel(rng));     // hit time
+                uint32_t adc = pedestal(rng);
+                if (h % 4 == 0) adc += signal(rng);
+                words.push_back(adc);
+            }
+
+            auto buf = std::make_shared<ByteBuffer>(4*words.size());
+            buf->order(ByteOrder::nativeOrder());
+            std::memcpy(buf->array(), words.data(), 4*words.size());
+            events.push_back(buf);
+        }
+    }
+
 #endif //EVIO_TEST_HELPER_H
@@ -0,0 +1,112 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check that EventWriter::setMaxRecordAge gets a partially filled record into the file
+// while the writer is still open. A few events, far too few to fill a record, are
+// written slowly, then a Reader following the file must find them all before close().
+// This is done with 1 and with several compression threads, and with and without
+// compression.
+
+
+#include <thread>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/**
+ * Read the events in the file written so far.
+ * @return number of events matching those written, or -1 if one differs.
+ */
+static int readEvents(std::string const & fileName, std::vector<std::shared_ptr<ByteBuffer>> const & events) {
+    Reader reader;
+    reader.setFollowMode(true);
+    reader.open(fileName);
+
+    int count = 0;
+    uint32_t len;
+    std::shared_ptr<uint8_t> event;
+    while ((event = reader.getNextEvent(&len)) != nullptr) {
+        if (count >= (int)events.size() || len != events[count]->limit() ||
+            std::memcmp(event.get(), events[count]->array(), len) != 0) {
+            return -1;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+static void testMaxRecordAge(Compressor::CompressionType type, uint32_t compressionThreads) {
+
+    std::string what = "Type " + std::to_string(type) + ", " +
+                       std::to_string(compressionThreads) + " compression threads";
+    std::string dir = "maxRecordAgeTest";
+    std::string baseName = "maxRecordAgeTest.evio", runType;
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    for (uint32_t i = 0; i < 5; i++) {
+        events.push_back(makeEvent(i));
+    }
+
+    try {
+        makeDirectory(dir);
+
+        EventWriter writer(baseName, dir, runType, 1, 0, 1000000, 10000,
+                           ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                           1, 0, 1, 1, type, compressionThreads);
+        writer.setMaxRecordAge(50);
+
+        // First 3 events go into one record, the last 2 into the next
+        for (uint32_t i = 0; i < events.size(); i++) {
+            writer.writeEvent(events[i]);
+            if (i == 2 || i == 4) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            }
+        }
+
+        std::string fileName = writer.getCurrentFilePath();
+        int count = readEvents(fileName, events);
+        if (count < 0) {
+            fail(what + ", event read back differs");
+        }
+        else if (count != (int)events.size()) {
+            fail(what + ", " + std::to_string(count) + " of " + std::to_string(events.size()) +
+                 " events in file before close");
+        }
+        else {
+            std::cout << what << ": all events in file before close" << std::endl;
+        }
+
+        writer.close();
+
+        if (readEvents(fileName, events) != (int)events.size()) {
+            fail(what + ", events missing after close");
+        }
+    }
+    catch (std::exception & e) {
+        fail(what + ": " + e.what());
+    }
+
+    boost::filesystem::remove_all(dir);
+}
+
+
+int main(int argc, char **argv) {
+
+    testMaxRecordAge(Compressor::UNCOMPRESSED, 1);
+    testMaxRecordAge(Compressor::UNCOMPRESSED, 3);
+    testMaxRecordAge(Compressor::LZ4, 1);
+    testMaxRecordAge(Compressor::LZ4, 3);
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Measure the effect of placing the threads and records of an EventWriter,
+// which writes compressed events to a file, on chosen CPUs and NUMA nodes.
+// See EventWriter::setThreadPlacement.
+//
+// The same events are written with:
+// 1) no placement, letting the OS move threads around,
+// 2) compression and writing threads pinned to the CPUs of each NUMA node,
+//    with records in that node's memory,
+// 3) if there are 2 or more nodes, compression threads on node 0 and
+//    the writing thread on node 1, to show the cost of crossing sockets,
+// 4) if given with -c and -w, compression and writing threads on those CPUs.
+// The rate of each, in MB/s of uncompressed events, is printed.
+// Use a fast disk or tmpfs so it's not the limit.
+
+
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <thread>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+static std::string cpuString(std::vector<int> const & cpus) {
+    if (cpus.empty()) return "any";
+    std::string s;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        // Print ranges as first-last
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (!s.empty()) s += ",";
+        s += std::to_string(cpus[i]);
+        if (j > i) s += "-" + std::to_string(cpus[j]);
+        i = j;
+    }
+    return s;
+}
+
+
+/**
+ * Write events totaling at least the given number of bytes to a file with the given
+ * compression type, number of compression threads and thread placement.
+ * @return rate in MB/s of uncompressed events.
+ */
+static double runWriter(std::vector<std::shared_ptr<ByteBuffer>> & events, std::string fileName,
+                        Compressor::CompressionType type, uint32_t threads, size_t totalBytes,
+                        std::vector<int> const & compCpus, std::vector<int> const & writeCpus) {
+
+    std::string directory, runType;
+    size_t bytes = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        EventWriter writer(fileName, directory, runType, 1, 0, 4*1024*1024, 1000000,
+                           ByteOrder::nativeOrder(), "", true, false, nullptr,
+                           1, 0, 1, 1, type, threads);
+
+        if (!compCpus.empty() || !writeCpus.empty()) {
+            writer.setThreadPlacement(compCpus, writeCpus);
+        }
+
+        while (bytes < totalBytes) {
+            for (auto & buf : events) {
+                buf->clear();
+                writer.writeEvent(buf);
+                bytes += buf->limit();
+            }
+        }
+        writer.close();
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::remove(fileName.c_str());
+    return bytes/1.e6/secs;
+}
+
+
+static void usage(char *name) {
+    std::cout << "Usage: " << name << " [-t <threads>] [-m <MB>] [-r <runs>] [-z <type>]" << std::endl
+              << "          [-c <cpu list>] [-w <cpu list>] [-o <output file>]" << std::endl
+              << "  -t  number of compression threads (default 4)" << std::endl
+              << "  -m  MB of events written per run (default 512)" << std::endl
+              << "  -r  runs of each placement, best is printed (default 3)" << std::endl
+              << "  -z  compression type, 1 = lz4, 2 = lz4 best, 3 = gzip, 4 = zstd (default 1)" << std::endl
+              << "  -c  CPUs for compression threads, as in taskset, e.g. 0-7,16-23" << std::endl
+              << "  -w  CPUs for writing thread" << std::endl
+              << "  -o  file written (default ./placementBenchmark.evio)" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+
+    std::string outFile = "./placementBenchmark.evio";
+    std::vector<int> compCpus, writeCpus;
+    uint32_t threads = 4;
+    size_t writeBytes = 512*1000000UL;
+    int runs = 3;
+    auto type = Compressor::LZ4;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg[0] == '-' && arg.size() == 2 && i + 1 < argc) {
+            std::string val = argv[++i];
+            switch (arg[1]) {
+                case 't': threads    = std::stoul(val); break;
+                case 'm': writeBytes = 1000000UL*std::stoul(val); break;
+                case 'r': runs       = std::stoi(val); break;
+                case 'z': type       = Compressor::toCompressionType(std::stoul(val)); break;
+                case 'c': compCpus   = ThreadPlacement::parseCpuList(val); break;
+                case 'w': writeCpus  = ThreadPlacement::parseCpuList(val); break;
+                case 'o': outFile    = val; break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+        else {
+            usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    makeHitEvents(20000, 20, 120, events);
+
+    // Placements to compare: name, compression CPUs, writing CPUs
+    struct Placement {std::string name; std::vector<int> comp; std::vector<int> write;};
+    std::vector<Placement> placements = {{"none", {}, {}}};
+
+    uint32_t nodeCount = ThreadPlacement::getNumaNodeCount();
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        auto cpus = ThreadPlacement::getNodeCpus(node);
+        if (cpus.empty()) continue;
+        placements.push_back({"node " + std::to_string(node), cpus, cpus});
+    }
+
+    if (nodeCount > 1) {
+        auto cpus0 = ThreadPlacement::getNodeCpus(0);
+        auto cpus1 = ThreadPlacement::getNodeCpus(1);
+        if (!cpus0.empty() && !cpus1.empty()) {
+            placements.push_back({"node 0/1", cpus0, cpus1});
+        }
+    }
+
+    if (!compCpus.empty() || !writeCpus.empty()) {
+        placements.push_back({"given", compCpus, writeCpus});
+    }
+
+    std::cout << events.size() << " generated events, " << nodeCount << " NUMA node(s), "
+              << threads << " compression threads, type " << type << ", "
+              << writeBytes/1000000 << " MB per run, best of " << runs << ", to " << outFile
+              << ":" << std::endl;
+
+    double rateNone = 0.;
+    for (auto const & p : placements) {
+        double best = 0.;
+        for (int r = 0; r < runs; r++) {
+            best = std::max(best, runWriter(events, outFile, type, threads, writeBytes, p.comp, p.write));
+        }
+        if (p.name == "none") rateNone = best;
+
+        std::cout << std::left << std::setw(10) << p.name
+                  << " compress on " << std::setw(14) << cpuString(p.comp)
+                  << " write on " << std::setw(14) << cpuString(p.write) << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(9) << best << " MB/s"
+                  << std::setprecision(2) << "   x " << best/rateNone << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Compare the throughput of reading all records of a file with each of Reader's
+// io engines: std::ifstream (header, then payload), pread (whole record at once),
+// and io_uring (several whole records at once).
+// Without a file argument, a file of uncompressed events is written first.
+// For numbers that reflect the disk and not the page cache, drop the page cache
+// before each run (e.g. "echo 1 > /proc/sys/vm/drop_caches" as root) and use a
+// file much bigger than memory, or run each engine separately with the last argument.
+
+
+#include <chrono>
+#include <vector>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+static void writeFile(std::string fileName, uint32_t nEvents, uint32_t eventWords) {
+    std::string directory = "", runType = "";
+    EventWriter writer(fileName, directory, runType, 1, 0, 4194304, 1000);
+
+    auto buf = std::make_shared<ByteBuffer>(4*(eventWords + 2));
+    buf->order(ByteOrder::nativeOrder());
+
+    for (uint32_t i = 0; i < nEvents; i++) {
+        buf->clear();
+        buf->putInt(eventWords + 1);            // bank length
+        buf->putInt((1 << 16) | (0x1 << 8));    // tag = 1, type = uint32
+        for (uint32_t j = 0; j < eventWords; j++) {
+            buf->putInt(i);
+        }
+        buf->flip();
+        writer.writeEvent(buf);
+    }
+    writer.close();
+}
+
+
+static void readFile(std::string const & fileName, AsyncRecordIO::IoEngine engine,
+                     uint32_t queueDepth, std::string const & name) {
+    Reader reader(fileName);
+    reader.setIoEngine(engine, queueDepth);
+
+    size_t bytes = 0;
+    uint64_t events = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < reader.getRecordCount(); i++) {
+        reader.readRecord(i);
+        bytes += reader.getRecordPositions()[i].getLength();
+        events += reader.getCurrentRecordStream().getEntries();
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::string used = name;
+    if (engine == AsyncRecordIO::IO_URING && reader.getIoEngine() != AsyncRecordIO::IO_URING) {
+        used += " (unavailable, used pread)";
+    }
+
+    std::cout << "  " << used << ": " << reader.getRecordCount() << " records, " << events << " events, "
+              << bytes / 1000000.0 << " MB in " << secs << " s = "
+              << bytes / 1000000.0 / secs << " MB/s" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+
+    std::string fileName = "readRecordBenchmark.evio";
+    uint32_t queueDepth = 8;
+    std::string only;
+
+    if (argc > 1) fileName = argv[1];
+    if (argc > 2) queueDepth = std::stoi(argv[2]);
+    if (argc > 3) only = argv[3];
+
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " [<file> [<queue depth> [ifstream|pread|io_uring]]]" << std::endl;
+        std::cout << "Writing " << fileName << " ..." << std::endl;
+        writeFile(fileName, 200000, 256);
+    }
+
+    std::cout << "Reading " << fileName << ", io_uring queue depth = " << queueDepth << std::endl;
+
+    if (only.empty() || only == "ifstream") readFile(fileName, AsyncRecordIO::IFSTREAM, queueDepth, "ifstream");
+    if (only.empty() || only == "pread")    readFile(fileName, AsyncRecordIO::PREAD,    queueDepth, "pread   ");
+    if (only.empty() || only == "io_uring") readFile(fileName, AsyncRecordIO::IO_URING, queueDepth, "io_uring");
+
+    return 0;
+}
@@ -0,0 +1,566 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check the ways a Reader can read a file or buffer. Uncompressed and LZ4 files are
+// read by a plain Reader, whose events must be those written, and then:
+// 1) memory mapped, also with threads reading ahead, keeping events after close(),
+// 2) as a compressed buffer decompressed lazily, which has no EvioNodes,
+// 3) through EventViews, which go stale once the next record is read,
+// 4) with an index file, which is written, reused, and rejected once the file
+//    is touched or appended to,
+// 5) with an LRU record cache, whose hit and miss counts are checked under random access,
+// 6) with the PREAD and IO_URING engines, and the fallback to PREAD,
+// 7) scanning a file whose records are larger than the chunk of headers read at once,
+// 8) following a file appended to by a writer in another thread.
+// Each event is compared with the one read by the plain Reader.
+
+
+#include <list>
+#include <thread>
+#include <fstream>
+#include <random>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Contents of events. */
+typedef std::vector<std::vector<uint8_t>> Events;
+
+
+static const std::string dir = "readerModesTest";
+
+
+/** Contents of the given event buffers. */
+static Events contents(std::vector<std::shared_ptr<ByteBuffer>> const & buffers) {
+    Events events;
+    for (auto & buf : buffers) {
+        events.emplace_back(buf->array(), buf->array() + buf->limit());
+    }
+    return events;
+}
+
+
+/** Read all events, in order, by index. */
+static Events readEvents(Reader & reader) {
+    Events events;
+    uint32_t len;
+    for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+        auto event = reader.getEvent(i, &len);
+        events.emplace_back(event.get(), event.get() + len);
+    }
+    return events;
+}
+
+
+/** Fail if the events read are not those expected. */
+static void checkEvents(Events const & events, Events const & expected, std::string const & what) {
+    if (events.size() != expected.size()) {
+        fail(what + ", " + std::to_string(events.size()) + " events of " + std::to_string(expected.size()));
+        return;
+    }
+    for (size_t i = 0; i < events.size(); i++) {
+        if (events[i] != expected[i]) {
+            fail(what + ", event " + std::to_string(i) + " differs");
+            return;
+        }
+    }
+}
+
+
+/** Fail if event #i read is not the one expected. */
+static bool checkEvent(const uint8_t *event, uint32_t len, uint32_t i,
+                       Events const & expected, std::string const & what) {
+    if (event == nullptr || len != expected[i].size() ||
+        std::memcmp(event, expected[i].data(), len) != 0) {
+        fail(what + ", event " + std::to_string(i) + " differs");
+        return false;
+    }
+    return true;
+}
+
+
+/** Write events into a file which has no record index, so a Reader must find its records. */
+static void writeFile(std::string const & fileName, std::vector<std::shared_ptr<ByteBuffer>> & events,
+                      Compressor::CompressionType type, uint32_t maxEventCount, uint32_t maxBufferSize = 0) {
+    Writer writer(HeaderType::EVIO_FILE, ByteOrder::ENDIAN_LOCAL, maxEventCount, maxBufferSize,
+                  "", nullptr, 0, type, false);
+    writer.open(fileName);
+    for (auto & buf : events) {
+        writer.addEvent(buf);
+    }
+    writer.close();
+}
+
+
+static void testMapped(std::string const & fileName, Events const & plain, std::string const & what) {
+    try {
+        std::vector<std::shared_ptr<uint8_t>> kept;
+        std::vector<uint32_t> lengths;
+        {
+            Reader reader(fileName, false, true, true);
+            if (!reader.isMemoryMapped()) {
+                fail(what + ", mapped, file not mapped");
+            }
+
+            uint32_t len;
+            for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+                kept.push_back(reader.getEvent(i, &len));
+                lengths.push_back(len);
+            }
+            reader.close();
+        }
+
+        // Events may point into the mapped memory, which must stay mapped while they exist
+        Events events;
+        for (size_t i = 0; i < kept.size(); i++) {
+            events.emplace_back(kept[i].get(), kept[i].get() + lengths[i]);
+        }
+        checkEvents(events, plain, what + ", mapped, events kept after close");
+
+        Reader reader(fileName, false, true, true);
+        reader.setReadAhead(2, 4);
+        checkEvents(readEvents(reader), plain, what + ", mapped with read ahead");
+    }
+    catch (std::exception & e) {
+        fail(what + ", mapped: " + e.what());
+    }
+}
+
+
+static void testLazy(std::vector<std::shared_ptr<ByteBuffer>> & buffers, Events const & expected) {
+    try {
+        auto buffer = std::make_shared<ByteBuffer>(8000000);
+        buffer->order(ByteOrder::ENDIAN_LOCAL);
+        EventWriter writer(buffer, 0, 100, "", 1, Compressor::LZ4);
+        for (auto & buf : buffers) {
+            writer.writeEvent(buf);
+        }
+        writer.close();
+
+        // Decompressed all at once
+        auto written = writer.getByteBuffer();
+        Reader reader(written);
+        Events plain = readEvents(reader);
+        checkEvents(plain, expected, "Buffer");
+        if (reader.getEventNode(0) == nullptr) {
+            fail("Buffer, no EvioNode");
+        }
+
+        // Decompressed record by record, keeping 2 records
+        auto lazyWritten = writer.getByteBuffer();
+        Reader lazy(lazyWritten, false, true, 2);
+        if (!lazy.isCompressed()) {
+            fail("Lazy buffer, decompressed up front");
+        }
+        checkEvents(readEvents(lazy), plain, "Lazy buffer");
+
+        // Backwards, so each record is decompressed again
+        uint32_t len;
+        for (uint32_t i = lazy.getEventCount(); i > 0; i--) {
+            auto event = lazy.getEvent(i - 1, &len);
+            if (!checkEvent(event.get(), len, i - 1, plain, "Lazy buffer, backwards")) break;
+        }
+
+        try {
+            lazy.getEventNode(0);
+            fail("Lazy buffer, EvioNode returned");
+        }
+        catch (EvioException & e) {}
+    }
+    catch (std::exception & e) {
+        fail(std::string("Lazy buffer: ") + e.what());
+    }
+}
+
+
+static void testEventView(std::string const & fileName, Events const & plain, std::string const & what) {
+    try {
+        Reader reader(fileName);
+        if (reader.getRecordCount() < 2) {
+            fail(what + ", views, need 2 records");
+            return;
+        }
+
+        // First event of the second record
+        uint32_t next = reader.getRecordPositions()[0].getCount();
+
+        EventView view = reader.getEventView(0);
+        checkEvent(view.data(), view.length(), 0, plain, what + ", view");
+        if (view.getGeneration() != reader.getCurrentRecordStream().getGeneration()) {
+            fail(what + ", view not of current record");
+        }
+
+        EventView nextView = reader.getEventView(next);
+        checkEvent(nextView.data(), nextView.length(), next, plain, what + ", view of next record");
+        if (view.getGeneration() == reader.getCurrentRecordStream().getGeneration()) {
+            fail(what + ", view of previous record not stale");
+        }
+
+#ifdef EVIO_CHECK_EVENT_VIEWS
+        if (!view.isStale() || nextView.isStale()) {
+            fail(what + ", views not checked");
+        }
+        try {
+            view.data();
+            fail(what + ", stale view used");
+        }
+        catch (EvioException & e) {}
+#endif
+
+        for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+            view = reader.getEventView(i);
+            if (!checkEvent(view.data(), view.length(), i, plain, what + ", views")) break;
+        }
+    }
+    catch (std::exception & e) {
+        fail(what + ", views: " + e.what());
+    }
+}
+
+
+/** Modification time of a file in nanoseconds, -1 if it does not exist. */
+static int64_t modificationTime(std::string const & fileName) {
+    struct stat fileStat {};
+    if (::stat(fileName.c_str(), &fileStat) != 0) {
+        return -1;
+    }
+#ifdef __APPLE__
+    int64_t mtimeNsec = fileStat.st_mtimespec.tv_nsec;
+#else
+    int64_t mtimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+    return (int64_t)fileStat.st_mtime * 1000000000L + mtimeNsec;
+}
+
+
+static void testIndexFile(std::string const & originalName, Events const & plain) {
+    try {
+        std::string fileName = dir + "/indexed.evio";
+        std::string indexName = fileName + ".idx";
+        boost::filesystem::copy_file(originalName, fileName);
+
+        {
+            Reader reader;
+            reader.setUseIndexFile(true);
+            reader.open(fileName);
+            if (reader.getIndexFileName() != indexName || modificationTime(indexName) < 0) {
+                fail("Index file not written");
+                return;
+            }
+            checkEvents(readEvents(reader), plain, "Index file written");
+        }
+
+        // Let any rewrite of the index file change its modification time
+        int64_t indexTime = modificationTime(indexName);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        {
+            Reader reader;
+            reader.setUseIndexFile(true);
+            reader.open(fileName);
+            if (modificationTime(indexName) != indexTime) {
+                fail("Index file rewritten instead of reused");
+            }
+            checkEvents(readEvents(reader), plain, "Index file reused");
+        }
+
+        // Touched file, as if rewritten since
+        struct timespec times[2] = {{0, UTIME_OMIT}, {1000000000, 0}};
+        ::utimensat(AT_FDCWD, fileName.c_str(), times, 0);
+        {
+            Reader reader(fileName);
+            if (reader.readIndexFile()) {
+                fail("Index file used after file touched");
+            }
+        }
+        {
+            Reader reader;
+            reader.setUseIndexFile(true);
+            reader.open(fileName);
+            checkEvents(readEvents(reader), plain, "Index file after touch");
+            if (!reader.readIndexFile()) {
+                fail("Index file not rewritten after file touched");
+            }
+        }
+
+        // Appended to file
+        {
+            std::ofstream file(fileName, std::ios::binary | std::ios::app);
+            file.write("\0\0\0\0", 4);
+        }
+        {
+            Reader reader;
+            reader.open(fileName, false);
+            if (reader.readIndexFile()) {
+                fail("Index file used after file appended to");
+            }
+        }
+    }
+    catch (std::exception & e) {
+        fail(std::string("Index file: ") + e.what());
+    }
+}
+
+
+static void testRecordCache(std::string const & fileName, Events const & plain, std::string const & what) {
+    try {
+        const uint32_t cacheSize = 4;
+        Reader reader(fileName);
+        reader.setRecordCacheSize(cacheSize);
+        reader.resetRecordCacheStats();
+
+        // Record of each event, and its first event
+        std::vector<uint32_t> recordOf, firstEvent;
+        auto & positions = reader.getRecordPositions();
+        for (uint32_t r = 0; r < positions.size(); r++) {
+            firstEvent.push_back(recordOf.size());
+            for (uint32_t c = 0; c < positions[r].getCount(); c++) recordOf.push_back(r);
+        }
+
+        // Same bookkeeping as the cache: current record + the most recently used others
+        std::list<uint32_t> cached;
+        int64_t current = -1;
+        uint64_t hits = 0, misses = 0;
+
+        // Half the events from the first few records, so some are found in the cache
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<uint32_t> anyEvent(0, recordOf.size() - 1);
+        std::uniform_int_distribution<uint32_t> nearEvent(0, firstEvent[std::min<size_t>(6, firstEvent.size() - 1)]);
+        uint32_t len;
+
+        for (uint32_t k = 0; k < 3000; k++) {
+            uint32_t i = (k % 2 == 0) ? anyEvent(rng) : nearEvent(rng);
+            uint32_t r = recordOf[i];
+
+            if (r != current) {
+                auto it = std::find(cached.begin(), cached.end(), r);
+                if (it != cached.end()) {
+                    hits++;
+                    cached.erase(it);
+                }
+                else {
+                    misses++;
+                    if (current >= 0 && cached.size() + 1 >= cacheSize) {
+                        cached.pop_back();
+                    }
+                }
+                if (current >= 0) cached.push_front(current);
+                current = r;
+            }
+
+            auto event = reader.getEvent(i, &len);
+            if (!checkEvent(event.get(), len, i, plain, what + ", cache")) break;
+        }
+
+        if (reader.getRecordCacheHits() != hits || reader.getRecordCacheMisses() != misses) {
+            fail(what + ", cache hits/misses " + std::to_string(reader.getRecordCacheHits()) + "/" +
+                 std::to_string(reader.getRecordCacheMisses()) + ", expected " +
+                 std::to_string(hits) + "/" + std::to_string(misses));
+        }
+        if (hits == 0) {
+            fail(what + ", cache never hit");
+        }
+    }
+    catch (std::exception & e) {
+        fail(what + ", cache: " + e.what());
+    }
+}
+
+
+static void testIoEngines(std::string const & fileName, Events const & plain, std::string const & what) {
+    for (auto engine : {AsyncRecordIO::PREAD, AsyncRecordIO::IO_URING}) {
+        std::string name = what + (engine == AsyncRecordIO::PREAD ? ", pread" : ", io_uring");
+        try {
+            Reader reader(fileName);
+            reader.setIoEngine(engine, 4);
+            checkEvents(readEvents(reader), plain, name);
+
+            // Out of order
+            uint32_t len;
+            for (uint32_t i = reader.getEventCount(); i > 0; i -= 7) {
+                auto event = reader.getEvent(i - 1, &len);
+                if (!checkEvent(event.get(), len, i - 1, plain, name + ", backwards")) break;
+                if (i < 7) break;
+            }
+
+            if (engine == AsyncRecordIO::PREAD && reader.getIoEngine() != AsyncRecordIO::PREAD) {
+                fail(name + ", not used");
+            }
+            if (engine == AsyncRecordIO::IO_URING) {
+                std::cout << what << ": io_uring " <<
+                          (reader.getIoEngine() == AsyncRecordIO::IO_URING ? "used" : "not available, pread used")
+                          << std::endl;
+            }
+        }
+        catch (std::exception & e) {
+            fail(name + ": " + e.what());
+        }
+    }
+}
+
+
+/** An io_uring deeper than the kernel allows cannot be set up, so pread must be used. */
+static void testIoUringFallback() {
+    try {
+        std::string fileName = dir + "/tiny.evio";
+        std::vector<std::shared_ptr<ByteBuffer>> buffers;
+        for (uint32_t i = 0; i < 20; i++) {
+            buffers.push_back(makeEvent(i, 1, ByteOrder::ENDIAN_LOCAL));
+        }
+        writeFile(fileName, buffers, Compressor::UNCOMPRESSED, 5);
+
+        Reader reader(fileName);
+        reader.setIoEngine(AsyncRecordIO::IO_URING, 65536);
+        checkEvents(readEvents(reader), contents(buffers), "io_uring fallback");
+        if (reader.getIoEngine() != AsyncRecordIO::PREAD) {
+            fail("io_uring fallback, pread not used");
+        }
+    }
+    catch (std::exception & e) {
+        fail(std::string("io_uring fallback: ") + e.what());
+    }
+}
+
+
+static void testChunkedScan() {
+    try {
+        std::string fileName = dir + "/large.evio";
+
+        // 4 events per record: every 5th event is 1.2 MB, so most records are larger than
+        // the chunk of the file read at once when scanning (Reader::SCAN_CHUNK_BYTES, 1 MiB)
+        std::vector<std::shared_ptr<ByteBuffer>> buffers;
+        for (uint32_t i = 0; i < 40; i++) {
+            buffers.push_back(makeEvent(i, (i % 5 == 0) ? 300000 : 20 + i, ByteOrder::ENDIAN_LOCAL));
+        }
+        writeFile(fileName, buffers, Compressor::UNCOMPRESSED, 4, 4000000);
+        Events expected = contents(buffers);
+
+        Reader reader(fileName);
+        uint32_t largeRecords = 0;
+        for (auto & pos : reader.getRecordPositions()) {
+            if (pos.getLength() > 1048576) largeRecords++;
+        }
+        if (largeRecords == 0 || largeRecords == reader.getRecordCount()) {
+            fail("Chunked scan, need both large and small records");
+        }
+        checkEvents(readEvents(reader), expected, "Chunked scan");
+
+        Reader mapped(fileName, false, true, true);
+        checkEvents(readEvents(mapped), expected, "Chunked scan, mapped");
+    }
+    catch (std::exception & e) {
+        fail(std::string("Chunked scan: ") + e.what());
+    }
+}
+
+
+static void testFollow(std::vector<std::shared_ptr<ByteBuffer>> & buffers, Events const & expected) {
+    try {
+        std::string baseName = "followed.evio", runType;
+        EventWriter writer(baseName, dir, runType, 1, 0, 1000000, 20,
+                           ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                           1, 0, 1, 1, Compressor::LZ4, 1);
+        std::string fileName = writer.getCurrentFilePath();
+
+        std::thread writerThread([&writer, &buffers]() {
+            try {
+                for (size_t i = 0; i < buffers.size(); i++) {
+                    writer.writeEvent(buffers[i]);
+                    if (i % 200 == 199) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    }
+                }
+                writer.close();
+            }
+            catch (std::exception & e) {
+                fail(std::string("Follow, writer: ") + e.what());
+            }
+        });
+
+        for (int i = 0; i < 1000 && !boost::filesystem::exists(fileName); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        Reader reader;
+        reader.setFollowMode(true);
+        reader.open(fileName);
+
+        uint32_t count = 0, len;
+        while (reader.waitForEvents(10000)) {
+            auto event = reader.getNextEvent(&len);
+            if (count >= expected.size() || !checkEvent(event.get(), len, count, expected, "Follow")) break;
+            count++;
+        }
+
+        writerThread.join();
+
+        if (count != expected.size()) {
+            fail("Follow, read " + std::to_string(count) + " events of " + std::to_string(expected.size()));
+        }
+        if (!reader.isEndOfStream()) {
+            fail("Follow, end of file not found");
+        }
+    }
+    catch (std::exception & e) {
+        fail(std::string("Follow: ") + e.what());
+    }
+}
+
+
+int main(int argc, char **argv) {
+
+    std::vector<std::shared_ptr<ByteBuffer>> buffers;
+    for (uint32_t i = 0; i < 3000; i++) {
+        buffers.push_back(makeEvent(i));
+    }
+    Events expected = contents(buffers);
+
+    makeDirectory(dir);
+
+    for (auto type : {Compressor::UNCOMPRESSED, Compressor::LZ4}) {
+        std::string what = (type == Compressor::LZ4) ? "LZ4" : "Uncompressed";
+        std::string fileName = dir + "/" + what + ".evio";
+        Events plain;
+
+        try {
+            writeFile(fileName, buffers, type, 100);
+            Reader reader(fileName);
+            plain = readEvents(reader);
+            checkEvents(plain, expected, what + ", plain");
+        }
+        catch (std::exception & e) {
+            fail(what + ": " + e.what());
+            continue;
+        }
+
+        testMapped(fileName, plain, what);
+        testEventView(fileName, plain, what);
+        testRecordCache(fileName, plain, what);
+        testIoEngines(fileName, plain, what);
+
+        if (type == Compressor::LZ4) {
+            testIndexFile(fileName, plain);
+        }
+    }
+
+    testLazy(buffers, expected);
+    testIoUringFallback();
+    testChunkedScan();
+    testFollow(buffers, expected);
+
+    boost::filesystem::remove_all(dir);
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check building events in place with EventWriter::reserveEventBuffer & commitEvent.
+// Events of different sizes are built by a CompactEventBuilder directly in the space
+// the writer reserved, filling several records. This is done when writing to a file
+// with 1 and with several compression threads, and when writing to a buffer.
+// Each is read back and compared to the same events built separately.
+
+
+#include <vector>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Build event #i, a bank of banks holding a bank of ints of a size depending on i. */
+static void buildEvent(CompactEventBuilder & builder, uint32_t i) {
+    std::vector<int32_t> data(10 + (i * 37) % 500);
+    for (size_t j = 0; j < data.size(); j++) data[j] = i * 1000 + j;
+
+    builder.openBank(1, DataType::BANK, 1);
+    builder.openBank(2, DataType::INT32, i % 256);
+    builder.addIntData(data.data(), data.size());
+    builder.closeAll();
+}
+
+
+/** The bytes of event #i, built separately. */
+static std::vector<uint8_t> expectedEvent(uint32_t i) {
+    CompactEventBuilder builder(8192, ByteOrder::ENDIAN_LOCAL);
+    buildEvent(builder, i);
+    auto buf = builder.getBuffer();
+    return std::vector<uint8_t>(buf->array() + buf->arrayOffset(),
+                                buf->array() + buf->arrayOffset() + builder.getTotalBytes());
+}
+
+
+/** Write events by building them in the writer's reserved space. */
+static void writeEvents(EventWriter & writer, uint32_t events) {
+    for (uint32_t i = 0; i < events; i++) {
+        auto buf = writer.reserveEventBuffer(8192);
+        if (buf == nullptr) {
+            fail("no reserved buffer for event " + std::to_string(i));
+            return;
+        }
+        CompactEventBuilder builder(buf);
+        buildEvent(builder, i);
+        writer.commitEvent(builder.getTotalBytes());
+    }
+    writer.close();
+}
+
+
+/** Read back all events and compare them to those expected. */
+static void checkEvents(Reader & reader, uint32_t events, std::string const & what) {
+    if (reader.getEventCount() != events) {
+        fail(what + ", read " + std::to_string(reader.getEventCount()) + " events");
+        return;
+    }
+
+    uint32_t len;
+    for (uint32_t i = 0; i < events; i++) {
+        auto data = reader.getEvent(i, &len);
+        std::vector<uint8_t> expected = expectedEvent(i);
+        if (data == nullptr || len != expected.size() ||
+            std::memcmp(data.get(), expected.data(), len) != 0) {
+            fail(what + ", event " + std::to_string(i) + " differs");
+            return;
+        }
+    }
+    std::cout << what << ": " << events << " events done" << std::endl;
+}
+
+
+static void testFile(uint32_t compressionThreads) {
+    std::string fileName = "reserveEventTest.evio";
+    std::string directory, runType;
+    uint32_t events = 1000;
+
+    try {
+        {
+            // At most 64 events per record, so many records
+            EventWriter writer(fileName, directory, runType, 1, 0, 1000000, 64,
+                               ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                               1, 0, 1, 1, Compressor::LZ4, compressionThreads);
+            writeEvents(writer, events);
+        }
+
+        Reader reader(fileName);
+        checkEvents(reader, events, "File, " + std::to_string(compressionThreads) + " compression threads");
+    }
+    catch (std::exception & e) {
+        fail(std::string("file: ") + e.what());
+    }
+
+    std::remove(fileName.c_str());
+}
+
+
+static void testBuffer() {
+    uint32_t events = 100;
+
+    try {
+        auto buffer = std::make_shared<ByteBuffer>(4000000);
+        buffer->order(ByteOrder::ENDIAN_LOCAL);
+        EventWriter writer(buffer);
+        writeEvents(writer, events);
+
+        auto written = writer.getByteBuffer();
+        Reader reader(written);
+        checkEvents(reader, events, "Buffer");
+    }
+    catch (std::exception & e) {
+        fail(std::string("buffer: ") + e.what());
+    }
+}
+
+
+int main(int argc, char **argv) {
+    testFile(1);
+    testFile(4);
+    testBuffer();
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Compare the wait strategies of RecordSupply, which set how the compression and
+// writing threads of EventWriter and WriterMT wait for records.
+//
+// Records go through a RecordSupply as they do in a writer: a producer fills and
+// publishes them, RecordCompressor threads compress them, and a writing thread takes
+// them in order and releases them (without writing to disk). For each strategy:
+// 1) Paced: records are published at a fixed interval, as from a slow DAQ.
+//    The latency from publishing a record to the writing thread getting it,
+//    and the CPU used while mostly waiting, in cores, are printed.
+// 2) Full speed: records are published as fast as possible.
+//    The rate and CPU time per record are printed.
+
+
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <sys/resource.h>
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Result of one run. */
+struct Result {
+    double seconds = 0.;
+    double cpuSeconds = 0.;
+    std::vector<double> latencies;
+};
+
+
+/** CPU time, user + system, used so far by all threads of this process, in seconds. */
+static double cpuSeconds() {
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)/1.e6;
+}
+
+
+/**
+ * Pass records through a supply with the given wait strategy.
+ * @param interval time between publishing records, 0 for as fast as possible.
+ */
+static Result run(RecordSupply::WaitStrategy strategy, uint32_t threads, uint32_t records,
+                  std::chrono::microseconds interval, std::vector<uint8_t> const & event) {
+
+    auto type = Compressor::LZ4;
+    uint32_t ringSize = Util::powerOfTwo(std::max(16U, threads + 2), true);
+    auto supply = std::make_shared<RecordSupply>(ringSize, ByteOrder::nativeOrder(), threads,
+                                                 1000, 0, type, strategy);
+
+    std::vector<std::chrono::steady_clock::time_point> published(records);
+    Result result;
+    result.latencies.resize(records);
+
+    std::vector<RecordCompressor> compressors;
+    compressors.reserve(threads);
+    for (uint32_t i = 0; i < threads; i++) {
+        compressors.emplace_back(i, type, supply);
+    }
+    for (auto & c : compressors) {
+        c.startThread();
+    }
+
+    // Writing thread: get records in order and release them
+    boost::thread writer([&]() {
+        for (uint32_t i = 0; i < records; i++) {
+            auto item = supply->getToWrite();
+            result.latencies[i] = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - published[i]).count();
+            supply->releaseWriterSequential(item);
+        }
+    });
+
+    double cpu0 = cpuSeconds();
+    auto t0 = std::chrono::steady_clock::now();
+    auto next = t0;
+
+    for (uint32_t i = 0; i < records; i++) {
+        if (interval.count() > 0) {
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+
+        auto item = supply->get();
+        item->getRecord()->addEvent(event);
+        // Time stamp is seen by the writing thread through the ring's barriers
+        published[i] = std::chrono::steady_clock::now();
+        supply->publish(item);
+    }
+
+    writer.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    result.cpuSeconds = cpuSeconds() - cpu0;
+
+    for (auto & c : compressors) {
+        c.stopThread();
+    }
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+
+static void usage(char *name) {
+    std::cout << "Usage: " << name << " [-t <threads>] [-n <records>] [-i <usec>] [-e <bytes>]" << std::endl
+              << "  -t  number of compression threads (default 2)" << std::endl
+              << "  -n  records per run (default 2000 paced, 20 x that at full speed)" << std::endl
+              << "  -i  microseconds between records when paced (default 1000)" << std::endl
+              << "  -e  bytes of data in each record (default 16384)" << std::endl;
+}
+
+
+int main(int argc, char **argv) {
+
+    uint32_t threads = 2;
+    uint32_t records = 2000;
+    uint32_t eventBytes = 16384;
+    std::chrono::microseconds interval(1000);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg[0] == '-' && arg.size() == 2 && i + 1 < argc) {
+            std::string val = argv[++i];
+            switch (arg[1]) {
+                case 't': threads    = std::stoul(val); break;
+                case 'n': records    = std::stoul(val); break;
+                case 'i': interval   = std::chrono::microseconds(std::stoul(val)); break;
+                case 'e': eventBytes = std::stoul(val); break;
+                default:
+                    usage(argv[0]);
+                    return 1;
+            }
+        }
+        else {
+            usage(argv[0]);
+            return arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // One event of detector hits, about the given size
+    std::vector<std::shared_ptr<ByteBuffer>> hitEvents;
+    uint32_t hits = eventBytes > 16 ? (eventBytes/4 - 4)/3 : 0;
+    makeHitEvents(1, hits, hits, hitEvents);
+    std::vector<uint8_t> event(hitEvents[0]->array(), hitEvents[0]->array() + hitEvents[0]->limit());
+
+    std::vector<RecordSupply::WaitStrategy> strategies = {RecordSupply::BLOCKING, RecordSupply::YIELDING,
+                                                          RecordSupply::SPIN_BACKOFF, RecordSupply::BUSY_SPIN};
+
+    std::cout << threads << " compression threads, " << event.size() << " bytes per record, "
+              << std::thread::hardware_concurrency() << " cores" << std::endl << std::endl;
+
+    std::cout << "Paced, " << records << " records, one every " << interval.count() << " usec:" << std::endl;
+    for (auto strategy : strategies) {
+        Result r = run(strategy, threads, records, interval, event);
+        auto & lat = r.latencies;
+        double mean = 0.;
+        for (double l : lat) mean += l;
+        mean /= lat.size();
+
+        std::cout << std::left << std::setw(13) << RecordSupply::waitStrategyName(strategy) << std::right
+                  << std::fixed << std::setprecision(1)
+                  << "  latency usec: mean " << std::setw(7) << mean
+                  << "  median " << std::setw(7) << lat[lat.size()/2]
+                  << "  99% " << std::setw(7) << lat[lat.size()*99/100]
+                  << "  max " << std::setw(8) << lat.back()
+                  << std::setprecision(2) << "   cpu " << std::setw(5) << r.cpuSeconds/r.seconds
+                  << " cores" << std::endl;
+    }
+
+    uint32_t fastRecords = 20*records;
+    std::cout << std::endl << "Full speed, " << fastRecords << " records:" << std::endl;
+    for (auto strategy : strategies) {
+        Result r = run(strategy, threads, fastRecords, std::chrono::microseconds(0), event);
+
+        std::cout << std::left << std::setw(13) << RecordSupply::waitStrategyName(strategy) << std::right
+                  << std::fixed << std::setprecision(0)
+                  << "  " << std::setw(9) << fastRecords/r.seconds << " records/s"
+                  << std::setprecision(1)
+                  << "  " << std::setw(8) << fastRecords*event.size()/1.e6/r.seconds << " MB/s"
+                  << "   cpu " << std::setw(7) << 1.e6*r.cpuSeconds/fastRecords << " usec/record"
+                  << std::setprecision(2) << "  " << std::setw(5) << r.cpuSeconds/r.seconds
+                  << " cores" << std::endl;
+    }
+
+    return 0;
+}
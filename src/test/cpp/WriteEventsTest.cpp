@@ -0,0 +1,189 @@
+//
+// Copyright 2026, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+// EPSCI Group
+// Thomas Jefferson National Accelerator Facility
+// 12000, Jefferson Ave, Newport News, VA 23606
+// (757)-269-7100
+
+
+// Check that EventWriter::writeEvents gives the same files as calling writeEvent
+// for each event. Events of different sizes are written in batches of different
+// sizes, so batches end in the middle of records, and files are split often,
+// so the writing of batches is handed over to writeEvent at record and file boundaries.
+// This is done with events in buffers and as nodes, with 1 and with several
+// compression threads, and every file written is compared record by record and event by event.
+
+
+#include "EvioTestHelper.h"
+
+using namespace evio;
+
+
+/** Do the 2 files have the same records, holding the same events? */
+static bool sameFile(std::string const & fileName1, std::string const & fileName2) {
+    Reader reader1(fileName1), reader2(fileName2);
+
+    // Padding of compressed data is not set, so files are compared record by record
+    auto & records1 = reader1.getRecordPositions();
+    auto & records2 = reader2.getRecordPositions();
+    if (records1.size() != records2.size()) return false;
+    for (size_t i = 0; i < records1.size(); i++) {
+        if (records1[i].getPosition() != records2[i].getPosition() ||
+            records1[i].getLength()   != records2[i].getLength() ||
+            records1[i].getCount()    != records2[i].getCount()) {
+            return false;
+        }
+    }
+
+    uint32_t len1, len2;
+    for (uint32_t i = 0; i < reader1.getEventCount(); i++) {
+        auto event1 = reader1.getEvent(i, &len1);
+        auto event2 = reader2.getEvent(i, &len2);
+        if (len1 != len2 || std::memcmp(event1.get(), event2.get(), len1) != 0) return false;
+    }
+    return true;
+}
+
+
+/** Are the files in the 2 directories the same? */
+static bool sameFiles(std::string const & dir1, std::string const & dir2, std::string const & what) {
+    auto names = listFiles(dir1);
+    if (names.size() < 2 || names != listFiles(dir2)) {
+        fail(what + ", different files written");
+        return false;
+    }
+    for (auto const & name : names) {
+        if (!sameFile(dir1 + "/" + name, dir2 + "/" + name)) {
+            fail(what + ", file " + name + " differs");
+            return false;
+        }
+    }
+    std::cout << what << ": " << names.size() << " files match" << std::endl;
+    return true;
+}
+
+
+static std::shared_ptr<EventWriter> makeWriter(std::string dir, Compressor::CompressionType type,
+                                               uint32_t compressionThreads) {
+    std::string baseName = "writeEventsTest.evio", runType;
+    // Split files every 200kB, at most 50 events per record
+    return std::make_shared<EventWriter>(baseName, dir, runType, 1, 200000, 1000000, 50,
+                                         ByteOrder::ENDIAN_LOCAL, "", true, false, nullptr,
+                                         1, 0, 1, 1, type, compressionThreads);
+}
+
+
+static void testBuffers(Compressor::CompressionType type, uint32_t compressionThreads,
+                        std::vector<std::shared_ptr<ByteBuffer>> const & events) {
+
+    std::string what = "Buffers, type " + std::to_string(type) + ", " +
+                       std::to_string(compressionThreads) + " compression threads";
+    std::string dir1 = "writeEventsTest1", dir2 = "writeEventsTest2";
+
+    try {
+        makeDirectory(dir1);
+        auto writer = makeWriter(dir1, type, compressionThreads);
+        for (auto buf : events) {
+            writer->writeEvent(buf);
+        }
+        writer->close();
+
+        makeDirectory(dir2);
+        writer = makeWriter(dir2, type, compressionThreads);
+        size_t i = 0, batch = 1;
+        while (i < events.size()) {
+            size_t n = std::min(batch, events.size() - i);
+            std::vector<std::shared_ptr<ByteBuffer>> batchEvents(events.begin() + i, events.begin() + i + n);
+            if (writer->writeEvents(batchEvents) != n) {
+                fail(what + ", not all events of batch written");
+                break;
+            }
+            i += n;
+            batch = batch % 97 + 13;
+        }
+        writer->close();
+
+        sameFiles(dir1, dir2, what);
+    }
+    catch (std::exception & e) {
+        fail(what + ": " + e.what());
+    }
+
+    boost::filesystem::remove_all(dir1);
+    boost::filesystem::remove_all(dir2);
+}
+
+
+static void testNodes(std::vector<std::shared_ptr<ByteBuffer>> const & events) {
+
+    std::string what = "Nodes";
+    std::string dir1 = "writeEventsTest1", dir2 = "writeEventsTest2";
+
+    try {
+        // Nodes of all events, in a buffer holding them one after the other
+        auto buffer = std::make_shared<ByteBuffer>(8000000);
+        buffer->order(ByteOrder::ENDIAN_LOCAL);
+        {
+            EventWriter writer(buffer, 8000000, 1000000);
+            for (auto buf : events) {
+                writer.writeEvent(buf);
+            }
+            writer.close();
+        }
+        auto written = buffer;
+        Reader reader(written);
+        std::vector<std::shared_ptr<EvioNode>> nodes;
+        for (uint32_t i = 0; i < reader.getEventCount(); i++) {
+            nodes.push_back(reader.getEventNode(i));
+        }
+
+        makeDirectory(dir1);
+        auto writer = makeWriter(dir1, Compressor::UNCOMPRESSED, 1);
+        for (auto node : nodes) {
+            writer->writeEvent(node);
+        }
+        writer->close();
+
+        makeDirectory(dir2);
+        writer = makeWriter(dir2, Compressor::UNCOMPRESSED, 1);
+        size_t i = 0, batch = 1;
+        while (i < nodes.size()) {
+            size_t n = std::min(batch, nodes.size() - i);
+            std::vector<std::shared_ptr<EvioNode>> batchNodes(nodes.begin() + i, nodes.begin() + i + n);
+            if (writer->writeEvents(batchNodes) != n) {
+                fail(what + ", not all events of batch written");
+                break;
+            }
+            i += n;
+            batch = batch % 97 + 13;
+        }
+        writer->close();
+
+        sameFiles(dir1, dir2, what);
+    }
+    catch (std::exception & e) {
+        fail(what + ": " + e.what());
+    }
+
+    boost::filesystem::remove_all(dir1);
+    boost::filesystem::remove_all(dir2);
+}
+
+
+int main(int argc, char **argv) {
+
+    std::vector<std::shared_ptr<ByteBuffer>> events;
+    for (uint32_t i = 0; i < 3000; i++) {
+        events.push_back(makeEvent(i));
+    }
+
+    testBuffers(Compressor::UNCOMPRESSED, 1, events);
+    testBuffers(Compressor::LZ4, 1, events);
+    testBuffers(Compressor::LZ4, 3, events);
+    testNodes(events);
+
+    std::cout << (failures > 0 ? "FAILED" : "PASSED") << std::endl;
+    return failures > 0 ? 1 : 0;
+}